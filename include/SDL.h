@@ -29,6 +29,7 @@
 
 #include "SDL_main.h"
 #include "SDL_stdinc.h"
+#include "SDL_atomic.h"
 #include "SDL_audio.h"
 #include "SDL_cdrom.h"
 #include "SDL_cpuinfo.h"
@@ -0,0 +1,148 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+#ifndef _SDL_atomic_h
+#define _SDL_atomic_h
+
+/** @file SDL_atomic.h
+ *  Atomic operations on integers and pointers, memory barriers and
+ *  spinlocks.  They use the compiler's __atomic builtins where it has
+ *  them, and otherwise a mutex.
+ *
+ *  Every operation is sequentially consistent, so it also works as a
+ *  full memory barrier.
+ *
+ *  @note These are independent of the other SDL routines.
+ */
+
+#include "SDL_stdinc.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Spinlocks                                              */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** A spinlock is an int, 0 when it is unlocked.
+ *  Only hold one for a few instructions: a thread waiting for it keeps
+ *  the CPU busy, and yields it only after a while.
+ */
+typedef int SDL_SpinLock;
+
+/** Take the lock if it is free.
+ *  @return SDL_TRUE if the lock was taken
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicTryLock(SDL_SpinLock *lock);
+
+/** Wait until the lock is free and take it */
+extern DECLSPEC void SDLCALL SDL_AtomicLock(SDL_SpinLock *lock);
+
+/** Release a lock taken by SDL_AtomicLock() or SDL_AtomicTryLock() */
+extern DECLSPEC void SDLCALL SDL_AtomicUnlock(SDL_SpinLock *lock);
+
+/*@}*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Memory barriers                                        */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** Keeps the compiler from moving memory accesses across it */
+#if defined(__GNUC__)
+#define SDL_CompilerBarrier()	__asm__ __volatile__ ("" : : : "memory")
+#elif defined(_MSC_VER) && (_MSC_VER > 1200)
+void _ReadWriteBarrier(void);
+#pragma intrinsic(_ReadWriteBarrier)
+#define SDL_CompilerBarrier()	_ReadWriteBarrier()
+#else
+#define SDL_CompilerBarrier()	\
+	{ SDL_SpinLock _tmp = 0; SDL_AtomicLock(&_tmp); SDL_AtomicUnlock(&_tmp); }
+#endif
+
+extern DECLSPEC void SDLCALL SDL_MemoryBarrierReleaseFunction(void);
+extern DECLSPEC void SDLCALL SDL_MemoryBarrierAcquireFunction(void);
+
+/** Memory barriers for passing data to another thread without a lock.
+ *  The writer fills in the data, calls SDL_MemoryBarrierRelease(), then
+ *  sets a flag.  The reader sees the flag, calls SDL_MemoryBarrierAcquire(),
+ *  then reads the data, which is sure to be complete.
+ */
+#if defined(__ATOMIC_SEQ_CST)
+#define SDL_MemoryBarrierRelease()	__atomic_thread_fence(__ATOMIC_RELEASE)
+#define SDL_MemoryBarrierAcquire()	__atomic_thread_fence(__ATOMIC_ACQUIRE)
+#else
+#define SDL_MemoryBarrierRelease()	SDL_MemoryBarrierReleaseFunction()
+#define SDL_MemoryBarrierAcquire()	SDL_MemoryBarrierAcquireFunction()
+#endif
+
+/*@}*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Atomic integers and pointers                           */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** An int that is only read and changed with the functions below */
+typedef struct { int value; } SDL_atomic_t;
+
+/** Set the value to 'newval' if it is 'oldval'.
+ *  @return SDL_TRUE if it was set
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCAS(SDL_atomic_t *a, int oldval, int newval);
+
+/** Set the value, returning the one it replaced */
+extern DECLSPEC int SDLCALL SDL_AtomicSet(SDL_atomic_t *a, int v);
+
+/** Read the value */
+extern DECLSPEC int SDLCALL SDL_AtomicGet(SDL_atomic_t *a);
+
+/** Add 'v' to the value, returning the value before the add */
+extern DECLSPEC int SDLCALL SDL_AtomicAdd(SDL_atomic_t *a, int v);
+
+/** Set the bits of 'v' in the value, returning the value before */
+extern DECLSPEC int SDLCALL SDL_AtomicOr(SDL_atomic_t *a, int v);
+
+/** Keep only the bits of 'v' in the value, returning the value before */
+extern DECLSPEC int SDLCALL SDL_AtomicAnd(SDL_atomic_t *a, int v);
+
+/** Take a reference */
+#define SDL_AtomicIncRef(a)	SDL_AtomicAdd(a, 1)
+
+/** Drop a reference, SDL_TRUE if it was the last one */
+#define SDL_AtomicDecRef(a)	(SDL_AtomicAdd(a, -1) == 1)
+
+/** The same for a pointer */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCASPtr(void **a, void *oldval, void *newval);
+extern DECLSPEC void * SDLCALL SDL_AtomicSetPtr(void **a, void *v);
+extern DECLSPEC void * SDLCALL SDL_AtomicGetPtr(void **a);
+
+/*@}*/
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_atomic_h */
@@ -65,6 +65,7 @@ extern "C" {
  *     This function usually runs in a separate thread, and so you should
  *     protect data structures that it accesses by calling SDL_LockAudio()
  *     and SDL_UnlockAudio() in your code.
+ *     It may be NULL to feed the audio with SDL_QueueAudio() instead.
  * - 'desired->userdata' is passed as the first parameter to your callback
  *     function.
  *
@@ -195,6 +196,64 @@ extern DECLSPEC SDL_audiostatus SDLCALL SDL_GetAudioStatus(void);
  */
 extern DECLSPEC void SDLCALL SDL_PauseAudio(int pause_on);
 
+/**
+ * @name Audio Queue
+ * When the audio device is opened without a callback, the audio is played
+ * from a queue instead.  The queued data is in the format asked for, and
+ * is converted like the callback data would be.  The audio thread takes
+ * it without locking, so these functions can be called from any thread
+ * without SDL_LockAudio().  If the queue runs dry the device plays silence.
+ */
+/*@{*/
+/**
+ * This function adds 'len' bytes of audio data to the end of the queue.
+ * It returns 0, or -1 if the device wasn't opened without a callback or
+ * there wasn't enough memory, in which case part of the data may have
+ * been queued.
+ */
+extern DECLSPEC int SDLCALL SDL_QueueAudio(const void *data, Uint32 len);
+
+/**
+ * This function returns the number of bytes queued and not yet played.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioSize(void);
+
+/**
+ * This function drops all the queued audio.  The memory it used is kept
+ * for the data queued next, and freed when the device is closed.
+ */
+extern DECLSPEC void SDLCALL SDL_ClearQueuedAudio(void);
+
+/**
+ * This function returns how many times the queue ran dry after some data
+ * was played since the device was opened, each time padding the audio
+ * with silence until more was queued.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetAudioUnderruns(void);
+/*@}*/
+
+/**
+ * This function tells SDL whether the callback always writes every byte
+ * of the buffer it is passed, so the buffer doesn't have to be cleared to
+ * silence before each call.  It is off by default and applies to the
+ * audio opened afterwards.  Callbacks that mix into the buffer, like ones
+ * using SDL_MixAudio(), must leave it off.
+ */
+extern DECLSPEC void SDLCALL SDL_SetAudioCallbackFillsBuffer(int fills);
+
+/**
+ * This function gets how long the audio thread took to make each buffer,
+ * from getting it from the driver until handing it back, which covers the
+ * callback, clearing it to silence and any conversion.  'periods' is set
+ * to the number of buffers made since the device was opened or the counts
+ * were reset, 'total' and 'worst' to the sum and the longest time, in
+ * SDL_GetPerformanceCounter() counts.  Any of them may be NULL.
+ */
+extern DECLSPEC void SDLCALL SDL_GetAudioPeriodStats(Uint32 *periods, Uint64 *total, Uint64 *worst);
+
+/** This function sets the counts of SDL_GetAudioPeriodStats() back to 0 */
+extern DECLSPEC void SDLCALL SDL_ResetAudioPeriodStats(void);
+
 /**
  * This function loads a WAVE from the data source, automatically freeing
  * that source if 'freesrc' is non-zero.  For example, to load a WAVE file,
@@ -246,6 +305,60 @@ extern DECLSPEC int SDLCALL SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
  */
 extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT *cvt);
 
+/**
+ * @name Audio Streams
+ * A conversion for audio that comes in pieces, like decoded music.  Any
+ * number of bytes can be put in and taken out at a time, the stream keeps
+ * the partial frames and the resampler history between them, so the
+ * output is the same as converting all of the audio at once.  The
+ * conversion goes through buffers of a fixed size however much is put in,
+ * and the converted data waits in the stream until it is taken.  One
+ * thread may put data in, flush and clear the stream while another one
+ * takes the data out.
+ */
+/*@{*/
+typedef struct SDL_AudioStream SDL_AudioStream;
+
+/**
+ * This function creates a stream converting between the given formats,
+ * channels and frequencies, like SDL_BuildAudioCVT().  It returns NULL
+ * and sets the SDL error message if the conversion isn't supported.
+ */
+extern DECLSPEC SDL_AudioStream * SDLCALL SDL_NewAudioStream(Uint16 src_format, Uint8 src_channels, int src_rate, Uint16 dst_format, Uint8 dst_channels, int dst_rate);
+
+/**
+ * This function converts 'len' bytes of audio and adds them to the stream.
+ * It returns 0, or -1 if it ran out of memory.
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len);
+
+/**
+ * This function takes up to 'len' bytes of converted audio out of the
+ * stream.  It returns the number of bytes taken.
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamGet(SDL_AudioStream *stream, void *buf, int len);
+
+/**
+ * This function returns the number of converted bytes in the stream.
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamAvailable(SDL_AudioStream *stream);
+
+/**
+ * This function converts what the resampler still holds back, as if the
+ * audio ended in silence, and starts the stream over for new audio.
+ * Partial frames are dropped.  It returns 0, or -1 if it ran out of
+ * memory.
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamFlush(SDL_AudioStream *stream);
+
+/**
+ * This function drops everything in the stream and starts it over.
+ */
+extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
+
+extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
+/*@}*/
+
 
 #define SDL_MIX_MAXVOLUME 128
 /**
@@ -257,6 +370,89 @@ extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT *cvt);
  */
 extern DECLSPEC void SDLCALL SDL_MixAudio(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
 
+/**
+ * @name Voice Mixer
+ * A mixer for a fixed number of voices, each playing a sound sample with
+ * its own volume, pan and pitch.  Pass SDL_MixVoices as the callback and
+ * the mixer as the userdata to SDL_OpenAudio().  All voices are summed
+ * into 32 bit values and clipped once, so this is cheaper than calling
+ * SDL_MixAudio() for each sound.  The voice functions lock the audio
+ * callback while they change a voice.
+ */
+/*@{*/
+#define SDL_MIX_MAXVOICES 256
+
+typedef struct SDL_VoiceMixer SDL_VoiceMixer;
+typedef struct SDL_VoiceSample SDL_VoiceSample;
+
+/**
+ * This function creates a mixer with the given number of voices, up to
+ * SDL_MIX_MAXVOICES, for the format, channels (mono or stereo) and
+ * frequency in 'spec'.  This is the format the callback is called with,
+ * usually the spec passed to SDL_OpenAudio().  It returns NULL and sets
+ * the SDL error message if it failed.
+ */
+extern DECLSPEC SDL_VoiceMixer * SDLCALL SDL_CreateVoiceMixer(const SDL_AudioSpec *spec, int voices);
+
+/**
+ * This function frees a mixer.  It must not be used by the audio callback
+ * anymore, close the audio device first.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeVoiceMixer(SDL_VoiceMixer *mixer);
+
+/**
+ * The audio callback of a mixer, 'userdata' is the SDL_VoiceMixer.  It
+ * overwrites 'stream' with the mix of all playing voices.  It can also
+ * be called from your own callback.
+ */
+extern DECLSPEC void SDLCALL SDL_MixVoices(void *userdata, Uint8 *stream, int len);
+
+/**
+ * This function converts a sound to a sample the mixer can play, using
+ * the format, channels and frequency in 'spec'.  The sound is copied and
+ * can be freed afterwards, samples with more than two channels are mixed
+ * down to stereo.  It returns NULL and sets the SDL error message if it
+ * failed.
+ */
+extern DECLSPEC SDL_VoiceSample * SDLCALL SDL_CreateVoiceSample(const Uint8 *buf, Uint32 len, const SDL_AudioSpec *spec);
+
+/**
+ * This function frees a sample.  Stop the voices playing it first.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeVoiceSample(SDL_VoiceSample *sample);
+
+/**
+ * This function starts playing a sample on a voice, or on the first free
+ * voice if 'voice' is -1.  The sample is played 'loops' more times after
+ * the first, or forever if 'loops' is -1.  It returns the voice number,
+ * or -1 if there was no free voice.
+ */
+extern DECLSPEC int SDLCALL SDL_PlayVoice(SDL_VoiceMixer *mixer, int voice, SDL_VoiceSample *sample, int loops);
+
+/**
+ * The following functions change a voice, or all voices if 'voice' is -1.
+ * The settings are kept when a voice starts playing another sample.  They
+ * return 0, or -1 if the voice number is invalid.
+ *
+ * The volume ranges from 0 to SDL_MIX_MAXVOLUME, the default.  The pan
+ * ranges from -SDL_MIX_MAXVOLUME (left) to SDL_MIX_MAXVOLUME (right), 0
+ * plays both sides at full volume.  The pitch multiplies the playback
+ * rate, 1.0 plays the sample at its own frequency.
+ */
+/*@{*/
+extern DECLSPEC int SDLCALL SDL_StopVoice(SDL_VoiceMixer *mixer, int voice);
+extern DECLSPEC int SDLCALL SDL_SetVoiceVolume(SDL_VoiceMixer *mixer, int voice, int volume);
+extern DECLSPEC int SDLCALL SDL_SetVoicePan(SDL_VoiceMixer *mixer, int voice, int pan);
+extern DECLSPEC int SDLCALL SDL_SetVoicePitch(SDL_VoiceMixer *mixer, int voice, double pitch);
+/*@}*/
+
+/**
+ * This function returns 1 if the voice is playing, or the number of
+ * playing voices if 'voice' is -1.
+ */
+extern DECLSPEC int SDLCALL SDL_VoicePlaying(SDL_VoiceMixer *mixer, int voice);
+/*@}*/
+
 /**
  * @name Audio Locks
  * The lock manipulated by these functions protects the callback function.
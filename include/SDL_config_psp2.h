@@ -42,6 +42,13 @@ void SDL_PSP2_SetVideoModeScaling(int x, int y, float w, float h);
 void SDL_PSP2_SetVideoModeBilinear(int enable_bilinear);
 void SDL_PSP2_SetVideoModeSync(int enable_vsync);
 void SDL_PSP2_SetFlipWaitRendering(int flip_wait);
+void SDL_PSP2_SetDirtyRectUpdates(int enable);
+void SDL_PSP2_SetFlipTextures(int count);
+void SDL_PSP2_SetHardwareBlits(int enable);
+void SDL_PSP2_GetBatchStats(unsigned int *scenes, unsigned int *batches, unsigned int *draw_calls, unsigned int *quads);
+void SDL_PSP2_ResetBatchStats(void);
+void SDL_PSP2_SetGPUOverlays(int enable);
+void SDL_PSP2_GetTextureMemoryStats(unsigned int *used, unsigned int *reserved, unsigned int *high_water, unsigned int *fragmentation);
 void SDL_PSP2_SetTextureAllocMemblockType(SceKernelMemBlockType type);
 #ifdef __cplusplus
 }
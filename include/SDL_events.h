@@ -272,7 +272,12 @@ typedef enum {
  *  This function returns the number of events actually stored, or -1
  *  if there was an error.
  *
- *  This function is thread-safe.
+ *  This function is thread-safe.  Any number of threads may add events
+ *  at the same time; threads getting or peeking at events take turns.
+ *
+ *  Each event type holds up to 1024 events, or as many as the
+ *  SDL_EVENT_QUEUE_SIZE environment variable says when the event loop
+ *  starts.  Events added to a full queue are dropped.
  */
 extern DECLSPEC int SDLCALL SDL_PeepEvents(SDL_Event *events, int numevents,
 				SDL_eventaction action, Uint32 mask);
@@ -283,12 +288,30 @@ extern DECLSPEC int SDLCALL SDL_PeepEvents(SDL_Event *events, int numevents,
  */
 extern DECLSPEC int SDLCALL SDL_PollEvent(SDL_Event *event);
 
+/** Polls for currently pending events once, and moves up to 'numevents' of
+ *  them, oldest first, from the queue to 'events'.  Returns the number of
+ *  events stored, or 0 if there are none available.
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event *events, int numevents);
+
 /** Waits indefinitely for the next available event, returning 1, or 0 if there
  *  was an error while waiting for events.  If 'event' is not NULL, the next
  *  event is removed from the queue and stored in that area.
  */
 extern DECLSPEC int SDLCALL SDL_WaitEvent(SDL_Event *event);
 
+/** Waits until the next available event, or until 'timeout' milliseconds
+ *  have passed, returning 1, or 0 if there was no event or an error.
+ *  A negative 'timeout' waits indefinitely.  If 'event' is not NULL, the
+ *  next event is removed from the queue and stored in that area.
+ *
+ *  The waiting thread wakes up as soon as an event is added to the queue.
+ *  Unless SDL_INIT_EVENTTHREAD was used, it also wakes up every 10 ms,
+ *  or as often as the SDL_EVENT_POLL_INTERVAL environment variable says,
+ *  to poll the video driver for input.
+ */
+extern DECLSPEC int SDLCALL SDL_WaitEventTimeout(SDL_Event *event, int timeout);
+
 /** Add an event to the event queue.
  *  This function returns 0 on success, or -1 if the event queue was full
  *  or there was some other error.
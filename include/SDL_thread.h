@@ -45,6 +45,30 @@ extern "C" {
 struct SDL_Thread;
 typedef struct SDL_Thread SDL_Thread;
 
+/** Thread priority classes, mapped onto what each platform offers */
+typedef enum {
+	SDL_THREAD_PRIORITY_DEFAULT = 0,	/**< Same as the creating thread */
+	SDL_THREAD_PRIORITY_LOW,
+	SDL_THREAD_PRIORITY_NORMAL,
+	SDL_THREAD_PRIORITY_HIGH,
+	SDL_THREAD_PRIORITY_TIME_CRITICAL
+} SDL_ThreadPriority;
+
+/** How to create a thread, zero fields keep the defaults
+ *
+ *  Bit n of 'cpumask' lets the thread run on CPU n; on the PS Vita bits
+ *  0 to 2 are the three user cores.  Priorities the system doesn't let
+ *  the process have (raising it on Linux needs privileges) are ignored,
+ *  but a stack size or CPU mask it refuses makes creating the thread fail,
+ *  and so does a priority that isn't one of SDL_ThreadPriority.
+ */
+typedef struct SDL_ThreadAttributes {
+	const char *name;		/**< Shown by debuggers, NULL for the default */
+	Uint32 stacksize;		/**< In bytes, 0 for the platform's default */
+	SDL_ThreadPriority priority;
+	Uint32 cpumask;			/**< CPUs it may run on, 0 for any */
+} SDL_ThreadAttributes;
+
 /** Create a thread */
 #if ((defined(__WIN32__) && !defined(HAVE_LIBC)) || defined(__OS2__)) &&  !defined(__SYMBIAN32__)
 /**
@@ -79,16 +103,25 @@ typedef void (__cdecl *pfnSDL_CurrentEndThread)(unsigned code);
 #endif
 
 extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread);
+extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadWithAttributes(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttributes *attr, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread);
 
 #ifdef __OS2__
 #define SDL_CreateThread(fn, data) SDL_CreateThread(fn, data, _beginthread, _endthread)
+#define SDL_CreateThreadWithAttributes(fn, data, attr) SDL_CreateThreadWithAttributes(fn, data, attr, _beginthread, _endthread)
 #elif defined(_WIN32_WCE)
 #define SDL_CreateThread(fn, data) SDL_CreateThread(fn, data, NULL, NULL)
+#define SDL_CreateThreadWithAttributes(fn, data, attr) SDL_CreateThreadWithAttributes(fn, data, attr, NULL, NULL)
 #else
 #define SDL_CreateThread(fn, data) SDL_CreateThread(fn, data, _beginthreadex, _endthreadex)
+#define SDL_CreateThreadWithAttributes(fn, data, attr) SDL_CreateThreadWithAttributes(fn, data, attr, _beginthreadex, _endthreadex)
 #endif
 #else
 extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data);
+
+/** Create a thread with a given stack size, priority, CPU mask and name,
+ *  'attr' may be NULL for the same thread SDL_CreateThread() makes.
+ */
+extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadWithAttributes(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttributes *attr);
 #endif
 
 /** Get the 32-bit thread identifier for the current thread */
@@ -108,6 +141,58 @@ extern DECLSPEC void SDLCALL SDL_WaitThread(SDL_Thread *thread, int *status);
 /** Forcefully kill a thread without worrying about its state */
 extern DECLSPEC void SDLCALL SDL_KillThread(SDL_Thread *thread);
 
+/** @name Thread pools
+ *  A fixed set of worker threads running small tasks.  Each worker keeps
+ *  its own queue of tasks and takes work from the others when it runs
+ *  out.  Tasks submitted from inside a task go to that worker's queue,
+ *  the others to a queue shared by the pool.
+ */
+/*@{*/
+typedef struct SDL_ThreadPool SDL_ThreadPool;
+
+/** Counts unfinished tasks, so a thread can wait for a group of them */
+typedef struct SDL_TaskCounter SDL_TaskCounter;
+
+typedef void (SDLCALL *SDL_TaskFunction)(void *data);
+
+/** Runs the part [first, last) of a range */
+typedef void (SDLCALL *SDL_RangeFunction)(void *data, int first, int last);
+
+/** Create a pool of 'workers' threads.
+ *  'attr' may be NULL, or give the name, stack size and priority of the
+ *  workers; they take turns over the CPUs in its mask, one CPU each.
+ *  Without 'attr' the SDL_WORKER_THREAD_STACKSIZE, _PRIORITY and _CPUMASK
+ *  environment variables are used.
+ */
+extern DECLSPEC SDL_ThreadPool * SDLCALL SDL_CreateThreadPool(int workers, const SDL_ThreadAttributes *attr);
+
+/** Finish all the submitted tasks, then stop the workers and free the pool */
+extern DECLSPEC void SDLCALL SDL_DestroyThreadPool(SDL_ThreadPool *pool);
+
+extern DECLSPEC SDL_TaskCounter * SDLCALL SDL_CreateTaskCounter(void);
+extern DECLSPEC void SDLCALL SDL_DestroyTaskCounter(SDL_TaskCounter *counter);
+
+/** Run func(data) on the pool.
+ *  If 'counter' isn't NULL it counts the task until it has finished.
+ *  @return 0, or -1 if there isn't memory for the task
+ */
+extern DECLSPEC int SDLCALL SDL_SubmitTask(SDL_ThreadPool *pool, SDL_TaskFunction func, void *data, SDL_TaskCounter *counter);
+
+/** Run func(data, first, last) over [first, last) in parts no longer
+ *  than 'grain', or a size that gives each worker a few parts if 'grain'
+ *  is 0.  The range is split in halves as the workers take it, so idle
+ *  workers take big pieces.
+ *  With a 'counter' this returns at once and the counter counts the
+ *  parts, otherwise it returns when all of them are done.
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(SDL_ThreadPool *pool, int first, int last, int grain, SDL_RangeFunction func, void *data, SDL_TaskCounter *counter);
+
+/** Wait until the tasks counted by 'counter' have finished, running
+ *  tasks from the pool meanwhile.  Tasks may wait for other tasks.
+ */
+extern DECLSPEC int SDLCALL SDL_WaitTasks(SDL_ThreadPool *pool, SDL_TaskCounter *counter);
+/*@}*/
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
@@ -51,6 +51,31 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetTicks(void);
 /** Wait a specified number of milliseconds before returning */
 extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
 
+/**
+ * Get the current value of the high resolution counter, which counts
+ * SDL_GetPerformanceFrequency() times a second.  Only the difference
+ * between two values is meaningful.  Platforms without a finer clock
+ * count milliseconds.
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceCounter(void);
+
+/** Get the number of counts per second of the high resolution counter */
+extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
+
+/**
+ * Get the number of microseconds since the SDL library initialization.
+ * Unlike SDL_GetTicks(), this value doesn't wrap.
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetTicksUS(void);
+
+/**
+ * Wait a specified number of microseconds before returning.  This
+ * sleeps for most of the time and then spins on the high resolution
+ * counter for the last millisecond, so it keeps the CPU busy for that
+ * long but returns within tens of microseconds of the target time.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayPrecise(Uint32 us);
+
 /** Function prototype for the timer callback function */
 typedef Uint32 (SDLCALL *SDL_TimerCallback)(Uint32 interval);
 
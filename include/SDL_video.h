@@ -768,6 +768,21 @@ extern DECLSPEC int SDLCALL SDL_LowerBlit
 extern DECLSPEC int SDLCALL SDL_FillRect
 		(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color);
 
+/**
+ * This function sets how many threads large software blits, fills and
+ * SDL_SoftStretch() calls share.  Each one over SDL_BLIT_MIN_PIXELS
+ * pixels (128K by default) is split into bands of rows, and the calling
+ * thread runs bands next to 'threads'-1 worker threads.  0 or 1 runs
+ * them all on the calling thread, which is the default unless the
+ * SDL_BLIT_THREADS environment variable is set.  The workers take the
+ * SDL_BLIT_THREAD_STACKSIZE, _PRIORITY and _CPUMASK environment variables
+ * and run until SDL_Quit().
+ *
+ * Don't call this while another thread is blitting.
+ * This function returns 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SetBlitThreads(int threads);
+
 /**
  * This function takes a surface and copies it to a new surface of the
  * pixel format and colors of the video framebuffer, suitable for fast
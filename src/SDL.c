@@ -27,6 +27,7 @@
 #include "SDL_fatal.h"
 #if !SDL_VIDEO_DISABLED
 #include "video/SDL_leaks.h"
+extern void SDL_BlitThreadsQuit(void);
 #endif
 
 #if SDL_THREAD_PTH
@@ -220,6 +221,9 @@ void SDL_Quit(void)
   printf("[SDL_Quit] : Enter! Calling QuitSubSystem()\n"); fflush(stdout);
 #endif
 	SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
+#if !SDL_VIDEO_DISABLED
+	SDL_BlitThreadsQuit();
+#endif
 
 #ifdef CHECK_LEAKS
 #ifdef DEBUG_BUILD
@@ -0,0 +1,303 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_timer.h"
+
+/* Use the compiler's atomic builtins unless told not to, otherwise
+   every operation takes one mutex.
+ */
+#if !defined(SDL_ATOMIC_MUTEX) && \
+    (defined(HAVE_GCC_ATOMICS) || defined(__ATOMIC_SEQ_CST))
+#define SDL_ATOMIC_GCC	1
+#endif
+
+/* Tell the CPU we're spinning, so a hyperthread or the bus can get on */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SDL_CPUPause()	__asm__ __volatile__ ("pause")
+#elif defined(__GNUC__) && (defined(__aarch64__) || \
+      (defined(__ARM_ARCH) && __ARM_ARCH >= 7) || defined(__ARM_ARCH_6K__))
+#define SDL_CPUPause()	__asm__ __volatile__ ("yield")
+#else
+#define SDL_CPUPause()
+#endif
+
+/* How often to look at a held spinlock before giving up the CPU */
+#define SDL_SPIN_COUNT	64
+
+#if SDL_ATOMIC_GCC
+
+void SDL_AtomicInit(void)
+{
+}
+
+#define SDL_AtomicBegin()
+#define SDL_AtomicEnd()
+
+#else
+
+static SDL_mutex *SDL_atomic_lock = NULL;
+
+/* WARNING:
+   If the very first atomic operations run on several threads at once,
+   they could each create a mutex.  SDL_CreateThread() calls this before
+   starting a thread, so the race only comes up with threads SDL didn't
+   create.
+ */
+void SDL_AtomicInit(void)
+{
+	if ( SDL_atomic_lock == NULL ) {
+		SDL_atomic_lock = SDL_CreateMutex();
+	}
+}
+
+static void SDL_AtomicBegin(void)
+{
+	SDL_AtomicInit();
+	/* Carry on unguarded if there is no mutex to be had */
+	if ( SDL_atomic_lock ) {
+		SDL_mutexP(SDL_atomic_lock);
+	}
+}
+
+static void SDL_AtomicEnd(void)
+{
+	if ( SDL_atomic_lock ) {
+		SDL_mutexV(SDL_atomic_lock);
+	}
+}
+
+#endif /* SDL_ATOMIC_GCC */
+
+SDL_bool SDL_AtomicTryLock(SDL_SpinLock *lock)
+{
+#if SDL_ATOMIC_GCC
+	return (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) == 0) ? SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool taken = SDL_FALSE;
+
+	SDL_AtomicBegin();
+	if ( *lock == 0 ) {
+		*lock = 1;
+		taken = SDL_TRUE;
+	}
+	SDL_AtomicEnd();
+	return(taken);
+#endif
+}
+
+void SDL_AtomicLock(SDL_SpinLock *lock)
+{
+	int spins = 0;
+
+	while ( !SDL_AtomicTryLock(lock) ) {
+		/* Wait for it to look free before trying again, so the
+		   waiters don't fight over the cache line meanwhile
+		 */
+		do {
+			if ( ++spins < SDL_SPIN_COUNT ) {
+				SDL_CPUPause();
+			} else {
+				/* The holder may be waiting for this CPU */
+				SDL_Delay(0);
+				spins = 0;
+			}
+#if SDL_ATOMIC_GCC
+		} while ( __atomic_load_n(lock, __ATOMIC_RELAXED) != 0 );
+#else
+		} while ( 0 );
+#endif
+	}
+}
+
+void SDL_AtomicUnlock(SDL_SpinLock *lock)
+{
+#if SDL_ATOMIC_GCC
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+#else
+	SDL_AtomicBegin();
+	*lock = 0;
+	SDL_AtomicEnd();
+#endif
+}
+
+/* Taking and releasing the mutex orders memory both ways */
+void SDL_MemoryBarrierReleaseFunction(void)
+{
+#if SDL_ATOMIC_GCC
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#else
+	SDL_AtomicBegin();
+	SDL_AtomicEnd();
+#endif
+}
+
+void SDL_MemoryBarrierAcquireFunction(void)
+{
+#if SDL_ATOMIC_GCC
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+#else
+	SDL_AtomicBegin();
+	SDL_AtomicEnd();
+#endif
+}
+
+SDL_bool SDL_AtomicCAS(SDL_atomic_t *a, int oldval, int newval)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_compare_exchange_n(&a->value, &oldval, newval, 0,
+	                                   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool swapped = SDL_FALSE;
+
+	SDL_AtomicBegin();
+	if ( a->value == oldval ) {
+		a->value = newval;
+		swapped = SDL_TRUE;
+	}
+	SDL_AtomicEnd();
+	return(swapped);
+#endif
+}
+
+int SDL_AtomicSet(SDL_atomic_t *a, int v)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_exchange_n(&a->value, v, __ATOMIC_SEQ_CST);
+#else
+	int value;
+
+	SDL_AtomicBegin();
+	value = a->value;
+	a->value = v;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
+
+int SDL_AtomicGet(SDL_atomic_t *a)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_load_n(&a->value, __ATOMIC_SEQ_CST);
+#else
+	int value;
+
+	SDL_AtomicBegin();
+	value = a->value;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
+
+int SDL_AtomicAdd(SDL_atomic_t *a, int v)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_fetch_add(&a->value, v, __ATOMIC_SEQ_CST);
+#else
+	int value;
+
+	SDL_AtomicBegin();
+	value = a->value;
+	a->value = value + v;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
+
+int SDL_AtomicOr(SDL_atomic_t *a, int v)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_fetch_or(&a->value, v, __ATOMIC_SEQ_CST);
+#else
+	int value;
+
+	SDL_AtomicBegin();
+	value = a->value;
+	a->value = value | v;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
+
+int SDL_AtomicAnd(SDL_atomic_t *a, int v)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_fetch_and(&a->value, v, __ATOMIC_SEQ_CST);
+#else
+	int value;
+
+	SDL_AtomicBegin();
+	value = a->value;
+	a->value = value & v;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
+
+SDL_bool SDL_AtomicCASPtr(void **a, void *oldval, void *newval)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_compare_exchange_n(a, &oldval, newval, 0,
+	                                   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool swapped = SDL_FALSE;
+
+	SDL_AtomicBegin();
+	if ( *a == oldval ) {
+		*a = newval;
+		swapped = SDL_TRUE;
+	}
+	SDL_AtomicEnd();
+	return(swapped);
+#endif
+}
+
+void *SDL_AtomicSetPtr(void **a, void *v)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_exchange_n(a, v, __ATOMIC_SEQ_CST);
+#else
+	void *value;
+
+	SDL_AtomicBegin();
+	value = *a;
+	*a = v;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
+
+void *SDL_AtomicGetPtr(void **a)
+{
+#if SDL_ATOMIC_GCC
+	return __atomic_load_n(a, __ATOMIC_SEQ_CST);
+#else
+	void *value;
+
+	SDL_AtomicBegin();
+	value = *a;
+	SDL_AtomicEnd();
+	return(value);
+#endif
+}
@@ -27,6 +27,9 @@
 #include "SDL_audio_c.h"
 #include "SDL_audiomem.h"
 #include "SDL_sysaudio.h"
+#include "SDL_resample_c.h"
+#include "SDL_audioqueue_c.h"
+#include "../thread/SDL_thread_c.h"
 
 #ifdef __OS2__
 /* We'll need the DosSetPriority() API! */
@@ -123,19 +126,90 @@ static AudioBootStrap *bootstrap[] = {
 };
 SDL_AudioDevice *current_audio = NULL;
 
+/* Set with SDL_SetAudioCallbackFillsBuffer(), for the next device */
+static int callback_fills_buffer = 0;
+
 /* Various local functions */
 int SDL_AudioInit(const char *driver_name);
 void SDL_AudioQuit(void);
 
+/* Runs the callback into 'mix', or takes the queued audio, or writes
+   silence while paused
+ */
+static void SDL_FillAudio(SDL_AudioDevice *audio, Uint8 *mix, int len, int silence)
+{
+	if ( audio->paused ) {
+		SDL_memset(mix, silence, len);
+	} else if ( audio->queue ) {
+		/* The queue pads with silence and needs no lock */
+		SDL_GetAudioQueue(audio->queue, mix, len);
+	} else {
+		if ( !audio->fills_buffer ) {
+			SDL_memset(mix, silence, len);
+		}
+		SDL_mutexP(audio->mixer_lock);
+		(*audio->spec.callback)(audio->spec.userdata, mix, len);
+		SDL_mutexV(audio->mixer_lock);
+	}
+}
+
+/* Converts in another buffer, big enough for the conversion */
+static void SDL_ConvertAudioIn(SDL_AudioCVT *cvt, Uint8 *buf)
+{
+	Uint8 *own_buf = cvt->buf;
+
+	cvt->buf = buf;
+	SDL_ConvertAudio(cvt);
+	cvt->buf = own_buf;
+}
+
+/* Runs the callback as often as the resampler needs to fill the stream */
+static void SDL_ResampleAudio(SDL_AudioDevice *audio, Uint8 *stream, int silence)
+{
+	SDL_AudioCVT *convert = &audio->convert;
+	SDL_AudioCVT *convert_out = &audio->convert_out;
+	const int frame_size = audio->spec.channels * sizeof(Sint16);
+
+	while ( SDL_ResamplerNeeded(audio->resampler, audio->spec.samples) > 0 ) {
+		SDL_FillAudio(audio, convert->buf, convert->len, silence);
+		SDL_ConvertAudio(convert);
+		SDL_ResamplerPut(audio->resampler, (Sint16 *)convert->buf,
+		                 convert->len_cvt / frame_size);
+	}
+	if ( convert_out->needed && !audio->convert_out_in_place ) {
+		SDL_ResamplerGet(audio->resampler, (Sint16 *)convert_out->buf,
+		                 audio->spec.samples);
+		SDL_ConvertAudio(convert_out);
+		SDL_memcpy(stream, convert_out->buf, convert_out->len_cvt);
+	} else {
+		SDL_ResamplerGet(audio->resampler, (Sint16 *)stream,
+		                 audio->spec.samples);
+		if ( convert_out->needed ) {
+			SDL_ConvertAudioIn(convert_out, stream);
+		}
+	}
+}
+
+/* Adds the time taken to make one buffer to the statistics */
+static void SDL_UpdateAudioStats(SDL_AudioDevice *audio, Uint64 counts)
+{
+	SDL_AtomicLock(&audio->stats_lock);
+	++audio->stats_periods;
+	audio->stats_total += counts;
+	if ( counts > audio->stats_worst ) {
+		audio->stats_worst = counts;
+	}
+	SDL_AtomicUnlock(&audio->stats_lock);
+}
+
 /* The general mixing thread function */
 int SDLCALL SDL_RunAudio(void *audiop)
 {
 	SDL_AudioDevice *audio = (SDL_AudioDevice *)audiop;
 	Uint8 *stream;
 	int    stream_len;
-	void  *udata;
-	void (SDLCALL *fill)(void *userdata,Uint8 *stream, int len);
 	int    silence;
+	Uint64 start;
 
 	/* Perform any thread setup */
 	if ( audio->ThreadInit ) {
@@ -143,11 +217,7 @@ int SDLCALL SDL_RunAudio(void *audiop)
 	}
 	audio->threadid = SDL_ThreadID();
 
-	/* Set up the mixing function */
-	fill  = audio->spec.callback;
-	udata = audio->spec.userdata;
-
-	if ( audio->convert.needed ) {
+	if ( audio->convert.needed || audio->resampler ) {
 		if ( audio->convert.src_format == AUDIO_U8 ) {
 			silence = 0x80;
 		} else {
@@ -184,38 +254,29 @@ int SDLCALL SDL_RunAudio(void *audiop)
 	while ( audio->enabled ) {
 
 		/* Fill the current buffer with sound */
-		if ( audio->convert.needed ) {
-			if ( audio->convert.buf ) {
-				stream = audio->convert.buf;
-			} else {
-				continue;
-			}
-		} else {
-			stream = audio->GetAudioBuf(audio);
-			if ( stream == NULL ) {
-				stream = audio->fake_stream;
-			}
+		stream = audio->GetAudioBuf(audio);
+		if ( stream == NULL ) {
+			stream = audio->fake_stream;
 		}
-
-		SDL_memset(stream, silence, stream_len);
-
-		if ( ! audio->paused ) {
-			SDL_mutexP(audio->mixer_lock);
-			(*fill)(udata, stream, stream_len);
-			SDL_mutexV(audio->mixer_lock);
-		}
-
-		/* Convert the audio if necessary */
-		if ( audio->convert.needed ) {
+		start = SDL_GetPerformanceCounter();
+
+		if ( audio->resampler ) {
+			SDL_ResampleAudio(audio, stream, silence);
+		} else if ( ! audio->convert.needed ) {
+			SDL_FillAudio(audio, stream, stream_len, silence);
+		} else if ( audio->convert_in_place ) {
+			/* The conversion fits in the device buffer, skip the copy */
+			SDL_FillAudio(audio, stream, stream_len, silence);
+			SDL_ConvertAudioIn(&audio->convert, stream);
+		} else {
+			SDL_FillAudio(audio, audio->convert.buf, stream_len, silence);
 			SDL_ConvertAudio(&audio->convert);
-			stream = audio->GetAudioBuf(audio);
-			if ( stream == NULL ) {
-				stream = audio->fake_stream;
-			}
 			SDL_memcpy(stream, audio->convert.buf,
-			               audio->convert.len_cvt);
+			           audio->convert.len_cvt);
 		}
 
+		SDL_UpdateAudioStats(audio, SDL_GetPerformanceCounter() - start);
+
 		/* Ready current buffer for play and change current buffer */
 		if ( stream != audio->fake_stream ) {
 			audio->PlayAudio(audio);
@@ -258,6 +319,59 @@ static void SDL_UnlockAudio_Default(SDL_AudioDevice *audio)
 	SDL_mutexV(audio->mixer_lock);
 }
 
+/* Sets up the rate conversion SDL_AudioCVT can't do in fixed size buffers.
+   The callback still gets desired->samples frames at a time, each device
+   buffer takes as many calls as the resampler needs.
+ */
+static int SDL_OpenResampler(SDL_AudioDevice *audio, SDL_AudioSpec *desired)
+{
+	SDL_AudioCVT *convert = &audio->convert;
+	SDL_AudioCVT *convert_out = &audio->convert_out;
+	const int channels = audio->spec.channels;
+	const int frame_size = channels * sizeof(Sint16);
+
+	/* Callback data to 16 bit native, still at the callback rate */
+	if ( SDL_BuildAudioCVT(convert,
+		desired->format, desired->channels, desired->freq,
+		AUDIO_S16SYS, channels, desired->freq) < 0 ) {
+		return(-1);
+	}
+	convert->src_format = desired->format;	/* for the silence value */
+	convert->len = desired->size;
+	convert->buf = (Uint8 *)SDL_AllocAudioMem(convert->len*convert->len_mult);
+	if ( convert->buf == NULL ) {
+		SDL_OutOfMemory();
+		return(-1);
+	}
+
+	audio->resampler = SDL_NewResampler(SDL_GetResampleQuality(), channels,
+		(double)desired->freq / audio->spec.freq, audio->spec.samples,
+		(convert->len*convert->len_mult) / frame_size);
+	if ( audio->resampler == NULL ) {
+		return(-1);
+	}
+
+	/* Resampled data to the device format */
+	if ( SDL_BuildAudioCVT(convert_out,
+		AUDIO_S16SYS, channels, audio->spec.freq,
+		audio->spec.format, channels, audio->spec.freq) < 0 ) {
+		return(-1);
+	}
+	if ( convert_out->needed ) {
+		convert_out->len = audio->spec.samples * frame_size;
+		convert_out->buf = (Uint8 *)SDL_AllocAudioMem(
+			convert_out->len*convert_out->len_mult);
+		if ( convert_out->buf == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		audio->convert_out_in_place =
+			(convert_out->len*convert_out->len_mult <=
+			 (int)audio->spec.size);
+	}
+	return(0);
+}
+
 static Uint16 SDL_ParseAudioFormat(const char *string)
 {
 	Uint16 format = 0;
@@ -482,11 +596,6 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		}
 		desired->samples = power2;
 	}
-	if ( desired->callback == NULL ) {
-		SDL_SetError("SDL_OpenAudio() passed a NULL callback");
-		return(-1);
-	}
-
 #if SDL_THREADS_DISABLED
 	/* Uses interrupt driven audio, without thread */
 #else
@@ -508,6 +617,20 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	audio->enabled = 1;
 	audio->paused  = 1;
 
+	audio->fills_buffer = callback_fills_buffer;
+
+	/* Without a callback the audio is taken from SDL_QueueAudio() */
+	if ( desired->callback == NULL ) {
+		audio->queue = SDL_NewAudioQueue(desired->silence);
+		if ( audio->queue == NULL ) {
+			SDL_CloseAudio();
+			return(-1);
+		}
+		audio->spec.callback = SDL_DrainAudioQueue;
+		audio->spec.userdata = audio->queue;
+		audio->fills_buffer = 1;
+	}
+
 	audio->opened = audio->OpenAudio(audio, &audio->spec)+1;
 
 	if ( ! audio->opened ) {
@@ -532,11 +655,19 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	/* See if we need to do any conversion */
 	if ( obtained != NULL ) {
 		SDL_memcpy(obtained, &audio->spec, sizeof(audio->spec));
+		obtained->callback = desired->callback;
+		obtained->userdata = desired->userdata;
 	} else if ( desired->freq != audio->spec.freq ||
                     desired->format != audio->spec.format ||
 	            desired->channels != audio->spec.channels ) {
-		/* Build an audio conversion block */
-		if ( SDL_BuildAudioCVT(&audio->convert,
+		/* Resample in a stream if needed, else build an audio
+		   conversion block */
+		if ( SDL_NeedsResampler(desired->freq, audio->spec.freq) ) {
+			if ( SDL_OpenResampler(audio, desired) < 0 ) {
+				SDL_CloseAudio();
+				return(-1);
+			}
+		} else if ( SDL_BuildAudioCVT(&audio->convert,
 			desired->format, desired->channels,
 					desired->freq,
 			audio->spec.format, audio->spec.channels,
@@ -544,7 +675,7 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 			SDL_CloseAudio();
 			return(-1);
 		}
-		if ( audio->convert.needed ) {
+		if ( audio->convert.needed && !audio->resampler ) {
 			audio->convert.len = (int) ( ((double) audio->spec.size) /
                                           audio->convert.len_ratio );
 			audio->convert.buf =(Uint8 *)SDL_AllocAudioMem(
@@ -554,19 +685,18 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 				SDL_OutOfMemory();
 				return(-1);
 			}
+			audio->convert_in_place =
+				(audio->convert.len*audio->convert.len_mult <=
+				 (int)audio->spec.size);
 		}
 	}
 
 	/* Start the audio thread if necessary */
 	switch (audio->opened) {
 		case  1:
-			/* Start the audio thread */
-#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
-#undef SDL_CreateThread
-			audio->thread = SDL_CreateThread(SDL_RunAudio, audio, NULL, NULL);
-#else
-			audio->thread = SDL_CreateThread(SDL_RunAudio, audio);
-#endif
+			/* Start the audio thread, ahead of the others */
+			audio->thread = SDL_CreateThreadInternal(SDL_RunAudio, audio,
+			                 "SDL audio", SDL_THREAD_PRIORITY_HIGH, "SDL_AUDIO_THREAD");
 			if ( audio->thread == NULL ) {
 				SDL_CloseAudio();
 				SDL_SetError("Couldn't create audio thread");
@@ -607,6 +737,88 @@ void SDL_PauseAudio (int pause_on)
 	}
 }
 
+int SDL_QueueAudio(const void *data, Uint32 len)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( !audio || !audio->queue ) {
+		SDL_SetError("Audio device wasn't opened without a callback");
+		return(-1);
+	}
+	return(SDL_PutAudioQueue(audio->queue, data, len));
+}
+
+Uint32 SDL_GetQueuedAudioSize(void)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( !audio || !audio->queue ) {
+		return(0);
+	}
+	return(SDL_AudioQueueSize(audio->queue));
+}
+
+void SDL_ClearQueuedAudio(void)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( audio && audio->queue ) {
+		SDL_ClearAudioQueue(audio->queue);
+	}
+}
+
+Uint32 SDL_GetAudioUnderruns(void)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( !audio || !audio->queue ) {
+		return(0);
+	}
+	return(SDL_AudioQueueUnderruns(audio->queue));
+}
+
+void SDL_SetAudioCallbackFillsBuffer(int fills)
+{
+	callback_fills_buffer = (fills != 0);
+}
+
+void SDL_GetAudioPeriodStats(Uint32 *periods, Uint64 *total, Uint64 *worst)
+{
+	SDL_AudioDevice *audio = current_audio;
+	Uint32 n = 0;
+	Uint64 sum = 0, max = 0;
+
+	if ( audio ) {
+		SDL_AtomicLock(&audio->stats_lock);
+		n = audio->stats_periods;
+		sum = audio->stats_total;
+		max = audio->stats_worst;
+		SDL_AtomicUnlock(&audio->stats_lock);
+	}
+	if ( periods ) {
+		*periods = n;
+	}
+	if ( total ) {
+		*total = sum;
+	}
+	if ( worst ) {
+		*worst = max;
+	}
+}
+
+void SDL_ResetAudioPeriodStats(void)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( audio ) {
+		SDL_AtomicLock(&audio->stats_lock);
+		audio->stats_periods = 0;
+		audio->stats_total = 0;
+		audio->stats_worst = 0;
+		SDL_AtomicUnlock(&audio->stats_lock);
+	}
+}
+
 void SDL_LockAudio (void)
 {
 	SDL_AudioDevice *audio = current_audio;
@@ -647,10 +859,14 @@ void SDL_AudioQuit(void)
 		if ( audio->fake_stream != NULL ) {
 			SDL_FreeAudioMem(audio->fake_stream);
 		}
-		if ( audio->convert.needed ) {
+		if ( audio->convert.buf != NULL ) {
 			SDL_FreeAudioMem(audio->convert.buf);
-
 		}
+		if ( audio->convert_out.buf != NULL ) {
+			SDL_FreeAudioMem(audio->convert_out.buf);
+		}
+		SDL_FreeResampler(audio->resampler);
+		SDL_FreeAudioQueue(audio->queue);
 		if ( audio->opened ) {
 			audio->CloseAudio(audio);
 			audio->opened = 0;
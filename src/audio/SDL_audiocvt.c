@@ -24,6 +24,11 @@
 /* Functions for audio drivers to perform runtime conversion of audio format */
 
 #include "SDL_audio.h"
+#include "SDL_resample_c.h"
+#include "SDL_audiocvt_c.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_audiocvt_NEON.h"
+#include "SDL_audiocvt_SSE2.h"
 
 
 /* Effectively mix right and left channels into a single channel */
@@ -417,7 +422,7 @@ void SDLCALL SDL_ConvertSurround(SDL_AudioCVT *cvt, Uint16 format)
 
 			src = (Uint8 *)(cvt->buf+cvt->len_cvt);
 			dst = (Uint8 *)(cvt->buf+cvt->len_cvt*3);
-			for ( i=cvt->len_cvt; i; --i ) {
+			for ( i=cvt->len_cvt/2; i; --i ) {
 				dst -= 6;
 				src -= 2;
 				lf = src[0];
@@ -438,7 +443,7 @@ void SDLCALL SDL_ConvertSurround(SDL_AudioCVT *cvt, Uint16 format)
 
 			src = (Sint8 *)cvt->buf+cvt->len_cvt;
 			dst = (Sint8 *)cvt->buf+cvt->len_cvt*3;
-			for ( i=cvt->len_cvt; i; --i ) {
+			for ( i=cvt->len_cvt/2; i; --i ) {
 				dst -= 6;
 				src -= 2;
 				lf = src[0];
@@ -1300,6 +1305,56 @@ void SDLCALL SDL_RateSLOW(SDL_AudioCVT *cvt, Uint16 format)
 	}
 }
 
+/* Convert rate by any ratio with the windowed sinc resampler. The samples
+   are 16 bit native here, SDL_BuildAudioCVT converts to and from that
+   around this filter. The input is moved to the end of the buffer, which
+   SDL_BuildAudioCVT made room for, so the output can go at the start.
+ */
+static void SDL_RateSINC(SDL_AudioCVT *cvt, Uint16 format, int quality, int channels)
+{
+	const int frame_size = channels * sizeof(Sint16);
+	const int in_frames = cvt->len_cvt / frame_size;
+	Uint8 *src;
+
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting audio rate by %g with a sinc filter\n", 1.0/cvt->rate_incr);
+#endif
+	src = cvt->buf + (((cvt->len * cvt->len_mult) - in_frames * frame_size) & ~1);
+	SDL_memmove(src, cvt->buf, in_frames * frame_size);
+	cvt->len_cvt = SDL_ResampleBuffer(quality, channels, cvt->rate_incr,
+	                                  (Sint16 *)src, in_frames,
+	                                  (Sint16 *)cvt->buf) * frame_size;
+	if ( cvt->filters[++cvt->filter_index] ) {
+		cvt->filters[cvt->filter_index](cvt, format);
+	}
+}
+
+#define RATE_SINC(name, quality, channels) \
+static void SDLCALL name(SDL_AudioCVT *cvt, Uint16 format) \
+{ \
+	SDL_RateSINC(cvt, format, quality, channels); \
+}
+RATE_SINC(SDL_RateSINC_fast, SDL_RESAMPLE_FAST, 1)
+RATE_SINC(SDL_RateSINC_fast_c2, SDL_RESAMPLE_FAST, 2)
+RATE_SINC(SDL_RateSINC_fast_c4, SDL_RESAMPLE_FAST, 4)
+RATE_SINC(SDL_RateSINC_fast_c6, SDL_RESAMPLE_FAST, 6)
+RATE_SINC(SDL_RateSINC_medium, SDL_RESAMPLE_MEDIUM, 1)
+RATE_SINC(SDL_RateSINC_medium_c2, SDL_RESAMPLE_MEDIUM, 2)
+RATE_SINC(SDL_RateSINC_medium_c4, SDL_RESAMPLE_MEDIUM, 4)
+RATE_SINC(SDL_RateSINC_medium_c6, SDL_RESAMPLE_MEDIUM, 6)
+RATE_SINC(SDL_RateSINC_best, SDL_RESAMPLE_BEST, 1)
+RATE_SINC(SDL_RateSINC_best_c2, SDL_RESAMPLE_BEST, 2)
+RATE_SINC(SDL_RateSINC_best_c4, SDL_RESAMPLE_BEST, 4)
+RATE_SINC(SDL_RateSINC_best_c6, SDL_RESAMPLE_BEST, 6)
+#undef RATE_SINC
+
+/* Indexed by quality and by 1, 2, 4 or 6 channels */
+static void (SDLCALL *rate_sinc[SDL_RESAMPLE_QUALITIES][4])(SDL_AudioCVT *cvt, Uint16 format) = {
+	{ SDL_RateSINC_fast, SDL_RateSINC_fast_c2, SDL_RateSINC_fast_c4, SDL_RateSINC_fast_c6 },
+	{ SDL_RateSINC_medium, SDL_RateSINC_medium_c2, SDL_RateSINC_medium_c4, SDL_RateSINC_medium_c6 },
+	{ SDL_RateSINC_best, SDL_RateSINC_best_c2, SDL_RateSINC_best_c4, SDL_RateSINC_best_c6 },
+};
+
 int SDL_ConvertAudio(SDL_AudioCVT *cvt)
 {
 	/* Make sure there's data to convert */
@@ -1319,24 +1374,116 @@ int SDL_ConvertAudio(SDL_AudioCVT *cvt)
 	return(0);
 }
 
-/* Creates a set of audio filters to convert from one format to another. 
-   Returns -1 if the format conversion is not supported, or 1 if the
-   audio filter is set up.
-*/
-  
-int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
-	Uint16 src_format, Uint8 src_channels, int src_rate,
-	Uint16 dst_format, Uint8 dst_channels, int dst_rate)
+#if SDL_AUDIOCVT_NEON || SDL_AUDIOCVT_SSE2
+
+/* Takes the format the rest of a filter chain is given */
+static void SDLCALL SDL_KeepFormat(SDL_AudioCVT *cvt, Uint16 format)
 {
-/*printf("Build format %04x->%04x, channels %u->%u, rate %d->%d\n",
-		src_format, dst_format, src_channels, dst_channels, src_rate, dst_rate);*/
-	/* Start off with no conversion necessary */
-	cvt->needed = 0;
-	cvt->filter_index = 0;
-	cvt->filters[0] = NULL;
-	cvt->len_mult = 1;
-	cvt->len_ratio = 1.0;
+	cvt->src_format = format;
+}
+
+/* Runs a SIMD version of a filter, which converts whole blocks and leaves
+   the rest of the buffer to the C filter.  The output is 'mul' / 'div'
+   times as long as the input.
+ */
+static void SDL_ConvertSIMD(SDL_AudioCVT *cvt, Uint16 format,
+                            SDL_AudioFilter filter,
+                            Uint32 (*kernel)(Uint8 *buf, Uint32 len, Uint16 format),
+                            int mul, int div)
+{
+	const Uint32 len = (Uint32)cvt->len_cvt;
+	const Uint32 done = kernel(cvt->buf, len, format);
+	SDL_AudioCVT rest;
 
+	/* Longer output is made from the end down, shorter from the start */
+	if ( mul > div ) {
+		rest.buf = cvt->buf;
+	} else {
+		rest.buf = cvt->buf + done * mul / div;
+		if ( mul < div ) {
+			SDL_memmove(rest.buf, cvt->buf + done, len - done);
+		}
+	}
+	rest.len_cvt = (int)(len - done);
+	rest.src_format = format;
+	rest.filters[0] = filter;
+	rest.filters[1] = SDL_KeepFormat;
+	rest.filter_index = 0;
+	filter(&rest, format);
+
+	cvt->len_cvt = (int)(done * mul / div) + rest.len_cvt;
+	if ( cvt->filters[++cvt->filter_index] ) {
+		cvt->filters[cvt->filter_index](cvt, rest.src_format);
+	}
+}
+
+/* The filters with SIMD versions and how much longer they make the data */
+#define SIMD_FILTERS(isa) \
+	SIMD_FILTER(isa, ConvertSign, 1, 1) \
+	SIMD_FILTER(isa, Convert16LSB, 2, 1) \
+	SIMD_FILTER(isa, Convert16MSB, 2, 1) \
+	SIMD_FILTER(isa, ConvertStereo, 2, 1) \
+	SIMD_FILTER(isa, ConvertMono, 1, 2) \
+	SIMD_FILTER(isa, ConvertSurround, 3, 1) \
+	SIMD_FILTER(isa, ConvertStrip, 1, 3)
+
+#define SIMD_FILTER(isa, name, mul, div) \
+static void SDLCALL SDL_Filter##name##_##isa(SDL_AudioCVT *cvt, Uint16 format) \
+{ \
+	SDL_ConvertSIMD(cvt, format, SDL_##name, SDL_##name##_##isa, mul, div); \
+}
+#if SDL_AUDIOCVT_NEON
+SIMD_FILTERS(NEON)
+#endif
+#if SDL_AUDIOCVT_SSE2
+SIMD_FILTERS(SSE2)
+#endif
+#undef SIMD_FILTER
+
+#define SIMD_FILTER(isa, name, mul, div) \
+	if ( filter == SDL_##name ) { \
+		return(SDL_Filter##name##_##isa); \
+	}
+
+/* Returns the SIMD version of a filter for this CPU, or the filter */
+static SDL_AudioFilter SDL_GetSIMDFilter(SDL_AudioFilter filter)
+{
+#if SDL_AUDIOCVT_NEON
+	if ( SDL_HasARMNEON() ) {
+		SIMD_FILTERS(NEON)
+	}
+#endif
+#if SDL_AUDIOCVT_SSE2
+	if ( SDL_HasSSE2() ) {
+		SIMD_FILTERS(SSE2)
+	}
+#endif
+	return(filter);
+}
+#undef SIMD_FILTER
+
+/* The SIMD filters can be turned off with SDL_AUDIO_SIMD=0 */
+static int SDL_UseSIMDCVT(void)
+{
+	const char *env = SDL_getenv("SDL_AUDIO_SIMD");
+
+	return(!env || SDL_atoi(env) != 0);
+}
+
+#endif /* SDL_AUDIOCVT_NEON || SDL_AUDIOCVT_SSE2 */
+
+/* The fused filters can be turned off with SDL_AUDIO_FUSED=0 */
+static int SDL_UseFusedCVT(void)
+{
+	const char *env = SDL_getenv("SDL_AUDIO_FUSED");
+
+	return(!env || SDL_atoi(env) != 0);
+}
+
+/* Adds the filters that convert between sample formats */
+static void SDL_BuildFormatCVT(SDL_AudioCVT *cvt,
+	Uint16 src_format, Uint16 dst_format)
+{
 	/* First filter:  Endian conversion from src to dst */
 	if ( (src_format & 0x1000) != (dst_format & 0x1000)
 	     && ((src_format & 0xff) == 16) && ((dst_format & 0xff) == 16)) {
@@ -1370,6 +1517,32 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 				break;
 		}
 	}
+}
+
+/* Creates a set of audio filters to convert from one format to another. 
+   Returns -1 if the format conversion is not supported, or 1 if the
+   audio filter is set up.
+*/
+  
+int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
+	Uint16 src_format, Uint8 src_channels, int src_rate,
+	Uint16 dst_format, Uint8 dst_channels, int dst_rate)
+{
+	int resample, rate_index;
+	Uint8 channels = src_channels;
+
+/*printf("Build format %04x->%04x, channels %u->%u, rate %d->%d\n",
+		src_format, dst_format, src_channels, dst_channels, src_rate, dst_rate);*/
+	/* Start off with no conversion necessary */
+	cvt->needed = 0;
+	cvt->filter_index = 0;
+	cvt->filters[0] = NULL;
+	cvt->len_mult = 1;
+	cvt->len_ratio = 1.0;
+
+	/* The sinc filter takes 16 bit native samples */
+	resample = SDL_NeedsResampler(src_rate, dst_rate);
+	SDL_BuildFormatCVT(cvt, src_format, resample ? AUDIO_S16SYS : dst_format);
 
 	/* Last filter:  Mono/Stereo conversion */
 	if ( src_channels != dst_channels ) {
@@ -1435,7 +1608,27 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 
 	/* Do rate conversion */
 	cvt->rate_incr = 0.0;
-	if ( (src_rate/100) != (dst_rate/100) ) {
+	rate_index = cvt->filter_index;
+	if ( resample ) {
+		int index;
+
+		switch (src_channels) {
+			case 1: index = 0; break;
+			case 2: index = 1; break;
+			case 4: index = 2; break;
+			case 6: index = 3; break;
+			default: return -1;
+		}
+		cvt->filters[cvt->filter_index++] =
+				rate_sinc[SDL_GetResampleQuality()][index];
+		cvt->rate_incr = (double)src_rate/dst_rate;
+		/* The input moves up to make room for the output before it */
+		cvt->len_mult *= 1 + (dst_rate + src_rate - 1)/src_rate;
+		cvt->len_ratio /= cvt->rate_incr;
+
+		/* And back to the requested format */
+		SDL_BuildFormatCVT(cvt, AUDIO_S16SYS, dst_format);
+	} else if ( (src_rate/100) != (dst_rate/100) ) {
 		Uint32 hi_rate, lo_rate;
 		int len_mult;
 		double len_ratio;
@@ -1473,27 +1666,43 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 			lo_rate *= 2;
 			cvt->len_ratio *= len_ratio;
 		}
-		/* We may need a slow conversion here to finish up */
-		if ( (lo_rate/100) != (hi_rate/100) ) {
-#if 1
-			/* The problem with this is that if the input buffer is
-			   say 1K, and the conversion rate is say 1.1, then the
-			   output buffer is 1.1K, which may not be an acceptable
-			   buffer size for the audio driver (not a power of 2)
-			*/
-			/* For now, punt and hope the rate distortion isn't great.
-			*/
-#else
-			if ( src_rate < dst_rate ) {
-				cvt->rate_incr = (double)lo_rate/hi_rate;
-				cvt->len_mult *= 2;
-				cvt->len_ratio /= cvt->rate_incr;
-			} else {
-				cvt->rate_incr = (double)hi_rate/lo_rate;
-				cvt->len_ratio *= cvt->rate_incr;
-			}
-			cvt->filters[cvt->filter_index++] = SDL_RateSLOW;
+	}
+
+#if SDL_AUDIOCVT_NEON || SDL_AUDIOCVT_SSE2
+	/* Use the SIMD filters where the CPU has them, the fused filter falls
+	   back to them too
+	 */
+	if ( SDL_UseSIMDCVT() ) {
+		int i;
+
+		for ( i = 0; i < cvt->filter_index; ++i ) {
+			cvt->filters[i] = SDL_GetSIMDFilter(cvt->filters[i]);
+		}
+	}
 #endif
+
+	/* Do the whole chain in one pass when there's a fused filter for it,
+	   keeping the chain after it for the lengths it can't do.  Other
+	   channel counts are only fused when each sample is converted alone.
+	 */
+	if ( !resample && (cvt->filter_index > 1) &&
+	     (cvt->filter_index < (int)SDL_arraysize(cvt->filters)-1) &&
+	     SDL_UseFusedCVT() ) {
+		SDL_AudioFilter fused;
+		int i;
+
+		if ( (channels == dst_channels) && (rate_index == cvt->filter_index) ) {
+			fused = SDL_GetFusedFilter(src_format, 1, dst_format, 1);
+		} else {
+			fused = SDL_GetFusedFilter(src_format, channels,
+			                           dst_format, dst_channels);
+		}
+		if ( fused ) {
+			for ( i = cvt->filter_index; i > 0; --i ) {
+				cvt->filters[i] = cvt->filters[i-1];
+			}
+			cvt->filters[0] = fused;
+			++cvt->filter_index;
 		}
 	}
 
@@ -0,0 +1,324 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_audio.h"
+#include "SDL_audiocvt_NEON.h"
+
+#if SDL_AUDIOCVT_NEON
+
+/* NEON audio conversions.
+
+   The channels are split and interleaved with the structure loads and
+   stores, vld2/vld3 and vst2/vst3.  Mixing to mono has to divide like
+   the C code, which rounds toward zero for signed samples, while the
+   halving add rounds down: 1 is added back to negative averages of an
+   odd sum.  Big endian samples are swapped to do the arithmetic.
+*/
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#else
+#include "../cpuinfo/SDL_neon_emu.h"
+#endif
+
+#define IS_SIGNED(format)	((format) & 0x8000)
+#define IS_16BIT(format)	(((format) & 0xFF) == 16)
+#define IS_MSB(format)		((format) & 0x1000)
+
+static __inline__ uint16x8_t Swap16(uint16x8_t v)
+{
+	return vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(v)));
+}
+
+/* (a + b) / 2, rounded like the C code */
+static __inline__ uint8x16_t Average8(uint8x16_t a, uint8x16_t b, int sign)
+{
+	uint8x16_t h;
+
+	if ( !sign ) {
+		return vhaddq_u8(a, b);
+	}
+	h = vreinterpretq_u8_s8(vhaddq_s8(vreinterpretq_s8_u8(a),
+	                                  vreinterpretq_s8_u8(b)));
+	return vaddq_u8(h, vandq_u8(vshrq_n_u8(h, 7), veorq_u8(a, b)));
+}
+
+static __inline__ uint16x8_t Average16(uint16x8_t a, uint16x8_t b, int sign)
+{
+	uint16x8_t h;
+
+	if ( !sign ) {
+		return vhaddq_u16(a, b);
+	}
+	h = vreinterpretq_u16_s16(vhaddq_s16(vreinterpretq_s16_u16(a),
+	                                     vreinterpretq_s16_u16(b)));
+	return vaddq_u16(h, vandq_u16(vshrq_n_u16(h, 15), veorq_u16(a, b)));
+}
+
+/* x / 2, rounded like the C code */
+static __inline__ uint8x16_t Half8(uint8x16_t x, int sign)
+{
+	if ( !sign ) {
+		return vshrq_n_u8(x, 1);
+	}
+	x = vaddq_u8(x, vshrq_n_u8(x, 7));
+	return vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(x), 1));
+}
+
+static __inline__ uint16x8_t Half16(uint16x8_t x, int sign)
+{
+	if ( !sign ) {
+		return vshrq_n_u16(x, 1);
+	}
+	x = vaddq_u16(x, vshrq_n_u16(x, 15));
+	return vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(x), 1));
+}
+
+Uint32 SDL_ConvertSign_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	static const Uint8 lsb[16] = {
+		0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80
+	};
+	static const Uint8 msb[16] = {
+		0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0, 0x80, 0
+	};
+	uint8x16_t bits;
+	Uint32 i;
+
+	if ( !IS_16BIT(format) ) {
+		bits = vdupq_n_u8(0x80);
+	} else if ( IS_MSB(format) ) {
+		bits = vld1q_u8(msb);
+	} else {
+		bits = vld1q_u8(lsb);
+	}
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		vst1q_u8(buf + i, veorq_u8(vld1q_u8(buf + i), bits));
+	}
+	return len;
+}
+
+/* Each byte becomes the high byte of a 16 bit sample */
+Uint32 SDL_Convert16LSB_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = len & ~15;
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 2;
+	uint8x16x2_t v;
+	Uint32 i;
+
+	v.val[0] = vdupq_n_u8(0);
+	for ( i = done / 16; i; --i ) {
+		src -= 16;
+		dst -= 32;
+		v.val[1] = vld1q_u8(src);
+		vst2q_u8(dst, v);
+	}
+	return done;
+}
+
+Uint32 SDL_Convert16MSB_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = len & ~15;
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 2;
+	uint8x16x2_t v;
+	Uint32 i;
+
+	v.val[1] = vdupq_n_u8(0);
+	for ( i = done / 16; i; --i ) {
+		src -= 16;
+		dst -= 32;
+		v.val[0] = vld1q_u8(src);
+		vst2q_u8(dst, v);
+	}
+	return done;
+}
+
+Uint32 SDL_ConvertStereo_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = len & ~15;
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 2;
+	Uint32 i;
+
+	if ( IS_16BIT(format) ) {
+		uint16x8x2_t v;
+
+		if ( len & 1 ) {
+			return 0;
+		}
+		for ( i = done / 16; i; --i ) {
+			src -= 16;
+			dst -= 32;
+			v.val[0] = vld1q_u16((const Uint16 *)src);
+			v.val[1] = v.val[0];
+			vst2q_u16((Uint16 *)dst, v);
+		}
+	} else {
+		uint8x16x2_t v;
+
+		for ( i = done / 16; i; --i ) {
+			src -= 16;
+			dst -= 32;
+			v.val[0] = vld1q_u8(src);
+			v.val[1] = v.val[0];
+			vst2q_u8(dst, v);
+		}
+	}
+	return done;
+}
+
+Uint32 SDL_ConvertMono_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const int sign = IS_SIGNED(format);
+	const Uint32 done = len & ~31;
+	Uint8 *src = buf;
+	Uint8 *dst = buf;
+	Uint32 i;
+
+	if ( IS_16BIT(format) ) {
+		const int swap = IS_MSB(format);
+		uint16x8x2_t v;
+		uint16x8_t m;
+
+		for ( i = done / 32; i; --i ) {
+			v = vld2q_u16((const Uint16 *)src);
+			if ( swap ) {
+				m = Swap16(Average16(Swap16(v.val[0]), Swap16(v.val[1]), sign));
+			} else {
+				m = Average16(v.val[0], v.val[1], sign);
+			}
+			vst1q_u16((Uint16 *)dst, m);
+			src += 32;
+			dst += 16;
+		}
+	} else {
+		uint8x16x2_t v;
+
+		for ( i = done / 32; i; --i ) {
+			v = vld2q_u8(src);
+			vst1q_u8(dst, Average8(v.val[0], v.val[1], sign));
+			src += 32;
+			dst += 16;
+		}
+	}
+	return done;
+}
+
+/* Left and right, the rear channels and the center, which goes to the
+   front center and the subwoofer.  The C code puts left minus center in
+   the rear left channel for 8 bit samples and in the rear right one for
+   16 bit samples, and so does this.
+ */
+Uint32 SDL_ConvertSurround_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const int sign = IS_SIGNED(format);
+	const Uint32 done = len & ~31;
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 3;
+	Uint32 i;
+
+	if ( IS_16BIT(format) ) {
+		const int swap = IS_MSB(format);
+		uint16x8x2_t v, rear, center;
+		uint32x4x3_t lo, hi;
+		uint16x8_t lf, rf, ce;
+
+		if ( len & 1 ) {
+			return 0;
+		}
+		for ( i = done / 32; i; --i ) {
+			src -= 32;
+			dst -= 96;
+			v = vld2q_u16((const Uint16 *)src);
+			lo.val[0] = vreinterpretq_u32_u8(vld1q_u8(src));
+			hi.val[0] = vreinterpretq_u32_u8(vld1q_u8(src + 16));
+			lf = swap ? Swap16(v.val[0]) : v.val[0];
+			rf = swap ? Swap16(v.val[1]) : v.val[1];
+			ce = vaddq_u16(Half16(lf, sign), Half16(rf, sign));
+			rf = vsubq_u16(rf, ce);
+			lf = vsubq_u16(lf, ce);
+			if ( swap ) {
+				rf = Swap16(rf);
+				lf = Swap16(lf);
+				ce = Swap16(ce);
+			}
+			rear = vzipq_u16(rf, lf);
+			center = vzipq_u16(ce, ce);
+			lo.val[1] = vreinterpretq_u32_u16(rear.val[0]);
+			lo.val[2] = vreinterpretq_u32_u16(center.val[0]);
+			hi.val[1] = vreinterpretq_u32_u16(rear.val[1]);
+			hi.val[2] = vreinterpretq_u32_u16(center.val[1]);
+			vst3q_u32((Uint32 *)dst, lo);
+			vst3q_u32((Uint32 *)(dst + 48), hi);
+		}
+	} else {
+		uint8x16x2_t v, rear, center;
+		uint16x8x3_t lo, hi;
+		uint8x16_t ce;
+
+		for ( i = done / 32; i; --i ) {
+			src -= 32;
+			dst -= 96;
+			v = vld2q_u8(src);
+			lo.val[0] = vreinterpretq_u16_u8(vld1q_u8(src));
+			hi.val[0] = vreinterpretq_u16_u8(vld1q_u8(src + 16));
+			ce = vaddq_u8(Half8(v.val[0], sign), Half8(v.val[1], sign));
+			rear = vzipq_u8(vsubq_u8(v.val[0], ce), vsubq_u8(v.val[1], ce));
+			center = vzipq_u8(ce, ce);
+			lo.val[1] = vreinterpretq_u16_u8(rear.val[0]);
+			lo.val[2] = vreinterpretq_u16_u8(center.val[0]);
+			hi.val[1] = vreinterpretq_u16_u8(rear.val[1]);
+			hi.val[2] = vreinterpretq_u16_u8(center.val[1]);
+			vst3q_u16((Uint16 *)dst, lo);
+			vst3q_u16((Uint16 *)(dst + 48), hi);
+		}
+	}
+	return done;
+}
+
+/* The front left and right channels are the first 2 or 4 bytes of each
+   6 channel frame, which the 3 way loads pick out of every 6 or 12
+ */
+Uint32 SDL_ConvertStrip_NEON(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = (len / 48) * 48;
+	Uint8 *src = buf;
+	Uint8 *dst = buf;
+	Uint32 i;
+
+	for ( i = done / 48; i; --i ) {
+		if ( IS_16BIT(format) ) {
+			vst1q_u8(dst, vreinterpretq_u8_u32(vld3q_u32((const Uint32 *)src).val[0]));
+		} else {
+			vst1q_u8(dst, vreinterpretq_u8_u16(vld3q_u16((const Uint16 *)src).val[0]));
+		}
+		src += 48;
+		dst += 16;
+	}
+	return done;
+}
+
+#endif /* SDL_AUDIOCVT_NEON */
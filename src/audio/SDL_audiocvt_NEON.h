@@ -0,0 +1,50 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* NEON versions of the audio conversion filters, see SDL_audiocvt_NEON.c */
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SDL_AUDIOCVT_NEON	1
+#elif SDL_ARM_NEON_EMULATION
+/* Built with the portable stand-ins of SDL_neon_emu.h, for testing */
+#define SDL_AUDIOCVT_NEON	1
+#endif
+
+#if SDL_AUDIOCVT_NEON
+
+/* Each function converts the buffer in place in blocks of 16 to 48 bytes
+   and returns the number of source bytes it converted, the C filter of
+   the same name does the rest.  The ones that make the data longer do the
+   last blocks of the buffer and the others the first ones, so the rest is
+   where the C filter expects it.  The output matches the C filters, and
+   formats a function doesn't handle are left to them by returning 0.
+ */
+extern Uint32 SDL_ConvertSign_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_Convert16LSB_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_Convert16MSB_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertStereo_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertMono_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertSurround_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertStrip_NEON(Uint8 *buf, Uint32 len, Uint16 format);
+
+#endif /* SDL_AUDIOCVT_NEON */
@@ -0,0 +1,313 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_audio.h"
+#include "SDL_audiocvt_SSE2.h"
+
+#if SDL_AUDIOCVT_SSE2
+
+/* SSE2 audio conversions, the same arithmetic as SDL_audiocvt_NEON.c.
+   SSE2 has no structure loads, so the channels are split with shifts
+   within 16 or 32 bit lanes and joined with unpacks and shuffles.  The
+   8 bit 5.1 conversions need byte shuffles SSE2 doesn't have and are
+   left to the C code.
+*/
+
+#include <emmintrin.h>
+
+#define IS_SIGNED(format)	((format) & 0x8000)
+#define IS_16BIT(format)	(((format) & 0xFF) == 16)
+#define IS_MSB(format)		((format) & 0x1000)
+
+static __inline__ __m128i Swap16(__m128i v)
+{
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+/* The first and second sample of each pair of 16 bit lanes, in 32 bit
+   lanes and with the sign extended if they are signed
+ */
+static __inline__ __m128i First16(__m128i v, int sign)
+{
+	if ( sign ) {
+		return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+	}
+	return _mm_and_si128(v, _mm_set1_epi32(0xFFFF));
+}
+
+static __inline__ __m128i Second16(__m128i v, int sign)
+{
+	return sign ? _mm_srai_epi32(v, 16) : _mm_srli_epi32(v, 16);
+}
+
+/* x / 2 for 16 bit lanes, rounded like the C code */
+static __inline__ __m128i Half16(__m128i x, int sign)
+{
+	if ( !sign ) {
+		return _mm_srli_epi16(x, 1);
+	}
+	return _mm_srai_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 15)), 1);
+}
+
+Uint32 SDL_ConvertSign_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	__m128i bits;
+	Uint32 i;
+
+	if ( !IS_16BIT(format) ) {
+		bits = _mm_set1_epi8((char)0x80);
+	} else if ( IS_MSB(format) ) {
+		bits = _mm_set1_epi16(0x0080);
+	} else {
+		bits = _mm_set1_epi16((short)0x8000);
+	}
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+
+		_mm_storeu_si128((__m128i *)(buf + i), _mm_xor_si128(v, bits));
+	}
+	return len;
+}
+
+/* Each byte becomes the high byte of a 16 bit sample */
+Uint32 SDL_Convert16LSB_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = len & ~15;
+	const __m128i zero = _mm_setzero_si128();
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 2;
+	Uint32 i;
+
+	for ( i = done / 16; i; --i ) {
+		__m128i v;
+
+		src -= 16;
+		dst -= 32;
+		v = _mm_loadu_si128((const __m128i *)src);
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(zero, v));
+		_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(zero, v));
+	}
+	return done;
+}
+
+Uint32 SDL_Convert16MSB_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = len & ~15;
+	const __m128i zero = _mm_setzero_si128();
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 2;
+	Uint32 i;
+
+	for ( i = done / 16; i; --i ) {
+		__m128i v;
+
+		src -= 16;
+		dst -= 32;
+		v = _mm_loadu_si128((const __m128i *)src);
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(v, zero));
+		_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(v, zero));
+	}
+	return done;
+}
+
+Uint32 SDL_ConvertStereo_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = len & ~15;
+	const int wide = IS_16BIT(format);
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 2;
+	Uint32 i;
+
+	for ( i = done / 16; i; --i ) {
+		__m128i v;
+
+		src -= 16;
+		dst -= 32;
+		v = _mm_loadu_si128((const __m128i *)src);
+		if ( wide ) {
+			_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(v, v));
+			_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(v, v));
+		} else {
+			_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(v, v));
+			_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(v, v));
+		}
+	}
+	return done;
+}
+
+/* The sums are made in lanes twice as wide as the samples and divided
+   like the C code, which rounds toward zero for signed samples.  There's
+   no unsigned 32 to 16 bit pack in SSE2, so unsigned 16 bit averages are
+   moved into the signed range and back around the signed one.
+ */
+Uint32 SDL_ConvertMono_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const int sign = IS_SIGNED(format);
+	const Uint32 done = len & ~31;
+	Uint8 *src = buf;
+	Uint8 *dst = buf;
+	__m128i v[2], m[2];
+	Uint32 i;
+	int j;
+
+	for ( i = done / 32; i; --i ) {
+		v[0] = _mm_loadu_si128((const __m128i *)src);
+		v[1] = _mm_loadu_si128((const __m128i *)(src + 16));
+		if ( IS_16BIT(format) ) {
+			const __m128i bias = _mm_set1_epi32(0x8000);
+
+			for ( j = 0; j < 2; ++j ) {
+				if ( IS_MSB(format) ) {
+					v[j] = Swap16(v[j]);
+				}
+				m[j] = _mm_add_epi32(First16(v[j], sign), Second16(v[j], sign));
+				if ( sign ) {
+					m[j] = _mm_add_epi32(m[j], _mm_srli_epi32(m[j], 31));
+					m[j] = _mm_srai_epi32(m[j], 1);
+				} else {
+					m[j] = _mm_sub_epi32(_mm_srli_epi32(m[j], 1), bias);
+				}
+			}
+			m[0] = _mm_packs_epi32(m[0], m[1]);
+			if ( !sign ) {
+				m[0] = _mm_xor_si128(m[0], _mm_set1_epi16((short)0x8000));
+			}
+			if ( IS_MSB(format) ) {
+				m[0] = Swap16(m[0]);
+			}
+		} else {
+			for ( j = 0; j < 2; ++j ) {
+				if ( sign ) {
+					m[j] = _mm_add_epi16(_mm_srai_epi16(_mm_slli_epi16(v[j], 8), 8),
+					                     _mm_srai_epi16(v[j], 8));
+					m[j] = _mm_add_epi16(m[j], _mm_srli_epi16(m[j], 15));
+					m[j] = _mm_srai_epi16(m[j], 1);
+				} else {
+					m[j] = _mm_add_epi16(_mm_and_si128(v[j], _mm_set1_epi16(0xFF)),
+					                     _mm_srli_epi16(v[j], 8));
+					m[j] = _mm_srli_epi16(m[j], 1);
+				}
+			}
+			if ( sign ) {
+				m[0] = _mm_packs_epi16(m[0], m[1]);
+			} else {
+				m[0] = _mm_packus_epi16(m[0], m[1]);
+			}
+		}
+		_mm_storeu_si128((__m128i *)dst, m[0]);
+		src += 32;
+		dst += 16;
+	}
+	return done;
+}
+
+/* Picks dwords a[i], a[j], b[k], b[l] */
+#define SHUFFLE32(a, b, i, j, k, l) \
+	_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), \
+	                                _MM_SHUFFLE(l, k, j, i)))
+
+/* Interleaves the dwords of a, b and c like vst3q_u32 */
+static __inline__ void Store3x32(Uint8 *dst, __m128i a, __m128i b, __m128i c)
+{
+	const __m128i ab_lo = _mm_unpacklo_epi32(a, b);	/* a0 b0 a1 b1 */
+	const __m128i ab_hi = _mm_unpackhi_epi32(a, b);	/* a2 b2 a3 b3 */
+	const __m128i bc_lo = _mm_unpacklo_epi32(b, c);	/* b0 c0 b1 c1 */
+	const __m128i bc_hi = _mm_unpackhi_epi32(b, c);	/* b2 c2 b3 c3 */
+	const __m128i ca_lo = _mm_unpacklo_epi32(c, a);	/* c0 a0 c1 a1 */
+	const __m128i ca_hi = _mm_unpackhi_epi32(c, a);	/* c2 a2 c3 a3 */
+
+	_mm_storeu_si128((__m128i *)dst, SHUFFLE32(ab_lo, ca_lo, 0, 1, 0, 3));
+	_mm_storeu_si128((__m128i *)(dst + 16), SHUFFLE32(bc_lo, ab_hi, 2, 3, 0, 1));
+	_mm_storeu_si128((__m128i *)(dst + 32), SHUFFLE32(ca_hi, bc_hi, 0, 3, 2, 3));
+}
+
+/* 16 bit samples only, see SDL_ConvertSurround_NEON() for the channels */
+Uint32 SDL_ConvertSurround_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const int sign = IS_SIGNED(format);
+	const int swap = IS_MSB(format);
+	const Uint32 done = len & ~31;
+	Uint8 *src = buf + len;
+	Uint8 *dst = buf + len * 3;
+	__m128i v0, v1, s0, s1, lf, rf, ce, rear[2], center[2];
+	Uint32 i;
+
+	if ( !IS_16BIT(format) ) {
+		return 0;
+	}
+	for ( i = done / 32; i; --i ) {
+		src -= 32;
+		dst -= 96;
+		v0 = _mm_loadu_si128((const __m128i *)src);
+		v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+		s0 = swap ? Swap16(v0) : v0;
+		s1 = swap ? Swap16(v1) : v1;
+		/* Sign extended, so the pack keeps unsigned samples too */
+		lf = _mm_packs_epi32(First16(s0, 1), First16(s1, 1));
+		rf = _mm_packs_epi32(Second16(s0, 1), Second16(s1, 1));
+		ce = _mm_add_epi16(Half16(lf, sign), Half16(rf, sign));
+		rf = _mm_sub_epi16(rf, ce);
+		lf = _mm_sub_epi16(lf, ce);
+		if ( swap ) {
+			rf = Swap16(rf);
+			lf = Swap16(lf);
+			ce = Swap16(ce);
+		}
+		rear[0] = _mm_unpacklo_epi16(rf, lf);
+		rear[1] = _mm_unpackhi_epi16(rf, lf);
+		center[0] = _mm_unpacklo_epi16(ce, ce);
+		center[1] = _mm_unpackhi_epi16(ce, ce);
+		Store3x32(dst, v0, rear[0], center[0]);
+		Store3x32(dst + 48, v1, rear[1], center[1]);
+	}
+	return done;
+}
+
+/* 16 bit samples only, the front left and right samples are the first
+   dword of every three
+ */
+Uint32 SDL_ConvertStrip_SSE2(Uint8 *buf, Uint32 len, Uint16 format)
+{
+	const Uint32 done = (len / 48) * 48;
+	Uint8 *src = buf;
+	Uint8 *dst = buf;
+	__m128i v0, v1, v2;
+	Uint32 i;
+
+	if ( !IS_16BIT(format) ) {
+		return 0;
+	}
+	for ( i = done / 48; i; --i ) {
+		v0 = _mm_loadu_si128((const __m128i *)src);		/* d0 - d3 */
+		v1 = _mm_loadu_si128((const __m128i *)(src + 16));	/* d4 - d7 */
+		v2 = _mm_loadu_si128((const __m128i *)(src + 32));	/* d8 - d11 */
+		v1 = SHUFFLE32(v1, v2, 2, 2, 1, 1);			/* d6 d6 d9 d9 */
+		_mm_storeu_si128((__m128i *)dst, SHUFFLE32(v0, v1, 0, 3, 0, 2));
+		src += 48;
+		dst += 16;
+	}
+	return done;
+}
+
+#endif /* SDL_AUDIOCVT_SSE2 */
@@ -0,0 +1,43 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* SSE2 versions of the audio conversion filters, see SDL_audiocvt_SSE2.c */
+
+#if SDL_ASSEMBLY_ROUTINES && \
+    ((defined(__GNUC__) && defined(__SSE2__)) || \
+     (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+#define SDL_AUDIOCVT_SSE2	1
+#endif
+
+#if SDL_AUDIOCVT_SSE2
+
+/* Same contract as the NEON functions in SDL_audiocvt_NEON.h */
+extern Uint32 SDL_ConvertSign_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_Convert16LSB_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_Convert16MSB_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertStereo_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertMono_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertSurround_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+extern Uint32 SDL_ConvertStrip_SSE2(Uint8 *buf, Uint32 len, Uint16 format);
+
+#endif /* SDL_AUDIOCVT_SSE2 */
@@ -0,0 +1,42 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_audiocvt_c_h
+#define _SDL_audiocvt_c_h
+
+#include "SDL_audio.h"
+
+/* The type of the functions in SDL_AudioCVT.filters */
+typedef void (SDLCALL *SDL_AudioFilter)(SDL_AudioCVT *cvt, Uint16 format);
+
+/* Returns a filter that does the whole conversion in one pass over the
+   buffer, or NULL if there's none for these channels.  It handles sample
+   format changes, mono to stereo or stereo to mono, and a rate change by
+   a power of two, with the same results as the filter chain.  It goes
+   first in the chain, and passes the buffer on to the rest of the chain
+   when the length isn't a whole number of the frames it works on.
+ */
+extern SDL_AudioFilter SDL_GetFusedFilter(Uint16 src_format, int src_channels,
+                                          Uint16 dst_format, int dst_channels);
+
+#endif /* _SDL_audiocvt_c_h */
@@ -0,0 +1,248 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Audio conversions in one pass, instead of a pass per filter */
+
+#include "SDL_audio.h"
+#include "SDL_audiocvt_c.h"
+
+/* The samples are read as the raw bits of the source format, with the
+   sign bit flipped if the signedness changes, then moved to the width of
+   the destination.  That's what the endian, sign and 8/16 bit filters do.
+   Mixing to mono reads them as signed or unsigned numbers like
+   SDL_ConvertMono() does, and the rate filters repeat or drop frames.
+
+   The bytes are put together one by one, which compilers turn into loads
+   and swaps they can vectorize, where SDL_Swap16() can be inline assembly.
+ */
+#define READ_8(p)	((Uint32)(p)[0])
+#define READ_LSB(p)	((Uint32)(p)[0] | ((Uint32)(p)[1] << 8))
+#define READ_MSB(p)	(((Uint32)(p)[0] << 8) | (Uint32)(p)[1])
+
+#define WRITE_8(p, v)	((p)[0] = (Uint8)(v))
+#define WRITE_LSB(p, v)	((p)[0] = (Uint8)(v), (p)[1] = (Uint8)((v) >> 8))
+#define WRITE_MSB(p, v)	((p)[0] = (Uint8)((v) >> 8), (p)[1] = (Uint8)(v))
+
+#define WIDTH_8		1
+#define WIDTH_LSB	2
+#define WIDTH_MSB	2
+
+#define RESIZE(v, src, dst) \
+	((WIDTH_##dst > WIDTH_##src) ? ((v) << 8) : \
+	 (WIDTH_##dst < WIDTH_##src) ? ((v) >> 8) : (v))
+
+#define SAMPLE(p, src, dst) RESIZE(READ_##src(p) ^ flip, src, dst)
+
+#define SIGNED(v)	((int)((v) ^ bias) - (int)bias)
+
+/* Reads the frame at 's' into 'a' and 'b' */
+#define READ_1_1(s, src, dst) \
+	a = SAMPLE(s, src, dst);
+#define READ_2_2(s, src, dst) \
+	a = SAMPLE(s, src, dst); \
+	b = SAMPLE(s + WIDTH_##src, src, dst);
+#define READ_1_2(s, src, dst) \
+	READ_1_1(s, src, dst)
+#define READ_2_1(s, src, dst) \
+	READ_2_2(s, src, dst) \
+	a = (Uint32)((SIGNED(a) + SIGNED(b)) / 2);
+
+/* Writes 'a' and 'b' as a frame at 'd' */
+#define WRITE_1_1(d, dst) \
+	WRITE_##dst(d, a);
+#define WRITE_2_2(d, dst) \
+	WRITE_##dst(d, a); \
+	WRITE_##dst(d + WIDTH_##dst, b);
+#define WRITE_1_2(d, dst) \
+	WRITE_##dst(d, a); \
+	WRITE_##dst(d + WIDTH_##dst, a);
+#define WRITE_2_1(d, dst) \
+	WRITE_1_1(d, dst)
+
+/* Converts 'units' frames, each into 'reps' frames or taking one out of
+   every few.  The output goes after the input when it's longer, so then
+   the frames are converted from the end down.
+ */
+#define CONVERT_LOOP(src, dst, sc, dc, in_step, out_step, reps) \
+	if ( (out_step) > (in_step) ) { \
+		s = cvt->buf + units * (in_step); \
+		d = cvt->buf + units * (out_step); \
+		for ( u = units; u; --u ) { \
+			s -= (in_step); \
+			d -= (out_step); \
+			READ_##sc##_##dc(s, src, dst) \
+			for ( r = 0; r < (reps); ++r ) { \
+				WRITE_##sc##_##dc(d + r * WIDTH_##dst * dc, dst) \
+			} \
+		} \
+	} else { \
+		s = cvt->buf; \
+		d = cvt->buf; \
+		for ( u = units; u; --u ) { \
+			READ_##sc##_##dc(s, src, dst) \
+			for ( r = 0; r < (reps); ++r ) { \
+				WRITE_##sc##_##dc(d + r * WIDTH_##dst * dc, dst) \
+			} \
+			s += (in_step); \
+			d += (out_step); \
+		} \
+	}
+
+/* The fused filters are in the first slot, followed by the filter chain
+   for the lengths they can't do.  The steps are constants without a rate
+   change, which is the case that matters when opening the audio, and for
+   doubling or halving it.
+ */
+#define FUSED_FILTER(src, dst, sc, dc) \
+static void SDLCALL SDL_Fused_##src##_##dst##_##sc##_##dc(SDL_AudioCVT *cvt, \
+                                                          Uint16 format) \
+{ \
+	int in_step, out_step, reps, units, u, r; \
+	Uint32 flip, bias, a, b = 0; \
+	Uint8 *s, *d; \
+ \
+	units = SDL_SetupFused(cvt, WIDTH_##src * sc, WIDTH_##dst * dc, \
+	                       &in_step, &out_step, &reps, &flip, &bias); \
+	if ( units < 0 ) { \
+		if ( cvt->filters[++cvt->filter_index] ) { \
+			cvt->filters[cvt->filter_index](cvt, format); \
+		} \
+		return; \
+	} \
+	if ( reps == 1 && in_step == WIDTH_##src * sc ) { \
+		CONVERT_LOOP(src, dst, sc, dc, WIDTH_##src * sc, \
+		             WIDTH_##dst * dc, 1) \
+	} else if ( reps == 2 && in_step == WIDTH_##src * sc ) { \
+		CONVERT_LOOP(src, dst, sc, dc, WIDTH_##src * sc, \
+		             WIDTH_##dst * dc * 2, 2) \
+	} else if ( reps == 1 && in_step == WIDTH_##src * sc * 2 ) { \
+		CONVERT_LOOP(src, dst, sc, dc, WIDTH_##src * sc * 2, \
+		             WIDTH_##dst * dc, 1) \
+	} else { \
+		CONVERT_LOOP(src, dst, sc, dc, in_step, out_step, reps) \
+	} \
+	(void)b; \
+	cvt->len_cvt = units * out_step; \
+}
+
+/* Works out the steps through the buffer for a frame of 'in_frame' bytes
+   becoming 'out_frame' bytes.  The rate change is what's left of the
+   length ratio.  Returns the number of steps, or -1 if the length isn't
+   a whole number of them.
+ */
+static int SDL_SetupFused(SDL_AudioCVT *cvt, int in_frame, int out_frame,
+                          int *in_step, int *out_step, int *reps,
+                          Uint32 *flip, Uint32 *bias)
+{
+	const Uint16 src_format = cvt->src_format;
+	const Uint16 dst_format = cvt->dst_format;
+	double rate = cvt->len_ratio * in_frame / out_frame;
+
+	*in_step = in_frame;
+	*reps = 1;
+	while ( rate > 1.5 ) {
+		*reps *= 2;
+		rate /= 2;
+	}
+	while ( rate < 0.75 ) {
+		*in_step *= 2;
+		rate *= 2;
+	}
+	*out_step = out_frame * *reps;
+	if ( (cvt->len_cvt % *in_step) != 0 ) {
+		return(-1);
+	}
+
+	*flip = 0;
+	if ( (src_format ^ dst_format) & 0x8000 ) {
+		*flip = ((src_format & 0xFF) == 16) ? 0x8000 : 0x80;
+	}
+	/* SDL_Convert8() passes the rest of the chain an unsigned format, so
+	   16 bit samples are mixed down to 8 bits as unsigned numbers.
+	 */
+	*bias = 0;
+	if ( dst_format & 0x8000 ) {
+		if ( (dst_format & 0xFF) == 16 ) {
+			*bias = 0x8000;
+		} else if ( (src_format & 0xFF) == 8 ) {
+			*bias = 0x80;
+		}
+	}
+	return(cvt->len_cvt / *in_step);
+}
+
+#define FUSED_CHANNELS(src, dst) \
+	FUSED_FILTER(src, dst, 1, 1) \
+	FUSED_FILTER(src, dst, 2, 2) \
+	FUSED_FILTER(src, dst, 1, 2) \
+	FUSED_FILTER(src, dst, 2, 1)
+
+#define FUSED_FORMATS(src) \
+	FUSED_CHANNELS(src, 8) \
+	FUSED_CHANNELS(src, LSB) \
+	FUSED_CHANNELS(src, MSB)
+
+FUSED_FORMATS(8)
+FUSED_FORMATS(LSB)
+FUSED_FORMATS(MSB)
+
+#define FUSED_ENTRY(src, dst) { \
+	SDL_Fused_##src##_##dst##_1_1, SDL_Fused_##src##_##dst##_2_2, \
+	SDL_Fused_##src##_##dst##_1_2, SDL_Fused_##src##_##dst##_2_1 \
+}
+
+/* By source layout, destination layout and channels */
+static const SDL_AudioFilter fused_filters[3][3][4] = {
+	{ FUSED_ENTRY(8, 8), FUSED_ENTRY(8, LSB), FUSED_ENTRY(8, MSB) },
+	{ FUSED_ENTRY(LSB, 8), FUSED_ENTRY(LSB, LSB), FUSED_ENTRY(LSB, MSB) },
+	{ FUSED_ENTRY(MSB, 8), FUSED_ENTRY(MSB, LSB), FUSED_ENTRY(MSB, MSB) },
+};
+
+static int SDL_FusedLayout(Uint16 format)
+{
+	if ( (format & 0xFF) == 8 ) {
+		return(0);
+	}
+	return((format & 0x1000) ? 2 : 1);
+}
+
+SDL_AudioFilter SDL_GetFusedFilter(Uint16 src_format, int src_channels,
+                                   Uint16 dst_format, int dst_channels)
+{
+	int channels;
+
+	if ( src_channels == dst_channels ) {
+		if ( src_channels > 2 ) {
+			return(NULL);
+		}
+		channels = src_channels - 1;
+	} else if ( src_channels == 1 && dst_channels == 2 ) {
+		channels = 2;
+	} else if ( src_channels == 2 && dst_channels == 1 ) {
+		channels = 3;
+	} else {
+		return(NULL);
+	}
+	return(fused_filters[SDL_FusedLayout(src_format)]
+	                    [SDL_FusedLayout(dst_format)][channels]);
+}
@@ -0,0 +1,263 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* The queue behind SDL_QueueAudio() */
+
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_audioqueue_c.h"
+
+#define SDL_AUDIO_CHUNK	4096
+
+typedef struct SDL_AudioChunk {
+	struct SDL_AudioChunk *next;
+	Uint8 data[SDL_AUDIO_CHUNK];
+} SDL_AudioChunk;
+
+/* The byte counts only grow, wrapping around at 4 GB, and the differences
+   between them are the amounts queued. The data up to 'written' is in the
+   chunks from 'head' to 'tail', linked before the count is raised.
+ */
+struct SDL_AudioQueue {
+	/* Taken by the audio thread */
+	SDL_AudioChunk *head;
+	Uint32 head_pos;
+	Uint32 read_pos;
+	int primed;
+
+	/* Filled under the lock, a mutex because copying and allocating can
+	   take long */
+	SDL_mutex *lock;
+	SDL_AudioChunk *tail;
+	Uint32 tail_pos;
+
+	/* Shared between them */
+	SDL_atomic_t written;
+	SDL_atomic_t read;
+	SDL_atomic_t cleared;
+	SDL_atomic_t underruns;
+	void *free_chunks;
+
+	Uint8 silence;
+};
+
+static SDL_AudioChunk *SDL_NewAudioChunk(SDL_AudioQueue *queue)
+{
+	SDL_AudioChunk *chunk;
+
+	/* Only one thread takes chunks off the free list at a time, so the
+	   top one can't be taken and put back while this one looks at it.
+	 */
+	do {
+		chunk = (SDL_AudioChunk *)SDL_AtomicGetPtr(&queue->free_chunks);
+	} while ( chunk &&
+	          !SDL_AtomicCASPtr(&queue->free_chunks, chunk, chunk->next) );
+	if ( chunk == NULL ) {
+		chunk = (SDL_AudioChunk *)SDL_malloc(sizeof(*chunk));
+		if ( chunk == NULL ) {
+			SDL_OutOfMemory();
+			return(NULL);
+		}
+	}
+	chunk->next = NULL;
+	return(chunk);
+}
+
+static void SDL_FreeAudioChunk(SDL_AudioQueue *queue, SDL_AudioChunk *chunk)
+{
+	void *top;
+
+	do {
+		top = SDL_AtomicGetPtr(&queue->free_chunks);
+		chunk->next = (SDL_AudioChunk *)top;
+	} while ( !SDL_AtomicCASPtr(&queue->free_chunks, top, chunk) );
+}
+
+SDL_AudioQueue *SDL_NewAudioQueue(Uint8 silence)
+{
+	SDL_AudioQueue *queue;
+
+	queue = (SDL_AudioQueue *)SDL_malloc(sizeof(*queue));
+	if ( queue == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(queue, 0, sizeof(*queue));
+	queue->silence = silence;
+	queue->head = SDL_NewAudioChunk(queue);
+	if ( queue->head == NULL ) {
+		SDL_free(queue);
+		return(NULL);
+	}
+	queue->tail = queue->head;
+	queue->lock = SDL_CreateMutex();
+	if ( queue->lock == NULL ) {
+		SDL_free(queue->head);
+		SDL_free(queue);
+		return(NULL);
+	}
+	return(queue);
+}
+
+void SDL_FreeAudioQueue(SDL_AudioQueue *queue)
+{
+	SDL_AudioChunk *chunk, *next;
+
+	if ( queue == NULL ) {
+		return;
+	}
+	for ( chunk = queue->head; chunk; chunk = next ) {
+		next = chunk->next;
+		SDL_free(chunk);
+	}
+	for ( chunk = (SDL_AudioChunk *)queue->free_chunks; chunk; chunk = next ) {
+		next = chunk->next;
+		SDL_free(chunk);
+	}
+	SDL_DestroyMutex(queue->lock);
+	SDL_free(queue);
+}
+
+int SDL_PutAudioQueue(SDL_AudioQueue *queue, const void *data, Uint32 len)
+{
+	const Uint8 *src = (const Uint8 *)data;
+	SDL_AudioChunk *chunk;
+	Uint32 amount;
+	int retval = 0;
+
+	SDL_mutexP(queue->lock);
+	while ( len > 0 ) {
+		if ( queue->tail_pos == SDL_AUDIO_CHUNK ) {
+			chunk = SDL_NewAudioChunk(queue);
+			if ( chunk == NULL ) {
+				retval = -1;
+				break;
+			}
+			queue->tail->next = chunk;
+			queue->tail = chunk;
+			queue->tail_pos = 0;
+		}
+		amount = SDL_AUDIO_CHUNK - queue->tail_pos;
+		if ( amount > len ) {
+			amount = len;
+		}
+		SDL_memcpy(queue->tail->data + queue->tail_pos, src, amount);
+		queue->tail_pos += amount;
+		src += amount;
+		len -= amount;
+
+		/* Hand each piece over as soon as it's in */
+		SDL_AtomicAdd(&queue->written, (int)amount);
+	}
+	SDL_mutexV(queue->lock);
+	return(retval);
+}
+
+/* Takes data off the head, copying it to 'stream' unless that's NULL */
+static void SDL_TakeAudioQueue(SDL_AudioQueue *queue, Uint8 *stream, Uint32 len)
+{
+	SDL_AudioChunk *chunk;
+	Uint32 amount;
+
+	queue->read_pos += len;
+	while ( len > 0 ) {
+		/* There's more data, so the producer has moved on to the next
+		   chunk and this one can go back on the free list.
+		 */
+		if ( queue->head_pos == SDL_AUDIO_CHUNK ) {
+			chunk = queue->head;
+			queue->head = chunk->next;
+			queue->head_pos = 0;
+			SDL_FreeAudioChunk(queue, chunk);
+		}
+		amount = SDL_AUDIO_CHUNK - queue->head_pos;
+		if ( amount > len ) {
+			amount = len;
+		}
+		if ( stream ) {
+			SDL_memcpy(stream, queue->head->data + queue->head_pos, amount);
+			stream += amount;
+		}
+		queue->head_pos += amount;
+		len -= amount;
+	}
+	SDL_AtomicSet(&queue->read, (int)queue->read_pos);
+}
+
+void SDL_GetAudioQueue(SDL_AudioQueue *queue, Uint8 *stream, int len)
+{
+	Uint32 cleared, available;
+
+	/* Skip whatever was cleared since the last time */
+	cleared = (Uint32)SDL_AtomicGet(&queue->cleared);
+	if ( (Sint32)(cleared - queue->read_pos) > 0 ) {
+		SDL_TakeAudioQueue(queue, NULL, cleared - queue->read_pos);
+		queue->primed = 0;
+	}
+
+	available = (Uint32)SDL_AtomicGet(&queue->written) - queue->read_pos;
+	if ( available >= (Uint32)len ) {
+		SDL_TakeAudioQueue(queue, stream, len);
+		queue->primed = 1;
+		return;
+	}
+
+	/* Count running out after some data was played */
+	SDL_TakeAudioQueue(queue, stream, available);
+	SDL_memset(stream + available, queue->silence, len - available);
+	if ( queue->primed || available > 0 ) {
+		SDL_AtomicAdd(&queue->underruns, 1);
+		queue->primed = 0;
+	}
+}
+
+void SDLCALL SDL_DrainAudioQueue(void *userdata, Uint8 *stream, int len)
+{
+	SDL_GetAudioQueue((SDL_AudioQueue *)userdata, stream, len);
+}
+
+void SDL_ClearAudioQueue(SDL_AudioQueue *queue)
+{
+	SDL_mutexP(queue->lock);
+	SDL_AtomicSet(&queue->cleared, SDL_AtomicGet(&queue->written));
+	SDL_mutexV(queue->lock);
+}
+
+Uint32 SDL_AudioQueueSize(SDL_AudioQueue *queue)
+{
+	Uint32 read, cleared, written;
+
+	/* Read in this order, so neither can be ahead of 'written' */
+	read = (Uint32)SDL_AtomicGet(&queue->read);
+	cleared = (Uint32)SDL_AtomicGet(&queue->cleared);
+	written = (Uint32)SDL_AtomicGet(&queue->written);
+	if ( (Sint32)(cleared - read) > 0 ) {
+		read = cleared;
+	}
+	return(written - read);
+}
+
+Uint32 SDL_AudioQueueUnderruns(SDL_AudioQueue *queue)
+{
+	return((Uint32)SDL_AtomicGet(&queue->underruns));
+}
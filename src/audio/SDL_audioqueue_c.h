@@ -0,0 +1,68 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_audioqueue_c_h
+#define _SDL_audioqueue_c_h
+
+#include "SDL_audio.h"
+
+/* The data given to SDL_QueueAudio(), kept in a list of fixed size chunks
+   until the audio thread takes it. Any number of threads may put data in,
+   they take turns on a mutex, and one thread takes it out without
+   locking. Emptied chunks go on a free list for the next data, so the
+   audio thread never allocates or frees memory.
+ */
+typedef struct SDL_AudioQueue SDL_AudioQueue;
+
+/* Creates an empty queue, 'silence' pads the buffers it can't fill */
+extern SDL_AudioQueue *SDL_NewAudioQueue(Uint8 silence);
+
+/* Frees the queue, nothing may be using it anymore */
+extern void SDL_FreeAudioQueue(SDL_AudioQueue *queue);
+
+/* Adds data to the end of the queue, returns 0, or -1 if out of memory.
+   The data copied before running out of memory stays queued.
+ */
+extern int SDL_PutAudioQueue(SDL_AudioQueue *queue, const void *data, Uint32 len);
+
+/* Fills the buffer from the queue and pads it with silence if there isn't
+   enough data, counting an underrun if that ran the queue dry. Only one
+   thread may take data at a time.
+ */
+extern void SDL_GetAudioQueue(SDL_AudioQueue *queue, Uint8 *stream, int len);
+
+/* The same as SDL_GetAudioQueue() with the queue as the userdata, to be
+   used as the audio callback
+ */
+extern void SDLCALL SDL_DrainAudioQueue(void *userdata, Uint8 *stream, int len);
+
+/* Drops the data queued so far, the memory is kept for later data */
+extern void SDL_ClearAudioQueue(SDL_AudioQueue *queue);
+
+/* Returns the number of bytes queued and not taken yet */
+extern Uint32 SDL_AudioQueueSize(SDL_AudioQueue *queue);
+
+/* Returns the number of times the queue ran dry while playing */
+extern Uint32 SDL_AudioQueueUnderruns(SDL_AudioQueue *queue);
+
+#endif /* _SDL_audioqueue_c_h */
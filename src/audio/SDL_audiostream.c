@@ -0,0 +1,325 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Audio conversion of data that comes in pieces of any size */
+
+#include "SDL_audio.h"
+#include "SDL_audioqueue_c.h"
+#include "SDL_resample_c.h"
+
+/* Source frames converted at a time, the most the stream buffers */
+#define STREAM_BLOCK	1024
+
+/* The source data collects at the start of the first conversion's buffer
+   and goes through SDL_ConvertAudio() in whole units.  A unit is one
+   frame, or as many frames as the SDL_RateDIV2 filters in the chain make
+   one of, so every piece halves the rate at the same frames a conversion
+   of all of the data would.  Rates the filters can't change go through
+   the resampler between two conversions, like SDL_OpenResampler() sets
+   up for the audio device.  The converted data is queued until taken.
+ */
+struct SDL_AudioStream {
+	SDL_AudioCVT cvt_in;	/* to the destination, or 16 bit native to resample */
+	SDL_AudioCVT cvt_out;	/* the resampled data to the destination */
+	SDL_Resampler *resampler;
+	SDL_AudioQueue *queue;
+	int src_frame;		/* bytes in a source frame */
+	int mid_frame;		/* bytes in a 16 bit native frame */
+	int unit;		/* source bytes converted together */
+	int block;		/* source bytes cvt_in.buf holds */
+	int pending;		/* source bytes in cvt_in.buf */
+	Uint8 *partial;		/* what's left of a unit while converting */
+	double rate_incr;
+	Uint32 resampled_in;	/* frames put through the resampler */
+	Uint32 resampled_out;	/* frames taken out of it */
+};
+
+static int SDL_ValidStreamFormat(Uint16 format, Uint8 channels, int rate)
+{
+	switch (format) {
+		case AUDIO_U8:
+		case AUDIO_S8:
+		case AUDIO_U16LSB:
+		case AUDIO_S16LSB:
+		case AUDIO_U16MSB:
+		case AUDIO_S16MSB:
+			break;
+		default:
+			return(0);
+	}
+	switch (channels) {
+		case 1:
+		case 2:
+		case 4:
+		case 6:
+			break;
+		default:
+			return(0);
+	}
+	return(rate > 0);
+}
+
+/* Frames the SDL_RateDIV2 filters of a conversion take together */
+static int SDL_StreamUnitFrames(int src_rate, int dst_rate)
+{
+	int lo_rate = dst_rate;
+	int frames = 1;
+
+	if ( (src_rate > dst_rate) && ((src_rate/100) != (dst_rate/100)) ) {
+		/* The same test SDL_BuildAudioCVT() uses */
+		while ( ((lo_rate*2)/100) <= (src_rate/100) ) {
+			lo_rate *= 2;
+			frames *= 2;
+		}
+	}
+	return(frames);
+}
+
+SDL_AudioStream *SDL_NewAudioStream(Uint16 src_format, Uint8 src_channels,
+                                    int src_rate, Uint16 dst_format,
+                                    Uint8 dst_channels, int dst_rate)
+{
+	SDL_AudioStream *stream;
+	int resample, frames;
+
+	if ( !SDL_ValidStreamFormat(src_format, src_channels, src_rate) ||
+	     !SDL_ValidStreamFormat(dst_format, dst_channels, dst_rate) ) {
+		SDL_SetError("Unsupported audio stream format");
+		return(NULL);
+	}
+	stream = (SDL_AudioStream *)SDL_malloc(sizeof(*stream));
+	if ( stream == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(stream, 0, sizeof(*stream));
+
+	resample = SDL_NeedsResampler(src_rate, dst_rate);
+	if ( SDL_BuildAudioCVT(&stream->cvt_in,
+		src_format, src_channels, src_rate,
+		resample ? AUDIO_S16SYS : dst_format, dst_channels,
+		resample ? src_rate : dst_rate) < 0 ) {
+		SDL_SetError("Unsupported audio stream format");
+		SDL_free(stream);
+		return(NULL);
+	}
+	frames = 1;
+	if ( !resample ) {
+		frames = SDL_StreamUnitFrames(src_rate, dst_rate);
+	}
+	stream->src_frame = src_channels * ((src_format & 0xFF) / 8);
+	stream->mid_frame = dst_channels * sizeof(Sint16);
+	stream->unit = stream->src_frame * frames;
+	stream->block = stream->unit * ((STREAM_BLOCK > frames) ? (STREAM_BLOCK / frames) : 1);
+	stream->cvt_in.buf = (Uint8 *)SDL_malloc(stream->block * stream->cvt_in.len_mult);
+	stream->partial = (Uint8 *)SDL_malloc(stream->unit);
+	stream->queue = SDL_NewAudioQueue(0);
+	if ( !stream->cvt_in.buf || !stream->partial || !stream->queue ) {
+		SDL_FreeAudioStream(stream);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	if ( !resample ) {
+		return(stream);
+	}
+
+	stream->rate_incr = (double)src_rate / dst_rate;
+	stream->resampler = SDL_NewResampler(SDL_GetResampleQuality(),
+		dst_channels, stream->rate_incr, STREAM_BLOCK,
+		stream->block / stream->src_frame);
+	if ( stream->resampler == NULL ) {
+		SDL_FreeAudioStream(stream);
+		return(NULL);
+	}
+	if ( SDL_BuildAudioCVT(&stream->cvt_out,
+		AUDIO_S16SYS, dst_channels, dst_rate,
+		dst_format, dst_channels, dst_rate) < 0 ) {
+		SDL_SetError("Unsupported audio stream format");
+		SDL_FreeAudioStream(stream);
+		return(NULL);
+	}
+	stream->cvt_out.buf = (Uint8 *)SDL_malloc(
+		STREAM_BLOCK * stream->mid_frame * stream->cvt_out.len_mult);
+	if ( stream->cvt_out.buf == NULL ) {
+		SDL_FreeAudioStream(stream);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	return(stream);
+}
+
+/* Takes frames out of the resampler and queues them converted */
+static int SDL_TakeResampled(SDL_AudioStream *stream, int frames)
+{
+	SDL_AudioCVT *cvt = &stream->cvt_out;
+
+	SDL_ResamplerGet(stream->resampler, (Sint16 *)cvt->buf, frames);
+	stream->resampled_out += frames;
+	cvt->len = frames * stream->mid_frame;
+	SDL_ConvertAudio(cvt);
+	return(SDL_PutAudioQueue(stream->queue, cvt->buf, cvt->len_cvt));
+}
+
+/* Converts the first 'len' bytes of cvt_in.buf, keeping the rest of the
+   pending data for later
+ */
+static int SDL_ConvertPending(SDL_AudioStream *stream, int len)
+{
+	SDL_AudioCVT *cvt = &stream->cvt_in;
+	const int rest = stream->pending - len;
+	int frames, retval = 0;
+
+	if ( len == 0 ) {
+		return(0);
+	}
+	SDL_memcpy(stream->partial, cvt->buf + len, rest);
+	cvt->len = len;
+	SDL_ConvertAudio(cvt);
+	if ( stream->resampler == NULL ) {
+		retval = SDL_PutAudioQueue(stream->queue, cvt->buf, cvt->len_cvt);
+	} else {
+		/* Everything the input is enough for, then the history stays */
+		frames = cvt->len_cvt / stream->mid_frame;
+		SDL_ResamplerPut(stream->resampler, (Sint16 *)cvt->buf, frames);
+		stream->resampled_in += frames;
+		while ( retval == 0 &&
+		        (frames = SDL_ResamplerAvailable(stream->resampler)) > 0 ) {
+			if ( frames > STREAM_BLOCK ) {
+				frames = STREAM_BLOCK;
+			}
+			retval = SDL_TakeResampled(stream, frames);
+		}
+	}
+	SDL_memcpy(cvt->buf, stream->partial, rest);
+	stream->pending = rest;
+	return(retval);
+}
+
+int SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
+{
+	const Uint8 *data = (const Uint8 *)buf;
+	int amount;
+
+	while ( len > 0 ) {
+		amount = stream->block - stream->pending;
+		if ( amount > len ) {
+			amount = len;
+		}
+		SDL_memcpy(stream->cvt_in.buf + stream->pending, data, amount);
+		stream->pending += amount;
+		data += amount;
+		len -= amount;
+
+		/* Convert when the buffer is full and at the end of the data */
+		if ( (stream->pending == stream->block) || (len == 0) ) {
+			if ( SDL_ConvertPending(stream, stream->pending -
+			                        stream->pending % stream->unit) < 0 ) {
+				return(-1);
+			}
+		}
+	}
+	return(0);
+}
+
+int SDL_AudioStreamGet(SDL_AudioStream *stream, void *buf, int len)
+{
+	const Uint32 available = SDL_AudioQueueSize(stream->queue);
+
+	if ( len <= 0 ) {
+		return(0);
+	}
+	if ( (Uint32)len > available ) {
+		len = (int)available;
+	}
+	SDL_GetAudioQueue(stream->queue, (Uint8 *)buf, len);
+	return(len);
+}
+
+int SDL_AudioStreamAvailable(SDL_AudioStream *stream)
+{
+	return((int)SDL_AudioQueueSize(stream->queue));
+}
+
+/* Starts over without the data that hasn't been converted */
+static void SDL_RestartAudioStream(SDL_AudioStream *stream)
+{
+	stream->pending = 0;
+	if ( stream->resampler ) {
+		SDL_ResetResampler(stream->resampler);
+		stream->resampled_in = 0;
+		stream->resampled_out = 0;
+	}
+}
+
+int SDL_AudioStreamFlush(SDL_AudioStream *stream)
+{
+	const int max_in = stream->block / stream->src_frame;
+	Sint16 *silence = (Sint16 *)stream->cvt_in.buf;
+	int total, frames, needed, retval;
+
+	/* The whole frames short of a unit, like at the end of a conversion */
+	retval = SDL_ConvertPending(stream, stream->pending -
+	                            stream->pending % stream->src_frame);
+
+	/* The frames a conversion of all the input would end with */
+	if ( stream->resampler && retval == 0 ) {
+		total = SDL_ResampleLength(stream->rate_incr,
+		                           (int)stream->resampled_in);
+		SDL_memset(silence, 0, max_in * stream->mid_frame);
+		while ( retval == 0 && (int)stream->resampled_out < total ) {
+			frames = total - (int)stream->resampled_out;
+			if ( frames > STREAM_BLOCK ) {
+				frames = STREAM_BLOCK;
+			}
+			needed = SDL_ResamplerNeeded(stream->resampler, frames);
+			while ( needed > 0 ) {
+				SDL_ResamplerPut(stream->resampler, silence,
+				                 (needed < max_in) ? needed : max_in);
+				needed -= max_in;
+			}
+			retval = SDL_TakeResampled(stream, frames);
+		}
+	}
+	SDL_RestartAudioStream(stream);
+	return(retval);
+}
+
+void SDL_AudioStreamClear(SDL_AudioStream *stream)
+{
+	SDL_RestartAudioStream(stream);
+	SDL_ClearAudioQueue(stream->queue);
+}
+
+void SDL_FreeAudioStream(SDL_AudioStream *stream)
+{
+	if ( stream ) {
+		if ( stream->queue ) {
+			SDL_FreeAudioQueue(stream->queue);
+		}
+		SDL_FreeResampler(stream->resampler);
+		SDL_free(stream->cvt_in.buf);
+		SDL_free(stream->cvt_out.buf);
+		SDL_free(stream->partial);
+		SDL_free(stream);
+	}
+}
@@ -30,6 +30,8 @@
 #include "SDL_mixer_MMX.h"
 #include "SDL_mixer_MMX_VC.h"
 #include "SDL_mixer_m68k.h"
+#include "SDL_mixer_NEON.h"
+#include "SDL_mixer_SSE2.h"
 
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
@@ -90,16 +92,60 @@ static const Uint8 mix8[] =
 #define ADJUST_VOLUME(s, v)	(s = (s*v)/SDL_MIX_MAXVOLUME)
 #define ADJUST_VOLUME_U8(s, v)	(s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
+#if SDL_MIXER_NEON || SDL_MIXER_SSE2
+/* Mixes as much of the buffer as the SIMD functions can and returns the
+   number of bytes done, the C code below mixes the rest.
+ */
+static Uint32 SDL_MixAudio_SIMD(Uint16 format, Uint8 *dst, const Uint8 *src,
+                                Uint32 len, int volume)
+{
+	/* Louder than the maximum the scaled samples overflow their lanes */
+	if ( volume < 0 || volume > SDL_MIX_MAXVOLUME ) {
+		return 0;
+	}
+#if SDL_MIXER_NEON
+	if ( SDL_HasARMNEON() ) {
+		switch (format) {
+			case AUDIO_U8:
+				return SDL_MixAudio_NEON_U8(dst, src, len, volume);
+			case AUDIO_S8:
+				return SDL_MixAudio_NEON_S8(dst, src, len, volume);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+			case AUDIO_S16LSB:
+				return SDL_MixAudio_NEON_S16LSB(dst, src, len, volume);
+#endif
+		}
+	}
+#endif
+#if SDL_MIXER_SSE2
+	if ( SDL_HasSSE2() ) {
+		switch (format) {
+			case AUDIO_U8:
+				return SDL_MixAudio_SSE2_U8(dst, src, len, volume);
+			case AUDIO_S8:
+				return SDL_MixAudio_SSE2_S8(dst, src, len, volume);
+			case AUDIO_S16LSB:
+				return SDL_MixAudio_SSE2_S16LSB(dst, src, len, volume);
+		}
+	}
+#endif
+	return 0;
+}
+#endif /* SDL_MIXER_NEON || SDL_MIXER_SSE2 */
+
 void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
 {
 	Uint16 format;
+#if SDL_MIXER_NEON || SDL_MIXER_SSE2
+	Uint32 done;
+#endif
 
 	if ( volume == 0 ) {
 		return;
 	}
 	/* Mix the user-level audio format */
 	if ( current_audio ) {
-		if ( current_audio->convert.needed ) {
+		if ( current_audio->convert.needed || current_audio->resampler ) {
 			format = current_audio->convert.src_format;
 		} else {
 			format = current_audio->spec.format;
@@ -108,6 +154,12 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
   		/* HACK HACK HACK */
 		format = AUDIO_S16;
 	}
+#if SDL_MIXER_NEON || SDL_MIXER_SSE2
+	done = SDL_MixAudio_SIMD(format, dst, src, len, volume);
+	dst += done;
+	src += done;
+	len -= done;
+#endif
 	switch (format) {
 
 		case AUDIO_U8: {
@@ -0,0 +1,124 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_audio.h"
+#include "SDL_mixer_NEON.h"
+
+#if SDL_MIXER_NEON
+
+/* NEON mixing, 16 bytes at a time.
+
+   The C code scales each sample with ADJUST_VOLUME, a division that rounds
+   toward zero, and clamps the sum. vqdmulh would scale in one step but
+   rounds toward minus infinity, so the samples are multiplied into wider
+   lanes, negative products get SDL_MIX_MAXVOLUME-1 added and are shifted
+   down instead. The sums use saturating adds, which clamp like the C code.
+*/
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#else
+#include "../cpuinfo/SDL_neon_emu.h"
+#endif
+
+#define VOLUME_SHIFT	7	/* SDL_MIX_MAXVOLUME is 1 << 7 */
+
+/* ADJUST_VOLUME for 8 bit samples widened to 16 bits */
+static __inline__ int16x8_t AdjustVolume8(int16x8_t s, Sint16 volume)
+{
+	int16x8_t p = vmulq_n_s16(s, volume);
+
+	p = vaddq_s16(p, vandq_s16(vshrq_n_s16(p, 15),
+	                           vdupq_n_s16(SDL_MIX_MAXVOLUME - 1)));
+	return vshrq_n_s16(p, VOLUME_SHIFT);
+}
+
+/* ADJUST_VOLUME for 16 bit samples */
+static __inline__ int16x4_t AdjustVolume16(int16x4_t s, Sint16 volume)
+{
+	int32x4_t p = vmull_n_s16(s, volume);
+
+	p = vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31),
+	                           vdupq_n_s32(SDL_MIX_MAXVOLUME - 1)));
+	return vshrn_n_s32(p, VOLUME_SHIFT);
+}
+
+Uint32 SDL_MixAudio_NEON_U8(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+	const uint8x16_t bias = vdupq_n_u8(0x80);
+	const uint8x16_t top = vdupq_n_u8(0xFE);	/* like the mix8 table */
+	Uint32 i;
+
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		const int8x16_t s = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(src + i), bias));
+		const uint8x16_t d = vld1q_u8(dst + i);
+		int16x8_t lo, hi;
+
+		lo = AdjustVolume8(vmovl_s8(vget_low_s8(s)), (Sint16)volume);
+		hi = AdjustVolume8(vmovl_s8(vget_high_s8(s)), (Sint16)volume);
+		lo = vaddq_s16(lo, vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(d))));
+		hi = vaddq_s16(hi, vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(d))));
+		vst1q_u8(dst + i, vminq_u8(vcombine_u8(vqmovun_s16(lo),
+		                                       vqmovun_s16(hi)), top));
+	}
+	return len;
+}
+
+Uint32 SDL_MixAudio_NEON_S8(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+	Uint32 i;
+
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		const int8x16_t s = vreinterpretq_s8_u8(vld1q_u8(src + i));
+		const int8x16_t d = vreinterpretq_s8_u8(vld1q_u8(dst + i));
+		int8x16_t m;
+
+		m = vcombine_s8(
+			vmovn_s16(AdjustVolume8(vmovl_s8(vget_low_s8(s)), (Sint16)volume)),
+			vmovn_s16(AdjustVolume8(vmovl_s8(vget_high_s8(s)), (Sint16)volume)));
+		vst1q_u8(dst + i, vreinterpretq_u8_s8(vqaddq_s8(d, m)));
+	}
+	return len;
+}
+
+/* The buffers are loaded as bytes, they needn't be 16 bit aligned */
+Uint32 SDL_MixAudio_NEON_S16LSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+	Uint32 i;
+
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		const int16x8_t s = vreinterpretq_s16_u8(vld1q_u8(src + i));
+		const int16x8_t d = vreinterpretq_s16_u8(vld1q_u8(dst + i));
+		int16x8_t m;
+
+		m = vcombine_s16(AdjustVolume16(vget_low_s16(s), (Sint16)volume),
+		                 AdjustVolume16(vget_high_s16(s), (Sint16)volume));
+		vst1q_u8(dst + i, vreinterpretq_u8_s16(vqaddq_s16(d, m)));
+	}
+	return len;
+}
+
+#endif /* SDL_MIXER_NEON */
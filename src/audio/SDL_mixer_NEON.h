@@ -0,0 +1,43 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* NEON versions of SDL_MixAudio, see SDL_mixer_NEON.c */
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SDL_MIXER_NEON	1
+#elif SDL_ARM_NEON_EMULATION
+/* Built with the portable stand-ins of SDL_neon_emu.h, for testing */
+#define SDL_MIXER_NEON	1
+#endif
+
+#if SDL_MIXER_NEON
+
+/* Each function mixes the largest multiple of 16 bytes of len and returns
+   that size, the rest is left to the caller. The volume has to be between
+   0 and SDL_MIX_MAXVOLUME. The output matches the C code of SDL_MixAudio.
+ */
+extern Uint32 SDL_MixAudio_NEON_U8(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+extern Uint32 SDL_MixAudio_NEON_S8(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+extern Uint32 SDL_MixAudio_NEON_S16LSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+
+#endif /* SDL_MIXER_NEON */
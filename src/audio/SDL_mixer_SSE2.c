@@ -0,0 +1,123 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_audio.h"
+#include "SDL_mixer_SSE2.h"
+
+#if SDL_MIXER_SSE2
+
+/* SSE2 mixing, 16 bytes at a time, the same arithmetic as
+   SDL_mixer_NEON.c. SSE2 has no 8 bit multiply, so 8 bit samples are
+   sign extended to 16 bits by unpacking them into the high byte.
+*/
+
+#include <emmintrin.h>
+
+#define VOLUME_SHIFT	7	/* SDL_MIX_MAXVOLUME is 1 << 7 */
+
+/* ADJUST_VOLUME for 8 bit samples widened to 16 bits */
+static __inline__ __m128i AdjustVolume8(__m128i s, __m128i volume)
+{
+	__m128i p = _mm_mullo_epi16(s, volume);
+
+	p = _mm_add_epi16(p, _mm_and_si128(_mm_srai_epi16(p, 15),
+	                     _mm_set1_epi16(SDL_MIX_MAXVOLUME - 1)));
+	return _mm_srai_epi16(p, VOLUME_SHIFT);
+}
+
+/* ADJUST_VOLUME for 16 bit samples, the products are 32 bits wide */
+static __inline__ __m128i AdjustVolume16(__m128i s, __m128i volume)
+{
+	const __m128i round = _mm_set1_epi32(SDL_MIX_MAXVOLUME - 1);
+	const __m128i plo = _mm_mullo_epi16(s, volume);
+	const __m128i phi = _mm_mulhi_epi16(s, volume);
+	__m128i p0 = _mm_unpacklo_epi16(plo, phi);
+	__m128i p1 = _mm_unpackhi_epi16(plo, phi);
+
+	p0 = _mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), round));
+	p1 = _mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), round));
+	/* No saturation, the scaled samples fit in 16 bits */
+	return _mm_packs_epi32(_mm_srai_epi32(p0, VOLUME_SHIFT),
+	                       _mm_srai_epi32(p1, VOLUME_SHIFT));
+}
+
+Uint32 SDL_MixAudio_SSE2_U8(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+	const __m128i vol = _mm_set1_epi16((short)volume);
+	const __m128i bias = _mm_set1_epi8((char)0x80);
+	const __m128i top = _mm_set1_epi8((char)0xFE);	/* like the mix8 table */
+	const __m128i zero = _mm_setzero_si128();
+	Uint32 i;
+
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		const __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(src + i)), bias);
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i lo, hi;
+
+		lo = AdjustVolume8(_mm_srai_epi16(_mm_unpacklo_epi8(s, s), 8), vol);
+		hi = AdjustVolume8(_mm_srai_epi16(_mm_unpackhi_epi8(s, s), 8), vol);
+		lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(d, zero));
+		hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(d, zero));
+		_mm_storeu_si128((__m128i *)(dst + i),
+		                 _mm_min_epu8(_mm_packus_epi16(lo, hi), top));
+	}
+	return len;
+}
+
+Uint32 SDL_MixAudio_SSE2_S8(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+	const __m128i vol = _mm_set1_epi16((short)volume);
+	Uint32 i;
+
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i lo, hi;
+
+		lo = AdjustVolume8(_mm_srai_epi16(_mm_unpacklo_epi8(s, s), 8), vol);
+		hi = AdjustVolume8(_mm_srai_epi16(_mm_unpackhi_epi8(s, s), 8), vol);
+		_mm_storeu_si128((__m128i *)(dst + i),
+		                 _mm_adds_epi8(d, _mm_packs_epi16(lo, hi)));
+	}
+	return len;
+}
+
+Uint32 SDL_MixAudio_SSE2_S16LSB(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+	const __m128i vol = _mm_set1_epi16((short)volume);
+	Uint32 i;
+
+	len &= ~15;
+	for ( i = 0; i < len; i += 16 ) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		_mm_storeu_si128((__m128i *)(dst + i),
+		                 _mm_adds_epi16(d, AdjustVolume16(s, vol)));
+	}
+	return len;
+}
+
+#endif /* SDL_MIXER_SSE2 */
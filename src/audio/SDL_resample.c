@@ -0,0 +1,434 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Windowed sinc rate conversion in fixed point
+
+   The prototype lowpass is a Kaiser windowed sinc, tabulated once per
+   quality level with RESAMPLE_PHASES entries per zero crossing. Each output
+   frame computes its coefficients from the table for the position between
+   the input frames, interpolating between neighbouring entries, and takes
+   a 64 bit sum of the products with the input, scaled by the sum of the
+   coefficients so the gain stays at exactly 1. When the rate goes down the
+   filter is stretched over more input frames, which moves its cutoff down
+   to the new Nyquist rate.
+ */
+
+#include "SDL_audio.h"
+#include "SDL_resample_c.h"
+
+#define RESAMPLE_PHASES		256	/* table entries per zero crossing */
+#define RESAMPLE_BITS		20	/* fraction bits of the table entries */
+#define RESAMPLE_NORM_BITS	45	/* keeps the normalized sum within 64 bits */
+#define RESAMPLE_MAX_STRETCH	8	/* widest filter, in multiples of the prototype */
+#define RESAMPLE_MAX_ZEROS	16
+#define RESAMPLE_MAX_TAPS	(RESAMPLE_MAX_ZEROS * RESAMPLE_MAX_STRETCH)
+
+static const struct {
+	const char *name;
+	int zeros;		/* zero crossings to either side */
+	double cutoff;		/* in parts of the Nyquist rate */
+	double beta;		/* Kaiser window shape */
+} qualities[SDL_RESAMPLE_QUALITIES] = {
+	{ "fast", 4, 0.80, 5.0 },
+	{ "medium", 8, 0.90, 7.0 },
+	{ "best", 16, 0.94, 9.0 },
+};
+
+/* The tables have a zero crossing of zeros at the end, so the last taps
+   of a stretched filter can run past the window without a range check.
+ */
+static Sint32 table_fast[(4 + 1) * RESAMPLE_PHASES + 2];
+static Sint32 table_medium[(8 + 1) * RESAMPLE_PHASES + 2];
+static Sint32 table_best[(16 + 1) * RESAMPLE_PHASES + 2];
+static Sint32 *tables[SDL_RESAMPLE_QUALITIES] = {
+	table_fast, table_medium, table_best
+};
+static int tables_built[SDL_RESAMPLE_QUALITIES];
+
+typedef struct ResampleFilter {
+	const Sint32 *table;
+	int taps;		/* input frames used on either side */
+	Uint32 pstep;		/* table position per input frame, 16.16 */
+	Uint64 step;		/* input frames per output frame, 32.32 */
+} ResampleFilter;
+
+struct SDL_Resampler {
+	ResampleFilter filter;
+	int channels;
+	Uint64 pos;		/* next output frame, 32.32 frames into buf */
+	Sint16 *buf;
+	int frames;
+	int capacity;
+};
+
+/* Only what the table needs, so this doesn't depend on a math library */
+#define RESAMPLE_PI	3.14159265358979323846
+
+/* sin(pi * t) for t >= 0 */
+static double SinPi(double t)
+{
+	int whole = (int)t;
+	double x = t - whole;
+	double x2, term, sum;
+	int i;
+
+	if ( x > 0.5 ) {
+		x = 1.0 - x;
+	}
+	x *= RESAMPLE_PI;
+	x2 = x * x;
+	term = x;
+	sum = x;
+	for ( i = 2; i < 20; i += 2 ) {
+		term *= -x2 / (i * (i + 1));
+		sum += term;
+	}
+	return (whole & 1) ? -sum : sum;
+}
+
+static double SquareRoot(double x)
+{
+	double r = 1.0;
+	int i;
+
+	if ( x <= 0.0 ) {
+		return 0.0;
+	}
+	for ( i = 0; i < 64; ++i ) {
+		double next = 0.5 * (r + x / r);
+		if ( next == r ) {
+			break;
+		}
+		r = next;
+	}
+	return r;
+}
+
+/* Modified Bessel function of the first kind, order 0 */
+static double BesselI0(double x)
+{
+	double term = 1.0, sum = 1.0;
+	int k;
+
+	for ( k = 1; term > sum * 1e-16; ++k ) {
+		term *= (x * x) / (4.0 * k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+static void BuildTable(int quality)
+{
+	const int zeros = qualities[quality].zeros;
+	const double cutoff = qualities[quality].cutoff;
+	const double beta = qualities[quality].beta;
+	Sint32 *table = tables[quality];
+	int n;
+
+	for ( n = 0; n <= zeros * RESAMPLE_PHASES; ++n ) {
+		double x = (double)n / RESAMPLE_PHASES;
+		double w = x / zeros;
+		double h = cutoff;
+
+		if ( n > 0 ) {
+			h = SinPi(cutoff * x) / (RESAMPLE_PI * x);
+		}
+		h *= BesselI0(beta * SquareRoot(1.0 - w * w)) / BesselI0(beta);
+		h *= (1 << RESAMPLE_BITS);
+		table[n] = (Sint32)(h + (h < 0.0 ? -0.5 : 0.5));
+	}
+	for ( ; n < (zeros + 1) * RESAMPLE_PHASES + 2; ++n ) {
+		table[n] = 0;
+	}
+	tables_built[quality] = 1;
+}
+
+int SDL_GetResampleQuality(void)
+{
+	const char *env = SDL_getenv("SDL_AUDIO_RESAMPLER");
+	int quality = SDL_RESAMPLE_MEDIUM;
+	int i;
+
+	if ( env ) {
+		for ( i = 0; i < SDL_RESAMPLE_QUALITIES; ++i ) {
+			if ( SDL_strcasecmp(env, qualities[i].name) == 0 ) {
+				quality = i;
+			}
+		}
+	}
+	/* Build the table here rather than in the audio thread */
+	if ( !tables_built[quality] ) {
+		BuildTable(quality);
+	}
+	return quality;
+}
+
+int SDL_NeedsResampler(int src_rate, int dst_rate)
+{
+	int lo_rate, hi_rate;
+
+	if ( src_rate > dst_rate ) {
+		hi_rate = src_rate;
+		lo_rate = dst_rate;
+	} else {
+		hi_rate = dst_rate;
+		lo_rate = src_rate;
+	}
+	if ( lo_rate <= 0 ) {
+		return 0;
+	}
+	/* The same test the SDL_RateMUL2/SDL_RateDIV2 chain uses */
+	while ( ((lo_rate*2)/100) <= (hi_rate/100) ) {
+		lo_rate *= 2;
+	}
+	return ((lo_rate/100) != (hi_rate/100));
+}
+
+static Uint64 ResampleStep(double rate_incr)
+{
+	return (Uint64)(rate_incr * 4294967296.0 + 0.5);
+}
+
+static void SetupFilter(ResampleFilter *filter, int quality, double rate_incr)
+{
+	Uint32 scale = 0x10000;	/* filter bandwidth, 16.16 */
+
+	if ( !tables_built[quality] ) {
+		BuildTable(quality);
+	}
+	filter->step = ResampleStep(rate_incr);
+	if ( filter->step > ((Uint64)1 << 32) ) {
+		scale = (Uint32)(((Uint64)1 << 48) / filter->step);
+		if ( scale < 0x10000 / RESAMPLE_MAX_STRETCH ) {
+			scale = 0x10000 / RESAMPLE_MAX_STRETCH;
+		}
+	}
+	filter->table = tables[quality];
+	filter->taps = (int)((((Uint32)qualities[quality].zeros << 16) + scale - 1) / scale);
+	filter->pstep = scale * RESAMPLE_PHASES;
+}
+
+/* The coefficients for an output frame frac past input frame i, for the
+   input frames i-taps+1 up to i+taps. Returns the factor that scales their
+   sum to 1, with RESAMPLE_NORM_BITS fraction bits.
+ */
+static Sint32 ComputeCoefficients(const ResampleFilter *filter, Uint32 frac,
+                                  Sint32 *coefs)
+{
+	const Sint32 *table = filter->table;
+	const Uint32 pstep = filter->pstep;
+	Uint32 p = (Uint32)(((Uint64)frac * pstep) >> 32);
+	Uint32 q = pstep - p;
+	Sint32 sum = 0;
+	int j;
+
+	for ( j = filter->taps - 1; j >= 0; --j ) {
+		const Sint32 *t = table + (p >> 16);
+		coefs[j] = t[0] + (((t[1] - t[0]) * (Sint32)(p & 0xFFFF)) >> 16);
+		sum += coefs[j];
+		p += pstep;
+	}
+	for ( j = filter->taps; j < 2 * filter->taps; ++j ) {
+		const Sint32 *t = table + (q >> 16);
+		coefs[j] = t[0] + (((t[1] - t[0]) * (Sint32)(q & 0xFFFF)) >> 16);
+		sum += coefs[j];
+		q += pstep;
+	}
+	/* A floating point divide, there may be no integer one */
+	return (Sint32)((double)((Sint64)1 << RESAMPLE_NORM_BITS) / sum);
+}
+
+static void Filter(const Sint32 *coefs, int count, Sint32 norm,
+                   const Sint16 *in, int channels, Sint16 *out)
+{
+	int c, j;
+
+	for ( c = 0; c < channels; ++c ) {
+		const Sint16 *src = in + c;
+		Sint64 sum = 0;
+
+		for ( j = 0; j < count; ++j ) {
+			sum += (Sint64)coefs[j] * *src;
+			src += channels;
+		}
+		sum = (sum * norm + ((Sint64)1 << (RESAMPLE_NORM_BITS - 1))) >> RESAMPLE_NORM_BITS;
+		if ( sum > 32767 ) {
+			sum = 32767;
+		} else if ( sum < -32768 ) {
+			sum = -32768;
+		}
+		out[c] = (Sint16)sum;
+	}
+}
+
+int SDL_ResampleLength(double rate_incr, int in_frames)
+{
+	Uint64 step = ResampleStep(rate_incr);
+
+	/* Rounded, so whole multiples come out exact despite the rounded step */
+	return (int)((((Uint64)in_frames << 32) + step / 2) / step);
+}
+
+int SDL_ResampleBuffer(int quality, int channels, double rate_incr,
+                       const Sint16 *in, int in_frames, Sint16 *out)
+{
+	ResampleFilter filter;
+	Sint32 coefs[2 * RESAMPLE_MAX_TAPS];
+	Uint64 pos = 0;
+	Sint32 norm;
+	int out_frames, n;
+
+	SetupFilter(&filter, quality, rate_incr);
+	out_frames = SDL_ResampleLength(rate_incr, in_frames);
+	for ( n = 0; n < out_frames; ++n ) {
+		int first = (int)(pos >> 32) - filter.taps + 1;
+		int lo = 0, hi = 2 * filter.taps;
+
+		/* Leave out the taps that fall outside the buffer */
+		if ( first < 0 ) {
+			lo = -first;
+		}
+		if ( first + hi > in_frames ) {
+			hi = in_frames - first;
+		}
+		norm = ComputeCoefficients(&filter, (Uint32)pos, coefs);
+		Filter(coefs + lo, hi - lo, norm,
+		       in + (first + lo) * channels, channels, out);
+		out += channels;
+		pos += filter.step;
+	}
+	return out_frames;
+}
+
+SDL_Resampler *SDL_NewResampler(int quality, int channels, double rate_incr,
+                                int max_out, int max_in)
+{
+	SDL_Resampler *resampler;
+
+	resampler = (SDL_Resampler *)SDL_malloc(sizeof(*resampler));
+	if ( resampler == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SetupFilter(&resampler->filter, quality, rate_incr);
+	resampler->channels = channels;
+	/* History, lookahead and the input for one block of output */
+	resampler->capacity = 2 * resampler->filter.taps + 2 + max_in +
+		(int)(((Uint64)max_out * resampler->filter.step) >> 32);
+	resampler->buf = (Sint16 *)SDL_malloc(resampler->capacity * channels * sizeof(Sint16));
+	if ( resampler->buf == NULL ) {
+		SDL_free(resampler);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_ResetResampler(resampler);
+	return(resampler);
+}
+
+void SDL_ResetResampler(SDL_Resampler *resampler)
+{
+	/* Silence before the first input frame, for the taps to the left */
+	resampler->frames = resampler->filter.taps - 1;
+	resampler->pos = (Uint64)resampler->frames << 32;
+	SDL_memset(resampler->buf, 0, resampler->frames * resampler->channels * sizeof(Sint16));
+}
+
+int SDL_ResamplerNeeded(SDL_Resampler *resampler, int out_frames)
+{
+	Uint64 last;
+	int needed;
+
+	if ( out_frames <= 0 ) {
+		return 0;
+	}
+	last = resampler->pos + (out_frames - 1) * resampler->filter.step;
+	needed = (int)(last >> 32) + resampler->filter.taps + 1 - resampler->frames;
+	return (needed > 0) ? needed : 0;
+}
+
+int SDL_ResamplerAvailable(SDL_Resampler *resampler)
+{
+	/* The last input frame the filter may reach */
+	const int last = resampler->frames - resampler->filter.taps - 1;
+	const Uint64 end = (Uint64)(last + 1) << 32;
+
+	if ( last < 0 || resampler->pos >= end ) {
+		return 0;
+	}
+	return (int)((end - 1 - resampler->pos) / resampler->filter.step) + 1;
+}
+
+int SDL_ResamplerPut(SDL_Resampler *resampler, const Sint16 *in, int frames)
+{
+	const int channels = resampler->channels;
+
+	if ( resampler->frames + frames > resampler->capacity ) {
+		SDL_SetError("Resampler input overflow");
+		return(-1);
+	}
+	SDL_memcpy(resampler->buf + resampler->frames * channels, in,
+	           frames * channels * sizeof(Sint16));
+	resampler->frames += frames;
+	return(0);
+}
+
+int SDL_ResamplerGet(SDL_Resampler *resampler, Sint16 *out, int frames)
+{
+	const ResampleFilter *filter = &resampler->filter;
+	const int channels = resampler->channels;
+	Sint32 coefs[2 * RESAMPLE_MAX_TAPS];
+	int n, drop;
+
+	if ( SDL_ResamplerNeeded(resampler, frames) > 0 ) {
+		SDL_SetError("Resampler input underflow");
+		return(-1);
+	}
+	for ( n = 0; n < frames; ++n ) {
+		int first = (int)(resampler->pos >> 32) - filter->taps + 1;
+
+		Sint32 norm = ComputeCoefficients(filter, (Uint32)resampler->pos, coefs);
+
+		Filter(coefs, 2 * filter->taps, norm,
+		       resampler->buf + first * channels, channels, out);
+		out += channels;
+		resampler->pos += filter->step;
+	}
+
+	/* Keep what the next output frame still reaches back to */
+	drop = (int)(resampler->pos >> 32) - filter->taps + 1;
+	if ( drop > 0 ) {
+		resampler->frames -= drop;
+		SDL_memmove(resampler->buf, resampler->buf + drop * channels,
+		            resampler->frames * channels * sizeof(Sint16));
+		resampler->pos -= (Uint64)drop << 32;
+	}
+	return(frames);
+}
+
+void SDL_FreeResampler(SDL_Resampler *resampler)
+{
+	if ( resampler ) {
+		SDL_free(resampler->buf);
+		SDL_free(resampler);
+	}
+}
@@ -0,0 +1,98 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_resample_c_h
+#define _SDL_resample_c_h
+
+#include "SDL_audio.h"
+
+/* Windowed sinc rate conversion of native 16 bit signed samples, for the
+   ratios the SDL_RateMUL2/SDL_RateDIV2 chain can't do. The filter is read
+   from a polyphase table of the prototype lowpass, interpolating between
+   phases, so any ratio works without a table per ratio.
+ */
+
+/* Quality levels, the filter reaches 4, 8 or 16 samples to either side.
+   The SDL_AUDIO_RESAMPLER environment variable picks one by name:
+   "fast", "medium" (the default) or "best".
+ */
+#define SDL_RESAMPLE_FAST	0
+#define SDL_RESAMPLE_MEDIUM	1
+#define SDL_RESAMPLE_BEST	2
+#define SDL_RESAMPLE_QUALITIES	3
+
+/* Returns the quality set in the environment */
+extern int SDL_GetResampleQuality(void);
+
+/* Returns 1 if converting between the rates needs the resampler, 0 if the
+   rates are the same or a power of two apart (to within 100 Hz)
+ */
+extern int SDL_NeedsResampler(int src_rate, int dst_rate);
+
+/* The conversions below take the ratio as input frames per output frame,
+   like the rate_incr of SDL_AudioCVT, so src_rate / dst_rate.
+ */
+
+/* Returns the number of frames SDL_ResampleBuffer() makes of in_frames,
+   in_frames / rate_incr rounded to the nearest frame
+ */
+extern int SDL_ResampleLength(double rate_incr, int in_frames);
+
+/* Converts a whole buffer, as if it was surrounded by silence. The output
+   must not overlap the input. Returns the number of frames written.
+ */
+extern int SDL_ResampleBuffer(int quality, int channels, double rate_incr,
+                              const Sint16 *in, int in_frames, Sint16 *out);
+
+/* A stream conversion, which keeps the position and the samples the filter
+   still needs between calls, so the output can be taken in blocks of any
+   size without clicks at the block boundaries.
+ */
+typedef struct SDL_Resampler SDL_Resampler;
+
+/* Creates a stream conversion. max_out is the most frames taken out with
+   one SDL_ResamplerGet() and max_in the most put in with one
+   SDL_ResamplerPut(), the buffers are sized for them up front.
+ */
+extern SDL_Resampler *SDL_NewResampler(int quality, int channels,
+                                       double rate_incr,
+                                       int max_out, int max_in);
+
+/* Returns how many more input frames are needed to get out_frames */
+extern int SDL_ResamplerNeeded(SDL_Resampler *resampler, int out_frames);
+
+/* Returns how many output frames the input put in so far is enough for */
+extern int SDL_ResamplerAvailable(SDL_Resampler *resampler);
+
+/* Adds input frames, returns -1 if they don't fit */
+extern int SDL_ResamplerPut(SDL_Resampler *resampler, const Sint16 *in, int frames);
+
+/* Takes out frames, returns -1 if not enough input was put in */
+extern int SDL_ResamplerGet(SDL_Resampler *resampler, Sint16 *out, int frames);
+
+/* Drops the buffered input, the stream starts over from silence */
+extern void SDL_ResetResampler(SDL_Resampler *resampler);
+
+extern void SDL_FreeResampler(SDL_Resampler *resampler);
+
+#endif /* _SDL_resample_c_h */
@@ -24,6 +24,7 @@
 #ifndef _SDL_sysaudio_h
 #define _SDL_sysaudio_h
 
+#include "SDL_atomic.h"
 #include "SDL_mutex.h"
 #include "SDL_thread.h"
 
@@ -70,6 +71,31 @@ struct SDL_AudioDevice {
 	/* An audio conversion block for audio format emulation */
 	SDL_AudioCVT convert;
 
+	/* Set when a conversion fits in the device buffer, so the callback
+	   data is converted there instead of copied in afterwards
+	 */
+	int convert_in_place;
+	int convert_out_in_place;
+
+	/* Rate conversion for ratios the conversion block can't do in fixed
+	   size buffers. The callback data goes through convert, then the
+	   resampler, then convert_out to the device format.
+	 */
+	struct SDL_Resampler *resampler;
+	SDL_AudioCVT convert_out;
+
+	/* The data given to SDL_QueueAudio(), if opened without a callback */
+	struct SDL_AudioQueue *queue;
+
+	/* The time taken to make each buffer, for SDL_GetAudioPeriodStats() */
+	SDL_SpinLock stats_lock;
+	Uint32 stats_periods;
+	Uint64 stats_total;
+	Uint64 stats_worst;
+
+	/* The callback writes the whole buffer, so it isn't cleared first */
+	int fills_buffer;
+
 	/* Current state flags */
 	int enabled;
 	int paused;
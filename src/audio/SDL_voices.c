@@ -0,0 +1,578 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A mixer for a fixed number of voices, used as the audio callback */
+
+#include "SDL_audio.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_voices_NEON.h"
+#include "SDL_voices_SSE2.h"
+
+/* The voice positions are in frames, with this many fraction bits */
+#define VOICE_FRAC_BITS	16
+#define VOICE_FRAC_MASK	((1 << VOICE_FRAC_BITS) - 1)
+
+/* Sample frames per output frame at the highest pitch */
+#define MAX_STEP	256
+
+/* Frames mixed at a time, the accumulator stays in the cache */
+#define MIX_CHUNK	512
+
+/* The accumulator holds samples times gains up to SDL_MIX_MAXVOLUME */
+#define MIX_SHIFT	7
+
+struct SDL_VoiceSample {
+	Sint16 *data;	/* 16 bit native, followed by a copy of the last frame */
+	Uint32 frames;
+	int channels;	/* 1 or 2 */
+	int freq;
+};
+
+typedef struct SDL_Voice {
+	SDL_VoiceSample *sample;	/* NULL when the voice is free */
+	Uint64 pos;
+	Uint32 step;
+	int loops;
+	int volume;
+	int pan;
+	double pitch;
+} SDL_Voice;
+
+struct SDL_VoiceMixer {
+	SDL_Voice voices[SDL_MIX_MAXVOICES];
+	int num_voices;
+	int freq;
+	int channels;
+	int frame_size;		/* in the callback format */
+	Sint32 accum[MIX_CHUNK * 2];
+	SDL_AudioCVT cvt;	/* from 16 bit native to the callback format */
+
+	/* SIMD versions of the loops or NULL, they do whole blocks of frames
+	   and the C loops do the rest */
+	int (*copy)(Sint32 *accum, const Sint16 *s, int channels,
+	            int mix_channels, int count, int left, int right);
+	int (*run)(Sint32 *accum, const Sint16 *data, int channels,
+	           int mix_channels, Uint64 *pos, Uint32 step, int count,
+	           int left, int right);
+	int (*clip)(const Sint32 *accum, Sint16 *out, int count);
+};
+
+static Uint32 SDL_VoiceStep(const SDL_VoiceMixer *mixer, const SDL_Voice *voice)
+{
+	double step;
+
+	if ( voice->sample == NULL ) {
+		return 0;
+	}
+	step = voice->pitch * voice->sample->freq / mixer->freq;
+	step *= (1 << VOICE_FRAC_BITS);
+	/* At least a fraction of a frame, at most MAX_STEP frames */
+	if ( step < 1.0 ) {
+		return 1;
+	}
+	if ( step > (double)(MAX_STEP << VOICE_FRAC_BITS) ) {
+		return MAX_STEP << VOICE_FRAC_BITS;
+	}
+	return (Uint32)step;
+}
+
+/* Interpolates between the sample frames around the position */
+#define INTERPOLATE(s, frac) \
+	((s)[0] + ((((s)[channels] - (s)[0]) * (frac)) >> (VOICE_FRAC_BITS - 1)))
+
+/* Adds 'count' frames of a voice playing at the output rate, from the
+   start of a frame, without interpolating */
+static void SDL_MixVoiceCopy(const SDL_VoiceMixer *mixer, SDL_Voice *voice,
+                             Sint32 *accum, int count, int left, int right)
+{
+	const int channels = voice->sample->channels;
+	const Sint16 *s = voice->sample->data +
+		channels * (Uint32)(voice->pos >> VOICE_FRAC_BITS);
+	int i = 0;
+
+	if ( mixer->copy ) {
+		i = mixer->copy(accum, s, channels, mixer->channels, count,
+		                left, right);
+	}
+
+	if ( channels == 1 && mixer->channels == 2 ) {
+		for ( ; i < count; ++i ) {
+			accum[2 * i] += s[i] * left;
+			accum[2 * i + 1] += s[i] * right;
+		}
+	} else if ( channels == 2 && mixer->channels == 2 ) {
+		for ( ; i < count; ++i ) {
+			accum[2 * i] += s[2 * i] * left;
+			accum[2 * i + 1] += s[2 * i + 1] * right;
+		}
+	} else if ( channels == 1 ) {
+		for ( ; i < count; ++i ) {
+			accum[i] += s[i] * left;
+		}
+	} else {
+		for ( ; i < count; ++i ) {
+			accum[i] += ((s[2 * i] + s[2 * i + 1]) * left) >> 1;
+		}
+	}
+	voice->pos += (Uint64)count << VOICE_FRAC_BITS;
+}
+
+/* Adds 'count' frames of the voice to the accumulator. The position stays
+   before the end of the sample, so the frame after it is the guard frame
+   at worst. Multiplications by the gains are summed unscaled.
+ */
+static void SDL_MixVoiceRun(const SDL_VoiceMixer *mixer, SDL_Voice *voice,
+                            Sint32 *accum, int count, int left, int right)
+{
+	const Sint16 *data = voice->sample->data;
+	const int channels = voice->sample->channels;
+	const Uint32 step = voice->step;
+	Uint64 pos = voice->pos;
+	int i = 0;
+
+	if ( mixer->run ) {
+		i = mixer->run(accum, data, channels, mixer->channels, &pos, step,
+		               count, left, right);
+		accum += i * mixer->channels;
+	}
+
+	if ( channels == 1 && mixer->channels == 2 ) {
+		for ( ; i < count; ++i ) {
+			const Sint16 *s = data + (Uint32)(pos >> VOICE_FRAC_BITS);
+			const int frac = (int)(pos & VOICE_FRAC_MASK) >> 1;
+			const int v = INTERPOLATE(s, frac);
+
+			accum[0] += v * left;
+			accum[1] += v * right;
+			accum += 2;
+			pos += step;
+		}
+	} else if ( channels == 2 && mixer->channels == 2 ) {
+		for ( ; i < count; ++i ) {
+			const Sint16 *s = data + 2 * (Uint32)(pos >> VOICE_FRAC_BITS);
+			const int frac = (int)(pos & VOICE_FRAC_MASK) >> 1;
+
+			accum[0] += INTERPOLATE(s, frac) * left;
+			accum[1] += INTERPOLATE(s + 1, frac) * right;
+			accum += 2;
+			pos += step;
+		}
+	} else if ( channels == 1 ) {
+		for ( ; i < count; ++i ) {
+			const Sint16 *s = data + (Uint32)(pos >> VOICE_FRAC_BITS);
+			const int frac = (int)(pos & VOICE_FRAC_MASK) >> 1;
+
+			*accum++ += INTERPOLATE(s, frac) * left;
+			pos += step;
+		}
+	} else {
+		/* Stereo sample to mono, the pan doesn't apply */
+		for ( ; i < count; ++i ) {
+			const Sint16 *s = data + 2 * (Uint32)(pos >> VOICE_FRAC_BITS);
+			const int frac = (int)(pos & VOICE_FRAC_MASK) >> 1;
+
+			*accum++ += ((INTERPOLATE(s, frac) +
+			              INTERPOLATE(s + 1, frac)) * left) >> 1;
+			pos += step;
+		}
+	}
+	voice->pos = pos;
+}
+
+static void SDL_MixVoice(SDL_VoiceMixer *mixer, SDL_Voice *voice, int frames)
+{
+	Sint32 *accum = mixer->accum;
+	int left, right;
+
+	/* Full volume on the near side, the far side fades out. Mono output
+	   only uses the left gain. */
+	left = right = voice->volume;
+	if ( mixer->channels == 2 ) {
+		if ( voice->pan > 0 ) {
+			left = (left * (SDL_MIX_MAXVOLUME - voice->pan)) / SDL_MIX_MAXVOLUME;
+		} else if ( voice->pan < 0 ) {
+			right = (right * (SDL_MIX_MAXVOLUME + voice->pan)) / SDL_MIX_MAXVOLUME;
+		}
+	}
+
+	while ( frames > 0 ) {
+		const Uint64 end = (Uint64)voice->sample->frames << VOICE_FRAC_BITS;
+		Uint64 left_frames;
+		int count;
+
+		/* Frames to the end of the sample, rounded up */
+		left_frames = (end - voice->pos + voice->step - 1) / voice->step;
+		count = (left_frames < (Uint64)frames) ? (int)left_frames : frames;
+		if ( voice->step == (1 << VOICE_FRAC_BITS) &&
+		     (voice->pos & VOICE_FRAC_MASK) == 0 ) {
+			SDL_MixVoiceCopy(mixer, voice, accum, count, left, right);
+		} else {
+			SDL_MixVoiceRun(mixer, voice, accum, count, left, right);
+		}
+		accum += count * mixer->channels;
+		frames -= count;
+
+		if ( voice->pos >= end ) {
+			if ( voice->loops == 0 ) {
+				voice->sample = NULL;
+				break;
+			}
+			if ( voice->loops > 0 ) {
+				--voice->loops;
+			}
+			voice->pos %= end;
+		}
+	}
+}
+
+/* The only clipping, from the accumulator to 16 bit samples */
+static void SDL_ClipVoices(const SDL_VoiceMixer *mixer, Sint16 *out, int count)
+{
+	const Sint32 *accum = mixer->accum;
+	int i = 0;
+
+	if ( mixer->clip ) {
+		i = mixer->clip(accum, out, count);
+	}
+	for ( ; i < count; ++i ) {
+		Sint32 v = accum[i] >> MIX_SHIFT;
+
+		if ( v > 32767 ) {
+			v = 32767;
+		} else if ( v < -32768 ) {
+			v = -32768;
+		}
+		out[i] = (Sint16)v;
+	}
+}
+
+void SDL_MixVoices(void *userdata, Uint8 *stream, int len)
+{
+	SDL_VoiceMixer *mixer = (SDL_VoiceMixer *)userdata;
+	int frames = len / mixer->frame_size;
+	int i;
+
+	while ( frames > 0 ) {
+		const int count = SDL_min(frames, MIX_CHUNK);
+		const int samples = count * mixer->channels;
+
+		SDL_memset(mixer->accum, 0, samples * sizeof(Sint32));
+		for ( i = 0; i < mixer->num_voices; ++i ) {
+			if ( mixer->voices[i].sample ) {
+				SDL_MixVoice(mixer, &mixer->voices[i], count);
+			}
+		}
+
+		if ( mixer->cvt.needed ) {
+			SDL_ClipVoices(mixer, (Sint16 *)mixer->cvt.buf, samples);
+			mixer->cvt.len = samples * sizeof(Sint16);
+			SDL_ConvertAudio(&mixer->cvt);
+			SDL_memcpy(stream, mixer->cvt.buf, mixer->cvt.len_cvt);
+		} else {
+			SDL_ClipVoices(mixer, (Sint16 *)stream, samples);
+		}
+		stream += count * mixer->frame_size;
+		frames -= count;
+	}
+}
+
+/* Picks the SIMD loops for the CPU, SDL_AUDIO_SIMD=0 keeps the C loops
+   like it does for the conversions */
+static void SDL_ChooseVoiceLoops(SDL_VoiceMixer *mixer)
+{
+#if SDL_VOICES_NEON || SDL_VOICES_SSE2
+	const char *env = SDL_getenv("SDL_AUDIO_SIMD");
+
+	if ( env && SDL_atoi(env) == 0 ) {
+		return;
+	}
+#endif
+#if SDL_VOICES_NEON
+	if ( SDL_HasARMNEON() ) {
+		mixer->copy = SDL_MixVoiceCopy_NEON;
+		mixer->run = SDL_MixVoiceRun_NEON;
+		mixer->clip = SDL_ClipVoices_NEON;
+		return;
+	}
+#endif
+#if SDL_VOICES_SSE2
+	if ( SDL_HasSSE2() ) {
+		mixer->copy = SDL_MixVoiceCopy_SSE2;
+		mixer->run = SDL_MixVoiceRun_SSE2;
+		mixer->clip = SDL_ClipVoices_SSE2;
+	}
+#endif
+}
+
+SDL_VoiceMixer *SDL_CreateVoiceMixer(const SDL_AudioSpec *spec, int voices)
+{
+	SDL_VoiceMixer *mixer;
+	int i;
+
+	if ( voices < 1 || voices > SDL_MIX_MAXVOICES ) {
+		SDL_SetError("Voice mixers have 1 to %d voices", SDL_MIX_MAXVOICES);
+		return(NULL);
+	}
+	if ( spec->channels != 1 && spec->channels != 2 ) {
+		SDL_SetError("1 (mono) and 2 (stereo) channels supported");
+		return(NULL);
+	}
+	mixer = (SDL_VoiceMixer *)SDL_malloc(sizeof(*mixer));
+	if ( mixer == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(mixer, 0, sizeof(*mixer));
+	mixer->num_voices = voices;
+	mixer->freq = spec->freq;
+	mixer->channels = spec->channels;
+	mixer->frame_size = ((spec->format & 0xFF) / 8) * spec->channels;
+	for ( i = 0; i < SDL_MIX_MAXVOICES; ++i ) {
+		mixer->voices[i].volume = SDL_MIX_MAXVOLUME;
+		mixer->voices[i].pitch = 1.0;
+	}
+	SDL_ChooseVoiceLoops(mixer);
+
+	if ( SDL_BuildAudioCVT(&mixer->cvt, AUDIO_S16SYS, spec->channels,
+	                       spec->freq, spec->format, spec->channels,
+	                       spec->freq) < 0 ) {
+		SDL_free(mixer);
+		return(NULL);
+	}
+	if ( mixer->cvt.needed ) {
+		mixer->cvt.buf = (Uint8 *)SDL_malloc(MIX_CHUNK * spec->channels *
+		                           sizeof(Sint16) * mixer->cvt.len_mult);
+		if ( mixer->cvt.buf == NULL ) {
+			SDL_free(mixer);
+			SDL_OutOfMemory();
+			return(NULL);
+		}
+	}
+	return(mixer);
+}
+
+void SDL_FreeVoiceMixer(SDL_VoiceMixer *mixer)
+{
+	if ( mixer ) {
+		if ( mixer->cvt.buf ) {
+			SDL_free(mixer->cvt.buf);
+		}
+		SDL_free(mixer);
+	}
+}
+
+SDL_VoiceSample *SDL_CreateVoiceSample(const Uint8 *buf, Uint32 len,
+                                       const SDL_AudioSpec *spec)
+{
+	SDL_VoiceSample *sample;
+	SDL_AudioCVT cvt;
+	const int channels = (spec->channels > 2) ? 2 : spec->channels;
+	int frame_size;
+
+	if ( spec->freq <= 0 || spec->channels == 0 ) {
+		SDL_SetError("Invalid sample frequency or channels");
+		return(NULL);
+	}
+	if ( SDL_BuildAudioCVT(&cvt, spec->format, spec->channels, spec->freq,
+	                       AUDIO_S16SYS, channels, spec->freq) < 0 ) {
+		return(NULL);
+	}
+	frame_size = channels * sizeof(Sint16);
+
+	sample = (SDL_VoiceSample *)SDL_malloc(sizeof(*sample));
+	if ( sample == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	/* Room for the conversion and the guard frame */
+	cvt.len = len;
+	cvt.buf = (Uint8 *)SDL_malloc(len * cvt.len_mult + frame_size);
+	if ( cvt.buf == NULL ) {
+		SDL_free(sample);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memcpy(cvt.buf, buf, len);
+	if ( SDL_ConvertAudio(&cvt) < 0 ) {
+		SDL_free(cvt.buf);
+		SDL_free(sample);
+		return(NULL);
+	}
+	sample->data = (Sint16 *)cvt.buf;
+	sample->frames = cvt.len_cvt / frame_size;
+	sample->channels = channels;
+	sample->freq = spec->freq;
+	if ( sample->frames == 0 ) {
+		SDL_memset(sample->data, 0, frame_size);
+	} else {
+		SDL_memcpy(sample->data + sample->frames * channels,
+		           sample->data + (sample->frames - 1) * channels,
+		           frame_size);
+	}
+	return(sample);
+}
+
+void SDL_FreeVoiceSample(SDL_VoiceSample *sample)
+{
+	if ( sample ) {
+		SDL_free(sample->data);
+		SDL_free(sample);
+	}
+}
+
+/* Finds the voices 'voice' stands for, -1 for all of them */
+static int SDL_GetVoiceRange(SDL_VoiceMixer *mixer, int voice,
+                             int *first, int *last)
+{
+	if ( voice == -1 ) {
+		*first = 0;
+		*last = mixer->num_voices - 1;
+	} else if ( voice >= 0 && voice < mixer->num_voices ) {
+		*first = *last = voice;
+	} else {
+		SDL_SetError("Invalid voice %d", voice);
+		return(-1);
+	}
+	return(0);
+}
+
+int SDL_PlayVoice(SDL_VoiceMixer *mixer, int voice, SDL_VoiceSample *sample,
+                  int loops)
+{
+	SDL_Voice *v;
+
+	if ( voice == -1 ) {
+		for ( voice = 0; voice < mixer->num_voices; ++voice ) {
+			if ( mixer->voices[voice].sample == NULL ) {
+				break;
+			}
+		}
+		if ( voice == mixer->num_voices ) {
+			SDL_SetError("No free voice");
+			return(-1);
+		}
+	} else if ( voice < 0 || voice >= mixer->num_voices ) {
+		SDL_SetError("Invalid voice %d", voice);
+		return(-1);
+	}
+	if ( sample->frames == 0 ) {
+		return(voice);
+	}
+
+	SDL_LockAudio();
+	v = &mixer->voices[voice];
+	v->sample = sample;
+	v->pos = 0;
+	v->loops = loops;
+	v->step = SDL_VoiceStep(mixer, v);
+	SDL_UnlockAudio();
+	return(voice);
+}
+
+int SDL_StopVoice(SDL_VoiceMixer *mixer, int voice)
+{
+	int first, last;
+
+	if ( SDL_GetVoiceRange(mixer, voice, &first, &last) < 0 ) {
+		return(-1);
+	}
+	SDL_LockAudio();
+	for ( voice = first; voice <= last; ++voice ) {
+		mixer->voices[voice].sample = NULL;
+	}
+	SDL_UnlockAudio();
+	return(0);
+}
+
+int SDL_SetVoiceVolume(SDL_VoiceMixer *mixer, int voice, int volume)
+{
+	int first, last;
+
+	if ( SDL_GetVoiceRange(mixer, voice, &first, &last) < 0 ) {
+		return(-1);
+	}
+	if ( volume < 0 ) {
+		volume = 0;
+	} else if ( volume > SDL_MIX_MAXVOLUME ) {
+		volume = SDL_MIX_MAXVOLUME;
+	}
+	SDL_LockAudio();
+	for ( voice = first; voice <= last; ++voice ) {
+		mixer->voices[voice].volume = volume;
+	}
+	SDL_UnlockAudio();
+	return(0);
+}
+
+int SDL_SetVoicePan(SDL_VoiceMixer *mixer, int voice, int pan)
+{
+	int first, last;
+
+	if ( SDL_GetVoiceRange(mixer, voice, &first, &last) < 0 ) {
+		return(-1);
+	}
+	if ( pan < -SDL_MIX_MAXVOLUME ) {
+		pan = -SDL_MIX_MAXVOLUME;
+	} else if ( pan > SDL_MIX_MAXVOLUME ) {
+		pan = SDL_MIX_MAXVOLUME;
+	}
+	SDL_LockAudio();
+	for ( voice = first; voice <= last; ++voice ) {
+		mixer->voices[voice].pan = pan;
+	}
+	SDL_UnlockAudio();
+	return(0);
+}
+
+int SDL_SetVoicePitch(SDL_VoiceMixer *mixer, int voice, double pitch)
+{
+	int first, last;
+
+	if ( SDL_GetVoiceRange(mixer, voice, &first, &last) < 0 ) {
+		return(-1);
+	}
+	SDL_LockAudio();
+	for ( voice = first; voice <= last; ++voice ) {
+		SDL_Voice *v = &mixer->voices[voice];
+
+		v->pitch = pitch;
+		v->step = SDL_VoiceStep(mixer, v);
+	}
+	SDL_UnlockAudio();
+	return(0);
+}
+
+int SDL_VoicePlaying(SDL_VoiceMixer *mixer, int voice)
+{
+	int first, last, playing = 0;
+
+	if ( SDL_GetVoiceRange(mixer, voice, &first, &last) < 0 ) {
+		return(0);
+	}
+	for ( voice = first; voice <= last; ++voice ) {
+		if ( mixer->voices[voice].sample ) {
+			++playing;
+		}
+	}
+	return(playing);
+}
@@ -0,0 +1,176 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_audio.h"
+#include "SDL_voices_NEON.h"
+
+#if SDL_VOICES_NEON
+
+/* NEON voice mixing, 4 frames at a time in 32 bit lanes.
+
+   The copies widen the samples and multiply-accumulate them with the
+   gains.  The sample frames around the positions of a run are gathered
+   one frame at a time, NEON can't, then interpolated and accumulated
+   4 frames at once.  The clip is a saturating narrowing shift.
+*/
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#else
+#include "../cpuinfo/SDL_neon_emu.h"
+#endif
+
+#define VOICE_FRAC_BITS	16	/* as in SDL_voices.c */
+#define VOICE_FRAC_MASK	((1 << VOICE_FRAC_BITS) - 1)
+#define MIX_SHIFT	7
+
+/* The gains of the left and right channel for two stereo frames */
+static __inline__ int32x4_t StereoGains(int left, int right)
+{
+	Sint32 gains[4];
+
+	gains[0] = gains[2] = left;
+	gains[1] = gains[3] = right;
+	return vld1q_s32(gains);
+}
+
+/* Adds mono samples times the gains to the accumulator, stereo or mono */
+static __inline__ void AccumulateMono(Sint32 *accum, int32x4_t v,
+                                      int mix_channels, int32x4_t gains)
+{
+	if ( mix_channels == 2 ) {
+		const int32x4x2_t z = vzipq_s32(v, v);
+
+		vst1q_s32(accum, vmlaq_s32(vld1q_s32(accum), z.val[0], gains));
+		vst1q_s32(accum + 4, vmlaq_s32(vld1q_s32(accum + 4), z.val[1], gains));
+	} else {
+		vst1q_s32(accum, vmlaq_s32(vld1q_s32(accum), v, gains));
+	}
+}
+
+/* Adds stereo samples, one vector per channel, to the accumulator. The
+   pan doesn't apply to a mono mix.
+ */
+static __inline__ void AccumulateStereo(Sint32 *accum, int32x4_t l,
+                                        int32x4_t r, int mix_channels,
+                                        int32x4_t gains)
+{
+	if ( mix_channels == 2 ) {
+		const int32x4x2_t z = vzipq_s32(l, r);
+
+		vst1q_s32(accum, vmlaq_s32(vld1q_s32(accum), z.val[0], gains));
+		vst1q_s32(accum + 4, vmlaq_s32(vld1q_s32(accum + 4), z.val[1], gains));
+	} else {
+		const int32x4_t v = vshrq_n_s32(vmulq_s32(vaddq_s32(l, r), gains), 1);
+
+		vst1q_s32(accum, vaddq_s32(vld1q_s32(accum), v));
+	}
+}
+
+int SDL_MixVoiceCopy_NEON(Sint32 *accum, const Sint16 *s, int channels,
+                          int mix_channels, int count, int left, int right)
+{
+	const int32x4_t gains = (mix_channels == 2) ? StereoGains(left, right)
+	                                            : vdupq_n_s32(left);
+	int i;
+
+	count &= ~3;
+	for ( i = 0; i < count; i += 4 ) {
+		if ( channels == 1 ) {
+			AccumulateMono(accum + mix_channels * i, vmovl_s16(vld1_s16(s + i)),
+			               mix_channels, gains);
+		} else {
+			const int16x4x2_t v = vld2_s16(s + 2 * i);
+
+			AccumulateStereo(accum + mix_channels * i, vmovl_s16(v.val[0]),
+			                 vmovl_s16(v.val[1]), mix_channels, gains);
+		}
+	}
+	return count;
+}
+
+/* Interpolates like the INTERPOLATE macro of SDL_voices.c */
+static __inline__ int32x4_t Interpolate(const Sint32 *s0, const Sint32 *s1,
+                                        const Sint32 *frac)
+{
+	const int32x4_t a = vld1q_s32(s0);
+	const int32x4_t d = vmulq_s32(vsubq_s32(vld1q_s32(s1), a), vld1q_s32(frac));
+
+	return vaddq_s32(a, vshrq_n_s32(d, VOICE_FRAC_BITS - 1));
+}
+
+int SDL_MixVoiceRun_NEON(Sint32 *accum, const Sint16 *data, int channels,
+                         int mix_channels, Uint64 *pos, Uint32 step,
+                         int count, int left, int right)
+{
+	const int32x4_t gains = (mix_channels == 2) ? StereoGains(left, right)
+	                                            : vdupq_n_s32(left);
+	Uint64 p = *pos;
+	int i, j;
+
+	count &= ~3;
+	for ( i = 0; i < count; i += 4 ) {
+		/* The sample frames around the positions, a channel per row */
+		Sint32 s0[2][4], s1[2][4], frac[4];
+
+		for ( j = 0; j < 4; ++j ) {
+			const Sint16 *s = data + channels * (Uint32)(p >> VOICE_FRAC_BITS);
+
+			s0[0][j] = s[0];
+			s1[0][j] = s[channels];
+			if ( channels == 2 ) {
+				s0[1][j] = s[1];
+				s1[1][j] = s[3];
+			}
+			frac[j] = (int)(p & VOICE_FRAC_MASK) >> 1;
+			p += step;
+		}
+		if ( channels == 1 ) {
+			AccumulateMono(accum + mix_channels * i,
+			               Interpolate(s0[0], s1[0], frac),
+			               mix_channels, gains);
+		} else {
+			AccumulateStereo(accum + mix_channels * i,
+			                 Interpolate(s0[0], s1[0], frac),
+			                 Interpolate(s0[1], s1[1], frac),
+			                 mix_channels, gains);
+		}
+	}
+	*pos = p;
+	return count;
+}
+
+int SDL_ClipVoices_NEON(const Sint32 *accum, Sint16 *out, int count)
+{
+	int i;
+
+	count &= ~7;
+	for ( i = 0; i < count; i += 8 ) {
+		vst1q_s16(out + i,
+		          vcombine_s16(vqshrn_n_s32(vld1q_s32(accum + i), MIX_SHIFT),
+		                       vqshrn_n_s32(vld1q_s32(accum + i + 4), MIX_SHIFT)));
+	}
+	return count;
+}
+
+#endif /* SDL_VOICES_NEON */
@@ -0,0 +1,46 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* NEON versions of the voice mixer loops, see SDL_voices_NEON.c */
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SDL_VOICES_NEON	1
+#elif SDL_ARM_NEON_EMULATION
+/* Built with the portable stand-ins of SDL_neon_emu.h, for testing */
+#define SDL_VOICES_NEON	1
+#endif
+
+#if SDL_VOICES_NEON
+
+/* The loops of SDL_voices.c, 4 frames at a time.  They take the same
+   arguments, with 'channels' the channels of the sample and 'mix_channels'
+   those of the mixer, and return the frames they mixed, a multiple of 4.
+   The C loops mix the rest.  SDL_MixVoiceRun_*() advances '*pos' past the
+   frames it mixed, and SDL_ClipVoices_*() clips a multiple of 8 samples.
+   The accumulator and the output match the C loops.
+ */
+extern int SDL_MixVoiceCopy_NEON(Sint32 *accum, const Sint16 *s, int channels, int mix_channels, int count, int left, int right);
+extern int SDL_MixVoiceRun_NEON(Sint32 *accum, const Sint16 *data, int channels, int mix_channels, Uint64 *pos, Uint32 step, int count, int left, int right);
+extern int SDL_ClipVoices_NEON(const Sint32 *accum, Sint16 *out, int count);
+
+#endif /* SDL_VOICES_NEON */
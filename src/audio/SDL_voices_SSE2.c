@@ -0,0 +1,199 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_audio.h"
+#include "SDL_voices_SSE2.h"
+
+#if SDL_VOICES_SSE2
+
+/* SSE2 voice mixing, the same arithmetic as SDL_voices_NEON.c.
+
+   SSE2 has no 32 bit multiply, but the samples and gains fit in 16 bits,
+   so _mm_madd_epi16 does the products.  With the gain in the low half of
+   a 32 bit lane and 0 in the high half, the madd is the sample in the low
+   half times the gain.  Interpolating is s0 * (32767 - frac) + s1 * frac
+   + s0, one madd of the pair of sample frames and the pair of weights.
+*/
+
+#include <emmintrin.h>
+
+#define VOICE_FRAC_BITS	16	/* as in SDL_voices.c */
+#define VOICE_FRAC_MASK	((1 << VOICE_FRAC_BITS) - 1)
+#define MIX_SHIFT	7
+
+/* The gains of the left and right channel for two stereo frames */
+#define STEREO_GAINS(left, right)	_mm_set_epi32(right, left, right, left)
+
+/* Interpolates the 16 bit pairs of sample frames in 'pairs' with the
+   fractions, 15 bits, in 'frac'
+ */
+static __inline__ __m128i Interpolate(__m128i pairs, __m128i frac)
+{
+	const __m128i weights = _mm_or_si128(_mm_slli_epi32(frac, 16),
+	                        _mm_sub_epi32(_mm_set1_epi32(32767), frac));
+	const __m128i s0 = _mm_srai_epi32(_mm_slli_epi32(pairs, 16), 16);
+
+	return _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(pairs, weights), s0),
+	                      VOICE_FRAC_BITS - 1);
+}
+
+/* Adds the samples in 'v' times the gains to 4 accumulator samples */
+static __inline__ void Accumulate(Sint32 *accum, __m128i v, __m128i gains)
+{
+	_mm_storeu_si128((__m128i *)accum,
+	                 _mm_add_epi32(_mm_loadu_si128((const __m128i *)accum),
+	                               _mm_madd_epi16(v, gains)));
+}
+
+int SDL_MixVoiceCopy_SSE2(Sint32 *accum, const Sint16 *s, int channels,
+                          int mix_channels, int count, int left, int right)
+{
+	const __m128i gains = STEREO_GAINS(left, right);
+	const __m128i gain = _mm_set1_epi32(left);
+	int i;
+
+	count &= ~3;
+	for ( i = 0; i < count; i += 4 ) {
+		__m128i v;
+
+		if ( channels == 1 ) {
+			v = _mm_loadl_epi64((const __m128i *)(s + i));
+			v = _mm_unpacklo_epi16(v, v);
+			if ( mix_channels == 2 ) {
+				Accumulate(accum + 2 * i, _mm_unpacklo_epi32(v, v), gains);
+				Accumulate(accum + 2 * i + 4, _mm_unpackhi_epi32(v, v), gains);
+			} else {
+				Accumulate(accum + i, v, gain);
+			}
+		} else {
+			v = _mm_loadu_si128((const __m128i *)(s + 2 * i));
+			if ( mix_channels == 2 ) {
+				Accumulate(accum + 2 * i, _mm_unpacklo_epi16(v, v), gains);
+				Accumulate(accum + 2 * i + 4, _mm_unpackhi_epi16(v, v), gains);
+			} else {
+				/* Both channels times the gain, summed by the madd */
+				v = _mm_srai_epi32(_mm_madd_epi16(v, _mm_set1_epi16((short)left)), 1);
+				_mm_storeu_si128((__m128i *)(accum + i),
+				                 _mm_add_epi32(_mm_loadu_si128((const __m128i *)(accum + i)), v));
+			}
+		}
+	}
+	return count;
+}
+
+/* Inserts the pairs of samples of the frame at the position into 32 bit
+   lane 'lane' of 'v', and the right channel of stereo into the lane after
+   it, then steps to the next position.  The lanes have to be constants.
+ */
+#define INSERT_PAIR(v, s, channels, lane) \
+	v = _mm_insert_epi16(_mm_insert_epi16(v, (s)[0], 2 * (lane)), \
+	                     (s)[channels], 2 * (lane) + 1)
+#define INSERT_MONO(v, lane) \
+	s = data + (Uint32)(p >> VOICE_FRAC_BITS); \
+	INSERT_PAIR(v, s, 1, lane); \
+	p += step
+#define INSERT_STEREO(v, lane) \
+	s = data + 2 * (Uint32)(p >> VOICE_FRAC_BITS); \
+	INSERT_PAIR(v, s, 2, lane); \
+	INSERT_PAIR(v, s + 1, 2, (lane) + 1); \
+	p += step
+
+int SDL_MixVoiceRun_SSE2(Sint32 *accum, const Sint16 *data, int channels,
+                         int mix_channels, Uint64 *pos, Uint32 step,
+                         int count, int left, int right)
+{
+	const __m128i gains = STEREO_GAINS(left, right);
+	const __m128i gain = _mm_set1_epi32(left);
+	const __m128i mask = _mm_set1_epi32(VOICE_FRAC_MASK);
+	const __m128i step4 = _mm_set1_epi32((int)(4 * step));
+	/* The low 32 bits of the positions of the next 4 frames, enough for
+	   the fractions */
+	__m128i low = _mm_add_epi32(_mm_set1_epi32((int)(Uint32)*pos),
+	                            _mm_set_epi32((int)(3 * step), (int)(2 * step),
+	                                          (int)step, 0));
+	Uint64 p = *pos;
+	const Sint16 *s;
+	int i;
+
+	/* SSE2 has no gather, the sample frames are inserted one by one */
+	count &= ~3;
+	for ( i = 0; i < count; i += 4 ) {
+		const __m128i frac = _mm_srli_epi32(_mm_and_si128(low, mask), 1);
+		__m128i v = _mm_setzero_si128(), w = _mm_setzero_si128();
+
+		low = _mm_add_epi32(low, step4);
+		if ( channels == 1 ) {
+			INSERT_MONO(v, 0);
+			INSERT_MONO(v, 1);
+			INSERT_MONO(v, 2);
+			INSERT_MONO(v, 3);
+			v = Interpolate(v, frac);
+			if ( mix_channels == 2 ) {
+				Accumulate(accum + 2 * i, _mm_unpacklo_epi32(v, v), gains);
+				Accumulate(accum + 2 * i + 4, _mm_unpackhi_epi32(v, v), gains);
+			} else {
+				Accumulate(accum + i, v, gain);
+			}
+		} else {
+			/* Left and right pairs, with each frame's fraction twice */
+			INSERT_STEREO(v, 0);
+			INSERT_STEREO(v, 2);
+			INSERT_STEREO(w, 0);
+			INSERT_STEREO(w, 2);
+			v = Interpolate(v, _mm_unpacklo_epi32(frac, frac));
+			w = Interpolate(w, _mm_unpackhi_epi32(frac, frac));
+			if ( mix_channels == 2 ) {
+				Accumulate(accum + 2 * i, v, gains);
+				Accumulate(accum + 2 * i + 4, w, gains);
+			} else {
+				/* Stereo sample to mono, the pan doesn't apply */
+				v = _mm_madd_epi16(_mm_packs_epi32(v, w),
+				                   _mm_set1_epi16((short)left));
+				_mm_storeu_si128((__m128i *)(accum + i),
+				                 _mm_add_epi32(_mm_loadu_si128((const __m128i *)(accum + i)),
+				                               _mm_srai_epi32(v, 1)));
+			}
+		}
+	}
+	*pos = p;
+	return count;
+}
+
+/* The saturating pack clips like the C code */
+int SDL_ClipVoices_SSE2(const Sint32 *accum, Sint16 *out, int count)
+{
+	int i;
+
+	count &= ~7;
+	for ( i = 0; i < count; i += 8 ) {
+		const __m128i a = _mm_loadu_si128((const __m128i *)(accum + i));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(accum + i + 4));
+
+		_mm_storeu_si128((__m128i *)(out + i),
+		                 _mm_packs_epi32(_mm_srai_epi32(a, MIX_SHIFT),
+		                                 _mm_srai_epi32(b, MIX_SHIFT)));
+	}
+	return count;
+}
+
+#endif /* SDL_VOICES_SSE2 */
@@ -0,0 +1,39 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* SSE2 versions of the voice mixer loops, see SDL_voices_SSE2.c */
+
+#if SDL_ASSEMBLY_ROUTINES && \
+    ((defined(__GNUC__) && defined(__SSE2__)) || \
+     (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+#define SDL_VOICES_SSE2	1
+#endif
+
+#if SDL_VOICES_SSE2
+
+/* Same contract as the NEON functions in SDL_voices_NEON.h */
+extern int SDL_MixVoiceCopy_SSE2(Sint32 *accum, const Sint16 *s, int channels, int mix_channels, int count, int left, int right);
+extern int SDL_MixVoiceRun_SSE2(Sint32 *accum, const Sint16 *data, int channels, int mix_channels, Uint64 *pos, Uint32 step, int count, int left, int right);
+extern int SDL_ClipVoices_SSE2(const Sint32 *accum, Sint16 *out, int count);
+
+#endif /* SDL_VOICES_SSE2 */
@@ -45,6 +45,7 @@
 #define DISKDEFAULT_OUTFILE      "sdlaudio.raw"
 #define DISKENVR_WRITEDELAY      "SDL_DISKAUDIODELAY"
 #define DISKDEFAULT_WRITEDELAY   150
+#define DISKENVR_CHANNELS        "SDL_DISKAUDIOCHANNELS"
 
 /* Audio driver functions */
 static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec);
@@ -160,6 +161,13 @@ static void DISKAUD_CloseAudio(_THIS)
 static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 {
 	const char *fname = DISKAUD_GetOutputFilename();
+	const char *envr = SDL_getenv(DISKENVR_CHANNELS);
+
+	/* Write a fixed number of channels, if asked to */
+	if ( envr && SDL_atoi(envr) > 0 ) {
+		spec->channels = (Uint8)SDL_atoi(envr);
+		SDL_CalculateAudioSpec(spec);
+	}
 
 	/* Open the audio device */
 	this->hidden->output = SDL_RWFromFile(fname, "wb");
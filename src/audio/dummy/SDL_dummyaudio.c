@@ -36,6 +36,12 @@
 /* The tag name used by DUMMY audio */
 #define DUMMYAUD_DRIVER_NAME         "dummy"
 
+/* environment variables, to play like a device with a fixed number of
+   channels, or faster or slower than real time.
+ */
+#define DUMMYENVR_CHANNELS           "SDL_DUMMYAUDIOCHANNELS"
+#define DUMMYENVR_WRITEDELAY         "SDL_DUMMYAUDIODELAY"
+
 /* Audio driver functions */
 static int DUMMYAUD_OpenAudio(_THIS, SDL_AudioSpec *spec);
 static void DUMMYAUD_WaitAudio(_THIS);
@@ -127,6 +133,13 @@ static void DUMMYAUD_CloseAudio(_THIS)
 static int DUMMYAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 {
 	float bytes_per_sec = 0.0f;
+	const char *envr;
+
+	envr = SDL_getenv(DUMMYENVR_CHANNELS);
+	if ( envr && SDL_atoi(envr) > 0 ) {
+		spec->channels = (Uint8)SDL_atoi(envr);
+		SDL_CalculateAudioSpec(spec);
+	}
 
 	/* Allocate mixing buffer */
 	this->hidden->mixlen = spec->size;
@@ -149,6 +162,10 @@ static int DUMMYAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	this->hidden->initial_calls = 2;
 	this->hidden->write_delay =
 	               (Uint32) ((((float) spec->size) / bytes_per_sec) * 1000.0f);
+	envr = SDL_getenv(DUMMYENVR_WRITEDELAY);
+	if ( envr ) {
+		this->hidden->write_delay = SDL_atoi(envr);
+	}
 
 	/* We're ready to rock and roll. :-) */
 	return(0);
@@ -60,19 +60,6 @@ static int PSP2AUD_Available(void)
 	return(1);
 }
 
-static void PSP2AUD_ThreadInit(_THIS)
-{
-    /* Increase the priority of this audio thread by 1 to put it
-       ahead of other SDL threads. */
-    SceUID thid;
-    SceKernelThreadInfo info;
-    thid = sceKernelGetThreadId();
-    info.size = sizeof(SceKernelThreadInfo);
-    if (sceKernelGetThreadInfo(thid, &info) == 0) {
-        sceKernelChangeThreadPriority(thid, info.currentPriority - 1);
-    }
-}
-
 static void PSP2AUD_DeleteDevice(SDL_AudioDevice *device)
 {
 	SDL_free(device->hidden);
@@ -105,7 +92,6 @@ static SDL_AudioDevice *PSP2AUD_CreateDevice(int devindex)
 	this->PlayAudio = PSP2AUD_PlayAudio;
 	this->GetAudioBuf = PSP2AUD_GetAudioBuf;
 	this->CloseAudio = PSP2AUD_CloseAudio;
-	this->ThreadInit = PSP2AUD_ThreadInit;
 
 	this->free = PSP2AUD_DeleteDevice;
 
@@ -165,6 +151,23 @@ static int PSP2AUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
             return -1;
     }
 
+    /* The hardware plays only these rates, SDL resamples anything else */
+    switch (spec->freq) {
+        case 8000:
+        case 11025:
+        case 12000:
+        case 16000:
+        case 22050:
+        case 24000:
+        case 32000:
+        case 44100:
+        case 48000:
+            break;
+        default:
+            spec->freq = 48000;
+            break;
+    }
+
     /* The sample count must be a multiple of 64. */
     spec->samples = SCE_AUDIO_SAMPLE_ALIGN(spec->samples);
 
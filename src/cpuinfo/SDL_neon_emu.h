@@ -0,0 +1,887 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/* Portable C stand-ins for the NEON intrinsics used by the SIMD code in
+   src/video and src/audio, with the same lane by lane results. Building that code with
+   SDL_ARM_NEON_EMULATION on a host without NEON lets the tests compare it
+   against the C functions. It is not meant to be fast.
+*/
+
+#ifndef _SDL_neon_emu_h
+#define _SDL_neon_emu_h
+
+#include "SDL_stdinc.h"
+
+typedef struct { Uint8 lane[8]; } uint8x8_t;
+typedef struct { Uint8 lane[16]; } uint8x16_t;
+typedef struct { Sint8 lane[8]; } int8x8_t;
+typedef struct { Sint8 lane[16]; } int8x16_t;
+typedef struct { Uint16 lane[4]; } uint16x4_t;
+typedef struct { Uint16 lane[8]; } uint16x8_t;
+typedef struct { Sint16 lane[4]; } int16x4_t;
+typedef struct { Sint16 lane[8]; } int16x8_t;
+typedef struct { Uint32 lane[4]; } uint32x4_t;
+typedef struct { Sint32 lane[4]; } int32x4_t;
+typedef struct { uint8x8_t val[2]; } uint8x8x2_t;
+typedef struct { uint8x8_t val[4]; } uint8x8x4_t;
+typedef struct { uint16x8_t val[2]; } uint16x8x2_t;
+typedef struct { int16x8_t val[2]; } int16x8x2_t;
+typedef struct { int16x4_t val[2]; } int16x4x2_t;
+typedef struct { int32x4_t val[2]; } int32x4x2_t;
+typedef struct { uint8x16_t val[2]; } uint8x16x2_t;
+typedef struct { uint16x8_t val[3]; } uint16x8x3_t;
+typedef struct { uint32x4_t val[3]; } uint32x4x3_t;
+
+/* Loads, stores and lane shuffles */
+
+static __inline__ uint8x8_t vdup_n_u8(Uint8 value)
+{
+	uint8x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = value;
+	return r;
+}
+
+static __inline__ uint16x4_t vdup_n_u16(Uint16 value)
+{
+	uint16x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = value;
+	return r;
+}
+
+static __inline__ uint8x8_t vld1_u8(const Uint8 *p)
+{
+	uint8x8_t r;
+	SDL_memcpy(r.lane, p, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint8x16_t vld1q_u8(const Uint8 *p)
+{
+	uint8x16_t r;
+	SDL_memcpy(r.lane, p, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint8x8x4_t vld4_u8(const Uint8 *p)
+{
+	uint8x8x4_t r;
+	int i, j;
+	for ( i = 0; i < 8; ++i ) {
+		for ( j = 0; j < 4; ++j ) r.val[j].lane[i] = p[4 * i + j];
+	}
+	return r;
+}
+
+static __inline__ void vst1q_u16(Uint16 *p, uint16x8_t v)
+{
+	SDL_memcpy(p, v.lane, sizeof(v.lane));
+}
+
+static __inline__ void vst4_u8(Uint8 *p, uint8x8x4_t v)
+{
+	int i, j;
+	for ( i = 0; i < 8; ++i ) {
+		for ( j = 0; j < 4; ++j ) p[4 * i + j] = v.val[j].lane[i];
+	}
+}
+
+static __inline__ uint16x8_t vld1q_u16(const Uint16 *p)
+{
+	uint16x8_t r;
+	SDL_memcpy(r.lane, p, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ int16x4_t vld1_s16(const Sint16 *p)
+{
+	int16x4_t r;
+	SDL_memcpy(r.lane, p, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ void vst1q_s16(Sint16 *p, int16x8_t v)
+{
+	SDL_memcpy(p, v.lane, sizeof(v.lane));
+}
+
+static __inline__ int32x4_t vld1q_s32(const Sint32 *p)
+{
+	int32x4_t r;
+	SDL_memcpy(r.lane, p, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ void vst1q_s32(Sint32 *p, int32x4_t v)
+{
+	SDL_memcpy(p, v.lane, sizeof(v.lane));
+}
+
+static __inline__ int16x4x2_t vld2_s16(const Sint16 *p)
+{
+	int16x4x2_t r;
+	int i, j;
+	for ( i = 0; i < 4; ++i ) {
+		for ( j = 0; j < 2; ++j ) r.val[j].lane[i] = p[2 * i + j];
+	}
+	return r;
+}
+
+static __inline__ uint8x16x2_t vld2q_u8(const Uint8 *p)
+{
+	uint8x16x2_t r;
+	int i, j;
+	for ( i = 0; i < 16; ++i ) {
+		for ( j = 0; j < 2; ++j ) r.val[j].lane[i] = p[2 * i + j];
+	}
+	return r;
+}
+
+static __inline__ uint16x8x2_t vld2q_u16(const Uint16 *p)
+{
+	uint16x8x2_t r;
+	int i, j;
+	for ( i = 0; i < 8; ++i ) {
+		for ( j = 0; j < 2; ++j ) r.val[j].lane[i] = p[2 * i + j];
+	}
+	return r;
+}
+
+static __inline__ uint16x8x3_t vld3q_u16(const Uint16 *p)
+{
+	uint16x8x3_t r;
+	int i, j;
+	for ( i = 0; i < 8; ++i ) {
+		for ( j = 0; j < 3; ++j ) r.val[j].lane[i] = p[3 * i + j];
+	}
+	return r;
+}
+
+static __inline__ uint32x4x3_t vld3q_u32(const Uint32 *p)
+{
+	uint32x4x3_t r;
+	int i, j;
+	for ( i = 0; i < 4; ++i ) {
+		for ( j = 0; j < 3; ++j ) r.val[j].lane[i] = p[3 * i + j];
+	}
+	return r;
+}
+
+static __inline__ void vst2q_u8(Uint8 *p, uint8x16x2_t v)
+{
+	int i, j;
+	for ( i = 0; i < 16; ++i ) {
+		for ( j = 0; j < 2; ++j ) p[2 * i + j] = v.val[j].lane[i];
+	}
+}
+
+static __inline__ void vst2q_u16(Uint16 *p, uint16x8x2_t v)
+{
+	int i, j;
+	for ( i = 0; i < 8; ++i ) {
+		for ( j = 0; j < 2; ++j ) p[2 * i + j] = v.val[j].lane[i];
+	}
+}
+
+static __inline__ void vst3q_u16(Uint16 *p, uint16x8x3_t v)
+{
+	int i, j;
+	for ( i = 0; i < 8; ++i ) {
+		for ( j = 0; j < 3; ++j ) p[3 * i + j] = v.val[j].lane[i];
+	}
+}
+
+static __inline__ void vst3q_u32(Uint32 *p, uint32x4x3_t v)
+{
+	int i, j;
+	for ( i = 0; i < 4; ++i ) {
+		for ( j = 0; j < 3; ++j ) p[3 * i + j] = v.val[j].lane[i];
+	}
+}
+
+static __inline__ uint8x16_t vdupq_n_u8(Uint8 value)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = value;
+	return r;
+}
+
+static __inline__ int16x8_t vdupq_n_s16(Sint16 value)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = value;
+	return r;
+}
+
+static __inline__ int32x4_t vdupq_n_s32(Sint32 value)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = value;
+	return r;
+}
+
+static __inline__ void vst1q_u8(Uint8 *p, uint8x16_t v)
+{
+	SDL_memcpy(p, v.lane, sizeof(v.lane));
+}
+
+static __inline__ uint8x8_t vget_low_u8(uint8x16_t v)
+{
+	uint8x8_t r;
+	SDL_memcpy(r.lane, &v.lane[0], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint8x8_t vget_high_u8(uint8x16_t v)
+{
+	uint8x8_t r;
+	SDL_memcpy(r.lane, &v.lane[8], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint16x4_t vget_low_u16(uint16x8_t v)
+{
+	uint16x4_t r;
+	SDL_memcpy(r.lane, &v.lane[0], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint16x4_t vget_high_u16(uint16x8_t v)
+{
+	uint16x4_t r;
+	SDL_memcpy(r.lane, &v.lane[4], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ int8x8_t vget_low_s8(int8x16_t v)
+{
+	int8x8_t r;
+	SDL_memcpy(r.lane, &v.lane[0], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ int8x8_t vget_high_s8(int8x16_t v)
+{
+	int8x8_t r;
+	SDL_memcpy(r.lane, &v.lane[8], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ int16x4_t vget_low_s16(int16x8_t v)
+{
+	int16x4_t r;
+	SDL_memcpy(r.lane, &v.lane[0], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ int16x4_t vget_high_s16(int16x8_t v)
+{
+	int16x4_t r;
+	SDL_memcpy(r.lane, &v.lane[4], sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint8x16_t vcombine_u8(uint8x8_t lo, uint8x8_t hi)
+{
+	uint8x16_t r;
+	SDL_memcpy(&r.lane[0], lo.lane, sizeof(lo.lane));
+	SDL_memcpy(&r.lane[8], hi.lane, sizeof(hi.lane));
+	return r;
+}
+
+static __inline__ int8x16_t vcombine_s8(int8x8_t lo, int8x8_t hi)
+{
+	int8x16_t r;
+	SDL_memcpy(&r.lane[0], lo.lane, sizeof(lo.lane));
+	SDL_memcpy(&r.lane[8], hi.lane, sizeof(hi.lane));
+	return r;
+}
+
+static __inline__ int16x8_t vcombine_s16(int16x4_t lo, int16x4_t hi)
+{
+	int16x8_t r;
+	SDL_memcpy(&r.lane[0], lo.lane, sizeof(lo.lane));
+	SDL_memcpy(&r.lane[4], hi.lane, sizeof(hi.lane));
+	return r;
+}
+
+static __inline__ uint16x8_t vcombine_u16(uint16x4_t lo, uint16x4_t hi)
+{
+	uint16x8_t r;
+	SDL_memcpy(&r.lane[0], lo.lane, sizeof(lo.lane));
+	SDL_memcpy(&r.lane[4], hi.lane, sizeof(hi.lane));
+	return r;
+}
+
+static __inline__ uint8x8x2_t vzip_u8(uint8x8_t a, uint8x8_t b)
+{
+	uint8x8x2_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.val[i / 4].lane[(2 * i) % 8] = a.lane[i];
+		r.val[i / 4].lane[(2 * i) % 8 + 1] = b.lane[i];
+	}
+	return r;
+}
+
+static __inline__ uint8x16x2_t vzipq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16x2_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) {
+		r.val[i / 8].lane[(2 * i) % 16] = a.lane[i];
+		r.val[i / 8].lane[(2 * i) % 16 + 1] = b.lane[i];
+	}
+	return r;
+}
+
+/* Swaps the bytes of each 16 bit lane */
+static __inline__ uint8x16_t vrev16q_u8(uint8x16_t v)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = v.lane[i ^ 1];
+	return r;
+}
+
+static __inline__ uint16x8x2_t vzipq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8x2_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.val[i / 4].lane[(2 * i) % 8] = a.lane[i];
+		r.val[i / 4].lane[(2 * i) % 8 + 1] = b.lane[i];
+	}
+	return r;
+}
+
+static __inline__ int16x8x2_t vzipq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8x2_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.val[i / 4].lane[(2 * i) % 8] = a.lane[i];
+		r.val[i / 4].lane[(2 * i) % 8 + 1] = b.lane[i];
+	}
+	return r;
+}
+
+static __inline__ int32x4x2_t vzipq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4x2_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) {
+		r.val[i / 2].lane[(2 * i) % 4] = a.lane[i];
+		r.val[i / 2].lane[(2 * i) % 4 + 1] = b.lane[i];
+	}
+	return r;
+}
+
+static __inline__ int16x8_t vreinterpretq_s16_u16(uint16x8_t v)
+{
+	int16x8_t r;
+	SDL_memcpy(r.lane, v.lane, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint16x8_t vreinterpretq_u16_s16(int16x8_t v)
+{
+	uint16x8_t r;
+	SDL_memcpy(r.lane, v.lane, sizeof(r.lane));
+	return r;
+}
+
+/* Byte vectors in memory order, the lanes are little endian like on the
+   psp2 */
+static __inline__ int8x16_t vreinterpretq_s8_u8(uint8x16_t v)
+{
+	int8x16_t r;
+	SDL_memcpy(r.lane, v.lane, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ uint8x16_t vreinterpretq_u8_s8(int8x16_t v)
+{
+	uint8x16_t r;
+	SDL_memcpy(r.lane, v.lane, sizeof(r.lane));
+	return r;
+}
+
+static __inline__ int16x8_t vreinterpretq_s16_u8(uint8x16_t v)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.lane[i] = (Sint16)(v.lane[2 * i] | (v.lane[2 * i + 1] << 8));
+	}
+	return r;
+}
+
+static __inline__ uint8x16_t vreinterpretq_u8_s16(int16x8_t v)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.lane[2 * i] = (Uint8)(v.lane[i] & 0xFF);
+		r.lane[2 * i + 1] = (Uint8)((v.lane[i] >> 8) & 0xFF);
+	}
+	return r;
+}
+
+static __inline__ uint16x8_t vreinterpretq_u16_u8(uint8x16_t v)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.lane[i] = (Uint16)(v.lane[2 * i] | (v.lane[2 * i + 1] << 8));
+	}
+	return r;
+}
+
+static __inline__ uint8x16_t vreinterpretq_u8_u16(uint16x8_t v)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.lane[2 * i] = (Uint8)(v.lane[i] & 0xFF);
+		r.lane[2 * i + 1] = (Uint8)(v.lane[i] >> 8);
+	}
+	return r;
+}
+
+static __inline__ uint32x4_t vreinterpretq_u32_u8(uint8x16_t v)
+{
+	uint32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) {
+		r.lane[i] = (Uint32)v.lane[4 * i] | ((Uint32)v.lane[4 * i + 1] << 8) |
+		            ((Uint32)v.lane[4 * i + 2] << 16) |
+		            ((Uint32)v.lane[4 * i + 3] << 24);
+	}
+	return r;
+}
+
+static __inline__ uint8x16_t vreinterpretq_u8_u32(uint32x4_t v)
+{
+	uint8x16_t r;
+	int i, j;
+	for ( i = 0; i < 4; ++i ) {
+		for ( j = 0; j < 4; ++j ) r.lane[4 * i + j] = (Uint8)(v.lane[i] >> (8 * j));
+	}
+	return r;
+}
+
+static __inline__ uint32x4_t vreinterpretq_u32_u16(uint16x8_t v)
+{
+	uint32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) {
+		r.lane[i] = (Uint32)v.lane[2 * i] | ((Uint32)v.lane[2 * i + 1] << 16);
+	}
+	return r;
+}
+
+/* Arithmetic, wrapping like the hardware unless saturating */
+
+static __inline__ uint16x8_t vmovl_u8(uint8x8_t v)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = v.lane[i];
+	return r;
+}
+
+static __inline__ int16x8_t vmovl_s8(int8x8_t v)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = v.lane[i];
+	return r;
+}
+
+static __inline__ int32x4_t vmovl_s16(int16x4_t v)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = v.lane[i];
+	return r;
+}
+
+static __inline__ int8x8_t vmovn_s16(int16x8_t v)
+{
+	int8x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint8)v.lane[i];
+	return r;
+}
+
+static __inline__ uint16x8_t vsubl_u8(uint8x8_t a, uint8x8_t b)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Uint16)(a.lane[i] - b.lane[i]);
+	return r;
+}
+
+static __inline__ uint8x16_t vaddq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Uint8)(a.lane[i] + b.lane[i]);
+	return r;
+}
+
+static __inline__ uint16x8_t vaddq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Uint16)(a.lane[i] + b.lane[i]);
+	return r;
+}
+
+static __inline__ uint8x16_t vsubq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Uint8)(a.lane[i] - b.lane[i]);
+	return r;
+}
+
+static __inline__ uint16x8_t vsubq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Uint16)(a.lane[i] - b.lane[i]);
+	return r;
+}
+
+/* Halving adds, (a + b) >> 1 without overflow, rounding down */
+static __inline__ uint8x16_t vhaddq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Uint8)((a.lane[i] + b.lane[i]) >> 1);
+	return r;
+}
+
+static __inline__ int8x16_t vhaddq_s8(int8x16_t a, int8x16_t b)
+{
+	int8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Sint8)((a.lane[i] + b.lane[i]) >> 1);
+	return r;
+}
+
+static __inline__ uint16x8_t vhaddq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Uint16)((a.lane[i] + b.lane[i]) >> 1);
+	return r;
+}
+
+static __inline__ int16x8_t vhaddq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)((a.lane[i] + b.lane[i]) >> 1);
+	return r;
+}
+
+static __inline__ int16x8_t vaddq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(a.lane[i] + b.lane[i]);
+	return r;
+}
+
+static __inline__ int32x4_t vaddq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = a.lane[i] + b.lane[i];
+	return r;
+}
+
+static __inline__ int32x4_t vsubq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = a.lane[i] - b.lane[i];
+	return r;
+}
+
+static __inline__ int8x16_t vqaddq_s8(int8x16_t a, int8x16_t b)
+{
+	int8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) {
+		const int sum = a.lane[i] + b.lane[i];
+		r.lane[i] = (Sint8)(sum < -128 ? -128 : sum > 127 ? 127 : sum);
+	}
+	return r;
+}
+
+static __inline__ int16x8_t vqaddq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		const int sum = a.lane[i] + b.lane[i];
+		r.lane[i] = (Sint16)(sum < -32768 ? -32768 : sum > 32767 ? 32767 : sum);
+	}
+	return r;
+}
+
+static __inline__ int16x8_t vsubq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(a.lane[i] - b.lane[i]);
+	return r;
+}
+
+static __inline__ int16x8_t vnegq_s16(int16x8_t v)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)-v.lane[i];
+	return r;
+}
+
+static __inline__ int16x8_t vabsq_s16(int16x8_t v)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(v.lane[i] < 0 ? -v.lane[i] : v.lane[i]);
+	return r;
+}
+
+static __inline__ int16x8_t veorq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(a.lane[i] ^ b.lane[i]);
+	return r;
+}
+
+static __inline__ uint8x16_t veorq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Uint8)(a.lane[i] ^ b.lane[i]);
+	return r;
+}
+
+static __inline__ uint16x8_t veorq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = a.lane[i] ^ b.lane[i];
+	return r;
+}
+
+static __inline__ uint8x16_t vandq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = a.lane[i] & b.lane[i];
+	return r;
+}
+
+static __inline__ uint16x8_t vandq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = a.lane[i] & b.lane[i];
+	return r;
+}
+
+static __inline__ int16x8_t vandq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(a.lane[i] & b.lane[i]);
+	return r;
+}
+
+static __inline__ int32x4_t vandq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = a.lane[i] & b.lane[i];
+	return r;
+}
+
+static __inline__ uint8x16_t vminq_u8(uint8x16_t a, uint8x16_t b)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = a.lane[i] < b.lane[i] ? a.lane[i] : b.lane[i];
+	return r;
+}
+
+static __inline__ int16x8_t vmulq_n_s16(int16x8_t v, Sint16 n)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(v.lane[i] * n);
+	return r;
+}
+
+static __inline__ int32x4_t vmull_n_s16(int16x4_t v, Sint16 n)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = (Sint32)v.lane[i] * n;
+	return r;
+}
+
+static __inline__ uint32x4_t vmull_u16(uint16x4_t a, uint16x4_t b)
+{
+	uint32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = (Uint32)a.lane[i] * b.lane[i];
+	return r;
+}
+
+static __inline__ int32x4_t vmulq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = a.lane[i] * b.lane[i];
+	return r;
+}
+
+static __inline__ int32x4_t vmlaq_s32(int32x4_t a, int32x4_t b, int32x4_t c)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = a.lane[i] + b.lane[i] * c.lane[i];
+	return r;
+}
+
+static __inline__ uint8x8_t vqmovun_s16(int16x8_t v)
+{
+	uint8x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.lane[i] = (Uint8)(v.lane[i] < 0 ? 0 : v.lane[i] > 255 ? 255 : v.lane[i]);
+	}
+	return r;
+}
+
+/* Shifts, the counts have to be constants like for the real intrinsics */
+
+static __inline__ uint8x16_t vshrq_n_u8(uint8x16_t v, int n)
+{
+	uint8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Uint8)(v.lane[i] >> n);
+	return r;
+}
+
+static __inline__ int8x16_t vshrq_n_s8(int8x16_t v, int n)
+{
+	int8x16_t r;
+	int i;
+	for ( i = 0; i < 16; ++i ) r.lane[i] = (Sint8)(v.lane[i] >> n);
+	return r;
+}
+
+static __inline__ uint16x8_t vshrq_n_u16(uint16x8_t v, int n)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Uint16)(v.lane[i] >> n);
+	return r;
+}
+
+static __inline__ int16x8_t vshrq_n_s16(int16x8_t v, int n)
+{
+	int16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Sint16)(v.lane[i] >> n);
+	return r;
+}
+
+static __inline__ int32x4_t vshrq_n_s32(int32x4_t v, int n)
+{
+	int32x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = v.lane[i] >> n;
+	return r;
+}
+
+static __inline__ int16x4_t vshrn_n_s32(int32x4_t v, int n)
+{
+	int16x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = (Sint16)(v.lane[i] >> n);
+	return r;
+}
+
+static __inline__ int16x4_t vqshrn_n_s32(int32x4_t v, int n)
+{
+	int16x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) {
+		const Sint32 x = v.lane[i] >> n;
+		r.lane[i] = (Sint16)(x < -32768 ? -32768 : x > 32767 ? 32767 : x);
+	}
+	return r;
+}
+
+static __inline__ uint16x4_t vshrn_n_u32(uint32x4_t v, int n)
+{
+	uint16x4_t r;
+	int i;
+	for ( i = 0; i < 4; ++i ) r.lane[i] = (Uint16)(v.lane[i] >> n);
+	return r;
+}
+
+static __inline__ uint16x8_t vshll_n_u8(uint8x8_t v, int n)
+{
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) r.lane[i] = (Uint16)(v.lane[i] << n);
+	return r;
+}
+
+/* Shift right and insert, keeps the top n bits of a */
+static __inline__ uint16x8_t vsriq_n_u16(uint16x8_t a, uint16x8_t b, int n)
+{
+	const Uint16 keep = (Uint16)(0xFFFF << (16 - n));
+	uint16x8_t r;
+	int i;
+	for ( i = 0; i < 8; ++i ) {
+		r.lane[i] = (Uint16)((a.lane[i] & keep) | (b.lane[i] >> n));
+	}
+	return r;
+}
+
+#endif /* _SDL_neon_emu_h */
@@ -28,6 +28,7 @@
 #include "SDL_sysevents.h"
 #include "SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
+#include "../thread/SDL_thread_c.h"
 #if !SDL_JOYSTICK_DISABLED
 #include "../joystick/SDL_joystick_c.h"
 #endif
@@ -37,14 +38,53 @@ SDL_EventFilter SDL_EventOK = NULL;
 Uint8 SDL_ProcessEvents[SDL_NUMEVENTS];
 static Uint32 SDL_eventstate = 0;
 
-/* Private data -- event queue */
+/* Private data -- event queue
+
+   Every event type has its own queue, a ring of cells which any number of
+   threads add to without a lock: a producer claims a position by moving the
+   tail with a compare-and-swap, fills the cell and then publishes it by
+   setting its sequence number (see Dmitry Vyukov's bounded MPMC queue).
+   Only one thread takes events out at a time, the others wait on a mutex
+   for the few copies it takes.  Each event gets a stamp from
+   a global counter, so that the oldest event of the types asked for is at
+   the head of one of the queues, and can be taken without moving the others.
+
+   A full queue is doubled, up to SDL_EVENT_QUEUE_SIZE events, while the
+   other threads wait outside the queue.  Threads in the queues only copy
+   an event, so waiting for them spins a little before giving up the CPU.
+ */
 #define MAXEVENTS	128
+#define MINQUEUESIZE	16
+#define MAXQUEUESIZE	1024
+#define POLLINTERVAL	10	/* ms between polls of the video driver */
+#define RESIZING	0x40000000	/* Set in SDL_EventQ.users */
+#define SPINCOUNT	64	/* Looks at the queue before yielding the CPU */
+
+typedef struct SDL_EventCell {
+	SDL_atomic_t sequence;
+	Uint32 stamp;
+	SDL_Event event;
+} SDL_EventCell;
+
+typedef struct SDL_EventTypeQueue {
+	SDL_EventCell *cells;
+	struct SDL_SysWMmsg *wmmsg;	/* Messages of SDL_SYSWMEVENT cells */
+	int size;			/* A power of two */
+	SDL_atomic_t tail;		/* Next position to add at */
+	Uint32 head;			/* Next position to take from */
+} SDL_EventTypeQueue;
+
 static struct {
-	SDL_mutex *lock;
 	int active;
-	int head;
-	int tail;
-	SDL_Event event[MAXEVENTS];
+	int maxsize;
+	SDL_EventTypeQueue queue[SDL_NUMEVENTS];
+	SDL_atomic_t stamp;
+	SDL_atomic_t pending;		/* Mask of types with events */
+	SDL_atomic_t users;		/* Threads in the queues */
+	SDL_mutex *reading;			/* Held while taking events out */
+	SDL_atomic_t waiters;		/* Threads asleep on 'wait' */
+	SDL_sem *wait;
+	Uint32 poll_interval;
 	int wmmsg_next;
 	struct SDL_SysWMmsg wmmsg[MAXEVENTS];
 } SDL_EventQ;
@@ -147,17 +187,7 @@ static int SDL_StartEventThread(Uint32 flags)
 	SDL_EventThread = NULL;
 	SDL_memset(&SDL_EventLock, 0, sizeof(SDL_EventLock));
 
-	/* Create the lock and set ourselves active */
-#if !SDL_THREADS_DISABLED
-	SDL_EventQ.lock = SDL_CreateMutex();
-	if ( SDL_EventQ.lock == NULL ) {
-#ifdef __MACOS__ /* MacOS classic you can't multithread, so no lock needed */
-		;
-#else
-		return(-1);
-#endif
-	}
-#endif /* !SDL_THREADS_DISABLED */
+	/* Set ourselves active */
 	SDL_EventQ.active = 1;
 
 	if ( (flags&SDL_INIT_EVENTTHREAD) == SDL_INIT_EVENTTHREAD ) {
@@ -169,12 +199,8 @@ static int SDL_StartEventThread(Uint32 flags)
 
 		/* The event thread will handle timers too */
 		SDL_SetTimerThreaded(2);
-#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
-#undef SDL_CreateThread
-		SDL_EventThread = SDL_CreateThread(SDL_GobbleEvents, NULL, NULL, NULL);
-#else
-		SDL_EventThread = SDL_CreateThread(SDL_GobbleEvents, NULL);
-#endif
+		SDL_EventThread = SDL_CreateThreadInternal(SDL_GobbleEvents, NULL,
+		                  "SDL event", SDL_THREAD_PRIORITY_DEFAULT, "SDL_EVENT_THREAD");
 		if ( SDL_EventThread == NULL ) {
 			return(-1);
 		}
@@ -193,10 +219,6 @@ static void SDL_StopEventThread(void)
 		SDL_DestroyMutex(SDL_EventLock.lock);
 		SDL_EventLock.lock = NULL;
 	}
-#ifndef IPOD
-	SDL_DestroyMutex(SDL_EventQ.lock);
-	SDL_EventQ.lock = NULL;
-#endif
 }
 
 Uint32 SDL_EventThreadID(void)
@@ -204,6 +226,102 @@ Uint32 SDL_EventThreadID(void)
 	return(event_thread);
 }
 
+static void SDL_QuitEventQueue(void)
+{
+	int type;
+
+	for ( type = 0; type < SDL_NUMEVENTS; ++type ) {
+		SDL_free(SDL_EventQ.queue[type].cells);
+		SDL_free(SDL_EventQ.queue[type].wmmsg);
+	}
+	SDL_memset(SDL_EventQ.queue, 0, sizeof(SDL_EventQ.queue));
+	SDL_EventQ.pending.value = 0;
+	SDL_EventQ.wmmsg_next = 0;
+	if ( SDL_EventQ.wait ) {
+		SDL_DestroySemaphore(SDL_EventQ.wait);
+		SDL_EventQ.wait = NULL;
+	}
+	if ( SDL_EventQ.reading ) {
+		SDL_DestroyMutex(SDL_EventQ.reading);
+		SDL_EventQ.reading = NULL;
+	}
+}
+
+/* Allocate a queue of 'size' cells, keeping the events of the old one */
+static int SDL_ResizeEventQueue(SDL_EventTypeQueue *queue, int size)
+{
+	SDL_EventCell *cells;
+	struct SDL_SysWMmsg *wmmsg = NULL;
+	Uint32 head = queue->head;
+	Uint32 tail = (Uint32)queue->tail.value;
+	Uint32 pos;
+
+	cells = (SDL_EventCell *)SDL_malloc(size * sizeof(*cells));
+	if ( queue == &SDL_EventQ.queue[SDL_SYSWMEVENT] ) {
+		wmmsg = (struct SDL_SysWMmsg *)SDL_malloc(size * sizeof(*wmmsg));
+	}
+	if ( !cells || (!wmmsg && queue == &SDL_EventQ.queue[SDL_SYSWMEVENT]) ) {
+		SDL_free(cells);
+		SDL_free(wmmsg);
+		SDL_OutOfMemory();
+		return(-1);
+	}
+	for ( pos = head; pos != tail; ++pos ) {
+		cells[pos & (size-1)] = queue->cells[pos & (queue->size-1)];
+		if ( wmmsg ) {
+			wmmsg[pos & (size-1)] = queue->wmmsg[pos & (queue->size-1)];
+		}
+	}
+	for ( ; pos != head + size; ++pos ) {
+		cells[pos & (size-1)].sequence.value = (int)pos;
+	}
+	SDL_free(queue->cells);
+	SDL_free(queue->wmmsg);
+	queue->cells = cells;
+	queue->wmmsg = wmmsg;
+	queue->size = size;
+	return(0);
+}
+
+static int SDL_InitEventQueue(void)
+{
+	const char *envr = SDL_getenv("SDL_EVENT_QUEUE_SIZE");
+	int type;
+
+	SDL_EventQ.maxsize = MAXQUEUESIZE;
+	if ( envr && SDL_atoi(envr) > 0 ) {
+		SDL_EventQ.maxsize = MINQUEUESIZE;
+		while ( SDL_EventQ.maxsize < SDL_atoi(envr) &&
+		        SDL_EventQ.maxsize < (1 << 24) ) {
+			SDL_EventQ.maxsize *= 2;
+		}
+	}
+	SDL_EventQ.poll_interval = POLLINTERVAL;
+	envr = SDL_getenv("SDL_EVENT_POLL_INTERVAL");
+	if ( envr && SDL_atoi(envr) > 0 ) {
+		SDL_EventQ.poll_interval = SDL_atoi(envr);
+	}
+	SDL_EventQ.stamp.value = 0;
+	SDL_EventQ.users.value = 0;
+	SDL_EventQ.waiters.value = 0;
+#if !SDL_THREADS_DISABLED
+	SDL_EventQ.reading = SDL_CreateMutex();
+	if ( SDL_EventQ.reading == NULL ) {
+		SDL_QuitEventQueue();
+		return(-1);
+	}
+	/* Without it, SDL_WaitEvent() polls the queue */
+	SDL_EventQ.wait = SDL_CreateSemaphore(0);
+#endif
+	for ( type = 0; type < SDL_NUMEVENTS; ++type ) {
+		if ( SDL_ResizeEventQueue(&SDL_EventQ.queue[type], MINQUEUESIZE) < 0 ) {
+			SDL_QuitEventQueue();
+			return(-1);
+		}
+	}
+	return(0);
+}
+
 /* Public functions */
 
 void SDL_StopEventLoop(void)
@@ -218,9 +336,7 @@ void SDL_StopEventLoop(void)
 	SDL_QuitQuit();
 
 	/* Clean out EventQ */
-	SDL_EventQ.head = 0;
-	SDL_EventQ.tail = 0;
-	SDL_EventQ.wmmsg_next = 0;
+	SDL_QuitEventQueue();
 }
 
 /* This function (and associated calls) may be called more than once */
@@ -230,8 +346,10 @@ int SDL_StartEventLoop(Uint32 flags)
 
 	/* Clean out the event queue */
 	SDL_EventThread = NULL;
-	SDL_EventQ.lock = NULL;
 	SDL_StopEventLoop();
+	if ( SDL_InitEventQueue() < 0 ) {
+		return(-1);
+	}
 
 	/* No filter to start with, process most event types */
 	SDL_EventOK = NULL;
@@ -261,61 +379,200 @@ int SDL_StartEventLoop(Uint32 flags)
 }
 
 
-/* Add an event to the event queue -- called with the queue locked */
+/* Wait a moment for another thread in the queues */
+static void SDL_SpinEventQueue(int *spins)
+{
+	if ( ++*spins >= SPINCOUNT ) {
+		/* It may be waiting for this CPU */
+		SDL_Delay(0);
+		*spins = 0;
+	}
+}
+
+/* Wait until no queue is being resized, and count ourselves as a user */
+static void SDL_EnterEventQueue(void)
+{
+	int spins = 0;
+
+	while ( SDL_AtomicAdd(&SDL_EventQ.users, 1) & RESIZING ) {
+		SDL_AtomicAdd(&SDL_EventQ.users, -1);
+		while ( SDL_AtomicGet(&SDL_EventQ.users) & RESIZING ) {
+			SDL_SpinEventQueue(&spins);
+		}
+	}
+}
+
+static void SDL_LeaveEventQueue(void)
+{
+	SDL_AtomicAdd(&SDL_EventQ.users, -1);
+}
+
+/* Double a full queue once every thread has left the queues.
+   Returns 0 if the event should be added again, or -1 if it is dropped.
+ */
+static int SDL_GrowEventQueue(int type, int size)
+{
+	SDL_EventTypeQueue *queue = &SDL_EventQ.queue[type];
+	int retval = 0;
+	int spins = 0;
+
+	if ( SDL_AtomicOr(&SDL_EventQ.users, RESIZING) & RESIZING ) {
+		/* Another thread is resizing, try again when it's done */
+		return(0);
+	}
+	while ( SDL_AtomicGet(&SDL_EventQ.users) != RESIZING ) {
+		SDL_SpinEventQueue(&spins);
+	}
+	/* The queue may have been grown or emptied while we waited */
+	if ( queue->size == size &&
+	     (int)((Uint32)queue->tail.value - queue->head) == size ) {
+		if ( size >= SDL_EventQ.maxsize ) {
+			SDL_SetError("Event queue is full");
+			retval = -1;
+		} else {
+			retval = SDL_ResizeEventQueue(queue, size * 2);
+		}
+	}
+	SDL_AtomicAnd(&SDL_EventQ.users, ~RESIZING);
+	return(retval);
+}
+
+/* Add an event to the queue of its type, returns 1 if it was added */
 static int SDL_AddEvent(SDL_Event *event)
 {
-	int tail, added;
+	const int type = event->type & (SDL_NUMEVENTS-1);
+	SDL_EventTypeQueue *queue = &SDL_EventQ.queue[type];
+	SDL_EventCell *cell;
+	Uint32 pos;
+	int size, diff;
+
+	SDL_EnterEventQueue();
+	for ( ; ; ) {
+		size = queue->size;
+		pos = (Uint32)SDL_AtomicGet(&queue->tail);
+		cell = &queue->cells[pos & (size-1)];
+		diff = (int)((Uint32)SDL_AtomicGet(&cell->sequence) - pos);
+		if ( diff == 0 ) {
+			if ( SDL_AtomicCAS(&queue->tail, (int)pos, (int)(pos+1)) ) {
+				break;
+			}
+		} else if ( diff < 0 ) {
+			/* The cell still holds an event, the queue is full */
+			SDL_LeaveEventQueue();
+			if ( SDL_GrowEventQueue(type, size) < 0 ) {
+				return(0);
+			}
+			SDL_EnterEventQueue();
+		}
+	}
+	cell->stamp = (Uint32)SDL_AtomicAdd(&SDL_EventQ.stamp, 1);
+	cell->event = *event;
+	if ( type == SDL_SYSWMEVENT ) {
+		queue->wmmsg[pos & (queue->size-1)] = *event->syswm.msg;
+	}
+	SDL_AtomicSet(&cell->sequence, (int)(pos+1));
+	/* The event is visible before we look at the pending mask, so either
+	   we set the bit or SDL_CutEvent() sees the event after clearing it */
+	if ( !(SDL_AtomicGet(&SDL_EventQ.pending) & (1 << type)) ) {
+		SDL_AtomicOr(&SDL_EventQ.pending, 1 << type);
+	}
+	SDL_LeaveEventQueue();
 
-	tail = (SDL_EventQ.tail+1)%MAXEVENTS;
-	if ( tail == SDL_EventQ.head ) {
-		/* Overflow, drop event */
-		added = 0;
-	} else {
-		SDL_EventQ.event[SDL_EventQ.tail] = *event;
-		if (event->type == SDL_SYSWMEVENT) {
-			/* Note that it's possible to lose an event */
-			int next = SDL_EventQ.wmmsg_next;
-			SDL_EventQ.wmmsg[next] = *event->syswm.msg;
-		        SDL_EventQ.event[SDL_EventQ.tail].syswm.msg =
-						&SDL_EventQ.wmmsg[next];
-			SDL_EventQ.wmmsg_next = (next+1)%MAXEVENTS;
+	/* Wake up SDL_WaitEvent(), once is enough */
+	if ( SDL_AtomicGet(&SDL_EventQ.waiters) &&
+	     SDL_SemValue(SDL_EventQ.wait) == 0 ) {
+		SDL_SemPost(SDL_EventQ.wait);
+	}
+	return(1);
+}
+
+/* Return the cell at 'pos' of a queue, if an event has been added there */
+static __inline__ SDL_EventCell *SDL_EventAt(SDL_EventTypeQueue *queue, Uint32 pos)
+{
+	SDL_EventCell *cell = &queue->cells[pos & (queue->size-1)];
+
+	if ( (Uint32)SDL_AtomicGet(&cell->sequence) != pos+1 ) {
+		return(NULL);
+	}
+	return(cell);
+}
+
+/* Copy an event out of a queue, with its window manager message */
+static void SDL_CopyEvent(SDL_Event *event, SDL_EventTypeQueue *queue, Uint32 pos)
+{
+	*event = queue->cells[pos & (queue->size-1)].event;
+	if ( queue == &SDL_EventQ.queue[SDL_SYSWMEVENT] ) {
+		/* Note that it's possible to lose an event */
+		int next = SDL_EventQ.wmmsg_next;
+		SDL_EventQ.wmmsg[next] = queue->wmmsg[pos & (queue->size-1)];
+		event->syswm.msg = &SDL_EventQ.wmmsg[next];
+		SDL_EventQ.wmmsg_next = (next+1)%MAXEVENTS;
+	}
+}
+
+/* Take the oldest event at the head of a queue -- called while reading */
+static void SDL_CutEvent(int type)
+{
+	SDL_EventTypeQueue *queue = &SDL_EventQ.queue[type];
+	Uint32 pos = queue->head++;
+
+	SDL_AtomicSet(&queue->cells[pos & (queue->size-1)].sequence,
+	              (int)(pos + queue->size));
+	if ( ! SDL_EventAt(queue, queue->head) ) {
+		/* Clear the pending bit, unless an event came in meanwhile */
+		SDL_AtomicAnd(&SDL_EventQ.pending, ~(1 << type));
+		if ( SDL_EventAt(queue, queue->head) ) {
+			SDL_AtomicOr(&SDL_EventQ.pending, 1 << type);
 		}
-		SDL_EventQ.tail = tail;
-		added = 1;
-	}
-	return(added);
-}
-
-/* Cut an event, and return the next valid spot, or the tail */
-/*                           -- called with the queue locked */
-static int SDL_CutEvent(int spot)
-{
-	if ( spot == SDL_EventQ.head ) {
-		SDL_EventQ.head = (SDL_EventQ.head+1)%MAXEVENTS;
-		return(SDL_EventQ.head);
-	} else
-	if ( (spot+1)%MAXEVENTS == SDL_EventQ.tail ) {
-		SDL_EventQ.tail = spot;
-		return(SDL_EventQ.tail);
-	} else
-	/* We cut the middle -- shift everything over */
-	{
-		int here, next;
-
-		/* This can probably be optimized with SDL_memcpy() -- careful! */
-		if ( --SDL_EventQ.tail < 0 ) {
-			SDL_EventQ.tail = MAXEVENTS-1;
+	}
+}
+
+/* Get or peek at up to 'numevents' of the oldest events matching 'mask' */
+static int SDL_TakeEvents(SDL_Event *events, int numevents,
+                          SDL_eventaction action, Uint32 mask)
+{
+	Uint32 cursor[SDL_NUMEVENTS];
+	int used, type, oldest;
+	Uint32 types, stamp = 0;
+	SDL_EventCell *cell;
+
+	for ( type = 0; type < SDL_NUMEVENTS; ++type ) {
+		cursor[type] = SDL_EventQ.queue[type].head;
+	}
+	for ( used = 0; used < numevents; ++used ) {
+		types = (Uint32)SDL_AtomicGet(&SDL_EventQ.pending) & mask;
+		if ( action == SDL_PEEKEVENT ) {
+			/* The pending mask only knows about the queue heads */
+			types = mask;
+		}
+		oldest = -1;
+		for ( type = 0; types; ++type, types >>= 1 ) {
+			if ( !(types & 1) ) {
+				continue;
+			}
+			cell = SDL_EventAt(&SDL_EventQ.queue[type], cursor[type]);
+			if ( cell &&
+			     (oldest < 0 || (Sint32)(cell->stamp - stamp) < 0) ) {
+				oldest = type;
+				stamp = cell->stamp;
+			}
+		}
+		if ( oldest < 0 ) {
+			break;
 		}
-		for ( here=spot; here != SDL_EventQ.tail; here = next ) {
-			next = (here+1)%MAXEVENTS;
-			SDL_EventQ.event[here] = SDL_EventQ.event[next];
+		if ( events ) {
+			SDL_CopyEvent(&events[used],
+			              &SDL_EventQ.queue[oldest], cursor[oldest]);
 		}
-		return(spot);
+		if ( action == SDL_GETEVENT ) {
+			SDL_CutEvent(oldest);
+		}
+		++cursor[oldest];
 	}
-	/* NOTREACHED */
+	return(used);
 }
 
-/* Lock the event queue, take a peep at it, and unlock it */
+/* Add to the event queue, or take a peep at it */
 int SDL_PeepEvents(SDL_Event *events, int numevents, SDL_eventaction action,
 								Uint32 mask)
 {
@@ -325,41 +582,29 @@ int SDL_PeepEvents(SDL_Event *events, int numevents, SDL_eventaction action,
 	if ( ! SDL_EventQ.active ) {
 		return(-1);
 	}
-	/* Lock the event queue */
 	used = 0;
-	if ( SDL_mutexP(SDL_EventQ.lock) == 0 ) {
-		if ( action == SDL_ADDEVENT ) {
-			for ( i=0; i<numevents; ++i ) {
-				used += SDL_AddEvent(&events[i]);
-			}
-		} else {
-			SDL_Event tmpevent;
-			int spot;
-
-			/* If 'events' is NULL, just see if they exist */
-			if ( events == NULL ) {
-				action = SDL_PEEKEVENT;
-				numevents = 1;
-				events = &tmpevent;
-			}
-			spot = SDL_EventQ.head;
-			while ((used < numevents)&&(spot != SDL_EventQ.tail)) {
-				if ( mask & SDL_EVENTMASK(SDL_EventQ.event[spot].type) ) {
-					events[used++] = SDL_EventQ.event[spot];
-					if ( action == SDL_GETEVENT ) {
-						spot = SDL_CutEvent(spot);
-					} else {
-						spot = (spot+1)%MAXEVENTS;
-					}
-				} else {
-					spot = (spot+1)%MAXEVENTS;
-				}
-			}
+	if ( action == SDL_ADDEVENT ) {
+		for ( i=0; i<numevents; ++i ) {
+			used += SDL_AddEvent(&events[i]);
 		}
-		SDL_mutexV(SDL_EventQ.lock);
-	} else {
-		SDL_SetError("Couldn't lock event queue");
-		used = -1;
+		return(used);
+	}
+
+	/* If 'events' is NULL, just see if they exist */
+	if ( events == NULL ) {
+		action = SDL_PEEKEVENT;
+		numevents = 1;
+	}
+
+	/* Events are taken out by one thread at a time */
+	if ( SDL_EventQ.reading ) {
+		SDL_mutexP(SDL_EventQ.reading);
+	}
+	SDL_EnterEventQueue();
+	used = SDL_TakeEvents(events, numevents, action, mask);
+	SDL_LeaveEventQueue();
+	if ( SDL_EventQ.reading ) {
+		SDL_mutexV(SDL_EventQ.reading);
 	}
 	return(used);
 }
@@ -400,18 +645,65 @@ int SDL_PollEvent (SDL_Event *event)
 	return 1;
 }
 
-int SDL_WaitEvent (SDL_Event *event)
+/* Sleep until an event is added, or for 'timeout' milliseconds */
+static void SDL_SleepForEvent(Uint32 timeout)
 {
+	if ( ! SDL_EventQ.wait ) {
+		SDL_Delay(SDL_min(timeout, POLLINTERVAL));
+		return;
+	}
+
+	/* Either we see the event here, or SDL_AddEvent() sees us waiting */
+	SDL_AtomicAdd(&SDL_EventQ.waiters, 1);
+	if ( ! SDL_AtomicGet(&SDL_EventQ.pending) ) {
+		SDL_SemWaitTimeout(SDL_EventQ.wait, timeout);
+	}
+	SDL_AtomicAdd(&SDL_EventQ.waiters, -1);
+}
+
+int SDL_WaitEventTimeout (SDL_Event *event, int timeout)
+{
+	Uint32 start = SDL_GetTicks();
+	Uint32 elapsed, wait;
+
 	while ( 1 ) {
 		SDL_PumpEvents();
 		switch(SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_ALLEVENTS)) {
 		    case -1: return 0;
 		    case 1: return 1;
-		    case 0: SDL_Delay(10);
 		}
+		wait = SDL_MUTEX_MAXWAIT;
+		if ( timeout >= 0 ) {
+			elapsed = SDL_GetTicks() - start;
+			if ( elapsed >= (Uint32)timeout ) {
+				return 0;
+			}
+			wait = timeout - elapsed;
+		}
+		/* The event thread pumps the video driver, or we have to */
+		if ( !SDL_EventThread && current_video ) {
+			wait = SDL_min(wait, SDL_EventQ.poll_interval);
+		}
+		SDL_SleepForEvent(wait);
 	}
 }
 
+int SDL_WaitEvent (SDL_Event *event)
+{
+	return SDL_WaitEventTimeout(event, -1);
+}
+
+int SDL_PollEvents(SDL_Event *events, int numevents)
+{
+	SDL_PumpEvents();
+
+	/* We can't return -1, just return 0 (no events) on error */
+	numevents = SDL_PeepEvents(events, numevents, SDL_GETEVENT, SDL_ALLEVENTS);
+	if ( numevents < 0 )
+		return 0;
+	return numevents;
+}
+
 int SDL_PushEvent(SDL_Event *event)
 {
 	if ( SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0) <= 0 )
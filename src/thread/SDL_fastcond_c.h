@@ -0,0 +1,119 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A condition variable that is one atomic word and one semaphore.
+
+   'state' holds the number of waiting threads in its low 16 bits and the
+   number of wakeups posted to the semaphore for them, not yet taken, in
+   its high 16 bits.  A waiter registers while it still holds the mutex,
+   so a signal sent after it unlocks always finds it.  Signalling claims
+   wakeups for the waiters that don't have one yet and posts them all in
+   one semaphore call, and nobody waits for the woken threads to answer.
+
+   A waiter that times out leaves unless every waiter already has a wakeup
+   on the way, in which case one of them is its own and it takes it.  A
+   thread that starts waiting after a signal can take that wakeup from a
+   thread already waiting; the one left behind stays counted and gets the
+   next signal, the same as if it had woken up spuriously and waited again.
+
+   The platform defines before including this:
+	SDL_FastCondSem			the type of its semaphore
+	SDL_FastCondWait(sem, ms)	wait for the semaphore, 0 on success,
+					SDL_MUTEX_TIMEDOUT or -1
+	SDL_FastCondPost(sem, n)	signal the semaphore 'n' times
+
+   The psp2 condition variable uses a kernel semaphore.  test/testfastcond.c
+   uses a Linux futex, so the same code can be tested and timed there.
+ */
+
+#ifndef _SDL_fastcond_c_h
+#define _SDL_fastcond_c_h
+
+#include "SDL_atomic.h"
+
+#define SDL_FASTCOND_WAITER	0x00000001
+#define SDL_FASTCOND_WAKEUP	0x00010000
+#define SDL_FASTCOND_WAITERS(state)	((state) & 0xFFFF)
+#define SDL_FASTCOND_WAKEUPS(state)	((state) >> 16)
+
+typedef struct SDL_FastCond {
+	SDL_atomic_t state;
+	SDL_FastCondSem sem;
+} SDL_FastCond;
+
+/* Wake one waiting thread, or all of them */
+static __inline__ int SDL_FastCondSignal(SDL_FastCond *cond, int all)
+{
+	Uint32 state, wake;
+
+	do {
+		state = (Uint32)SDL_AtomicGet(&cond->state);
+		wake = SDL_FASTCOND_WAITERS(state) - SDL_FASTCOND_WAKEUPS(state);
+		if ( wake == 0 ) {
+			return 0;
+		}
+		if ( ! all ) {
+			wake = 1;
+		}
+	} while ( ! SDL_AtomicCAS(&cond->state, (int)state,
+	                          (int)(state + wake * SDL_FASTCOND_WAKEUP)) );
+	return SDL_FastCondPost(cond->sem, wake);
+}
+
+/* Register the calling thread as waiting, with the mutex still held */
+static __inline__ void SDL_FastCondPrepare(SDL_FastCond *cond)
+{
+	SDL_AtomicAdd(&cond->state, SDL_FASTCOND_WAITER);
+}
+
+/* Wait for a signal after SDL_FastCondPrepare(), with the mutex unlocked */
+static __inline__ int SDL_FastCondSleep(SDL_FastCond *cond, Uint32 ms)
+{
+	Uint32 state;
+	int retval;
+
+	retval = SDL_FastCondWait(cond->sem, ms);
+	if ( retval == 0 ) {
+		SDL_AtomicAdd(&cond->state, -(SDL_FASTCOND_WAITER|SDL_FASTCOND_WAKEUP));
+		return 0;
+	}
+
+	/* Stop waiting, unless every waiter has a wakeup coming and so one
+	   of them is ours.  A thread that starts waiting now can still take
+	   it, so look again until we get one or are free to leave.
+	 */
+	for ( ; ; ) {
+		state = (Uint32)SDL_AtomicGet(&cond->state);
+		if ( SDL_FASTCOND_WAKEUPS(state) < SDL_FASTCOND_WAITERS(state) ) {
+			if ( SDL_AtomicCAS(&cond->state, (int)state,
+			                   (int)(state - SDL_FASTCOND_WAITER)) ) {
+				return retval;
+			}
+		} else if ( SDL_FastCondWait(cond->sem, 1) == 0 ) {
+			SDL_AtomicAdd(&cond->state, -(SDL_FASTCOND_WAITER|SDL_FASTCOND_WAKEUP));
+			return 0;
+		}
+	}
+}
+
+#endif /* _SDL_fastcond_c_h */
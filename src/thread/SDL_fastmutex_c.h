@@ -0,0 +1,107 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A recursive mutex that only calls the kernel when it's contended.
+
+   'count' is the number of threads holding or waiting for the lock, so
+   locking is an atomic increment from zero and unlocking a decrement back
+   to zero.  A thread that finds the lock taken spins for a moment, then
+   sleeps on a semaphore which the unlocking thread signals when 'count'
+   says someone is waiting (a "benaphore").  The owner and recursion count
+   are only written by the thread holding the lock.
+
+   The platform defines before including this:
+	SDL_FastMutexSem		the type of its semaphore
+	SDL_FastMutexWait(sem)		wait for the semaphore, 0 on success
+	SDL_FastMutexPost(sem)		signal the semaphore
+	SDL_FastMutexSelf()		a non-zero id of the calling thread
+
+   The psp2 mutex uses a kernel semaphore.  test/testfastmutex.c uses a
+   Linux futex, so the same code can be tested and timed there.
+ */
+
+#ifndef _SDL_fastmutex_c_h
+#define _SDL_fastmutex_c_h
+
+#include "SDL_atomic.h"
+
+/* SDL_atomic would take an SDL_mutex for each operation without them */
+#if defined(SDL_ATOMIC_MUTEX) || \
+    !(defined(HAVE_GCC_ATOMICS) || defined(__ATOMIC_SEQ_CST))
+#error The fast mutex needs lock-free atomic operations
+#endif
+
+/* How many times to try the lock before sleeping */
+#define SDL_FASTMUTEX_SPIN	100
+
+typedef struct SDL_FastMutex {
+	SDL_atomic_t count;
+	SDL_atomic_t owner;
+	int recursion;
+	SDL_FastMutexSem sem;
+} SDL_FastMutex;
+
+static __inline__ int SDL_FastMutexLock(SDL_FastMutex *mutex)
+{
+	const Uint32 self = SDL_FastMutexSelf();
+	int spin;
+
+	if ( (Uint32)SDL_AtomicGet(&mutex->owner) == self ) {
+		++mutex->recursion;
+		return 0;
+	}
+	for ( spin = 0; spin < SDL_FASTMUTEX_SPIN; ++spin ) {
+		if ( SDL_AtomicGet(&mutex->count) == 0 &&
+		     SDL_AtomicCAS(&mutex->count, 0, 1) ) {
+			goto locked;
+		}
+	}
+	if ( SDL_AtomicAdd(&mutex->count, 1) > 0 ) {
+		if ( SDL_FastMutexWait(mutex->sem) != 0 ) {
+			SDL_AtomicAdd(&mutex->count, -1);
+			return -1;
+		}
+	}
+locked:
+	SDL_AtomicSet(&mutex->owner, (int)self);
+	mutex->recursion = 1;
+	return 0;
+}
+
+static __inline__ int SDL_FastMutexUnlock(SDL_FastMutex *mutex)
+{
+	if ( (Uint32)SDL_AtomicGet(&mutex->owner) != SDL_FastMutexSelf() ) {
+		return -1;
+	}
+	if ( --mutex->recursion > 0 ) {
+		return 0;
+	}
+	SDL_AtomicSet(&mutex->owner, 0);
+	if ( SDL_AtomicAdd(&mutex->count, -1) > 1 ) {
+		/* Someone is waiting, hand the lock over */
+		SDL_FastMutexPost(mutex->sem);
+	}
+	return 0;
+}
+
+#endif /* _SDL_fastmutex_c_h */
@@ -28,6 +28,9 @@
 #include "SDL_thread_c.h"
 #include "SDL_systhread.h"
 
+/* Sets up the mutex the atomic operations fall back on, in SDL_atomic.c */
+extern void SDL_AtomicInit(void);
+
 #define ARRAY_CHUNKSIZE	32
 /* The array of threads currently active in the application
    (except the main thread)
@@ -168,14 +171,6 @@ SDL_error *SDL_GetErrBuf(void)
 }
 
 
-/* Arguments and callback to setup and run the user thread function */
-typedef struct {
-	int (SDLCALL *func)(void *);
-	void *data;
-	SDL_Thread *info;
-	SDL_sem *wait;
-} thread_args;
-
 void SDL_RunThread(void *data)
 {
 	thread_args *args;
@@ -205,16 +200,24 @@ void SDL_RunThread(void *data)
 }
 
 #ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
-#undef SDL_CreateThread
-DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
+static SDL_Thread *SDL_CreateThreadCore(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttributes *attr, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
 #else
-DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data)
+static SDL_Thread *SDL_CreateThreadCore(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttributes *attr)
 #endif
 {
 	SDL_Thread *thread;
 	thread_args *args;
 	int ret;
 
+	/* The thread backends look the priority up in a table */
+	if ( attr && (unsigned int)attr->priority > SDL_THREAD_PRIORITY_TIME_CRITICAL ) {
+		SDL_SetError("Invalid thread priority %d", (int)attr->priority);
+		return(NULL);
+	}
+
+	/* While this may still be the only thread */
+	SDL_AtomicInit();
+
 	/* Allocate memory for the thread info structure */
 	thread = (SDL_Thread *)SDL_malloc(sizeof(*thread));
 	if ( thread == NULL ) {
@@ -234,6 +237,7 @@ DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *
 	args->func = fn;
 	args->data = data;
 	args->info = thread;
+	args->attr = attr;
 	args->wait = SDL_CreateSemaphore(0);
 	if ( args->wait == NULL ) {
 		SDL_free(thread);
@@ -266,6 +270,87 @@ DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *
 	return(thread);
 }
 
+#ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
+#undef SDL_CreateThread
+#undef SDL_CreateThreadWithAttributes
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
+{
+	return SDL_CreateThreadCore(fn, data, NULL, pfnBeginThread, pfnEndThread);
+}
+
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadWithAttributes(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttributes *attr, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
+{
+	return SDL_CreateThreadCore(fn, data, attr, pfnBeginThread, pfnEndThread);
+}
+#else
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data)
+{
+	return SDL_CreateThreadCore(fn, data, NULL);
+}
+
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadWithAttributes(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttributes *attr)
+{
+	return SDL_CreateThreadCore(fn, data, attr);
+}
+#endif
+
+static const char *SDL_GetThreadHint(const char *hint, const char *attribute)
+{
+	char name[64];
+
+	SDL_snprintf(name, sizeof(name), "%s_%s", hint, attribute);
+	return SDL_getenv(name);
+}
+
+/* Override 'attr' with the environment variables for 'hint' */
+void SDL_GetThreadHints(SDL_ThreadAttributes *attr, const char *hint)
+{
+	static const char *priorities[] = {
+		"default", "low", "normal", "high", "time_critical"
+	};
+	const char *value;
+	int i;
+
+	if ( (value = SDL_GetThreadHint(hint, "STACKSIZE")) != NULL ) {
+		attr->stacksize = (Uint32)SDL_strtoul(value, NULL, 0);
+	}
+	if ( (value = SDL_GetThreadHint(hint, "PRIORITY")) != NULL ) {
+		for ( i = 0; i < SDL_arraysize(priorities); ++i ) {
+			if ( SDL_strcasecmp(value, priorities[i]) == 0 ) {
+				attr->priority = (SDL_ThreadPriority)i;
+			}
+		}
+	}
+	if ( (value = SDL_GetThreadHint(hint, "CPUMASK")) != NULL ) {
+		attr->cpumask = (Uint32)SDL_strtoul(value, NULL, 0);
+	}
+}
+
+SDL_Thread *SDL_CreateThreadInternal(int (SDLCALL *fn)(void *), void *data,
+                                     const char *name, SDL_ThreadPriority priority,
+                                     const char *hint)
+{
+	SDL_ThreadAttributes attr;
+
+	SDL_memset(&attr, 0, sizeof(attr));
+	attr.name = name;
+	attr.priority = priority;
+	SDL_GetThreadHints(&attr, hint);
+#ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
+	/* What the SDL_CreateThread() macros pass, without a C runtime there
+	   is none */
+#if defined(__WIN32__) && !defined(HAVE_LIBC)
+	return SDL_CreateThreadCore(fn, data, &attr, NULL, NULL);
+#elif defined(__OS2__)
+	return SDL_CreateThreadCore(fn, data, &attr, _beginthread, _endthread);
+#else
+	return SDL_CreateThreadCore(fn, data, &attr, _beginthreadex, _endthreadex);
+#endif
+#else
+	return SDL_CreateThreadCore(fn, data, &attr);
+#endif
+}
+
 void SDL_WaitThread(SDL_Thread *thread, int *status)
 {
 	if ( thread ) {
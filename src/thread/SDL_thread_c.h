@@ -60,7 +60,27 @@ struct SDL_Thread {
 	void *data;
 };
 
+/* Arguments and callback to setup and run the user thread function,
+   'attr' is only valid until the thread has started */
+typedef struct {
+	int (SDLCALL *func)(void *);
+	void *data;
+	SDL_Thread *info;
+	SDL_sem *wait;
+	const SDL_ThreadAttributes *attr;
+} thread_args;
+
 /* This is the function called to run a thread */
 extern void SDL_RunThread(void *data);
 
+/* Create one of SDL's own threads.  The environment variables 'hint'
+   followed by _STACKSIZE, _PRIORITY (low, normal, high, time_critical)
+   and _CPUMASK override the defaults, e.g. SDL_AUDIO_THREAD_CPUMASK=4.
+   SDL_GetThreadHints() applies them to 'attr'.
+ */
+extern void SDL_GetThreadHints(SDL_ThreadAttributes *attr, const char *hint);
+extern SDL_Thread *SDL_CreateThreadInternal(int (SDLCALL *fn)(void *), void *data,
+                                            const char *name, SDL_ThreadPriority priority,
+                                            const char *hint);
+
 #endif /* _SDL_thread_c_h */
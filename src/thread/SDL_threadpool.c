@@ -0,0 +1,652 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A thread pool with a work stealing queue for each worker
+
+   Each worker owns a Chase-Lev deque: it pushes and pops tasks at the
+   bottom without locking, and other threads steal the oldest task from
+   the top with a compare-and-swap.  Threads outside the pool queue tasks
+   in a list behind the pool's mutex.  Idle workers sleep on a semaphore,
+   and whoever queues a task claims one sleeper to wake, the same way
+   SDL_fastcond_c.h counts its waiters.
+ */
+
+#include "SDL_atomic.h"
+#include "SDL_thread.h"
+#include "SDL_thread_c.h"
+
+/* Tasks a worker can hold before new ones go to the shared queue */
+#define SDL_WORKER_DEQUE	1024
+
+typedef struct SDL_Task {
+	SDL_TaskFunction func;
+	SDL_RangeFunction range;
+	void *data;
+	int first, last, grain;
+	SDL_TaskCounter *counter;
+	struct SDL_Task *next;
+} SDL_Task;
+
+/* 'pending' is twice the unfinished tasks.  The last task to finish takes
+   it to 1 while it wakes the waiters, and to 0 when it's done with it.
+ */
+struct SDL_TaskCounter {
+	SDL_atomic_t pending;
+	SDL_atomic_t waiters;
+	SDL_sem *sem;
+	SDL_TaskCounter *next;
+};
+
+#if SDL_THREADS_DISABLED
+
+/* Without threads, tasks run as they're submitted */
+struct SDL_ThreadPool {
+	int workers;
+};
+
+SDL_ThreadPool *SDL_CreateThreadPool(int workers, const SDL_ThreadAttributes *attr)
+{
+	SDL_ThreadPool *pool;
+
+	if ( workers <= 0 ) {
+		SDL_SetError("Invalid number of workers: %d", workers);
+		return(NULL);
+	}
+	pool = (SDL_ThreadPool *)SDL_malloc(sizeof(*pool));
+	if ( pool == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	pool->workers = workers;
+	return(pool);
+}
+
+void SDL_DestroyThreadPool(SDL_ThreadPool *pool)
+{
+	SDL_free(pool);
+}
+
+SDL_TaskCounter *SDL_CreateTaskCounter(void)
+{
+	SDL_TaskCounter *counter;
+
+	counter = (SDL_TaskCounter *)SDL_calloc(1, sizeof(*counter));
+	if ( counter == NULL ) {
+		SDL_OutOfMemory();
+	}
+	return(counter);
+}
+
+void SDL_DestroyTaskCounter(SDL_TaskCounter *counter)
+{
+	SDL_free(counter);
+}
+
+int SDL_SubmitTask(SDL_ThreadPool *pool, SDL_TaskFunction func, void *data, SDL_TaskCounter *counter)
+{
+	func(data);
+	return(0);
+}
+
+int SDL_ParallelFor(SDL_ThreadPool *pool, int first, int last, int grain, SDL_RangeFunction func, void *data, SDL_TaskCounter *counter)
+{
+	if ( first < last ) {
+		func(data, first, last);
+	}
+	return(0);
+}
+
+int SDL_WaitTasks(SDL_ThreadPool *pool, SDL_TaskCounter *counter)
+{
+	return(0);
+}
+
+#else
+
+typedef struct SDL_Worker {
+	SDL_ThreadPool *pool;
+	SDL_Thread *thread;
+	SDL_atomic_t threadid;
+	Uint32 seed;
+	/* The owner works at the bottom, thieves at the top */
+	SDL_atomic_t top;
+	SDL_atomic_t bottom;
+	void *tasks[SDL_WORKER_DEQUE];
+} SDL_Worker;
+
+struct SDL_ThreadPool {
+	int numworkers;
+	SDL_Worker **workers;
+
+	/* Tasks from outside the pool, and spare counters for SDL_ParallelFor() */
+	SDL_mutex *lock;
+	SDL_Task *head, *tail;
+	SDL_atomic_t queued;
+	SDL_TaskCounter *spare;
+
+	/* Idle workers not yet claimed by somebody queueing a task */
+	SDL_sem *wakeup;
+	SDL_atomic_t sleepers;
+	SDL_atomic_t quit;
+};
+
+/* Deque operations, after "Correct and Efficient Work-Stealing for Weak
+   Memory Models" by Lê, Pop, Cohen and Zappa Nardelli.  The positions
+   wrap around, only their differences matter.
+ */
+static int SDL_PushTask(SDL_Worker *worker, SDL_Task *task)
+{
+	Uint32 bottom = (Uint32)SDL_AtomicGet(&worker->bottom);
+	Uint32 top = (Uint32)SDL_AtomicGet(&worker->top);
+
+	if ( (int)(bottom - top) >= SDL_WORKER_DEQUE ) {
+		return(-1);
+	}
+	SDL_AtomicSetPtr(&worker->tasks[bottom % SDL_WORKER_DEQUE], task);
+	SDL_AtomicSet(&worker->bottom, (int)(bottom + 1));
+	return(0);
+}
+
+static SDL_Task *SDL_PopTask(SDL_Worker *worker)
+{
+	Uint32 bottom = (Uint32)SDL_AtomicGet(&worker->bottom) - 1;
+	Uint32 top;
+	SDL_Task *task = NULL;
+
+	SDL_AtomicSet(&worker->bottom, (int)bottom);
+	top = (Uint32)SDL_AtomicGet(&worker->top);
+	if ( (int)(bottom - top) >= 0 ) {
+		task = (SDL_Task *)SDL_AtomicGetPtr(&worker->tasks[bottom % SDL_WORKER_DEQUE]);
+		if ( bottom == top ) {
+			/* The last one, race the thieves for it */
+			if ( ! SDL_AtomicCAS(&worker->top, (int)top, (int)(top + 1)) ) {
+				task = NULL;
+			}
+			SDL_AtomicSet(&worker->bottom, (int)(bottom + 1));
+		}
+	} else {
+		SDL_AtomicSet(&worker->bottom, (int)(bottom + 1));
+	}
+	return(task);
+}
+
+static SDL_Task *SDL_StealTask(SDL_Worker *worker, int *contended)
+{
+	Uint32 top = (Uint32)SDL_AtomicGet(&worker->top);
+	Uint32 bottom = (Uint32)SDL_AtomicGet(&worker->bottom);
+	SDL_Task *task;
+
+	if ( (int)(bottom - top) <= 0 ) {
+		return(NULL);
+	}
+	task = (SDL_Task *)SDL_AtomicGetPtr(&worker->tasks[top % SDL_WORKER_DEQUE]);
+	if ( ! SDL_AtomicCAS(&worker->top, (int)top, (int)(top + 1)) ) {
+		/* Somebody else got it, there may be more */
+		*contended = 1;
+		return(NULL);
+	}
+	return(task);
+}
+
+/* The worker running on this thread, or NULL */
+static SDL_Worker *SDL_GetWorker(SDL_ThreadPool *pool)
+{
+	Uint32 self = SDL_ThreadID();
+	int i;
+
+	for ( i = 0; i < pool->numworkers; ++i ) {
+		if ( (Uint32)SDL_AtomicGet(&pool->workers[i]->threadid) == self ) {
+			return(pool->workers[i]);
+		}
+	}
+	return(NULL);
+}
+
+static void SDL_WakeWorker(SDL_ThreadPool *pool)
+{
+	int sleepers;
+
+	while ( (sleepers = SDL_AtomicGet(&pool->sleepers)) > 0 ) {
+		if ( SDL_AtomicCAS(&pool->sleepers, sleepers, sleepers - 1) ) {
+			SDL_SemPost(pool->wakeup);
+			break;
+		}
+	}
+}
+
+static void SDL_QueueTask(SDL_ThreadPool *pool, SDL_Worker *worker, SDL_Task *task)
+{
+	if ( ! worker || SDL_PushTask(worker, task) < 0 ) {
+		SDL_mutexP(pool->lock);
+		task->next = NULL;
+		if ( pool->tail ) {
+			pool->tail->next = task;
+		} else {
+			pool->head = task;
+		}
+		pool->tail = task;
+		SDL_AtomicAdd(&pool->queued, 1);
+		SDL_mutexV(pool->lock);
+	}
+	SDL_WakeWorker(pool);
+}
+
+static SDL_Task *SDL_NewTask(SDL_TaskCounter *counter)
+{
+	SDL_Task *task;
+
+	task = (SDL_Task *)SDL_calloc(1, sizeof(*task));
+	if ( task == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	task->counter = counter;
+	if ( counter ) {
+		SDL_AtomicAdd(&counter->pending, 2);
+	}
+	return(task);
+}
+
+static void SDL_TaskDone(SDL_TaskCounter *counter)
+{
+	int pending, waiters;
+
+	for ( ; ; ) {
+		pending = SDL_AtomicGet(&counter->pending);
+		if ( pending != 2 ) {
+			if ( SDL_AtomicCAS(&counter->pending, pending, pending - 2) ) {
+				return;
+			}
+		} else if ( SDL_AtomicCAS(&counter->pending, pending, 1) ) {
+			for ( waiters = SDL_AtomicGet(&counter->waiters); waiters > 0; --waiters ) {
+				SDL_SemPost(counter->sem);
+			}
+			/* The counter may be gone as soon as this reaches 0 */
+			SDL_AtomicAdd(&counter->pending, -1);
+			return;
+		}
+	}
+}
+
+/* Find a task: our own newest, then the shared queue, then the oldest
+   task of another worker, starting from a random one.
+ */
+static SDL_Task *SDL_FindTask(SDL_ThreadPool *pool, SDL_Worker *worker)
+{
+	SDL_Task *task = NULL;
+	int i, start, contended;
+
+	if ( worker && (task = SDL_PopTask(worker)) != NULL ) {
+		return(task);
+	}
+	if ( SDL_AtomicGet(&pool->queued) > 0 ) {
+		SDL_mutexP(pool->lock);
+		task = pool->head;
+		if ( task ) {
+			pool->head = task->next;
+			if ( pool->head == NULL ) {
+				pool->tail = NULL;
+			}
+			SDL_AtomicAdd(&pool->queued, -1);
+		}
+		SDL_mutexV(pool->lock);
+		if ( task ) {
+			return(task);
+		}
+	}
+	if ( worker ) {
+		worker->seed = worker->seed * 1103515245 + 12345;
+		start = (worker->seed >> 16) % pool->numworkers;
+	} else {
+		start = 0;
+	}
+	do {
+		contended = 0;
+		for ( i = 0; i < pool->numworkers; ++i ) {
+			SDL_Worker *victim = pool->workers[(start + i) % pool->numworkers];
+			if ( victim != worker &&
+			     (task = SDL_StealTask(victim, &contended)) != NULL ) {
+				return(task);
+			}
+		}
+	} while ( contended );
+	return(NULL);
+}
+
+static void SDL_RunTask(SDL_ThreadPool *pool, SDL_Worker *worker, SDL_Task *task)
+{
+	SDL_TaskCounter *counter = task->counter;
+	SDL_Task *half;
+	int middle;
+
+	if ( task->range ) {
+		/* Leave the upper halves for the others until a part is left */
+		while ( task->last - task->first > task->grain ) {
+			middle = task->first + (task->last - task->first) / 2;
+			half = SDL_NewTask(counter);
+			if ( half == NULL ) {
+				break;
+			}
+			*half = *task;
+			half->first = middle;
+			SDL_QueueTask(pool, worker, half);
+			task->last = middle;
+		}
+		task->range(task->data, task->first, task->last);
+	} else {
+		task->func(task->data);
+	}
+	SDL_free(task);
+	if ( counter ) {
+		SDL_TaskDone(counter);
+	}
+}
+
+static int SDL_HasWork(SDL_ThreadPool *pool)
+{
+	int i;
+
+	if ( SDL_AtomicGet(&pool->queued) > 0 ) {
+		return(1);
+	}
+	for ( i = 0; i < pool->numworkers; ++i ) {
+		SDL_Worker *worker = pool->workers[i];
+		if ( (int)((Uint32)SDL_AtomicGet(&worker->bottom) -
+		           (Uint32)SDL_AtomicGet(&worker->top)) > 0 ) {
+			return(1);
+		}
+	}
+	return(0);
+}
+
+static int SDLCALL SDL_RunWorker(void *data)
+{
+	SDL_Worker *worker = (SDL_Worker *)data;
+	SDL_ThreadPool *pool = worker->pool;
+	SDL_Task *task;
+	int sleepers;
+
+	SDL_AtomicSet(&worker->threadid, (int)SDL_ThreadID());
+	for ( ; ; ) {
+		task = SDL_FindTask(pool, worker);
+		if ( task ) {
+			SDL_RunTask(pool, worker, task);
+			continue;
+		}
+		if ( SDL_AtomicGet(&pool->quit) ) {
+			break;
+		}
+
+		/* Go to sleep, unless work came in while we registered.  If
+		   every sleeper has been claimed, one of the wakeups is ours.
+		 */
+		SDL_AtomicAdd(&pool->sleepers, 1);
+		if ( SDL_HasWork(pool) || SDL_AtomicGet(&pool->quit) ) {
+			while ( (sleepers = SDL_AtomicGet(&pool->sleepers)) > 0 ) {
+				if ( SDL_AtomicCAS(&pool->sleepers, sleepers, sleepers - 1) ) {
+					break;
+				}
+			}
+			if ( sleepers > 0 ) {
+				continue;
+			}
+		}
+		SDL_SemWait(pool->wakeup);
+	}
+	return(0);
+}
+
+SDL_ThreadPool *SDL_CreateThreadPool(int workers, const SDL_ThreadAttributes *attr)
+{
+	SDL_ThreadPool *pool;
+	SDL_ThreadAttributes worker_attr;
+	Uint32 cpumask;
+	int i, cpu;
+
+	if ( workers <= 0 ) {
+		SDL_SetError("Invalid number of workers: %d", workers);
+		return(NULL);
+	}
+	pool = (SDL_ThreadPool *)SDL_calloc(1, sizeof(*pool));
+	if ( pool == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	pool->workers = (SDL_Worker **)SDL_calloc(workers, sizeof(*pool->workers));
+	pool->lock = SDL_CreateMutex();
+	pool->wakeup = SDL_CreateSemaphore(0);
+	if ( ! pool->workers || ! pool->lock || ! pool->wakeup ) {
+		SDL_DestroyThreadPool(pool);
+		return(NULL);
+	}
+
+	if ( attr ) {
+		worker_attr = *attr;
+	} else {
+		SDL_memset(&worker_attr, 0, sizeof(worker_attr));
+		SDL_GetThreadHints(&worker_attr, "SDL_WORKER_THREAD");
+	}
+	if ( worker_attr.name == NULL ) {
+		worker_attr.name = "SDL worker";
+	}
+	cpumask = worker_attr.cpumask;
+
+	/* All the workers exist before any of them can look for work */
+	for ( i = 0; i < workers; ++i ) {
+		pool->workers[i] = (SDL_Worker *)SDL_calloc(1, sizeof(SDL_Worker));
+		if ( pool->workers[i] == NULL ) {
+			SDL_OutOfMemory();
+			SDL_DestroyThreadPool(pool);
+			return(NULL);
+		}
+		pool->workers[i]->pool = pool;
+		pool->workers[i]->seed = i;
+		++pool->numworkers;
+	}
+	for ( i = 0, cpu = 0; i < workers; ++i ) {
+		if ( cpumask ) {
+			/* The next CPU in the mask, going round */
+			while ( !(cpumask & (1 << cpu)) ) {
+				cpu = (cpu + 1) % 32;
+			}
+			worker_attr.cpumask = 1 << cpu;
+			cpu = (cpu + 1) % 32;
+		}
+		pool->workers[i]->thread = SDL_CreateThreadWithAttributes(SDL_RunWorker, pool->workers[i], &worker_attr);
+		if ( pool->workers[i]->thread == NULL ) {
+			SDL_DestroyThreadPool(pool);
+			return(NULL);
+		}
+	}
+	return(pool);
+}
+
+void SDL_DestroyThreadPool(SDL_ThreadPool *pool)
+{
+	SDL_TaskCounter *counter;
+	int i;
+
+	if ( pool == NULL ) {
+		return;
+	}
+
+	/* The workers finish the work there is, then see they can quit */
+	SDL_AtomicSet(&pool->quit, 1);
+	for ( i = 0; i < pool->numworkers; ++i ) {
+		if ( pool->workers[i]->thread ) {
+			SDL_SemPost(pool->wakeup);
+		}
+	}
+	for ( i = 0; i < pool->numworkers; ++i ) {
+		if ( pool->workers[i]->thread ) {
+			SDL_WaitThread(pool->workers[i]->thread, NULL);
+		}
+	}
+	/* Now nobody steals from them any more */
+	for ( i = 0; i < pool->numworkers; ++i ) {
+		SDL_free(pool->workers[i]);
+	}
+	while ( (counter = pool->spare) != NULL ) {
+		pool->spare = counter->next;
+		SDL_DestroyTaskCounter(counter);
+	}
+	if ( pool->wakeup ) {
+		SDL_DestroySemaphore(pool->wakeup);
+	}
+	if ( pool->lock ) {
+		SDL_DestroyMutex(pool->lock);
+	}
+	SDL_free(pool->workers);
+	SDL_free(pool);
+}
+
+SDL_TaskCounter *SDL_CreateTaskCounter(void)
+{
+	SDL_TaskCounter *counter;
+
+	counter = (SDL_TaskCounter *)SDL_calloc(1, sizeof(*counter));
+	if ( counter == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	counter->sem = SDL_CreateSemaphore(0);
+	if ( counter->sem == NULL ) {
+		SDL_free(counter);
+		return(NULL);
+	}
+	return(counter);
+}
+
+void SDL_DestroyTaskCounter(SDL_TaskCounter *counter)
+{
+	if ( counter ) {
+		SDL_DestroySemaphore(counter->sem);
+		SDL_free(counter);
+	}
+}
+
+int SDL_SubmitTask(SDL_ThreadPool *pool, SDL_TaskFunction func, void *data, SDL_TaskCounter *counter)
+{
+	SDL_Task *task;
+
+	if ( pool == NULL ) {
+		SDL_SetError("Passed a NULL thread pool");
+		return(-1);
+	}
+	task = SDL_NewTask(counter);
+	if ( task == NULL ) {
+		return(-1);
+	}
+	task->func = func;
+	task->data = data;
+	SDL_QueueTask(pool, SDL_GetWorker(pool), task);
+	return(0);
+}
+
+int SDL_ParallelFor(SDL_ThreadPool *pool, int first, int last, int grain, SDL_RangeFunction func, void *data, SDL_TaskCounter *counter)
+{
+	SDL_TaskCounter *wait = NULL;
+	SDL_Task *task;
+	int retval;
+
+	if ( pool == NULL ) {
+		SDL_SetError("Passed a NULL thread pool");
+		return(-1);
+	}
+	if ( first >= last ) {
+		return(0);
+	}
+	if ( grain <= 0 ) {
+		/* About four parts for each worker */
+		grain = (last - first) / (4 * pool->numworkers);
+		if ( grain < 1 ) {
+			grain = 1;
+		}
+	}
+	if ( counter == NULL ) {
+		/* Borrow a counter to wait on */
+		SDL_mutexP(pool->lock);
+		wait = pool->spare;
+		if ( wait ) {
+			pool->spare = wait->next;
+		}
+		SDL_mutexV(pool->lock);
+		if ( wait == NULL && (wait = SDL_CreateTaskCounter()) == NULL ) {
+			return(-1);
+		}
+		counter = wait;
+	}
+
+	retval = 0;
+	task = SDL_NewTask(counter);
+	if ( task ) {
+		task->range = func;
+		task->data = data;
+		task->first = first;
+		task->last = last;
+		task->grain = grain;
+		SDL_QueueTask(pool, SDL_GetWorker(pool), task);
+	} else {
+		retval = -1;
+	}
+
+	if ( wait ) {
+		SDL_WaitTasks(pool, wait);
+		SDL_mutexP(pool->lock);
+		wait->next = pool->spare;
+		pool->spare = wait;
+		SDL_mutexV(pool->lock);
+	}
+	return(retval);
+}
+
+int SDL_WaitTasks(SDL_ThreadPool *pool, SDL_TaskCounter *counter)
+{
+	SDL_Worker *worker;
+	SDL_Task *task;
+
+	if ( pool == NULL || counter == NULL ) {
+		SDL_SetError("Passed a NULL thread pool or counter");
+		return(-1);
+	}
+	worker = SDL_GetWorker(pool);
+	while ( SDL_AtomicGet(&counter->pending) != 0 ) {
+		task = SDL_FindTask(pool, worker);
+		if ( task ) {
+			SDL_RunTask(pool, worker, task);
+			continue;
+		}
+
+		/* A worker keeps looking now and then, the tasks it waits for
+		   may queue work that only it would be awake to run.
+		 */
+		SDL_AtomicAdd(&counter->waiters, 1);
+		if ( SDL_AtomicGet(&counter->pending) > 1 ) {
+			SDL_SemWaitTimeout(counter->sem, worker ? 1 : SDL_MUTEX_MAXWAIT);
+		}
+		SDL_AtomicAdd(&counter->waiters, -1);
+	}
+	return(0);
+}
+
+#endif /* SDL_THREADS_DISABLED */
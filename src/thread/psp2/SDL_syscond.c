@@ -23,21 +23,57 @@
 
 #if SDL_THREAD_PSP2
 
-/* An implementation of condition variables using semaphores and mutexes */
-/*
-   This implementation borrows heavily from the BeOS condition variable
-   implementation, written by Christopher Tate and Owen Smith.  Thanks!
+/* Condition variables on one kernel semaphore, see SDL_fastcond_c.h.
+
+   The kernel's own condition variables can only be used with a kernel
+   mutex, and SDL_mutex stays out of the kernel unless it's contended.
  */
 
 #include "SDL_thread.h"
 
+#include <psp2/kernel/threadmgr.h>
+#include <psp2/kernel/error.h>
+
+/* The longest wait the kernel takes at once, in milliseconds */
+#define PSP2_MAXWAIT	(0x7FFFFFFF / 1000)
+
+static int PSP2_CondWait(SceUID sem, Uint32 ms)
+{
+	SceUInt timeout;
+	Uint32 wait;
+	int res;
+
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		res = sceKernelWaitSema(sem, 1, NULL);
+	} else {
+		/* Long timeouts would overflow in microseconds, wait in pieces */
+		do {
+			wait = (ms > PSP2_MAXWAIT) ? PSP2_MAXWAIT : ms;
+			ms -= wait;
+			timeout = wait * 1000;
+			res = sceKernelWaitSema(sem, 1, &timeout);
+		} while ( res == SCE_KERNEL_ERROR_WAIT_TIMEOUT && ms > 0 );
+	}
+	switch (res) {
+		case SCE_KERNEL_OK:
+			return 0;
+		case SCE_KERNEL_ERROR_WAIT_TIMEOUT:
+			return SDL_MUTEX_TIMEDOUT;
+		default:
+			SDL_SetError("sceKernelWaitSema() failed: %x", res);
+			return -1;
+	}
+}
+
+#define SDL_FastCondSem			SceUID
+#define SDL_FastCondWait(sem, ms)	PSP2_CondWait(sem, ms)
+#define SDL_FastCondPost(sem, n)	sceKernelSignalSema(sem, n)
+
+#include "../SDL_fastcond_c.h"
+
 struct SDL_cond
 {
-	SDL_mutex *lock;
-	int waiting;
-	int signals;
-	SDL_sem *wait_sem;
-	SDL_sem *wait_done;
+	SDL_FastCond fast;
 };
 
 /* Create a condition variable */
@@ -45,14 +81,13 @@ SDL_cond * SDL_CreateCond(void)
 {
 	SDL_cond *cond;
 
-	cond = (SDL_cond *) SDL_malloc(sizeof(SDL_cond));
+	cond = (SDL_cond *) SDL_calloc(1, sizeof(SDL_cond));
 	if ( cond ) {
-		cond->lock = SDL_CreateMutex();
-		cond->wait_sem = SDL_CreateSemaphore(0);
-		cond->wait_done = SDL_CreateSemaphore(0);
-		cond->waiting = cond->signals = 0;
-		if ( ! cond->lock || ! cond->wait_sem || ! cond->wait_done ) {
-			SDL_DestroyCond(cond);
+		/* At most one wakeup per waiter is ever posted */
+		cond->fast.sem = sceKernelCreateSema("SDL cond", 0, 0, 0xFFFF, NULL);
+		if ( cond->fast.sem < 0 ) {
+			SDL_SetError("sceKernelCreateSema() failed: %x", cond->fast.sem);
+			SDL_free(cond);
 			cond = NULL;
 		}
 	} else {
@@ -65,15 +100,7 @@ SDL_cond * SDL_CreateCond(void)
 void SDL_DestroyCond(SDL_cond *cond)
 {
 	if ( cond ) {
-		if ( cond->wait_sem ) {
-			SDL_DestroySemaphore(cond->wait_sem);
-		}
-		if ( cond->wait_done ) {
-			SDL_DestroySemaphore(cond->wait_done);
-		}
-		if ( cond->lock ) {
-			SDL_DestroyMutex(cond->lock);
-		}
+		sceKernelDeleteSema(cond->fast.sem);
 		SDL_free(cond);
 	}
 }
@@ -85,20 +112,10 @@ int SDL_CondSignal(SDL_cond *cond)
 		SDL_SetError("Passed a NULL condition variable");
 		return -1;
 	}
-
-	/* If there are waiting threads not already signalled, then
-	   signal the condition and wait for the thread to respond.
-	*/
-	SDL_LockMutex(cond->lock);
-	if ( cond->waiting > cond->signals ) {
-		++cond->signals;
-		SDL_SemPost(cond->wait_sem);
-		SDL_UnlockMutex(cond->lock);
-		SDL_SemWait(cond->wait_done);
-	} else {
-		SDL_UnlockMutex(cond->lock);
+	if ( SDL_FastCondSignal(&cond->fast, 0) < 0 ) {
+		SDL_SetError("sceKernelSignalSema() failed");
+		return -1;
 	}
-
 	return 0;
 }
 
@@ -109,30 +126,10 @@ int SDL_CondBroadcast(SDL_cond *cond)
 		SDL_SetError("Passed a NULL condition variable");
 		return -1;
 	}
-
-	/* If there are waiting threads not already signalled, then
-	   signal the condition and wait for the thread to respond.
-	*/
-	SDL_LockMutex(cond->lock);
-	if ( cond->waiting > cond->signals ) {
-		int i, num_waiting;
-
-		num_waiting = (cond->waiting - cond->signals);
-		cond->signals = cond->waiting;
-		for ( i=0; i<num_waiting; ++i ) {
-			SDL_SemPost(cond->wait_sem);
-		}
-		/* Now all released threads are blocked here, waiting for us.
-		   Collect them all (and win fabulous prizes!) :-)
-		 */
-		SDL_UnlockMutex(cond->lock);
-		for ( i=0; i<num_waiting; ++i ) {
-			SDL_SemWait(cond->wait_done);
-		}
-	} else {
-		SDL_UnlockMutex(cond->lock);
+	if ( SDL_FastCondSignal(&cond->fast, 1) < 0 ) {
+		SDL_SetError("sceKernelSignalSema() failed");
+		return -1;
 	}
-
 	return 0;
 }
 
@@ -165,46 +162,15 @@ int SDL_CondWaitTimeout(SDL_cond *cond, SDL_mutex *mutex, Uint32 ms)
 		return -1;
 	}
 
-	/* Obtain the protection mutex, and increment the number of waiters.
-	   This allows the signal mechanism to only perform a signal if there
-	   are waiting threads.
+	/* Count ourselves in before letting go of the mutex, so a signal
+	   sent as soon as it's unlocked can't miss us.
 	 */
-	SDL_LockMutex(cond->lock);
-	++cond->waiting;
-	SDL_UnlockMutex(cond->lock);
-
-	/* Unlock the mutex, as is required by condition variable semantics */
-	SDL_UnlockMutex(mutex);
-
-	/* Wait for a signal */
-	if ( ms == SDL_MUTEX_MAXWAIT ) {
-		retval = SDL_SemWait(cond->wait_sem);
-	} else {
-		retval = SDL_SemWaitTimeout(cond->wait_sem, ms);
-	}
-
-	/* Let the signaler know we have completed the wait, otherwise
-           the signaler can race ahead and get the condition semaphore
-           if we are stopped between the mutex unlock and semaphore wait,
-           giving a deadlock.  See the following URL for details:
-        http://www-classic.be.com/aboutbe/benewsletter/volume_III/Issue40.html
-	*/
-	SDL_LockMutex(cond->lock);
-	if ( cond->signals > 0 ) {
-		/* If we timed out, we need to eat a condition signal */
-		if ( retval > 0 ) {
-			SDL_SemWait(cond->wait_sem);
-		}
-		/* We always notify the signal thread that we are done */
-		SDL_SemPost(cond->wait_done);
-
-		/* Signal handshake complete */
-		--cond->signals;
+	SDL_FastCondPrepare(&cond->fast);
+	if ( SDL_UnlockMutex(mutex) < 0 ) {
+		SDL_FastCondSleep(&cond->fast, 0);
+		return -1;
 	}
-	--cond->waiting;
-	SDL_UnlockMutex(cond->lock);
-
-	/* Lock the mutex, as is required by condition variable semantics */
+	retval = SDL_FastCondSleep(&cond->fast, ms);
 	SDL_LockMutex(mutex);
 
 	return retval;
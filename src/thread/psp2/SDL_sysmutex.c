@@ -29,8 +29,16 @@
 #include <psp2/kernel/threadmgr.h>
 #include <psp2/kernel/error.h>
 
+/* Only contended locks call the kernel, see SDL_fastmutex_c.h */
+#define SDL_FastMutexSem	SceUID
+#define SDL_FastMutexWait(sem)	sceKernelWaitSema(sem, 1, NULL)
+#define SDL_FastMutexPost(sem)	sceKernelSignalSema(sem, 1)
+#define SDL_FastMutexSelf()	((Uint32)sceKernelGetThreadId())
+
+#include "../SDL_fastmutex_c.h"
+
 struct SDL_mutex {
-	SceUID uid;
+	SDL_FastMutex fast;
 };
 
 /* Create a mutex */
@@ -39,17 +47,13 @@ SDL_mutex *SDL_CreateMutex(void)
 	SDL_mutex *mutex;
 
 	/* Allocate mutex memory */
-	mutex = (SDL_mutex *)SDL_malloc(sizeof(*mutex));
+	mutex = (SDL_mutex *)SDL_calloc(1, sizeof(*mutex));
 	if ( mutex ) {
-        mutex->uid =  sceKernelCreateMutex("SDL mutex",
-            SCE_KERNEL_MUTEX_ATTR_RECURSIVE,
-            0,
-            NULL
-        );
-
-        if (mutex->uid <= 0) {
-            printf("Error creating mutex: %x\n", mutex->uid);
-            SDL_OutOfMemory(); // TODO: proper error
+		mutex->fast.sem = sceKernelCreateSema("SDL mutex", 0, 0, 1, NULL);
+		if ( mutex->fast.sem < 0 ) {
+			SDL_SetError("sceKernelCreateSema() failed: %x", mutex->fast.sem);
+			SDL_free(mutex);
+			mutex = NULL;
 		}
 	} else {
 		SDL_OutOfMemory();
@@ -61,7 +65,7 @@ SDL_mutex *SDL_CreateMutex(void)
 void SDL_DestroyMutex(SDL_mutex *mutex)
 {
 	if ( mutex ) {
-		sceKernelDeleteMutex(mutex->uid);
+		sceKernelDeleteSema(mutex->fast.sem);
 		SDL_free(mutex);
 	}
 }
@@ -70,21 +74,16 @@ void SDL_DestroyMutex(SDL_mutex *mutex)
 int SDL_mutexP(SDL_mutex *mutex)
 {
 #if SDL_THREADS_DISABLED
-    return 0;
+	return 0;
 #else
-    SceInt32 res = 0;
-
 	if ( mutex == NULL ) {
-        SDL_SetError("Passed a NULL mutex");
+		SDL_SetError("Passed a NULL mutex");
 		return -1;
 	}
-
-    res = sceKernelLockMutex(mutex->uid, 1, NULL);
-    if (res != SCE_KERNEL_OK) {
-        SDL_SetError("Error trying to lock mutex: %x", res);
-        return -1;
+	if ( SDL_FastMutexLock(&mutex->fast) < 0 ) {
+		SDL_SetError("Error trying to lock mutex");
+		return -1;
 	}
-
 	return 0;
 #endif /* SDL_THREADS_DISABLED */
 }
@@ -95,19 +94,14 @@ int SDL_mutexV(SDL_mutex *mutex)
 #if SDL_THREADS_DISABLED
 	return 0;
 #else
-	SceInt32 res = 0;
-
 	if ( mutex == NULL ) {
-        SDL_SetError("Passed a NULL mutex");
+		SDL_SetError("Passed a NULL mutex");
 		return -1;
 	}
-
-    res = sceKernelUnlockMutex(mutex->uid, 1);
-    if (res != 0) {
-        SDL_SetError("Error trying to unlock mutex: %x", res);
+	if ( SDL_FastMutexUnlock(&mutex->fast) < 0 ) {
+		SDL_SetError("mutex not owned by this thread");
 		return -1;
 	}
-
 	return 0;
 #endif /* SDL_THREADS_DISABLED */
 }
@@ -38,10 +38,21 @@ static int ThreadEntry(SceSize args, void *argp)
     return 0;
 }
 
+/* User thread priorities go from 64 (highest) to 191, 160 is the default */
+static const int priorities[] = { 0, 176, 160, 128, 64 };
+
+/* The user cores are CPUs 0 to 2 */
+#define PSP2_CPU_MASK_USER_0	0x10000
+#define PSP2_NUM_USER_CPUS	3
+
 int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
 {
+    const SDL_ThreadAttributes *attr = ((thread_args *)args)->attr;
     SceKernelThreadInfo info;
+    const char *name = "SDL thread";
+    SceSize stacksize = 0x10000;
     int priority = 32;
+    int cpumask = 0;
 
     /* Set priority of new thread to the same as the current thread */
     info.size = sizeof(SceKernelThreadInfo);
@@ -50,12 +61,38 @@ int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
         priority = info.currentPriority;
     }
 
-    thread->handle = sceKernelCreateThread("SDL thread", ThreadEntry,
-                           priority, 0x10000, 0, 0, NULL);
+    if (attr)
+    {
+        if (attr->name)
+        {
+            name = attr->name;
+        }
+        if (attr->stacksize)
+        {
+            /* The kernel wants whole pages */
+            stacksize = (attr->stacksize + 0xFFF) & ~0xFFF;
+        }
+        if (attr->priority != SDL_THREAD_PRIORITY_DEFAULT)
+        {
+            priority = priorities[attr->priority];
+        }
+        if (attr->cpumask)
+        {
+            if (attr->cpumask >> PSP2_NUM_USER_CPUS)
+            {
+                SDL_SetError("Only CPUs 0-2 run user threads, not mask 0x%x", attr->cpumask);
+                return -1;
+            }
+            cpumask = attr->cpumask * PSP2_CPU_MASK_USER_0;
+        }
+    }
+
+    thread->handle = sceKernelCreateThread(name, ThreadEntry,
+                           priority, stacksize, 0, cpumask, NULL);
 
     if (thread->handle < 0)
     {
-		SDL_SetError("sceKernelCreateThread() failed");
+		SDL_SetError("sceKernelCreateThread() failed: %x", thread->handle);
         return -1;
     }
 
@@ -23,6 +23,13 @@
 
 #include <pthread.h>
 #include <signal.h>
+#include <errno.h>
+#ifdef __LINUX__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
 
 #include "SDL_thread.h"
 #include "../SDL_thread_c.h"
@@ -42,8 +49,22 @@ Uint32 riscos_main_thread = 0; /* Thread running events */
 #endif
  
 
+#ifdef __LINUX__
+/* Nice values for the priority classes, raising them needs privileges */
+static const int nice_values[] = { 0, 10, 0, -5, -10 };
+#endif
+
 static void *RunThread(void *data)
 {
+#ifdef __LINUX__
+	const SDL_ThreadAttributes *attr = ((thread_args *)data)->attr;
+
+	/* Linux threads have a nice value of their own */
+	if ( attr && attr->priority != SDL_THREAD_PRIORITY_DEFAULT ) {
+		setpriority(PRIO_PROCESS, syscall(SYS_gettid),
+		            nice_values[attr->priority]);
+	}
+#endif
 	SDL_RunThread(data);
 	pthread_exit((void*)0);
 	return((void *)0);		/* Prevent compiler warning */
@@ -51,7 +72,9 @@ static void *RunThread(void *data)
 
 int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
 {
+	const SDL_ThreadAttributes *attr = ((thread_args *)args)->attr;
 	pthread_attr_t type;
+	int retval;
 
 	/* Set the thread attributes */
 	if ( pthread_attr_init(&type) != 0 ) {
@@ -59,12 +82,48 @@ int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
 		return(-1);
 	}
 	pthread_attr_setdetachstate(&type, PTHREAD_CREATE_JOINABLE);
+	if ( attr && attr->stacksize ) {
+		if ( pthread_attr_setstacksize(&type, attr->stacksize) != 0 ) {
+			SDL_SetError("Invalid thread stack size: %u", attr->stacksize);
+			pthread_attr_destroy(&type);
+			return(-1);
+		}
+	}
+#if defined(__LINUX__) && defined(CPU_SET)
+	if ( attr && attr->cpumask ) {
+		cpu_set_t cpus;
+		int i;
+
+		CPU_ZERO(&cpus);
+		for ( i = 0; i < 32; ++i ) {
+			if ( attr->cpumask & (1u << i) ) {
+				CPU_SET(i, &cpus);
+			}
+		}
+		pthread_attr_setaffinity_np(&type, sizeof(cpus), &cpus);
+	}
+#endif
 
 	/* Create the thread and go! */
-	if ( pthread_create(&thread->handle, &type, RunThread, args) != 0 ) {
-		SDL_SetError("Not enough resources to create thread");
+	retval = pthread_create(&thread->handle, &type, RunThread, args);
+	pthread_attr_destroy(&type);
+	if ( retval != 0 ) {
+		if ( retval == EINVAL && attr && attr->cpumask ) {
+			SDL_SetError("No CPU in thread CPU mask 0x%x", attr->cpumask);
+		} else {
+			SDL_SetError("Not enough resources to create thread");
+		}
 		return(-1);
 	}
+#if defined(__LINUX__) && defined(CPU_SET)
+	if ( attr && attr->name ) {
+		/* Linux only keeps 15 characters */
+		char name[16];
+
+		SDL_strlcpy(name, attr->name, sizeof(name));
+		pthread_setname_np(thread->handle, name);
+	}
+#endif
 
 #ifdef __RISCOS__
 	if (riscos_using_threads == 0) {
@@ -42,13 +42,21 @@ struct _SDL_TimerID {
 	Uint32 interval;
 	SDL_NewTimerCallback cb;
 	void *param;
-	Uint32 last_alarm;
-	struct _SDL_TimerID *next;
+	Uint32 next_alarm;
+	int index;
 };
 
-static SDL_TimerID SDL_timers = NULL;
+/* The timers are kept in a binary min-heap ordered by their next alarm,
+   so the timer thread only looks at the first one and can sleep until
+   it's due.  The timer whose callback is running is out of the heap.
+ */
+static SDL_TimerID *SDL_timers = NULL;
+static int SDL_num_timers = 0;
+static int SDL_max_timers = 0;
+static SDL_TimerID SDL_current_timer = NULL;
+static SDL_bool current_removed = SDL_FALSE;
 static SDL_mutex *SDL_timer_mutex;
-static volatile SDL_bool list_changed = SDL_FALSE;
+static SDL_sem *SDL_timer_wakeup;
 
 /* Set whether or not the timer should use a thread.
    This should not be called while the timer subsystem is running.
@@ -80,6 +88,7 @@ int SDL_TimerInit(void)
 	}
 	if ( SDL_timer_threaded ) {
 		SDL_timer_mutex = SDL_CreateMutex();
+		SDL_timer_wakeup = SDL_CreateSemaphore(0);
 	}
 	if ( retval == 0 ) {
 		SDL_timer_started = 1;
@@ -96,70 +105,152 @@ void SDL_TimerQuit(void)
 	if ( SDL_timer_threaded ) {
 		SDL_DestroyMutex(SDL_timer_mutex);
 		SDL_timer_mutex = NULL;
+		SDL_DestroySemaphore(SDL_timer_wakeup);
+		SDL_timer_wakeup = NULL;
 	}
+	SDL_free(SDL_timers);
+	SDL_timers = NULL;
+	SDL_max_timers = 0;
 	SDL_timer_started = 0;
 	SDL_timer_threaded = 0;
 }
 
-void SDL_ThreadedTimerCheck(void)
+/* Move the timer at 'index' up or down the heap to where it belongs */
+static void SDL_SiftTimer(int index)
 {
-	Uint32 now, ms;
-	SDL_TimerID t, prev, next;
-	SDL_bool removed;
+	SDL_TimerID t = SDL_timers[index];
+	int parent, child;
+
+	while ( index > 0 ) {
+		parent = (index - 1) / 2;
+		if ( (Sint32)(SDL_timers[parent]->next_alarm - t->next_alarm) <= 0 ) {
+			break;
+		}
+		SDL_timers[index] = SDL_timers[parent];
+		SDL_timers[index]->index = index;
+		index = parent;
+	}
+	for ( ; ; ) {
+		child = 2 * index + 1;
+		if ( child >= SDL_num_timers ) {
+			break;
+		}
+		if ( child + 1 < SDL_num_timers &&
+		     (Sint32)(SDL_timers[child+1]->next_alarm -
+		              SDL_timers[child]->next_alarm) < 0 ) {
+			++child;
+		}
+		if ( (Sint32)(t->next_alarm - SDL_timers[child]->next_alarm) <= 0 ) {
+			break;
+		}
+		SDL_timers[index] = SDL_timers[child];
+		SDL_timers[index]->index = index;
+		index = child;
+	}
+	SDL_timers[index] = t;
+	t->index = index;
+}
+
+static int SDL_InsertTimer(SDL_TimerID t)
+{
+	if ( SDL_num_timers == SDL_max_timers ) {
+		int size = SDL_max_timers ? SDL_max_timers * 2 : 16;
+		SDL_TimerID *timers;
+
+		timers = (SDL_TimerID *)SDL_realloc(SDL_timers, size * sizeof(*timers));
+		if ( ! timers ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		SDL_timers = timers;
+		SDL_max_timers = size;
+	}
+	SDL_timers[SDL_num_timers++] = t;
+	SDL_SiftTimer(SDL_num_timers - 1);
+	return(0);
+}
+
+static void SDL_DeleteTimer(SDL_TimerID t)
+{
+	int index = t->index;
+
+	if ( index != --SDL_num_timers ) {
+		SDL_timers[index] = SDL_timers[SDL_num_timers];
+		SDL_SiftTimer(index);
+	}
+	t->index = -1;
+}
+
+void SDL_ThreadedTimerWake(void)
+{
+	if ( SDL_timer_wakeup && SDL_SemValue(SDL_timer_wakeup) == 0 ) {
+		SDL_SemPost(SDL_timer_wakeup);
+	}
+}
+
+Uint32 SDL_ThreadedTimerCheck(void)
+{
+	Uint32 now, ms, wait;
+	SDL_TimerID t;
 
 	SDL_mutexP(SDL_timer_mutex);
-	list_changed = SDL_FALSE;
-	now = SDL_GetTicks();
-	for ( prev = NULL, t = SDL_timers; t; t = next ) {
-		removed = SDL_FALSE;
-		ms = t->interval - SDL_TIMESLICE;
-		next = t->next;
-		if ( (int)(now - t->last_alarm) > (int)ms ) {
-			struct _SDL_TimerID timer;
-
-			if ( (now - t->last_alarm) < t->interval ) {
-				t->last_alarm += t->interval;
-			} else {
-				t->last_alarm = now;
-			}
+	for ( ; ; ) {
+		if ( ! SDL_num_timers ) {
+			wait = SDL_MUTEX_MAXWAIT;
+			break;
+		}
+		now = SDL_GetTicks();
+		t = SDL_timers[0];
+		if ( (Sint32)(t->next_alarm - now) > 0 ) {
+			wait = t->next_alarm - now;
+			break;
+		}
+		SDL_DeleteTimer(t);
 #ifdef DEBUG_TIMERS
-			printf("Executing timer %p (thread = %d)\n",
-				t, SDL_ThreadID());
+		printf("Executing timer %p (thread = %d)\n",
+			t, SDL_ThreadID());
 #endif
-			timer = *t;
-			SDL_mutexV(SDL_timer_mutex);
-			ms = timer.cb(timer.interval, timer.param);
-			SDL_mutexP(SDL_timer_mutex);
-			if ( list_changed ) {
-				/* Abort, list of timers modified */
-				/* FIXME: what if ms was changed? */
-				break;
-			}
-			if ( ms != t->interval ) {
-				if ( ms ) {
-					t->interval = ROUND_RESOLUTION(ms);
-				} else {
-					/* Remove timer from the list */
+		/* Timers may be added and removed while the callback runs */
+		SDL_current_timer = t;
+		current_removed = SDL_FALSE;
+		SDL_mutexV(SDL_timer_mutex);
+		ms = t->cb(t->interval, t->param);
+		SDL_mutexP(SDL_timer_mutex);
+		SDL_current_timer = NULL;
+		if ( current_removed ) {
+			SDL_free(t);
+			continue;
+		}
+		if ( ! ms ) {
 #ifdef DEBUG_TIMERS
-					printf("SDL: Removing timer %p\n", t);
+			printf("SDL: Removing timer %p\n", t);
 #endif
-					if ( prev ) {
-						prev->next = next;
-					} else {
-						SDL_timers = next;
-					}
-					SDL_free(t);
-					--SDL_timer_running;
-					removed = SDL_TRUE;
-				}
-			}
+			SDL_free(t);
+			--SDL_timer_running;
+			continue;
 		}
-		/* Don't update prev if the timer has disappeared */
-		if ( ! removed ) {
-			prev = t;
+		t->interval = ROUND_RESOLUTION(ms);
+		t->next_alarm += t->interval;
+		if ( (Sint32)(now - t->next_alarm) >= 0 ) {
+			/* We're a whole interval late, don't try to catch up */
+			t->next_alarm = now + t->interval;
+		}
+		if ( SDL_InsertTimer(t) < 0 ) {
+			SDL_free(t);
+			--SDL_timer_running;
 		}
 	}
 	SDL_mutexV(SDL_timer_mutex);
+	return(wait);
+}
+
+void SDL_ThreadedTimerWait(Uint32 ms)
+{
+	if ( SDL_timer_wakeup ) {
+		SDL_SemWaitTimeout(SDL_timer_wakeup, ms);
+	} else {
+		SDL_Delay(1);
+	}
 }
 
 static SDL_TimerID SDL_AddTimerInternal(Uint32 interval, SDL_NewTimerCallback callback, void *param)
@@ -170,11 +261,16 @@ static SDL_TimerID SDL_AddTimerInternal(Uint32 interval, SDL_NewTimerCallback ca
 		t->interval = ROUND_RESOLUTION(interval);
 		t->cb = callback;
 		t->param = param;
-		t->last_alarm = SDL_GetTicks();
-		t->next = SDL_timers;
-		SDL_timers = t;
+		t->next_alarm = SDL_GetTicks() + t->interval;
+		if ( SDL_InsertTimer(t) < 0 ) {
+			SDL_free(t);
+			return NULL;
+		}
 		++SDL_timer_running;
-		list_changed = SDL_TRUE;
+		if ( t->index == 0 ) {
+			/* It's due before the one the timer thread waits for */
+			SDL_ThreadedTimerWake();
+		}
 	}
 #ifdef DEBUG_TIMERS
 	printf("SDL_AddTimer(%d) = %08x num_timers = %d\n", interval, (Uint32)t, SDL_timer_running);
@@ -205,26 +301,29 @@ SDL_TimerID SDL_AddTimer(Uint32 interval, SDL_NewTimerCallback callback, void *p
 
 SDL_bool SDL_RemoveTimer(SDL_TimerID id)
 {
-	SDL_TimerID t, prev = NULL;
 	SDL_bool removed;
+	int i;
 
 	removed = SDL_FALSE;
 	SDL_mutexP(SDL_timer_mutex);
-	/* Look for id in the linked list of timers */
-	for (t = SDL_timers; t; prev=t, t = t->next ) {
-		if ( t == id ) {
-			if(prev) {
-				prev->next = t->next;
-			} else {
-				SDL_timers = t->next;
+	if ( id && id == SDL_current_timer && ! current_removed ) {
+		/* Its callback is running, it's freed when that returns */
+		current_removed = SDL_TRUE;
+		removed = SDL_TRUE;
+	} else {
+		/* The id may be stale, so look for it without touching it */
+		for ( i = 0; i < SDL_num_timers; ++i ) {
+			if ( SDL_timers[i] == id ) {
+				SDL_DeleteTimer(id);
+				SDL_free(id);
+				removed = SDL_TRUE;
+				break;
 			}
-			SDL_free(t);
-			--SDL_timer_running;
-			removed = SDL_TRUE;
-			list_changed = SDL_TRUE;
-			break;
 		}
 	}
+	if ( removed ) {
+		--SDL_timer_running;
+	}
 #ifdef DEBUG_TIMERS
 	printf("SDL_RemoveTimer(%08x) = %d num_timers = %d thread = %d\n", (Uint32)id, removed, SDL_timer_running, SDL_ThreadID());
 #endif
@@ -232,6 +331,48 @@ SDL_bool SDL_RemoveTimer(SDL_TimerID id)
 	return removed;
 }
 
+#if !defined(SDL_TIMER_UNIX) && !defined(SDL_TIMER_PSP2)
+/* Backends without a finer clock count milliseconds */
+Uint64 SDL_GetPerformanceCounter(void)
+{
+	return SDL_GetTicks();
+}
+
+Uint64 SDL_GetPerformanceFrequency(void)
+{
+	return 1000;
+}
+
+Uint64 SDL_GetTicksUS(void)
+{
+	return (Uint64)SDL_GetTicks() * 1000;
+}
+#endif
+
+/* How long SDL_DelayPrecise() spins rather than sleeps, in microseconds.
+   Sleeping may wake us up about this late.
+ */
+#define PRECISE_SPIN	1000
+
+void SDL_DelayPrecise(Uint32 us)
+{
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	const Uint64 start = SDL_GetPerformanceCounter();
+	const Uint64 ticks = ((Uint64)us * frequency) / 1000000;
+	Uint64 elapsed, left;
+
+	for ( ; ; ) {
+		elapsed = SDL_GetPerformanceCounter() - start;
+		if ( elapsed >= ticks ) {
+			break;
+		}
+		left = ((ticks - elapsed) * 1000000) / frequency;
+		if ( left >= PRECISE_SPIN + 1000 ) {
+			SDL_Delay((Uint32)((left - PRECISE_SPIN) / 1000));
+		}
+	}
+}
+
 /* Old style callback functions are wrapped through this */
 static Uint32 SDLCALL callback_wrapper(Uint32 ms, void *param)
 {
@@ -253,13 +394,14 @@ int SDL_SetTimer(Uint32 ms, SDL_TimerCallback callback)
 	}
 	if ( SDL_timer_running ) {	/* Stop any currently running timer */
 		if ( SDL_timer_threaded ) {
-			while ( SDL_timers ) {
-				SDL_TimerID freeme = SDL_timers;
-				SDL_timers = SDL_timers->next;
-				SDL_free(freeme);
+			while ( SDL_num_timers ) {
+				SDL_free(SDL_timers[--SDL_num_timers]);
+			}
+			if ( SDL_current_timer ) {
+				current_removed = SDL_TRUE;
 			}
 			SDL_timer_running = 0;
-			list_changed = SDL_TRUE;
+			SDL_ThreadedTimerWake();
 		} else {
 			SDL_SYS_StopTimer();
 			SDL_timer_running = 0;
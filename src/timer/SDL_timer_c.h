@@ -42,5 +42,14 @@ extern int SDL_SetTimerThreaded(int value);
 extern int SDL_TimerInit(void);
 extern void SDL_TimerQuit(void);
 
-/* This function is called from the SDL event thread if it is available */
-extern void SDL_ThreadedTimerCheck(void);
+/* This function is called from the SDL event thread if it is available.
+   It runs the timers that are due, and returns the milliseconds until the
+   next one is, or SDL_MUTEX_MAXWAIT if there are no timers.
+ */
+extern Uint32 SDL_ThreadedTimerCheck(void);
+
+/* The timer thread sleeps with this until the next timer is due, and is
+   woken up early when a timer is added.
+ */
+extern void SDL_ThreadedTimerWait(Uint32 ms);
+extern void SDL_ThreadedTimerWake(void);
@@ -42,6 +42,7 @@ void SDL_Delay (Uint32 ms)
 }
 
 #include "SDL_thread.h"
+#include "../../thread/SDL_thread_c.h"
 
 /* Data to handle a single periodic alarm */
 static int timer_alive = 0;
@@ -50,10 +51,9 @@ static SDL_Thread *timer = NULL;
 static int RunTimer(void *unused)
 {
 	while ( timer_alive ) {
-		if ( SDL_timer_running ) {
-			SDL_ThreadedTimerCheck();
-		}
-		SDL_Delay(1);
+		/* Sleep until the next timer is due, or one is added */
+		SDL_ThreadedTimerWait(SDL_timer_running ?
+		                      SDL_ThreadedTimerCheck() : SDL_MUTEX_MAXWAIT);
 	}
 	return(0);
 }
@@ -62,7 +62,8 @@ static int RunTimer(void *unused)
 int SDL_SYS_TimerInit(void)
 {
 	timer_alive = 1;
-	timer = SDL_CreateThread(RunTimer, NULL);
+	timer = SDL_CreateThreadInternal(RunTimer, NULL, "SDL timer",
+	                                 SDL_THREAD_PRIORITY_DEFAULT, "SDL_TIMER_THREAD");
 	if ( timer == NULL )
 		return(-1);
 	return(SDL_SetTimerThreaded(1));
@@ -71,6 +72,7 @@ int SDL_SYS_TimerInit(void)
 void SDL_SYS_TimerQuit(void)
 {
 	timer_alive = 0;
+	SDL_ThreadedTimerWake();
 	if ( timer ) {
 		SDL_WaitThread(timer, NULL);
 		timer = NULL;
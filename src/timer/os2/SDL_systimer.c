@@ -153,10 +153,9 @@ static int SDLCALL RunTimer(void *unused)
 {
         DosSetPriority(PRTYS_THREAD, PRTYC_TIMECRITICAL, 0, 0);
         while (timer_alive) {
-                if (SDL_timer_running) {
-                        SDL_ThreadedTimerCheck();
-                }
-                SDL_Delay(10);
+                /* Sleep until the next timer is due, or one is added */
+                SDL_ThreadedTimerWait(SDL_timer_running ?
+                                      SDL_ThreadedTimerCheck() : SDL_MUTEX_MAXWAIT);
         }
         return 0;
 }
@@ -174,6 +173,7 @@ int SDL_SYS_TimerInit(void)
 void SDL_SYS_TimerQuit(void)
 {
         timer_alive = 0;
+        SDL_ThreadedTimerWake();
         if (timer) {
                 SDL_WaitThread(timer, NULL);
                 timer = NULL;
@@ -54,6 +54,25 @@ Uint32 SDL_GetTicks (void)
     return (ticks);
 }
 
+Uint64 SDL_GetPerformanceCounter(void)
+{
+	/* The process time already counts microseconds */
+	return sceKernelGetProcessTimeWide();
+}
+
+Uint64 SDL_GetPerformanceFrequency(void)
+{
+	return 1000000;
+}
+
+Uint64 SDL_GetTicksUS(void)
+{
+	if (!ticks_started) {
+		SDL_StartTicks();
+	}
+	return sceKernelGetProcessTimeWide() - start;
+}
+
 void SDL_Delay (Uint32 ms)
 {
 	const Uint32 max_delay = 0xffffffffUL / 1000;
@@ -63,6 +82,7 @@ void SDL_Delay (Uint32 ms)
 }
 
 #include "SDL_thread.h"
+#include "../../thread/SDL_thread_c.h"
 
 /* Data to handle a single periodic alarm */
 static int timer_alive = 0;
@@ -71,10 +91,9 @@ static SDL_Thread *timer = NULL;
 static int RunTimer(void *unused)
 {
 	while ( timer_alive ) {
-		if ( SDL_timer_running ) {
-			SDL_ThreadedTimerCheck();
-		}
-		SDL_Delay(1);
+		/* Sleep until the next timer is due, or one is added */
+		SDL_ThreadedTimerWait(SDL_timer_running ?
+		                      SDL_ThreadedTimerCheck() : SDL_MUTEX_MAXWAIT);
 	}
 	return(0);
 }
@@ -83,7 +102,8 @@ static int RunTimer(void *unused)
 int SDL_SYS_TimerInit(void)
 {
 	timer_alive = 1;
-	timer = SDL_CreateThread(RunTimer, NULL);
+	timer = SDL_CreateThreadInternal(RunTimer, NULL, "SDL timer",
+	                                 SDL_THREAD_PRIORITY_DEFAULT, "SDL_TIMER_THREAD");
 	if ( timer == NULL )
 		return(-1);
 	return(SDL_SetTimerThreaded(1));
@@ -92,6 +112,7 @@ int SDL_SYS_TimerInit(void)
 void SDL_SYS_TimerQuit(void)
 {
 	timer_alive = 0;
+	SDL_ThreadedTimerWake();
 	if ( timer ) {
 		SDL_WaitThread(timer, NULL);
 		timer = NULL;
@@ -190,10 +190,9 @@ static SDL_Thread *timer = NULL;
 static int RunTimer(void *unused)
 {
 	while ( timer_alive ) {
-		if ( SDL_timer_running ) {
-			SDL_ThreadedTimerCheck();
-		}
-		SDL_Delay(1);
+		/* Sleep until the next timer is due, or one is added */
+		SDL_ThreadedTimerWait(SDL_timer_running ?
+		                      SDL_ThreadedTimerCheck() : SDL_MUTEX_MAXWAIT);
 	}
 	return(0);
 }
@@ -211,6 +210,7 @@ int SDL_SYS_TimerInit(void)
 void SDL_SYS_TimerQuit(void)
 {
 	timer_alive = 0;
+	SDL_ThreadedTimerWake();
 	if ( timer ) {
 		SDL_WaitThread(timer, NULL);
 		timer = NULL;
@@ -85,6 +85,43 @@ Uint32 SDL_GetTicks (void)
 #endif
 }
 
+Uint64 SDL_GetPerformanceCounter(void)
+{
+#if HAVE_CLOCK_GETTIME
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return (Uint64)now.tv_sec*1000000000 + now.tv_nsec;
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (Uint64)now.tv_sec*1000000 + now.tv_usec;
+#endif
+}
+
+Uint64 SDL_GetPerformanceFrequency(void)
+{
+#if HAVE_CLOCK_GETTIME
+	return 1000000000;
+#else
+	return 1000000;
+#endif
+}
+
+Uint64 SDL_GetTicksUS(void)
+{
+#if HAVE_CLOCK_GETTIME
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return ((Uint64)(now.tv_sec-start.tv_sec)*1000000000 +
+	        (now.tv_nsec-start.tv_nsec))/1000;
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (Uint64)(now.tv_sec-start.tv_sec)*1000000 +
+	       (now.tv_usec-start.tv_usec);
+#endif
+}
+
 void SDL_Delay (Uint32 ms)
 {
 #if SDL_THREAD_PTH
@@ -189,6 +226,7 @@ void SDL_SYS_StopTimer(void)
 #else /* USE_ITIMER */
 
 #include "SDL_thread.h"
+#include "../../thread/SDL_thread_c.h"
 
 /* Data to handle a single periodic alarm */
 static int timer_alive = 0;
@@ -197,10 +235,9 @@ static SDL_Thread *timer = NULL;
 static int RunTimer(void *unused)
 {
 	while ( timer_alive ) {
-		if ( SDL_timer_running ) {
-			SDL_ThreadedTimerCheck();
-		}
-		SDL_Delay(1);
+		/* Sleep until the next timer is due, or one is added */
+		SDL_ThreadedTimerWait(SDL_timer_running ?
+		                      SDL_ThreadedTimerCheck() : SDL_MUTEX_MAXWAIT);
 	}
 	return(0);
 }
@@ -209,7 +246,8 @@ static int RunTimer(void *unused)
 int SDL_SYS_TimerInit(void)
 {
 	timer_alive = 1;
-	timer = SDL_CreateThread(RunTimer, NULL);
+	timer = SDL_CreateThreadInternal(RunTimer, NULL, "SDL timer",
+	                                 SDL_THREAD_PRIORITY_DEFAULT, "SDL_TIMER_THREAD");
 	if ( timer == NULL )
 		return(-1);
 	return(SDL_SetTimerThreaded(1));
@@ -218,6 +256,7 @@ int SDL_SYS_TimerInit(void)
 void SDL_SYS_TimerQuit(void)
 {
 	timer_alive = 0;
+	SDL_ThreadedTimerWake();
 	if ( timer ) {
 		SDL_WaitThread(timer, NULL);
 		timer = NULL;
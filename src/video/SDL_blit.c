@@ -22,10 +22,12 @@
 #include "SDL_config.h"
 
 #include "SDL_video.h"
+#include "SDL_atomic.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "../thread/SDL_thread_c.h"
 
 #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && SDL_ASSEMBLY_ROUTINES
 #define MMX_ASMBLIT
@@ -39,6 +41,109 @@
 #include "mmx.h"
 #endif
 
+/* Threads for large software blits, -1 until the environment is read and
+   -2 while the first blit reads it. The pool and the minimum are
+   set before the count, which the blits read without locking.
+ */
+#define SDL_BLIT_MIN_PIXELS	(128*1024)
+#define BLIT_THREADS_UNSET	-1
+#define BLIT_THREADS_STARTING	-2
+
+static SDL_atomic_t blit_threads = { BLIT_THREADS_UNSET };
+static int blit_min_pixels = SDL_BLIT_MIN_PIXELS;
+static SDL_ThreadPool *blit_pool = NULL;
+
+int SDL_SetBlitThreads(int threads)
+{
+	SDL_ThreadAttributes attr;
+	const char *value;
+
+	if ( threads < 0 ) {
+		SDL_SetError("Invalid number of blit threads: %d", threads);
+		return(-1);
+	}
+	if ( blit_pool ) {
+		SDL_DestroyThreadPool(blit_pool);
+		blit_pool = NULL;
+	}
+	SDL_AtomicSet(&blit_threads, 0);
+
+	value = SDL_getenv("SDL_BLIT_MIN_PIXELS");
+	if ( value ) {
+		blit_min_pixels = SDL_atoi(value);
+	} else {
+		blit_min_pixels = SDL_BLIT_MIN_PIXELS;
+	}
+
+	if ( threads > 1 ) {
+		/* The thread doing the blit does a share of the bands too */
+		SDL_memset(&attr, 0, sizeof(attr));
+		attr.name = "SDL blit";
+		SDL_GetThreadHints(&attr, "SDL_BLIT_THREAD");
+		blit_pool = SDL_CreateThreadPool(threads - 1, &attr);
+		if ( blit_pool == NULL ) {
+			return(-1);
+		}
+		SDL_AtomicSet(&blit_threads, threads);
+	}
+	return(0);
+}
+
+void SDL_BlitThreadsQuit(void)
+{
+	if ( blit_pool ) {
+		SDL_DestroyThreadPool(blit_pool);
+		blit_pool = NULL;
+	}
+	SDL_AtomicSet(&blit_threads, BLIT_THREADS_UNSET);
+}
+
+void SDL_RunBlitBands(int rows, int width, SDL_RangeFunction func, void *data)
+{
+	int threads = SDL_AtomicGet(&blit_threads);
+	int grain;
+
+	/* One thread sets up the pool, blits on other threads meanwhile run
+	   on their own thread */
+	if ( threads == BLIT_THREADS_UNSET &&
+	     SDL_AtomicCAS(&blit_threads, BLIT_THREADS_UNSET, BLIT_THREADS_STARTING) ) {
+		const char *value = SDL_getenv("SDL_BLIT_THREADS");
+
+		if ( SDL_SetBlitThreads(value ? SDL_atoi(value) : 0) < 0 ) {
+			SDL_AtomicSet(&blit_threads, 0);
+		}
+		threads = SDL_AtomicGet(&blit_threads);
+	}
+	if ( threads > 1 && rows > 1 && rows * width >= blit_min_pixels ) {
+		/* Two bands for each thread, idle threads steal half of one */
+		grain = (rows + 2 * threads - 1) / (2 * threads);
+		if ( SDL_ParallelFor(blit_pool, 0, rows, grain, func, data, NULL) == 0 ) {
+			return;
+		}
+	}
+	func(data, 0, rows);
+}
+
+typedef struct {
+	SDL_BlitInfo info;
+	SDL_loblit blit;
+} SDL_BlitBandInfo;
+
+/* Runs the blit over the rows [first, last) of the rectangle */
+static void SDLCALL SDL_BlitBand(void *data, int first, int last)
+{
+	SDL_BlitBandInfo *blit = (SDL_BlitBandInfo *)data;
+	SDL_BlitInfo band = blit->info;
+	int s_pitch = band.s_width * band.src->BytesPerPixel + band.s_skip;
+	int d_pitch = band.d_width * band.dst->BytesPerPixel + band.d_skip;
+
+	band.s_pixels += first * s_pitch;
+	band.s_height = last - first;
+	band.d_pixels += first * d_pitch;
+	band.d_height = last - first;
+	blit->blit(&band);
+}
+
 /* The general purpose software blit routine */
 static int SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
 			SDL_Surface *dst, SDL_Rect *dstrect)
@@ -93,8 +198,18 @@ static int SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
 		info.dst = dst->format;
 		RunBlit = src->map->sw_data->blit;
 
-		/* Run the actual software blit */
-		RunBlit(&info);
+		/* Run the actual software blit, in bands unless the
+		   surfaces overlap and the rows have to go in order
+		 */
+		if ( src->format->BitsPerPixel >= 8 && !SDL_PixelsOverlap(src, dst) ) {
+			SDL_BlitBandInfo blit;
+
+			blit.info = info;
+			blit.blit = RunBlit;
+			SDL_RunBlitBands(info.d_height, info.d_width, SDL_BlitBand, &blit);
+		} else {
+			RunBlit(&info);
+		}
 	}
 
 	/* We need to unlock the surfaces if they're locked */
@@ -25,6 +25,7 @@
 #define _SDL_blit_h
 
 #include "SDL_endian.h"
+#include "SDL_thread.h"
 
 /* The structure passed to the low level blit functions */
 typedef struct {
@@ -70,6 +71,18 @@ typedef struct SDL_BlitMap {
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface *surface);
 
+/* Runs func(data, first, last) over the rows [0, rows) of a blit 'width'
+   pixels wide, in bands on the blit threads if it is big enough to be
+   worth it.  The bands must not depend on each other.
+ */
+extern void SDL_RunBlitBands(int rows, int width, SDL_RangeFunction func, void *data);
+extern void SDL_BlitThreadsQuit(void);
+
+/* Whether the pixels of two surfaces share any memory */
+#define SDL_PixelsOverlap(src, dst) \
+	((Uint8 *)(src)->pixels < (Uint8 *)(dst)->pixels + (dst)->h*(dst)->pitch && \
+	 (Uint8 *)(dst)->pixels < (Uint8 *)(src)->pixels + (src)->h*(src)->pitch)
+
 /* Functions found in SDL_blit_{0,1,N,A}.c */
 extern SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int complex);
 extern SDL_loblit SDL_CalculateBlit1(SDL_Surface *surface, int complex);
@@ -196,28 +196,117 @@ void copy_row3(Uint8 *src, int src_w, Uint8 *dst, int dst_w)
 	}
 }
 
+typedef struct {
+	SDL_Surface *src;
+	SDL_Rect *srcrect;
+	SDL_Surface *dst;
+	SDL_Rect *dstrect;
+	int inc;
+#ifdef USE_ASM_STRETCH
+	SDL_bool use_asm;
+#endif
+} SDL_StretchInfo;
+
+/* Stretches the rows [first, last) of the destination rectangle */
+static void SDLCALL SDL_StretchRows(void *data, int first, int last)
+{
+	SDL_StretchInfo *info = (SDL_StretchInfo *)data;
+	SDL_Surface *src = info->src;
+	SDL_Rect *srcrect = info->srcrect;
+	SDL_Surface *dst = info->dst;
+	SDL_Rect *dstrect = info->dstrect;
+	int pos, inc;
+	int dst_maxrow;
+	int src_row, dst_row;
+	Uint8 *srcp = NULL;
+	Uint8 *dstp;
+#if defined(USE_ASM_STRETCH) && defined(__GNUC__)
+	int u1, u2;
+#endif
+	const int bpp = dst->format->BytesPerPixel;
+
+	/* Pick up where the rows before 'first' would have left off:
+	   the first row takes a source row, the others one every 'inc'
+	 */
+	inc = info->inc;
+	pos = 0x10000 + (first * inc & 0xFFFF);
+	src_row = srcrect->y + (first * inc >> 16);
+	dst_row = dstrect->y + first;
+
+	/* Perform the stretch blit */
+	for ( dst_maxrow = dstrect->y+last; dst_row<dst_maxrow; ++dst_row ) {
+		dstp = (Uint8 *)dst->pixels + (dst_row*dst->pitch)
+		                            + (dstrect->x*bpp);
+		while ( pos >= 0x10000L ) {
+			srcp = (Uint8 *)src->pixels + (src_row*src->pitch)
+			                            + (srcrect->x*bpp);
+			++src_row;
+			pos -= 0x10000L;
+		}
+#ifdef USE_ASM_STRETCH
+		if (info->use_asm) {
+#ifdef __GNUC__
+			__asm__ __volatile__ (
+			"call *%4"
+			: "=&D" (u1), "=&S" (u2)
+			: "0" (dstp), "1" (srcp), "r" (copy_row)
+			: "memory" );
+#elif defined(_MSC_VER) || defined(__WATCOMC__)
+		{ void *code = copy_row;
+			__asm {
+				push edi
+				push esi
+	
+				mov edi, dstp
+				mov esi, srcp
+				call dword ptr code
+
+				pop esi
+				pop edi
+			}
+		}
+#else
+#error Need inline assembly for this compiler
+#endif
+		} else
+#endif
+		switch (bpp) {
+		    case 1:
+			copy_row1(srcp, srcrect->w, dstp, dstrect->w);
+			break;
+		    case 2:
+			copy_row2((Uint16 *)srcp, srcrect->w,
+			          (Uint16 *)dstp, dstrect->w);
+			break;
+		    case 3:
+			copy_row3(srcp, srcrect->w, dstp, dstrect->w);
+			break;
+		    case 4:
+			copy_row4((Uint32 *)srcp, srcrect->w,
+			          (Uint32 *)dstp, dstrect->w);
+			break;
+		}
+		pos += inc;
+	}
+}
+
 /* Perform a stretch blit between two surfaces of the same format.
    NOTE:  This function is not safe to call from multiple threads!
+   (It runs its own bands on the blit threads, see SDL_SetBlitThreads())
 */
 int SDL_SoftStretch(SDL_Surface *src, SDL_Rect *srcrect,
                     SDL_Surface *dst, SDL_Rect *dstrect)
 {
 	int src_locked;
 	int dst_locked;
-	int pos, inc;
-	int dst_maxrow;
-	int src_row, dst_row;
-	Uint8 *srcp = NULL;
-	Uint8 *dstp;
+	int inc;
 	SDL_Rect full_src;
 	SDL_Rect full_dst;
+	SDL_StretchInfo info;
 #ifdef USE_ASM_STRETCH
 	SDL_bool use_asm = SDL_TRUE;
-#ifdef __GNUC__
-	int u1, u2;
-#endif
-#endif /* USE_ASM_STRETCH */
 	const int bpp = dst->format->BytesPerPixel;
+#endif
 
 	if ( src->format->BitsPerPixel != dst->format->BitsPerPixel ) {
 		SDL_SetError("Only works with same format surfaces");
@@ -277,10 +366,7 @@ int SDL_SoftStretch(SDL_Surface *src, SDL_Rect *srcrect,
 	}
 
 	/* Set up the data... */
-	pos = 0x10000;
 	inc = (srcrect->h << 16) / dstrect->h;
-	src_row = srcrect->y;
-	dst_row = dstrect->y;
 
 #ifdef USE_ASM_STRETCH
 	/* Write the opcodes for this stretch */
@@ -291,59 +377,18 @@ int SDL_SoftStretch(SDL_Surface *src, SDL_Rect *srcrect,
 #endif
 
 	/* Perform the stretch blit */
-	for ( dst_maxrow = dst_row+dstrect->h; dst_row<dst_maxrow; ++dst_row ) {
-		dstp = (Uint8 *)dst->pixels + (dst_row*dst->pitch)
-		                            + (dstrect->x*bpp);
-		while ( pos >= 0x10000L ) {
-			srcp = (Uint8 *)src->pixels + (src_row*src->pitch)
-			                            + (srcrect->x*bpp);
-			++src_row;
-			pos -= 0x10000L;
-		}
+	info.src = src;
+	info.srcrect = srcrect;
+	info.dst = dst;
+	info.dstrect = dstrect;
+	info.inc = inc;
 #ifdef USE_ASM_STRETCH
-		if (use_asm) {
-#ifdef __GNUC__
-			__asm__ __volatile__ (
-			"call *%4"
-			: "=&D" (u1), "=&S" (u2)
-			: "0" (dstp), "1" (srcp), "r" (copy_row)
-			: "memory" );
-#elif defined(_MSC_VER) || defined(__WATCOMC__)
-		{ void *code = copy_row;
-			__asm {
-				push edi
-				push esi
-	
-				mov edi, dstp
-				mov esi, srcp
-				call dword ptr code
-
-				pop esi
-				pop edi
-			}
-		}
-#else
-#error Need inline assembly for this compiler
+	info.use_asm = use_asm;
 #endif
-		} else
-#endif
-		switch (bpp) {
-		    case 1:
-			copy_row1(srcp, srcrect->w, dstp, dstrect->w);
-			break;
-		    case 2:
-			copy_row2((Uint16 *)srcp, srcrect->w,
-			          (Uint16 *)dstp, dstrect->w);
-			break;
-		    case 3:
-			copy_row3(srcp, srcrect->w, dstp, dstrect->w);
-			break;
-		    case 4:
-			copy_row4((Uint32 *)srcp, srcrect->w,
-			          (Uint32 *)dstp, dstrect->w);
-			break;
-		}
-		pos += inc;
+	if ( SDL_PixelsOverlap(src, dst) ) {
+		SDL_StretchRows(&info, 0, dstrect->h);
+	} else {
+		SDL_RunBlitBands(dstrect->h, dstrect->w, SDL_StretchRows, &info);
 	}
 
 	/* We need to unlock the surfaces if they're locked */
@@ -548,61 +548,24 @@ static int SDL_FillRect4(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	return -1;
 }
 
-/* 
- * This function performs a fast fill of the given rectangle with 'color'
- */
-int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
-{
-	SDL_VideoDevice *video = current_video;
-	SDL_VideoDevice *this  = current_video;
-	int x, y;
+typedef struct {
+	SDL_Surface *dst;
 	Uint8 *row;
+	int w;
+	Uint32 color;
+} SDL_FillInfo;
 
-	/* This function doesn't work on surfaces < 8 bpp */
-	if ( dst->format->BitsPerPixel < 8 ) {
-		switch(dst->format->BitsPerPixel) {
-		    case 1:
-			return SDL_FillRect1(dst, dstrect, color);
-			break;
-		    case 4:
-			return SDL_FillRect4(dst, dstrect, color);
-			break;
-		    default:
-			SDL_SetError("Fill rect on unsupported surface format");
-			return(-1);
-			break;
-		}
-	}
-
-	/* If 'dstrect' == NULL, then fill the whole surface */
-	if ( dstrect ) {
-		/* Perform clipping */
-		if ( !SDL_IntersectRect(dstrect, &dst->clip_rect, dstrect) ) {
-			return(0);
-		}
-	} else {
-		dstrect = &dst->clip_rect;
-	}
-
-	/* Check for hardware acceleration */
-	if ( ((dst->flags & SDL_HWSURFACE) == SDL_HWSURFACE) &&
-					video->info.blit_fill ) {
-		SDL_Rect hw_rect;
-		if ( dst == SDL_VideoSurface ) {
-			hw_rect = *dstrect;
-			hw_rect.x += current_video->offset_x;
-			hw_rect.y += current_video->offset_y;
-			dstrect = &hw_rect;
-		}
-		return(video->FillHWRect(this, dst, dstrect, color));
-	}
+/* Fills the rows [first, last) of the rectangle */
+static void SDLCALL SDL_FillRows(void *data, int first, int last)
+{
+	SDL_FillInfo *info = (SDL_FillInfo *)data;
+	SDL_Surface *dst = info->dst;
+	Uint8 *row = info->row + first*dst->pitch;
+	Uint32 color = info->color;
+	int w = info->w;
+	int h = last - first;
+	int x, y;
 
-	/* Perform software fill */
-	if ( SDL_LockSurface(dst) != 0 ) {
-		return(-1);
-	}
-	row = (Uint8 *)dst->pixels+dstrect->y*dst->pitch+
-			dstrect->x*dst->format->BytesPerPixel;
 #if SDL_ARM_NEON_BLITTERS
     if (SDL_HasARMNEON() && dst->format->BytesPerPixel != 3) {
         void FillRect8ARMNEONAsm(int32_t w, int32_t h, uint8_t *dst, int32_t dst_stride, uint8_t src);
@@ -610,18 +573,17 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
         void FillRect32ARMNEONAsm(int32_t w, int32_t h, uint32_t *dst, int32_t dst_stride, uint32_t src);
         switch (dst->format->BytesPerPixel) {
         case 1:
-            FillRect8ARMNEONAsm(dstrect->w, dstrect->h, (uint8_t *) row, dst->pitch >> 0, color);
+            FillRect8ARMNEONAsm(w, h, (uint8_t *) row, dst->pitch >> 0, color);
             break;
         case 2:
-            FillRect16ARMNEONAsm(dstrect->w, dstrect->h, (uint16_t *) row, dst->pitch >> 1, color);
+            FillRect16ARMNEONAsm(w, h, (uint16_t *) row, dst->pitch >> 1, color);
             break;
         case 4:
-            FillRect32ARMNEONAsm(dstrect->w, dstrect->h, (uint32_t *) row, dst->pitch >> 2, color);
+            FillRect32ARMNEONAsm(w, h, (uint32_t *) row, dst->pitch >> 2, color);
             break;
         }
 
-        SDL_UnlockSurface(dst);
-        return(0);
+        return;
     }
 #endif
 #if SDL_ARM_SIMD_BLITTERS
@@ -631,25 +593,24 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 		void FillRect32ARMSIMDAsm(int32_t w, int32_t h, uint32_t *dst, int32_t dst_stride, uint32_t src);
 		switch (dst->format->BytesPerPixel) {
 		case 1:
-			FillRect8ARMSIMDAsm(dstrect->w, dstrect->h, (uint8_t *) row, dst->pitch >> 0, color);
+			FillRect8ARMSIMDAsm(w, h, (uint8_t *) row, dst->pitch >> 0, color);
 			break;
 		case 2:
-			FillRect16ARMSIMDAsm(dstrect->w, dstrect->h, (uint16_t *) row, dst->pitch >> 1, color);
+			FillRect16ARMSIMDAsm(w, h, (uint16_t *) row, dst->pitch >> 1, color);
 			break;
 		case 4:
-			FillRect32ARMSIMDAsm(dstrect->w, dstrect->h, (uint32_t *) row, dst->pitch >> 2, color);
+			FillRect32ARMSIMDAsm(w, h, (uint32_t *) row, dst->pitch >> 2, color);
 			break;
 		}
 
-		SDL_UnlockSurface(dst);
-		return(0);
+		return;
 	}
 #endif
 	if ( dst->format->palette || (color == 0) ) {
-		x = dstrect->w*dst->format->BytesPerPixel;
+		x = w*dst->format->BytesPerPixel;
 		if ( !color && !((uintptr_t)row&3) && !(x&3) && !(dst->pitch&3) ) {
 			int n = x >> 2;
-			for ( y=dstrect->h; y; --y ) {
+			for ( y=h; y; --y ) {
 				SDL_memset4(row, 0, n);
 				row += dst->pitch;
 			}
@@ -662,14 +623,14 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 			 * uncachable, so only use it on software surfaces
 			 */
 			if((dst->flags & SDL_HWSURFACE) == SDL_HWSURFACE) {
-				if(dstrect->w >= 8) {
+				if(w >= 8) {
 					/*
 					 * 64-bit stores are probably most
 					 * efficient to uncached video memory
 					 */
 					double fill;
 					SDL_memset(&fill, color, (sizeof fill));
-					for(y = dstrect->h; y; y--) {
+					for(y = h; y; y--) {
 						Uint8 *d = row;
 						unsigned n = x;
 						unsigned nn;
@@ -705,7 +666,7 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 					}
 				} else {
 					/* narrow boxes */
-					for(y = dstrect->h; y; y--) {
+					for(y = h; y; y--) {
 						Uint8 *d = row;
 						Uint8 c = color;
 						int n = x;
@@ -719,7 +680,7 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 			} else
 #endif /* __powerpc__ */
 			{
-				for(y = dstrect->h; y; y--) {
+				for(y = h; y; y--) {
 					SDL_memset(row, color, x);
 					row += dst->pitch;
 				}
@@ -728,11 +689,11 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	} else {
 		switch (dst->format->BytesPerPixel) {
 		    case 2:
-			for ( y=dstrect->h; y; --y ) {
+			for ( y=h; y; --y ) {
 				Uint16 *pixels = (Uint16 *)row;
 				Uint16 c = (Uint16)color;
 				Uint32 cc = (Uint32)c << 16 | c;
-				int n = dstrect->w;
+				int n = w;
 				if((uintptr_t)pixels & 3) {
 					*pixels++ = c;
 					n--;
@@ -749,9 +710,9 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 			#if SDL_BYTEORDER == SDL_BIG_ENDIAN
 				color <<= 8;
 			#endif
-			for ( y=dstrect->h; y; --y ) {
+			for ( y=h; y; --y ) {
 				Uint8 *pixels = row;
-				for ( x=dstrect->w; x; --x ) {
+				for ( x=w; x; --x ) {
 					SDL_memcpy(pixels, &color, 3);
 					pixels += 3;
 				}
@@ -760,13 +721,73 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 			break;
 
 		    case 4:
-			for(y = dstrect->h; y; --y) {
-				SDL_memset4(row, color, dstrect->w);
+			for(y = h; y; --y) {
+				SDL_memset4(row, color, w);
 				row += dst->pitch;
 			}
 			break;
 		}
 	}
+}
+
+/* 
+ * This function performs a fast fill of the given rectangle with 'color'
+ */
+int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
+{
+	SDL_VideoDevice *video = current_video;
+	SDL_VideoDevice *this  = current_video;
+	SDL_FillInfo info;
+
+	/* This function doesn't work on surfaces < 8 bpp */
+	if ( dst->format->BitsPerPixel < 8 ) {
+		switch(dst->format->BitsPerPixel) {
+		    case 1:
+			return SDL_FillRect1(dst, dstrect, color);
+			break;
+		    case 4:
+			return SDL_FillRect4(dst, dstrect, color);
+			break;
+		    default:
+			SDL_SetError("Fill rect on unsupported surface format");
+			return(-1);
+			break;
+		}
+	}
+
+	/* If 'dstrect' == NULL, then fill the whole surface */
+	if ( dstrect ) {
+		/* Perform clipping */
+		if ( !SDL_IntersectRect(dstrect, &dst->clip_rect, dstrect) ) {
+			return(0);
+		}
+	} else {
+		dstrect = &dst->clip_rect;
+	}
+
+	/* Check for hardware acceleration */
+	if ( ((dst->flags & SDL_HWSURFACE) == SDL_HWSURFACE) &&
+					video->info.blit_fill ) {
+		SDL_Rect hw_rect;
+		if ( dst == SDL_VideoSurface ) {
+			hw_rect = *dstrect;
+			hw_rect.x += current_video->offset_x;
+			hw_rect.y += current_video->offset_y;
+			dstrect = &hw_rect;
+		}
+		return(video->FillHWRect(this, dst, dstrect, color));
+	}
+
+	/* Perform software fill */
+	if ( SDL_LockSurface(dst) != 0 ) {
+		return(-1);
+	}
+	info.dst = dst;
+	info.row = (Uint8 *)dst->pixels+dstrect->y*dst->pitch+
+			dstrect->x*dst->format->BytesPerPixel;
+	info.w = dstrect->w;
+	info.color = color;
+	SDL_RunBlitBands(dstrect->h, dstrect->w, SDL_FillRows, &info);
 	SDL_UnlockSurface(dst);
 
 	/* We're done! */
@@ -0,0 +1,279 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include "SDL_video.h"
+#include "SDL_yuv_neon_c.h"
+
+#if SDL_YUV_NEON
+
+/* NEON colorspace conversion, 16 pixels at a time.
+
+   The C functions in SDL_yuv_sw.c add table entries for the chroma terms
+   and look the clamped channels up in the rgb_2_pix tables. Here the same
+   terms are computed: the tables hold (int)(coef * (c - 128)), which is the
+   magnitude scaled by a fixed point constant and truncated, with the sign
+   put back. The constants below give exactly the table values for every
+   input, so the output matches the C functions bit for bit. The channels
+   are clamped with a saturating narrow and packed for the display.
+*/
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#else
+#include "../cpuinfo/SDL_neon_emu.h"
+#endif
+
+/* Fixed point versions of the Cr_r, Cr_g, Cb_g and Cb_b coefficients */
+#define CR_R_MUL	717	/* 0.419/0.299 in 7.9 */
+#define CR_R_SHIFT	9
+#define CR_G_MUL	731	/* 0.299/0.419 in 6.10 */
+#define CR_G_SHIFT	10
+#define CB_G_MUL	2821	/* 0.114/0.331 in 3.13 */
+#define CB_G_SHIFT	13
+#define CB_B_MUL	29055	/* 0.587/0.331 in 2.14 */
+#define CB_B_SHIFT	14
+
+/* Magnitude times a constant, truncated */
+#define SCALE(mag, mul, shift) \
+	vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(mag), vdup_n_u16(mul)), shift), \
+	             vshrn_n_u32(vmull_u16(vget_high_u16(mag), vdup_n_u16(mul)), shift))
+
+/* Negates the lanes where sign is all ones */
+static __inline__ int16x8_t ApplySign(uint16x8_t mag, int16x8_t sign)
+{
+	return vsubq_s16(veorq_s16(vreinterpretq_s16_u16(mag), sign), sign);
+}
+
+/* The colour terms of 8 chroma samples */
+typedef struct {
+	int16x8_t r, g, b;
+} ChromaTerms;
+
+static __inline__ ChromaTerms GetChromaTerms(uint8x8_t cr, uint8x8_t cb)
+{
+	const uint8x8_t bias = vdup_n_u8(128);
+	const int16x8_t dcr = vreinterpretq_s16_u16(vsubl_u8(cr, bias));
+	const int16x8_t dcb = vreinterpretq_s16_u16(vsubl_u8(cb, bias));
+	const int16x8_t scr = vshrq_n_s16(dcr, 15);
+	const int16x8_t scb = vshrq_n_s16(dcb, 15);
+	const uint16x8_t mcr = vreinterpretq_u16_s16(vabsq_s16(dcr));
+	const uint16x8_t mcb = vreinterpretq_u16_s16(vabsq_s16(dcb));
+	ChromaTerms terms;
+
+	terms.r = ApplySign(SCALE(mcr, CR_R_MUL, CR_R_SHIFT), scr);
+	terms.g = vnegq_s16(vaddq_s16(ApplySign(SCALE(mcr, CR_G_MUL, CR_G_SHIFT), scr),
+	                              ApplySign(SCALE(mcb, CB_G_MUL, CB_G_SHIFT), scb)));
+	terms.b = ApplySign(SCALE(mcb, CB_B_MUL, CB_B_SHIFT), scb);
+	return terms;
+}
+
+/* Clamped channels of 8 pixels */
+typedef struct {
+	uint8x8_t r, g, b;
+} Channels;
+
+static __inline__ Channels GetChannels(uint8x8_t lum, int16x8_t r, int16x8_t g, int16x8_t b)
+{
+	const int16x8_t l = vreinterpretq_s16_u16(vmovl_u8(lum));
+	Channels c;
+
+	c.r = vqmovun_s16(vaddq_s16(l, r));
+	c.g = vqmovun_s16(vaddq_s16(l, g));
+	c.b = vqmovun_s16(vaddq_s16(l, b));
+	return c;
+}
+
+static __inline__ uint16x8_t Pack565(Channels c)
+{
+	uint16x8_t pixels = vshll_n_u8(c.r, 8);
+	pixels = vsriq_n_u16(pixels, vshll_n_u8(c.g, 8), 5);
+	return vsriq_n_u16(pixels, vshll_n_u8(c.b, 8), 11);
+}
+
+/* Pixel layouts, the 32 bit ones have 0 in the unused byte like the tables */
+#define LAYOUT_565	0
+#define LAYOUT_RGB	1
+#define LAYOUT_BGR	2
+
+static __inline__ void Store32(unsigned char *out, uint8x8_t r, uint8x8_t g, uint8x8_t b, int layout)
+{
+	uint8x8x4_t pixels;
+
+	pixels.val[0] = (layout == LAYOUT_RGB) ? b : r;
+	pixels.val[1] = g;
+	pixels.val[2] = (layout == LAYOUT_RGB) ? r : b;
+	pixels.val[3] = vdup_n_u8(0);
+	vst4_u8(out, pixels);
+}
+
+/* 16 pixels with the chroma of every other pixel repeated */
+static __inline__ void Store16Pixels(unsigned char *out, uint8x16_t lum,
+                                     const ChromaTerms *terms, int layout)
+{
+	const int16x8x2_t r = vzipq_s16(terms->r, terms->r);
+	const int16x8x2_t g = vzipq_s16(terms->g, terms->g);
+	const int16x8x2_t b = vzipq_s16(terms->b, terms->b);
+	const Channels lo = GetChannels(vget_low_u8(lum), r.val[0], g.val[0], b.val[0]);
+	const Channels hi = GetChannels(vget_high_u8(lum), r.val[1], g.val[1], b.val[1]);
+
+	if ( layout == LAYOUT_565 ) {
+		vst1q_u16((Uint16 *)out, Pack565(lo));
+		vst1q_u16((Uint16 *)out + 8, Pack565(hi));
+	} else {
+		Store32(out, lo.r, lo.g, lo.b, layout);
+		Store32(out + 32, hi.r, hi.g, hi.b, layout);
+	}
+}
+
+static __inline__ void ConvertYV12(unsigned char *lum, unsigned char *cr,
+                                   unsigned char *cb, unsigned char *out,
+                                   int rows, int cols, int mod, int layout)
+{
+	const int bpp = (layout == LAYOUT_565) ? 2 : 4;
+	const int pitch = (cols + mod) * bpp;
+	int x, y;
+
+	for ( y = 0; y < rows / 2; ++y ) {
+		unsigned char *row1 = out + (2 * y) * pitch;
+		unsigned char *row2 = row1 + pitch;
+		unsigned char *lum1 = lum + (2 * y) * cols;
+		unsigned char *lum2 = lum1 + cols;
+		unsigned char *cry = cr + y * (cols / 2);
+		unsigned char *cby = cb + y * (cols / 2);
+
+		for ( x = 0; x < cols; x += 16 ) {
+			const ChromaTerms terms = GetChromaTerms(vld1_u8(cry + x / 2),
+			                                         vld1_u8(cby + x / 2));
+
+			Store16Pixels(row1 + x * bpp, vld1q_u8(lum1 + x), &terms, layout);
+			Store16Pixels(row2 + x * bpp, vld1q_u8(lum2 + x), &terms, layout);
+		}
+	}
+}
+
+/* The packed formats only differ in which bytes of a 4 byte group hold
+   what. Y1 always follows Y0 by 2 bytes.
+*/
+static __inline__ void ConvertYUY2(unsigned char *base, int ly, int lcr, int lcb,
+                                   unsigned char *out, int rows, int cols,
+                                   int mod, int layout)
+{
+	const int bpp = (layout == LAYOUT_565) ? 2 : 4;
+	const int pitch = (cols + mod) * bpp;
+	int x, y;
+
+	for ( y = 0; y < rows; ++y ) {
+		const unsigned char *src = base + y * cols * 2;
+		unsigned char *row = out + y * pitch;
+
+		for ( x = 0; x < cols; x += 16 ) {
+			const uint8x8x4_t group = vld4_u8(src + x * 2);
+			const ChromaTerms terms = GetChromaTerms(group.val[lcr], group.val[lcb]);
+			const Channels even = GetChannels(group.val[ly], terms.r, terms.g, terms.b);
+			const Channels odd = GetChannels(group.val[ly + 2], terms.r, terms.g, terms.b);
+
+			if ( layout == LAYOUT_565 ) {
+				const uint16x8x2_t pixels = vzipq_u16(Pack565(even), Pack565(odd));
+
+				vst1q_u16((Uint16 *)(row + x * 2), pixels.val[0]);
+				vst1q_u16((Uint16 *)(row + x * 2) + 8, pixels.val[1]);
+			} else {
+				const uint8x8x2_t r = vzip_u8(even.r, odd.r);
+				const uint8x8x2_t g = vzip_u8(even.g, odd.g);
+				const uint8x8x2_t b = vzip_u8(even.b, odd.b);
+
+				Store32(row + x * 4, r.val[0], g.val[0], b.val[0], layout);
+				Store32(row + x * 4 + 32, r.val[1], g.val[1], b.val[1], layout);
+			}
+		}
+	}
+}
+
+/* Works out the layout from the pointers SDL_DisplayYUV_SW passes, and
+   expands the loop for each so the byte positions are constants.
+*/
+static __inline__ void ConvertPacked(unsigned char *lum, unsigned char *cr,
+                                     unsigned char *cb, unsigned char *out,
+                                     int rows, int cols, int mod, int layout)
+{
+	if ( cb < lum ) {
+		/* UYVY */
+		ConvertYUY2(cb, 1, 2, 0, out, rows, cols, mod, layout);
+	} else if ( cr < cb ) {
+		/* YVYU */
+		ConvertYUY2(lum, 0, 1, 3, out, rows, cols, mod, layout);
+	} else {
+		/* YUY2 */
+		ConvertYUY2(lum, 0, 3, 1, out, rows, cols, mod, layout);
+	}
+}
+
+void Color565DitherYV12NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod )
+{
+	ConvertYV12(lum, cr, cb, out, rows, cols, mod, LAYOUT_565);
+}
+
+void ColorRGBDitherYV12NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod )
+{
+	ConvertYV12(lum, cr, cb, out, rows, cols, mod, LAYOUT_RGB);
+}
+
+void ColorBGRDitherYV12NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod )
+{
+	ConvertYV12(lum, cr, cb, out, rows, cols, mod, LAYOUT_BGR);
+}
+
+void Color565DitherYUY2NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod )
+{
+	ConvertPacked(lum, cr, cb, out, rows, cols, mod, LAYOUT_565);
+}
+
+void ColorRGBDitherYUY2NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod )
+{
+	ConvertPacked(lum, cr, cb, out, rows, cols, mod, LAYOUT_RGB);
+}
+
+void ColorBGRDitherYUY2NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod )
+{
+	ConvertPacked(lum, cr, cb, out, rows, cols, mod, LAYOUT_BGR);
+}
+
+#endif /* SDL_YUV_NEON */
@@ -0,0 +1,69 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* NEON versions of the most common 1X colorspace conversions, see
+   SDL_yuv_neon.c. They take the same arguments as the C functions in
+   SDL_yuv_sw.c but compute the colour terms instead of looking them up,
+   and need the number of columns to be a multiple of 16.
+*/
+
+#if SDL_ARM_NEON_BLITTERS && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SDL_YUV_NEON	1
+#elif SDL_ARM_NEON_EMULATION
+/* Built with the portable stand-ins of SDL_neon_emu.h, for testing */
+#define SDL_YUV_NEON	1
+#endif
+
+#if SDL_YUV_NEON
+
+/* 16 bit 565 */
+extern void Color565DitherYV12NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                                      unsigned char *lum, unsigned char *cr,
+                                      unsigned char *cb, unsigned char *out,
+                                      int rows, int cols, int mod );
+extern void Color565DitherYUY2NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                                      unsigned char *lum, unsigned char *cr,
+                                      unsigned char *cb, unsigned char *out,
+                                      int rows, int cols, int mod );
+
+/* 32 bit with red in 0x00FF0000 */
+extern void ColorRGBDitherYV12NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                                      unsigned char *lum, unsigned char *cr,
+                                      unsigned char *cb, unsigned char *out,
+                                      int rows, int cols, int mod );
+extern void ColorRGBDitherYUY2NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                                      unsigned char *lum, unsigned char *cr,
+                                      unsigned char *cb, unsigned char *out,
+                                      int rows, int cols, int mod );
+
+/* 32 bit with red in 0x000000FF, the psp2 screen layout */
+extern void ColorBGRDitherYV12NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                                      unsigned char *lum, unsigned char *cr,
+                                      unsigned char *cb, unsigned char *out,
+                                      int rows, int cols, int mod );
+extern void ColorBGRDitherYUY2NEON1X( int *colortab, Uint32 *rgb_2_pix,
+                                      unsigned char *lum, unsigned char *cr,
+                                      unsigned char *cb, unsigned char *out,
+                                      int rows, int cols, int mod );
+
+#endif /* SDL_YUV_NEON */
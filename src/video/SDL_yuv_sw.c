@@ -88,6 +88,7 @@
 #include "SDL_stretch_c.h"
 #include "SDL_yuvfuncs.h"
 #include "SDL_yuv_sw_c.h"
+#include "SDL_yuv_neon_c.h"
 
 /* The functions used to manipulate software video overlays */
 static struct private_yuvhwfuncs sw_yuvfuncs = {
@@ -1121,6 +1122,35 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 		/* We should never get here (caught above) */
 		break;
 	}
+#if SDL_YUV_NEON
+	/* NEON functions for the common layouts, 16 pixels at a time */
+	if ( SDL_HasARMNEON() && (width & 15) == 0 ) {
+		int packed = (format != SDL_YV12_OVERLAY) &&
+		             (format != SDL_IYUV_OVERLAY);
+
+		if ( (display->format->BytesPerPixel == 2) &&
+		     (Rmask == 0xF800) &&
+		     (Gmask == 0x07E0) &&
+		     (Bmask == 0x001F) ) {
+			swdata->Display1X = packed ? Color565DitherYUY2NEON1X :
+			                             Color565DitherYV12NEON1X;
+		}
+		if ( (display->format->BytesPerPixel == 4) &&
+		     (Rmask == 0x00FF0000) &&
+		     (Gmask == 0x0000FF00) &&
+		     (Bmask == 0x000000FF) ) {
+			swdata->Display1X = packed ? ColorRGBDitherYUY2NEON1X :
+			                             ColorRGBDitherYV12NEON1X;
+		}
+		if ( (display->format->BytesPerPixel == 4) &&
+		     (Rmask == 0x000000FF) &&
+		     (Gmask == 0x0000FF00) &&
+		     (Bmask == 0x00FF0000) ) {
+			swdata->Display1X = packed ? ColorBGRDitherYUY2NEON1X :
+			                             ColorBGRDitherYV12NEON1X;
+		}
+	}
+#endif
 
 	/* Find the pitch and offset values for the overlay */
 	overlay->pitches = swdata->pitches;
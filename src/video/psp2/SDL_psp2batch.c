@@ -0,0 +1,233 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Sprite batching for the psp2 video driver.
+ * Like SDL_psp2dirty.c this only goes through the gxm tools interface.
+ *
+ * Instead of a draw call per quad, the quads of a scene are collected and
+ * grouped by texture and blend state. All their vertices go into one
+ * reservation of the gxm quad pool and each group is drawn with a single
+ * call, so the draw calls only grow with the state changes.
+ *
+ * Moving a sprite back to an earlier run is only safe if no run in between
+ * draws under it. A coarse grid remembers the latest run drawing into each
+ * cell, which keeps that check cheap for thousands of sprites.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "SDL_psp2batch_c.h"
+
+static int Cell(int coord)
+{
+	return SDL_max(0, SDL_min(coord >> PSP2_BATCH_CELL_SHIFT,
+	                          PSP2_BATCH_GRID - 1));
+}
+
+static void *Grow(void *array, int *max, int size)
+{
+	int count = *max ? *max * 2 : 64;
+	void *resized = SDL_realloc(array, count * size);
+
+	if ( resized ) {
+		*max = count;
+	}
+	return resized;
+}
+
+int PSP2_AddSprite(PSP2_SpriteBatch *batch, const gxm_texture *texture,
+                   int blend, const SDL_Rect *srcrect, int dx, int dy,
+                   void *owner)
+{
+	const int cx0 = Cell(dx);
+	const int cy0 = Cell(dy);
+	const int cx1 = Cell(dx + srcrect->w - 1);
+	const int cy1 = Cell(dy + srcrect->h - 1);
+	PSP2_SpriteRun *run = NULL;
+	PSP2_Sprite *sprite;
+	int i, x, y, stop, last = -1;
+
+	if ( batch->grid == NULL ) {
+		batch->grid = (PSP2_BatchCell *)SDL_calloc(
+			PSP2_BATCH_GRID * PSP2_BATCH_GRID, sizeof(PSP2_BatchCell));
+		if ( batch->grid == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		batch->epoch = 1;
+	}
+	if ( batch->num_sprites == batch->max_sprites ) {
+		void *sprites = Grow(batch->sprites, &batch->max_sprites,
+		                     sizeof(PSP2_Sprite));
+		if ( sprites == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		batch->sprites = (PSP2_Sprite *)sprites;
+	}
+
+	/* The latest run drawing under the sprite has to be drawn before it */
+	for ( y = cy0; y <= cy1; ++y ) {
+		const PSP2_BatchCell *cell = &batch->grid[y * PSP2_BATCH_GRID];
+		for ( x = cx0; x <= cx1; ++x ) {
+			if ( cell[x].epoch == batch->epoch && cell[x].run > last ) {
+				last = cell[x].run;
+			}
+		}
+	}
+
+	/* Look for a run with the same state it can be moved back to */
+	stop = SDL_max(batch->num_runs - PSP2_BATCH_LOOKBACK, last);
+	stop = SDL_max(stop, 0);
+	for ( i = batch->num_runs - 1; i >= stop; --i ) {
+		if ( batch->runs[i].texture == texture &&
+		     batch->runs[i].blend == blend ) {
+			run = &batch->runs[i];
+			break;
+		}
+	}
+
+	if ( run == NULL ) {
+		if ( batch->num_runs == batch->max_runs ) {
+			void *runs = Grow(batch->runs, &batch->max_runs,
+			                  sizeof(PSP2_SpriteRun));
+			if ( runs == NULL ) {
+				SDL_OutOfMemory();
+				return(-1);
+			}
+			batch->runs = (PSP2_SpriteRun *)runs;
+		}
+		run = &batch->runs[batch->num_runs++];
+		run->texture = texture;
+		run->blend = blend;
+		run->head = batch->num_sprites;
+		run->count = 0;
+	} else {
+		batch->sprites[run->tail].next = batch->num_sprites;
+	}
+	run->tail = batch->num_sprites;
+	run->count++;
+
+	/* No run after this one draws here, so it's the latest now */
+	for ( y = cy0; y <= cy1; ++y ) {
+		PSP2_BatchCell *cell = &batch->grid[y * PSP2_BATCH_GRID];
+		for ( x = cx0; x <= cx1; ++x ) {
+			cell[x].epoch = batch->epoch;
+			cell[x].run = (int)(run - batch->runs);
+		}
+	}
+
+	sprite = &batch->sprites[batch->num_sprites++];
+	sprite->texture = texture;
+	sprite->blend = blend;
+	sprite->sx = srcrect->x;
+	sprite->sy = srcrect->y;
+	sprite->dx = dx;
+	sprite->dy = dy;
+	sprite->w = srcrect->w;
+	sprite->h = srcrect->h;
+	sprite->owner = owner;
+	sprite->next = -1;
+	return(0);
+}
+
+static void SetVertex(texture_vertex *vertex, int x, int y, float u, float v)
+{
+	vertex->x = (float)x;
+	vertex->y = (float)y;
+	vertex->z = +0.5f;
+	vertex->u = u;
+	vertex->v = v;
+}
+
+int PSP2_DrawSpriteBatch(PSP2_SpriteBatch *batch)
+{
+	texture_vertex *vertices;
+	int i, s;
+
+	if ( batch->num_sprites == 0 ) {
+		return(0);
+	}
+	vertices = gxm_reserve_quads(batch->num_sprites);
+	if ( vertices == NULL ) {
+		return(-1);
+	}
+
+	for ( i = 0; i < batch->num_runs; ++i ) {
+		const PSP2_SpriteRun *run = &batch->runs[i];
+		const float tex_w = (float)gxm_texture_get_width(run->texture);
+		const float tex_h = (float)gxm_texture_get_height(run->texture);
+		texture_vertex *quad = vertices;
+
+		for ( s = run->head; s >= 0; s = batch->sprites[s].next ) {
+			const PSP2_Sprite *sprite = &batch->sprites[s];
+			const float u0 = sprite->sx / tex_w;
+			const float v0 = sprite->sy / tex_h;
+			const float u1 = (sprite->sx + sprite->w) / tex_w;
+			const float v1 = (sprite->sy + sprite->h) / tex_h;
+			const int x1 = sprite->dx + sprite->w;
+			const int y1 = sprite->dy + sprite->h;
+
+			SetVertex(&quad[0], sprite->dx, sprite->dy, u0, v0);
+			SetVertex(&quad[1], x1, sprite->dy, u1, v0);
+			SetVertex(&quad[2], sprite->dx, y1, u0, v1);
+			SetVertex(&quad[3], x1, y1, u1, v1);
+			quad += 4;
+		}
+		gxm_draw_quads(run->texture, run->blend, vertices, run->count);
+		vertices = quad;
+
+		batch->stats.draw_calls += (run->count + VITA_GXM_QUADS_PER_DRAW - 1) /
+		                           VITA_GXM_QUADS_PER_DRAW;
+	}
+	batch->stats.batches += batch->num_runs;
+	batch->stats.quads += batch->num_sprites;
+	return(0);
+}
+
+void PSP2_ClearSpriteBatch(PSP2_SpriteBatch *batch)
+{
+	batch->num_sprites = 0;
+	batch->num_runs = 0;
+
+	/* Invalidates the grid without touching it */
+	if ( ++batch->epoch == 0 && batch->grid ) {
+		SDL_memset(batch->grid, 0, PSP2_BATCH_GRID * PSP2_BATCH_GRID *
+		                           sizeof(PSP2_BatchCell));
+		batch->epoch = 1;
+	}
+}
+
+void PSP2_FreeSpriteBatch(PSP2_SpriteBatch *batch)
+{
+	SDL_free(batch->sprites);
+	SDL_free(batch->runs);
+	SDL_free(batch->grid);
+	batch->sprites = NULL;
+	batch->runs = NULL;
+	batch->grid = NULL;
+	batch->max_sprites = 0;
+	batch->max_runs = 0;
+	PSP2_ClearSpriteBatch(batch);
+}
@@ -0,0 +1,101 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_psp2batch_c_h
+#define _SDL_psp2batch_c_h
+
+#include "SDL_video.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+
+/* How many runs back a sprite may be moved to join one with its state */
+#define PSP2_BATCH_LOOKBACK	16
+
+/* Overlaps are tracked on a grid of 8x8 pixel cells covering 1024x1024
+   pixels, sprites further out share the cells at the edge */
+#define PSP2_BATCH_CELL_SHIFT	3
+#define PSP2_BATCH_GRID		128
+
+/* One textured quad, copying a w x h rectangle from sx,sy to dx,dy */
+typedef struct PSP2_Sprite {
+	const gxm_texture *texture;
+	int blend;
+	int sx, sy;
+	int dx, dy;
+	int w, h;
+	void *owner;		/* caller data, e.g. the source surface */
+	int next;		/* next sprite of the same run, or -1 */
+} PSP2_Sprite;
+
+/* Sprites with the same texture and blend state, drawn with one call */
+typedef struct PSP2_SpriteRun {
+	const gxm_texture *texture;
+	int blend;
+	int head, tail;
+	int count;
+} PSP2_SpriteRun;
+
+/* Latest run drawing into a grid cell, valid if epoch is the batch's */
+typedef struct PSP2_BatchCell {
+	unsigned int epoch;
+	int run;
+} PSP2_BatchCell;
+
+typedef struct PSP2_BatchStats {
+	unsigned int scenes;
+	unsigned int batches;	/* texture and blend state changes */
+	unsigned int draw_calls;
+	unsigned int quads;
+} PSP2_BatchStats;
+
+/* Sprites queued for one scene, in runs sorted by texture and blend state.
+   A sprite only joins an earlier run if it doesn't overlap any run queued
+   after it, so the result looks the same as drawing in queued order.
+   A zeroed structure is an empty batch.
+ */
+typedef struct PSP2_SpriteBatch {
+	PSP2_Sprite *sprites;
+	int num_sprites, max_sprites;
+	PSP2_SpriteRun *runs;
+	int num_runs, max_runs;
+	PSP2_BatchCell *grid;
+	unsigned int epoch;
+	PSP2_BatchStats stats;
+} PSP2_SpriteBatch;
+
+/* Queues a sprite, returns -1 if out of memory */
+extern int PSP2_AddSprite(PSP2_SpriteBatch *batch, const gxm_texture *texture,
+                          int blend, const SDL_Rect *srcrect, int dx, int dy,
+                          void *owner);
+
+/* Draws the queued sprites into the current scene, one draw call per run,
+   from vertices written into a single reservation of the quad pool.
+   The batch stays queued until PSP2_ClearSpriteBatch().
+ */
+extern int PSP2_DrawSpriteBatch(PSP2_SpriteBatch *batch);
+
+extern void PSP2_ClearSpriteBatch(PSP2_SpriteBatch *batch);
+
+extern void PSP2_FreeSpriteBatch(PSP2_SpriteBatch *batch);
+
+#endif /* _SDL_psp2batch_c_h */
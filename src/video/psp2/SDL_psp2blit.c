@@ -0,0 +1,356 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* GPU blits between hardware surfaces for the psp2 video driver.
+ * Like SDL_psp2dirty.c this only goes through the gxm tools interface.
+ *
+ * Each blit becomes a textured quad. Opaque blits between surfaces of the
+ * same format sample the source texture directly, and so do per-pixel
+ * alpha blits. For colour keys and surface alpha the source pixels are
+ * first expanded into a 32 bit blend texture, the same way RLE
+ * acceleration prepares a surface, where keyed pixels get alpha 0 and the
+ * others get the surface alpha. That texture is then blended like a
+ * per-pixel alpha surface.
+ *
+ * The quads for one destination are collected in a sprite batch, see
+ * SDL_psp2batch.c, and drawn together in one scene. If the GPU can't
+ * render to the destination then, they are drawn by the software blitters.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "SDL_psp2blit_c.h"
+
+/* Sprite owners are the private_hwdata of the blit sources */
+static PSP2_SpriteBatch batch;
+static private_hwdata *target;
+
+/* Only these layouts match the gxm textures the driver creates */
+static int IsTextureFormat(const SDL_PixelFormat *format)
+{
+	switch (format->BitsPerPixel) {
+	    case 16:
+		return (format->Rmask == 0xF800 &&
+		        format->Gmask == 0x07E0 &&
+		        format->Bmask == 0x001F);
+	    case 32:
+		return (format->Rmask == 0x000000FF &&
+		        format->Gmask == 0x0000FF00 &&
+		        format->Bmask == 0x00FF0000);
+	    default:
+		return 0;
+	}
+}
+
+static int HasPixelAlpha(const SDL_Surface *surface)
+{
+	return (surface->flags & SDL_SRCALPHA) && surface->format->Amask;
+}
+
+/* Colour key, surface alpha or a format change go through the blend texture */
+static int NeedsBlendTexture(const SDL_Surface *src, const SDL_Surface *dst)
+{
+	if ( HasPixelAlpha(src) ) {
+		return 0;
+	}
+	if ( src->flags & SDL_SRCCOLORKEY ) {
+		return 1;
+	}
+	if ( (src->flags & SDL_SRCALPHA) &&
+	     src->format->alpha != SDL_ALPHA_OPAQUE ) {
+		return 1;
+	}
+	return (src->format->BitsPerPixel != dst->format->BitsPerPixel);
+}
+
+int PSP2_CanGPUBlit(SDL_Surface *src, SDL_Surface *dst)
+{
+	if ( src == dst || src->hwdata == NULL || dst->hwdata == NULL ) {
+		return 0;
+	}
+	if ( !IsTextureFormat(src->format) || !IsTextureFormat(dst->format) ) {
+		return 0;
+	}
+	/* Sampled directly, so the alpha has to be in the texture alpha */
+	if ( HasPixelAlpha(src) && src->format->Amask != 0xFF000000 ) {
+		return 0;
+	}
+	return (gxm_texture_enable_render_target(dst->hwdata->texture) == 0);
+}
+
+/* Expands the source pixels like the software blitters do. For a 16 bit
+   destination the channels are cut to its precision first, and then
+   widened again so the GPU rounds them back to exactly those values.
+ */
+static int UpdateBlendTexture(SDL_Surface *src, int dstbpp)
+{
+	private_hwdata *hwdata = src->hwdata;
+	SDL_PixelFormat *format = src->format;
+	const Uint32 rgbmask = ~format->Amask;
+	const Uint32 ckey = format->colorkey & rgbmask;
+	const int keyed = (src->flags & SDL_SRCCOLORKEY) != 0;
+	const Uint32 alpha = (src->flags & SDL_SRCALPHA) ?
+	                     format->alpha : SDL_ALPHA_OPAQUE;
+	Uint8 *dstrow;
+	int pitch, x, y;
+
+	if ( hwdata->blend_texture && !hwdata->blend_dirty &&
+	     hwdata->blend_bpp == dstbpp ) {
+		return(0);
+	}
+
+	/* Nothing queued or in flight may still use the old copy */
+	PSP2_WaitGPUBlits(src);
+
+	if ( hwdata->blend_texture == NULL ) {
+		hwdata->blend_texture = create_gxm_texture(src->w, src->h,
+		                            SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+		if ( hwdata->blend_texture == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+	}
+
+	dstrow = (Uint8 *)gxm_texture_get_datap(hwdata->blend_texture);
+	pitch = gxm_texture_get_stride(hwdata->blend_texture);
+	for ( y = 0; y < src->h; ++y ) {
+		const Uint8 *srcrow = (const Uint8 *)src->pixels + y * src->pitch;
+		Uint32 *dstp = (Uint32 *)dstrow;
+
+		for ( x = 0; x < src->w; ++x ) {
+			Uint32 pixel, r, g, b;
+
+			if ( format->BytesPerPixel == 2 ) {
+				pixel = ((const Uint16 *)srcrow)[x];
+			} else {
+				pixel = ((const Uint32 *)srcrow)[x];
+			}
+			if ( keyed && (pixel & rgbmask) == ckey ) {
+				dstp[x] = 0;
+				continue;
+			}
+			r = ((pixel & format->Rmask) >> format->Rshift) << format->Rloss;
+			g = ((pixel & format->Gmask) >> format->Gshift) << format->Gloss;
+			b = ((pixel & format->Bmask) >> format->Bshift) << format->Bloss;
+			if ( dstbpp == 16 ) {
+				r = (r & 0xF8) | (r >> 5);
+				g = (g & 0xFC) | (g >> 6);
+				b = (b & 0xF8) | (b >> 5);
+			}
+			dstp[x] = (alpha << 24) | (b << 16) | (g << 8) | r;
+		}
+		dstrow += pitch;
+	}
+
+	hwdata->blend_dirty = 0;
+	hwdata->blend_bpp = dstbpp;
+	return(0);
+}
+
+/* A texture as a software surface, with the texture alpha if blending */
+static SDL_Surface *CreateTextureSurface(const gxm_texture *texture, int blend)
+{
+	void *pixels = gxm_texture_get_datap(texture);
+	const int w = gxm_texture_get_width(texture);
+	const int h = gxm_texture_get_height(texture);
+	const int pitch = gxm_texture_get_stride(texture);
+	SDL_Surface *surface;
+
+	if ( gxm_texture_get_format(texture) == SCE_GXM_TEXTURE_FORMAT_R5G6B5 ) {
+		return SDL_CreateRGBSurfaceFrom(pixels, w, h, 16, pitch,
+		                                0xF800, 0x07E0, 0x001F, 0);
+	}
+	surface = SDL_CreateRGBSurfaceFrom(pixels, w, h, 32, pitch,
+	                                   0x000000FF, 0x0000FF00, 0x00FF0000,
+	                                   blend ? 0xFF000000 : 0);
+	if ( surface && blend ) {
+		SDL_SetAlpha(surface, SDL_SRCALPHA, SDL_ALPHA_OPAQUE);
+	}
+	return surface;
+}
+
+/* Draws the queued sprites in order with the software blitters, for when
+   the GPU can't render to the target. The textures hold the same pixels
+   and alpha the quads would have drawn.
+ */
+static void DrawSpritesOnCPU(void)
+{
+	SDL_Surface *dst;
+	int i;
+
+	for ( i = 0; i < batch.num_sprites; ++i ) {
+		const private_hwdata *owner = batch.sprites[i].owner;
+		if ( !gxm_fence_reached(owner->fence) ) {
+			gxm_wait_fence(owner->fence);
+		}
+	}
+	if ( !gxm_fence_reached(target->fence) ) {
+		gxm_wait_fence(target->fence);
+	}
+
+	dst = CreateTextureSurface(target->texture, 0);
+	if ( dst == NULL ) {
+		return;
+	}
+	for ( i = 0; i < batch.num_sprites; ++i ) {
+		const PSP2_Sprite *sprite = &batch.sprites[i];
+		SDL_Surface *src = CreateTextureSurface(sprite->texture,
+		                                        sprite->blend);
+		SDL_Rect srcrect, dstrect;
+
+		if ( src == NULL ) {
+			break;
+		}
+		srcrect.x = sprite->sx;
+		srcrect.y = sprite->sy;
+		srcrect.w = dstrect.w = sprite->w;
+		srcrect.h = dstrect.h = sprite->h;
+		dstrect.x = sprite->dx;
+		dstrect.y = sprite->dy;
+		SDL_LowerBlit(src, &srcrect, dst, &dstrect);
+		SDL_FreeSurface(src);
+	}
+	SDL_FreeSurface(dst);
+	target->blend_dirty = 1;
+}
+
+void PSP2_FlushGPUBlits(void)
+{
+	unsigned int fence;
+	int i;
+
+	if ( batch.num_sprites == 0 ) {
+		return;
+	}
+
+	/* A flipped screen may have switched to a ring texture not used yet */
+	if ( gxm_texture_enable_render_target(target->texture) == 0 ) {
+		gxm_start_drawing_to_texture(target->texture);
+		PSP2_DrawSpriteBatch(&batch);
+		gxm_end_drawing();
+		batch.stats.scenes++;
+
+		fence = gxm_get_fence();
+		target->fence = fence;
+		target->blend_dirty = 1;
+		for ( i = 0; i < batch.num_sprites; ++i ) {
+			((private_hwdata *)batch.sprites[i].owner)->fence = fence;
+		}
+	} else {
+		DrawSpritesOnCPU();
+	}
+	PSP2_ClearSpriteBatch(&batch);
+	target = NULL;
+}
+
+int PSP2_GPUBlit(SDL_Surface *src, SDL_Rect *srcrect,
+                 SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	private_hwdata *hwdata = src->hwdata;
+	const gxm_texture *texture;
+	int blend;
+
+	if ( target != dst->hwdata ) {
+		PSP2_FlushGPUBlits();
+	}
+
+	if ( NeedsBlendTexture(src, dst) ) {
+		/* May flush the batch if it still uses the old copy */
+		if ( UpdateBlendTexture(src, dst->format->BitsPerPixel) < 0 ) {
+			return(-1);
+		}
+		texture = hwdata->blend_texture;
+		blend = 1;
+	} else {
+		texture = hwdata->texture;
+		blend = HasPixelAlpha(src);
+	}
+	if ( PSP2_AddSprite(&batch, texture, blend, srcrect,
+	                    dstrect->x, dstrect->y, hwdata) < 0 ) {
+		return(-1);
+	}
+
+	target = dst->hwdata;
+	return(0);
+}
+
+/* Submits the queued blits if they read or write the surface */
+static void FlushBlitsUsing(const private_hwdata *hwdata)
+{
+	int i;
+
+	if ( target == hwdata ) {
+		PSP2_FlushGPUBlits();
+		return;
+	}
+	for ( i = 0; i < batch.num_sprites; ++i ) {
+		if ( batch.sprites[i].owner == hwdata ) {
+			PSP2_FlushGPUBlits();
+			return;
+		}
+	}
+}
+
+void PSP2_WaitGPUBlits(SDL_Surface *surface)
+{
+	private_hwdata *hwdata = surface->hwdata;
+
+	if ( hwdata == NULL ) {
+		return;
+	}
+	FlushBlitsUsing(hwdata);
+	if ( !gxm_fence_reached(hwdata->fence) ) {
+		gxm_wait_fence(hwdata->fence);
+	}
+}
+
+void PSP2_InvalidateGPUBlits(SDL_Surface *surface)
+{
+	if ( surface->hwdata ) {
+		surface->hwdata->blend_dirty = 1;
+	}
+}
+
+void PSP2_ReleaseGPUBlits(SDL_Surface *surface, PSP2_RetireQueue *retired)
+{
+	private_hwdata *hwdata = surface->hwdata;
+
+	if ( hwdata == NULL ) {
+		return;
+	}
+	FlushBlitsUsing(hwdata);
+	PSP2_RetireTexture(retired, hwdata->blend_texture);
+	hwdata->blend_texture = NULL;
+}
+
+PSP2_BatchStats *PSP2_GetGPUBlitStats(void)
+{
+	return &batch.stats;
+}
+
+void PSP2_QuitGPUBlits(void)
+{
+	PSP2_FlushGPUBlits();
+	PSP2_FreeSpriteBatch(&batch);
+}
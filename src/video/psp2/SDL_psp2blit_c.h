@@ -0,0 +1,79 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_psp2blit_c_h
+#define _SDL_psp2blit_c_h
+
+#include "SDL_video.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2batch_c.h"
+#include "SDL_psp2retire_c.h"
+
+/* Hardware surface data. For GPU blits a surface also remembers the fence
+   of the last scene that read or wrote its texture, and keeps a 32 bit
+   copy of its pixels with the colour key and surface alpha turned into
+   texture alpha.
+ */
+typedef struct private_hwdata {
+	gxm_texture *texture;
+	SDL_Rect dst;
+	unsigned int fence;
+	gxm_texture *blend_texture;
+	int blend_dirty;
+	int blend_bpp;		/* destination depth blend_texture was made for */
+} private_hwdata;
+
+/* Returns 1 if blits from src to dst can be done by the GPU */
+extern int PSP2_CanGPUBlit(SDL_Surface *src, SDL_Surface *dst);
+
+/* Blit function for src->map->hw_blit. Blits are queued in a sprite batch
+   and drawn in one scene per destination when the destination changes or
+   on flush.
+ */
+extern int PSP2_GPUBlit(SDL_Surface *src, SDL_Rect *srcrect,
+                        SDL_Surface *dst, SDL_Rect *dstrect);
+
+/* Submits the queued blits to the GPU */
+extern void PSP2_FlushGPUBlits(void);
+
+/* Call before the CPU touches the pixels of a hardware surface. Submits
+   queued blits involving it and waits until the GPU is done with it.
+ */
+extern void PSP2_WaitGPUBlits(SDL_Surface *surface);
+
+/* The pixels, colour key or alpha of the surface may have changed */
+extern void PSP2_InvalidateGPUBlits(SDL_Surface *surface);
+
+/* Call before the surface texture is retired. Submits queued blits
+   involving the surface and retires its blend texture, without waiting.
+ */
+extern void PSP2_ReleaseGPUBlits(SDL_Surface *surface, PSP2_RetireQueue *retired);
+
+/* Counters of the blits drawn so far, may be reset by the caller */
+extern PSP2_BatchStats *PSP2_GetGPUBlitStats(void);
+
+/* Submits the queued blits and frees the batch */
+extern void PSP2_QuitGPUBlits(void);
+
+#endif /* _SDL_psp2blit_c_h */
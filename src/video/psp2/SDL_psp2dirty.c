@@ -0,0 +1,197 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Dirty rectangle tracking for the psp2 screen texture.
+ * This file doesn't use any libgxm call directly, so it can be built on the
+ * host together with SDL_render_vita_gxm_host.c.
+ */
+
+#include "SDL_psp2dirty_c.h"
+
+static int RectArea(const SDL_Rect *rect)
+{
+	return (int)rect->w * (int)rect->h;
+}
+
+static void RectUnion(const SDL_Rect *a, const SDL_Rect *b, SDL_Rect *result)
+{
+	int x0 = SDL_min(a->x, b->x);
+	int y0 = SDL_min(a->y, b->y);
+	int x1 = SDL_max(a->x + a->w, b->x + b->w);
+	int y1 = SDL_max(a->y + a->h, b->y + b->h);
+
+	result->x = x0;
+	result->y = y0;
+	result->w = x1 - x0;
+	result->h = y1 - y0;
+}
+
+static int RectOverlapArea(const SDL_Rect *a, const SDL_Rect *b)
+{
+	int x0 = SDL_max(a->x, b->x);
+	int y0 = SDL_max(a->y, b->y);
+	int x1 = SDL_min(a->x + a->w, b->x + b->w);
+	int y1 = SDL_min(a->y + a->h, b->y + b->h);
+
+	if ( x1 <= x0 || y1 <= y0 ) {
+		return 0;
+	}
+	return (x1 - x0) * (y1 - y0);
+}
+
+static void RemoveRect(PSP2_DirtyRects *set, int i)
+{
+	set->rects[i] = set->rects[--set->count];
+}
+
+void PSP2_AddDirtyRect(PSP2_DirtyRects *set, const SDL_Rect *rect)
+{
+	SDL_Rect r = *rect;
+	SDL_Rect u;
+	int i;
+
+	if ( r.w == 0 || r.h == 0 ) {
+		return;
+	}
+
+	i = 0;
+	while ( i < set->count ) {
+		int covered = RectArea(&set->rects[i]) + RectArea(&r) -
+		              RectOverlapArea(&set->rects[i], &r);
+
+		RectUnion(&set->rects[i], &r, &u);
+
+		/* Merge when the bounding box wastes at most a quarter of its
+		   area; the merged rectangle may now touch earlier ones, so
+		   start over with it.
+		 */
+		if ( 4 * covered >= 3 * RectArea(&u) ) {
+			RemoveRect(set, i);
+			r = u;
+			i = 0;
+			continue;
+		}
+		++i;
+	}
+
+	if ( set->count == VITA_GXM_MAX_REGIONS ) {
+		/* Out of room, fold it into the rectangle that grows least */
+		int best = 0;
+		int best_growth = 0x7FFFFFFF;
+
+		for ( i = 0; i < set->count; ++i ) {
+			int growth;
+			RectUnion(&set->rects[i], &r, &u);
+			growth = RectArea(&u) - RectArea(&set->rects[i]);
+			if ( growth < best_growth ) {
+				best = i;
+				best_growth = growth;
+			}
+		}
+		RectUnion(&set->rects[best], &r, &u);
+		RemoveRect(set, best);
+		PSP2_AddDirtyRect(set, &u);
+		return;
+	}
+
+	set->rects[set->count++] = r;
+}
+
+void PSP2_ResetDirtyState(PSP2_DirtyState *state, int w, int h)
+{
+	SDL_Rect all;
+	int i;
+
+	state->w = w;
+	state->h = h;
+	state->pending.count = 0;
+
+	all.x = 0;
+	all.y = 0;
+	all.w = w;
+	all.h = h;
+	for ( i = 0; i < VITA_GXM_BUFFERS; ++i ) {
+		state->stale[i].count = 1;
+		state->stale[i].rects[0] = all;
+	}
+}
+
+void PSP2_AddDirtyRects(PSP2_DirtyState *state, int numrects, const SDL_Rect *rects)
+{
+	int i;
+
+	for ( i = 0; i < numrects; ++i ) {
+		/* Clip to the surface, SDL_UpdateRects() doesn't */
+		int x0 = SDL_max(rects[i].x, 0);
+		int y0 = SDL_max(rects[i].y, 0);
+		int x1 = SDL_min(rects[i].x + rects[i].w, state->w);
+		int y1 = SDL_min(rects[i].y + rects[i].h, state->h);
+
+		if ( x1 > x0 && y1 > y0 ) {
+			SDL_Rect clipped;
+			clipped.x = x0;
+			clipped.y = y0;
+			clipped.w = x1 - x0;
+			clipped.h = y1 - y0;
+			PSP2_AddDirtyRect(&state->pending, &clipped);
+		}
+	}
+}
+
+void PSP2_MarkDirtyPresented(PSP2_DirtyState *state)
+{
+	unsigned int back = gxm_get_back_buffer_index();
+
+	/* We don't know what changed, so the other buffers are all stale */
+	PSP2_ResetDirtyState(state, state->w, state->h);
+	state->stale[back].count = 0;
+}
+
+int PSP2_PresentDirtyRects(PSP2_DirtyState *state, const gxm_texture *texture)
+{
+	PSP2_DirtyRects *stale;
+	int i, b;
+
+	if ( state->pending.count == 0 ) {
+		return 0;
+	}
+
+	for ( b = 0; b < VITA_GXM_BUFFERS; ++b ) {
+		for ( i = 0; i < state->pending.count; ++i ) {
+			PSP2_AddDirtyRect(&state->stale[b], &state->pending.rects[i]);
+		}
+	}
+	state->pending.count = 0;
+
+	stale = &state->stale[gxm_get_back_buffer_index()];
+
+	gxm_start_drawing();
+	for ( i = 0; i < stale->count; ++i ) {
+		const SDL_Rect *r = &stale->rects[i];
+		gxm_draw_texture_part(texture, r->x, r->y, r->w, r->h);
+	}
+	gxm_end_drawing();
+	stale->count = 0;
+
+	return 1;
+}
@@ -0,0 +1,66 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_psp2dirty_c_h
+#define _SDL_psp2dirty_c_h
+
+#include "SDL_video.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+
+/* Coalesced set of rectangles, in surface coordinates */
+typedef struct PSP2_DirtyRects {
+	int count;
+	SDL_Rect rects[VITA_GXM_MAX_REGIONS];
+} PSP2_DirtyRects;
+
+/* Dirty rectangle tracking for the screen texture.
+   Every display buffer keeps the damage it hasn't been redrawn with yet,
+   because with triple buffering the back buffer holds a frame that is
+   VITA_GXM_BUFFERS presents old.
+ */
+typedef struct PSP2_DirtyState {
+	int w, h;
+	PSP2_DirtyRects pending;
+	PSP2_DirtyRects stale[VITA_GXM_BUFFERS];
+} PSP2_DirtyState;
+
+/* Adds a rectangle to the set, merging it with the existing ones */
+extern void PSP2_AddDirtyRect(PSP2_DirtyRects *set, const SDL_Rect *rect);
+
+/* Marks every display buffer as fully out of date */
+extern void PSP2_ResetDirtyState(PSP2_DirtyState *state, int w, int h);
+
+/* Records the rectangles passed to SDL_UpdateRects() for the next present */
+extern void PSP2_AddDirtyRects(PSP2_DirtyState *state, int numrects, const SDL_Rect *rects);
+
+/* Tells the tracker that the whole texture was drawn into the back buffer */
+extern void PSP2_MarkDirtyPresented(PSP2_DirtyState *state);
+
+/* Draws the out of date parts of the back buffer from the texture.
+   Returns 0 without touching the GPU if nothing changed since the last
+   present, 1 if a scene was drawn and the buffers should be swapped.
+ */
+extern int PSP2_PresentDirtyRects(PSP2_DirtyState *state, const gxm_texture *texture);
+
+#endif /* _SDL_psp2dirty_c_h */
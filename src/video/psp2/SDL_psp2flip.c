@@ -0,0 +1,77 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Screen texture rotation for the psp2 video driver.
+ * Like SDL_psp2dirty.c this only goes through the gxm tools interface.
+ */
+
+#include "SDL_stdinc.h"
+
+#include "SDL_psp2flip_c.h"
+
+int PSP2_CreateFlipRing(PSP2_FlipRing *ring, gxm_texture *first, int count)
+{
+	int i;
+
+	SDL_memset(ring, 0, sizeof(*ring));
+	ring->count = 1;
+	ring->textures[0] = first;
+
+	if ( count > VITA_GXM_BUFFERS ) {
+		count = VITA_GXM_BUFFERS;
+	}
+	for ( i = 1; i < count; ++i ) {
+		ring->textures[i] = create_gxm_texture(
+			gxm_texture_get_width(first),
+			gxm_texture_get_height(first),
+			gxm_texture_get_format(first));
+		if ( ring->textures[i] == NULL ) {
+			return(-1);
+		}
+		ring->count++;
+	}
+	return(0);
+}
+
+void PSP2_DestroyFlipRing(PSP2_FlipRing *ring, PSP2_RetireQueue *retired)
+{
+	int i;
+
+	for ( i = 0; i < ring->count; ++i ) {
+		PSP2_RetireTexture(retired, ring->textures[i]);
+		ring->textures[i] = NULL;
+	}
+	ring->count = 0;
+}
+
+gxm_texture *PSP2_RotateFlipRing(PSP2_FlipRing *ring)
+{
+	ring->fences[ring->current] = gxm_get_fence();
+	ring->current = (ring->current + 1) % ring->count;
+
+	/* Normally this was sampled count-1 frames ago and is long done */
+	if ( !gxm_fence_reached(ring->fences[ring->current]) ) {
+		gxm_wait_fence(ring->fences[ring->current]);
+	}
+	return ring->textures[ring->current];
+}
@@ -0,0 +1,54 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_psp2flip_c_h
+#define _SDL_psp2flip_c_h
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2retire_c.h"
+
+/* Ring of screen textures, so the CPU can draw the next frame while the
+   GPU is still sampling the previous ones. Each texture remembers the
+   fence of the last scene that read from it.
+ */
+typedef struct PSP2_FlipRing {
+	int count;
+	int current;
+	gxm_texture *textures[VITA_GXM_BUFFERS];
+	unsigned int fences[VITA_GXM_BUFFERS];
+} PSP2_FlipRing;
+
+/* Builds a ring of count textures, the first of which is the given one.
+   Returns 0, or -1 if the extra textures couldn't be allocated.
+ */
+extern int PSP2_CreateFlipRing(PSP2_FlipRing *ring, gxm_texture *first, int count);
+
+/* Retires every texture in the ring, including the first one */
+extern void PSP2_DestroyFlipRing(PSP2_FlipRing *ring, PSP2_RetireQueue *retired);
+
+/* Call after the scene drawing the current texture was ended.
+   Returns the next texture, once the GPU no longer reads from it.
+ */
+extern gxm_texture *PSP2_RotateFlipRing(PSP2_FlipRing *ring);
+
+#endif /* _SDL_psp2flip_c_h */
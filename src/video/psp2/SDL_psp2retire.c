@@ -0,0 +1,97 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Deferred texture destruction for the psp2 video driver.
+ * Like SDL_psp2dirty.c this only goes through the gxm tools interface.
+ *
+ * Freeing a surface used to drain the GPU before its texture could go.
+ * Instead the texture is queued with the fence of the latest scene, and
+ * freed once that fence is reached. Fences are handed out in submission
+ * order, so the queue is reclaimed from the front.
+ */
+
+#include "SDL_stdinc.h"
+
+#include "SDL_psp2retire_c.h"
+
+void PSP2_RetireTexture(PSP2_RetireQueue *queue, gxm_texture *texture)
+{
+	const unsigned int fence = gxm_get_fence();
+
+	if ( texture == NULL ) {
+		return;
+	}
+
+	/* Nothing can be using it anymore */
+	if ( gxm_fence_reached(fence) ) {
+		free_gxm_texture(texture);
+		return;
+	}
+
+	if ( queue->count == queue->max ) {
+		int max = queue->max ? queue->max * 2 : 32;
+		PSP2_RetiredTexture *entries = (PSP2_RetiredTexture *)
+			SDL_realloc(queue->entries, max * sizeof(*entries));
+		if ( entries == NULL ) {
+			/* Better late than leaked */
+			gxm_wait_fence(fence);
+			PSP2_ReclaimTextures(queue);
+			free_gxm_texture(texture);
+			return;
+		}
+		queue->entries = entries;
+		queue->max = max;
+	}
+	queue->entries[queue->count].texture = texture;
+	queue->entries[queue->count].fence = fence;
+	queue->count++;
+}
+
+int PSP2_ReclaimTextures(PSP2_RetireQueue *queue)
+{
+	int i, done = 0;
+
+	while ( done < queue->count &&
+	        gxm_fence_reached(queue->entries[done].fence) ) {
+		free_gxm_texture(queue->entries[done].texture);
+		done++;
+	}
+	if ( done > 0 ) {
+		for ( i = done; i < queue->count; ++i ) {
+			queue->entries[i - done] = queue->entries[i];
+		}
+		queue->count -= done;
+	}
+	return done;
+}
+
+void PSP2_DrainRetireQueue(PSP2_RetireQueue *queue)
+{
+	if ( queue->count > 0 ) {
+		gxm_wait_fence(queue->entries[queue->count - 1].fence);
+		PSP2_ReclaimTextures(queue);
+	}
+	SDL_free(queue->entries);
+	queue->entries = NULL;
+	queue->max = 0;
+}
@@ -0,0 +1,57 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_psp2retire_c_h
+#define _SDL_psp2retire_c_h
+
+#include "SDL_render_vita_gxm_tools.h"
+
+/* Textures freed by the app, waiting for the GPU to finish the scenes
+   that may still read or write them. Each one is tagged with the fence
+   of the last scene submitted when it was retired.
+ */
+typedef struct PSP2_RetiredTexture {
+	gxm_texture *texture;
+	unsigned int fence;
+} PSP2_RetiredTexture;
+
+/* Oldest first, a zeroed structure is an empty queue */
+typedef struct PSP2_RetireQueue {
+	PSP2_RetiredTexture *entries;
+	int count, max;
+} PSP2_RetireQueue;
+
+/* Queues the texture to be freed once the GPU is past the scenes submitted
+   so far. Queued GPU work using it has to be submitted first.
+ */
+extern void PSP2_RetireTexture(PSP2_RetireQueue *queue, gxm_texture *texture);
+
+/* Frees the queued textures the GPU is done with, without waiting.
+   Returns how many were freed.
+ */
+extern int PSP2_ReclaimTextures(PSP2_RetireQueue *queue);
+
+/* Waits for the GPU and frees everything, for shutdown */
+extern void PSP2_DrainRetireQueue(PSP2_RetireQueue *queue);
+
+#endif /* _SDL_psp2retire_c_h */
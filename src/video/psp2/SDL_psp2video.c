@@ -43,6 +43,7 @@
 #include "../../events/SDL_events_c.h"
 
 #include "SDL_psp2video.h"
+#include "SDL_psp2yuv_c.h"
 #include "SDL_psp2events_c.h"
 #include "SDL_psp2mouse_c.h"
 #include "SDL_psp2keyboard_c.h"
@@ -53,13 +54,12 @@
 
 #define PSP2VID_DRIVER_NAME "psp2"
 
-typedef struct private_hwdata {
-	gxm_texture *texture;
-	SDL_Rect dst;
-} private_hwdata;
-
 static int vsync = 1;
 static int flip_wait_rendering = 1;
+static int dirty_rect_updates = 0;
+static int flip_textures = 1;
+static int hardware_blits = 0;
+static int gpu_overlays = 0;
 
 /* Initialization/Query functions */
 static int PSP2_VideoInit(_THIS, SDL_PixelFormat *vformat);
@@ -68,10 +68,14 @@ static SDL_Surface *PSP2_SetVideoMode(_THIS, SDL_Surface *current, int width, in
 static int PSP2_SetColors(_THIS, int firstcolor, int ncolors, SDL_Color *colors);
 static void PSP2_VideoQuit(_THIS);
 static void PSP2_DeleteDevice(SDL_VideoDevice *device);
+static SDL_Overlay *PSP2_CreateYUVOverlay(_THIS, int width, int height, Uint32 format, SDL_Surface *display);
 
 /* Hardware surface functions */
 static int PSP2_FlipHWSurface(_THIS, SDL_Surface *surface);
 static int PSP2_AllocHWSurface(_THIS, SDL_Surface *surface);
+static int PSP2_CheckHWBlit(_THIS, SDL_Surface *src, SDL_Surface *dst);
+static int PSP2_SetHWColorKey(_THIS, SDL_Surface *surface, Uint32 key);
+static int PSP2_SetHWAlpha(_THIS, SDL_Surface *surface, Uint8 value);
 static int PSP2_LockHWSurface(_THIS, SDL_Surface *surface);
 static void PSP2_UnlockHWSurface(_THIS, SDL_Surface *surface);
 static void PSP2_FreeHWSurface(_THIS, SDL_Surface *surface);
@@ -109,15 +113,15 @@ static SDL_VideoDevice *PSP2_CreateDevice(int devindex)
 	device->VideoInit = PSP2_VideoInit;
 	device->ListModes = PSP2_ListModes;
 	device->SetVideoMode = PSP2_SetVideoMode;
-	device->CreateYUVOverlay = NULL;
+	device->CreateYUVOverlay = PSP2_CreateYUVOverlay;
 	device->SetColors = PSP2_SetColors;
 	device->UpdateRects = PSP2_UpdateRects;
 	device->VideoQuit = PSP2_VideoQuit;
 	device->AllocHWSurface = PSP2_AllocHWSurface;
-	device->CheckHWBlit = NULL;
+	device->CheckHWBlit = PSP2_CheckHWBlit;
 	device->FillHWRect = NULL;
-	device->SetHWColorKey = NULL;
-	device->SetHWAlpha = NULL;
+	device->SetHWColorKey = PSP2_SetHWColorKey;
+	device->SetHWAlpha = PSP2_SetHWAlpha;
 	device->LockHWSurface = PSP2_LockHWSurface;
 	device->UnlockHWSurface = PSP2_UnlockHWSurface;
 	device->FlipHWSurface = PSP2_FlipHWSurface;
@@ -140,6 +144,25 @@ VideoBootStrap PSP2_bootstrap = {
 	PSP2_Available, PSP2_CreateDevice
 };
 
+// GPU blits are only advertised when enabled, SDL then creates surfaces in video memory
+static void PSP2_UpdateBlitInfo(_THIS)
+{
+	this->info.blit_hw = hardware_blits;
+	this->info.blit_hw_CC = hardware_blits;
+	this->info.blit_hw_A = hardware_blits;
+
+	if (hardware_blits && this->displayformatalphapixel == NULL)
+	{
+		// alpha surfaces in the A8B8G8R8 texture layout, whatever the screen depth
+		this->displayformatalphapixel = SDL_AllocFormat(32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+	}
+	else if (!hardware_blits && this->displayformatalphapixel != NULL)
+	{
+		SDL_FreeFormat(this->displayformatalphapixel);
+		this->displayformatalphapixel = NULL;
+	}
+}
+
 static void PSP2_DeleteDevice(SDL_VideoDevice *device)
 {
 	SDL_free(device->hidden);
@@ -153,6 +176,7 @@ int PSP2_VideoInit(_THIS, SDL_PixelFormat *vformat)
         return -1;
     }
 	gxm_set_vblank_wait(vsync);
+	PSP2_UpdateBlitInfo(this);
 
 	vformat->BitsPerPixel = 16;
 	vformat->BytesPerPixel = 2;
@@ -235,11 +259,32 @@ SDL_Surface *PSP2_SetVideoMode(_THIS, SDL_Surface *current,
 			current->hwdata->dst.x, current->hwdata->dst.y,
 			(float)current->hwdata->dst.w/(float)current->w,
 			(float)current->hwdata->dst.h/(float)current->h);
+		if (PSP2_CreateFlipRing(&this->hidden->flip, current->hwdata->texture, flip_textures) < 0)
+		{
+			// not enough memory for all of them, run with what we got
+			flip_textures = this->hidden->flip.count;
+		}
+	}
+	if (hardware_blits)
+	{
+		// setting the mode again resets the flags of the screen allocated before
+		current->flags |= SDL_HWSURFACE;
 	}
+	PSP2_ResetDirtyState(&this->hidden->dirty, width, height);
 
 	return(current);
 }
 
+static SDL_Overlay *PSP2_CreateYUVOverlay(_THIS, int width, int height, Uint32 format, SDL_Surface *display)
+{
+	// without GPU overlays SDL converts them on the CPU, with NEON where it can
+	if (!gpu_overlays)
+	{
+		return(NULL);
+	}
+	return PSP2_CreateGPUOverlay(this, width, height, format, display);
+}
+
 static int PSP2_AllocHWSurface(_THIS, SDL_Surface *surface)
 {
 	surface->hwdata = (private_hwdata*) SDL_malloc (sizeof (private_hwdata));
@@ -278,12 +323,26 @@ static int PSP2_AllocHWSurface(_THIS, SDL_Surface *surface)
 		return -1;
 	}
 
+	if (surface->hwdata->texture == NULL)
+	{
+		SDL_free(surface->hwdata);
+		surface->hwdata = NULL;
+		SDL_OutOfMemory();
+		return -1;
+	}
+
 	surface->pixels = gxm_texture_get_datap(surface->hwdata->texture);
 	surface->pitch = gxm_texture_get_stride(surface->hwdata->texture);
 	// Don't force SDL_HWSURFACE. Screen surface still works as SDL_SWSURFACE (but may require sceGxmFinish on flip)
 	// Mixing SDL_HWSURFACE and SDL_SWSURFACE drops fps by 10% or so
 	// Not sure if there's even a point of having anything as SDL_HWSURFACE
 	//surface->flags |= SDL_HWSURFACE;
+	if (hardware_blits)
+	{
+		// except for GPU blits, SDL only hands blits between SDL_HWSURFACE surfaces to the driver.
+		// That includes the screen, which SDL then locks before the CPU draws to it
+		surface->flags |= SDL_HWSURFACE;
+	}
 
 	return(0);
 }
@@ -292,40 +351,111 @@ static void PSP2_FreeHWSurface(_THIS, SDL_Surface *surface)
 {
 	if (surface->hwdata != NULL)
 	{
-		gxm_wait_rendering_done();
-		free_gxm_texture(surface->hwdata->texture);
+		// the GPU may still use the textures, they are freed once it's done
+		PSP2_ReleaseGPUBlits(surface, &this->hidden->retired);
+		if (surface == this->screen && this->hidden->flip.count > 0)
+		{
+			// the screen texture is one of the ring textures
+			PSP2_DestroyFlipRing(&this->hidden->flip, &this->hidden->retired);
+		}
+		else
+		{
+			PSP2_RetireTexture(&this->hidden->retired, surface->hwdata->texture);
+		}
+		PSP2_ReclaimTextures(&this->hidden->retired);
 		SDL_free(surface->hwdata);
 		surface->hwdata = NULL;
 		surface->pixels = NULL;
 	}
 }
 
+static int PSP2_CheckHWBlit(_THIS, SDL_Surface *src, SDL_Surface *dst)
+{
+	// the CPU writes non-hardware surfaces without locking, that can't mix with queued GPU blits
+	if (hardware_blits &&
+		(src->flags & SDL_HWSURFACE) && (dst->flags & SDL_HWSURFACE) &&
+		PSP2_CanGPUBlit(src, dst))
+	{
+		src->flags |= SDL_HWACCEL;
+		src->map->hw_blit = PSP2_GPUBlit;
+		return 1;
+	}
+	src->flags &= ~SDL_HWACCEL;
+	return 0;
+}
+
+static int PSP2_SetHWColorKey(_THIS, SDL_Surface *surface, Uint32 key)
+{
+	PSP2_InvalidateGPUBlits(surface);
+	return(0);
+}
+
+static int PSP2_SetHWAlpha(_THIS, SDL_Surface *surface, Uint8 value)
+{
+	PSP2_InvalidateGPUBlits(surface);
+	return(0);
+}
+
 static int PSP2_LockHWSurface(_THIS, SDL_Surface *surface)
 {
+	// the GPU may still be blitting from or into it
+	PSP2_WaitGPUBlits(surface);
 	return(0);
 }
 
 static void PSP2_UnlockHWSurface(_THIS, SDL_Surface *surface)
 {
-	return;
+	PSP2_InvalidateGPUBlits(surface);
 }
 
 static int PSP2_FlipHWSurface(_THIS, SDL_Surface *surface)
 {
-	gxm_start_drawing();
-	gxm_draw_texture(surface->hwdata->texture);
-	gxm_end_drawing();
+	// blits into the screen texture go first, the GPU runs scenes in order
+	PSP2_FlushGPUBlits();
 
-	if(flip_wait_rendering == 1)
+	if (dirty_rect_updates)
+	{
+		// only redraw what SDL_UpdateRects reported, nothing at all if the screen didn't change
+		if (!PSP2_PresentDirtyRects(&this->hidden->dirty, surface->hwdata->texture))
+		{
+			return(0);
+		}
+	}
+	else
+	{
+		gxm_start_drawing();
+		gxm_draw_texture(surface->hwdata->texture);
+		gxm_end_drawing();
+	}
+
+	if (!dirty_rect_updates && this->hidden->flip.count > 1)
+	{
+		// let the app draw into a texture the GPU is done with, no need for sceGxmFinish
+		surface->hwdata->texture = PSP2_RotateFlipRing(&this->hidden->flip);
+		surface->pixels = gxm_texture_get_datap(surface->hwdata->texture);
+		// the ring already waited for the GPU to let go of the new texture
+		surface->hwdata->fence = this->hidden->flip.fences[this->hidden->flip.current];
+		surface->hwdata->blend_dirty = 1;
+	}
+	else if(flip_wait_rendering == 1)
 	{
 		gxm_wait_rendering_done();
 	}
 
 	gxm_swap_buffers();
+
+	// free the textures of surfaces freed a few frames ago
+	PSP2_ReclaimTextures(&this->hidden->retired);
+
+	return(0);
 }
 
 static void PSP2_UpdateRects(_THIS, int numrects, SDL_Rect *rects)
 {
+	if (dirty_rect_updates)
+	{
+		PSP2_AddDirtyRects(&this->hidden->dirty, numrects, rects);
+	}
 }
 
 int PSP2_SetColors(_THIS, int firstcolor, int ncolors, SDL_Color *colors)
@@ -335,10 +465,17 @@ int PSP2_SetColors(_THIS, int firstcolor, int ncolors, SDL_Color *colors)
 
 void PSP2_VideoQuit(_THIS)
 {
+	PSP2_QuitGPUBlits();
 	if (this->screen->hwdata != NULL)
 	{
 		PSP2_FreeHWSurface(this, this->screen);
 	}
+	if (this->displayformatalphapixel != NULL)
+	{
+		SDL_FreeFormat(this->displayformatalphapixel);
+		this->displayformatalphapixel = NULL;
+	}
+	PSP2_DrainRetireQueue(&this->hidden->retired);
 	gxm_finish();
 }
 
@@ -360,6 +497,7 @@ void SDL_PSP2_SetVideoModeScaling(int x, int y, float w, float h)
 		surface->hwdata->dst.x, surface->hwdata->dst.y,
 		(float)surface->hwdata->dst.w/(float)surface->w,
 		(float)surface->hwdata->dst.h/(float)surface->h);
+	PSP2_ResetDirtyState(&current_video->hidden->dirty, surface->w, surface->h);
 }
 
 // custom psp2 function for setting the texture filter to nearest or bilinear
@@ -369,21 +507,28 @@ void SDL_PSP2_SetVideoModeBilinear(int enable_bilinear)
 	
 	if (surface != NULL && surface->hwdata != NULL)
 	{
-		if (enable_bilinear)
-		{
-			//reduce pixelation by setting bilinear filtering
-			//for magnification
-			//(first one is minimization filter,
-			//second one is magnification filter)
-			gxm_texture_set_filters(surface->hwdata->texture,
-				SCE_GXM_TEXTURE_FILTER_LINEAR,
-				SCE_GXM_TEXTURE_FILTER_LINEAR);
-		}
-		else
+		PSP2_FlipRing *ring = &current_video->hidden->flip;
+		int i;
+
+		// every texture the screen may rotate through
+		for (i = 0; i < ring->count; i++)
 		{
-			gxm_texture_set_filters(surface->hwdata->texture,
-				SCE_GXM_TEXTURE_FILTER_POINT,
-				SCE_GXM_TEXTURE_FILTER_POINT);
+			if (enable_bilinear)
+			{
+				//reduce pixelation by setting bilinear filtering
+				//for magnification
+				//(first one is minimization filter,
+				//second one is magnification filter)
+				gxm_texture_set_filters(ring->textures[i],
+					SCE_GXM_TEXTURE_FILTER_LINEAR,
+					SCE_GXM_TEXTURE_FILTER_LINEAR);
+			}
+			else
+			{
+				gxm_texture_set_filters(ring->textures[i],
+					SCE_GXM_TEXTURE_FILTER_POINT,
+					SCE_GXM_TEXTURE_FILTER_POINT);
+			}
 		}
 	}
 }	
@@ -401,6 +546,82 @@ void SDL_PSP2_SetFlipWaitRendering(int flip_wait)
 	flip_wait_rendering = flip_wait;
 }
 
+// custom psp2 function for the number of textures the screen surface rotates through on Flip
+void SDL_PSP2_SetFlipTextures(int count)
+{
+	flip_textures = SDL_max(1, SDL_min(count, VITA_GXM_BUFFERS));
+}
+
+// custom psp2 function for presenting only the rects passed to SDL_UpdateRects on Flip
+void SDL_PSP2_SetDirtyRectUpdates(int enable)
+{
+	SDL_Surface *surface = SDL_VideoSurface;
+
+	dirty_rect_updates = enable;
+
+	if (surface != NULL && current_video != NULL)
+	{
+		PSP2_ResetDirtyState(&current_video->hidden->dirty, surface->w, surface->h);
+	}
+}
+
+// custom psp2 function for drawing blits between SDL_HWSURFACE surfaces with the GPU
+void SDL_PSP2_SetHardwareBlits(int enable)
+{
+	hardware_blits = enable;
+
+	if (current_video != NULL)
+	{
+		PSP2_UpdateBlitInfo(current_video);
+	}
+}
+
+// custom psp2 function for converting YUV overlays created afterwards with the GPU
+void SDL_PSP2_SetGPUOverlays(int enable)
+{
+	gpu_overlays = enable;
+}
+
+// custom psp2 function that returns the GPU blit counters: scenes drawn, texture/blend
+// batches, draw calls and quads. Any of the pointers may be NULL
+void SDL_PSP2_GetBatchStats(unsigned int *scenes, unsigned int *batches, unsigned int *draw_calls, unsigned int *quads)
+{
+	const PSP2_BatchStats *stats = PSP2_GetGPUBlitStats();
+
+	if (scenes)
+		*scenes = stats->scenes;
+	if (batches)
+		*batches = stats->batches;
+	if (draw_calls)
+		*draw_calls = stats->draw_calls;
+	if (quads)
+		*quads = stats->quads;
+}
+
+// custom psp2 function for resetting the GPU blit counters
+void SDL_PSP2_ResetBatchStats(void)
+{
+	SDL_memset(PSP2_GetGPUBlitStats(), 0, sizeof(PSP2_BatchStats));
+}
+
+// custom psp2 function that returns how much GPU memory textures use: bytes handed out,
+// bytes reserved from the system, the most ever handed out and the percentage of free
+// reserved memory outside the largest free block. Any of the pointers may be NULL
+void SDL_PSP2_GetTextureMemoryStats(unsigned int *used, unsigned int *reserved, unsigned int *high_water, unsigned int *fragmentation)
+{
+	gxm_heap_stats stats;
+
+	gxm_get_texture_memory_stats(&stats);
+	if (used)
+		*used = stats.used;
+	if (reserved)
+		*reserved = stats.reserved;
+	if (high_water)
+		*high_water = stats.high_water;
+	if (fragmentation)
+		*fragmentation = stats.fragmentation;
+}
+
 // custom psp2 function for setting mem type for new hw texture allocations
 void SDL_PSP2_SetTextureAllocMemblockType(SceKernelMemBlockType type)
 {
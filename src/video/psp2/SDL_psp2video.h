@@ -27,6 +27,10 @@
 #include "../SDL_sysvideo.h"
 
 #include "SDL_render_vita_gxm_types.h"
+#include "SDL_psp2dirty_c.h"
+#include "SDL_psp2flip_c.h"
+#include "SDL_psp2blit_c.h"
+#include "SDL_psp2retire_c.h"
 
 /* Hidden "this" pointer for the video functions */
 #define _THIS	SDL_VideoDevice *this
@@ -40,6 +44,9 @@ void SDL_PSP2_GetSurfaceRect(SDL_Rect *surfaceRect, SDL_Rect *scaledRect);
 
 struct SDL_PrivateVideoData {
 	gxm_texture *texture;
+	PSP2_DirtyState dirty;
+	PSP2_FlipRing flip;
+	PSP2_RetireQueue retired;
 };
 
 #endif /* _SDL_psp2video_h */
@@ -0,0 +1,257 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* GPU YUV overlays for the psp2 video driver.
+ * Like SDL_psp2dirty.c this only goes through the gxm tools interface.
+ *
+ * The overlay planes live in a gxm texture in one of the YUV formats the
+ * texture unit converts to RGB while sampling, so the app writes them
+ * straight into video memory and the existing texture shader does the
+ * colourspace conversion. Displaying the overlay is one quad, scaled to
+ * the destination rectangle and drawn into the screen texture.
+ *
+ * Unless GPU blits made the screen a hardware surface, which is locked
+ * before the CPU draws to it, displaying waits for the GPU to finish.
+ *
+ * The overlay has a few textures it writes to in turn, so the app can fill
+ * the next frame while the GPU still reads the last one. Like the screen
+ * textures, after a lock the planes hold an older frame, not the last one
+ * displayed.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "SDL_psp2yuv_c.h"
+
+struct private_yuvhwdata {
+	gxm_texture *textures[PSP2_YUV_TEXTURES];
+	unsigned int fences[PSP2_YUV_TEXTURES];
+	int current;
+	int displayed;	/* current texture was drawn since it was locked */
+
+	/* These are just so we don't have to allocate them separately */
+	Uint16 pitches[3];
+	Uint8 *planes[3];
+};
+
+static int PSP2_LockGPUOverlay(_THIS, SDL_Overlay *overlay);
+static void PSP2_UnlockGPUOverlay(_THIS, SDL_Overlay *overlay);
+static int PSP2_DisplayGPUOverlay(_THIS, SDL_Overlay *overlay, SDL_Rect *src, SDL_Rect *dst);
+static void PSP2_FreeGPUOverlay(_THIS, SDL_Overlay *overlay);
+
+static struct private_yuvhwfuncs gpu_yuvfuncs = {
+	PSP2_LockGPUOverlay,
+	PSP2_UnlockGPUOverlay,
+	PSP2_DisplayGPUOverlay,
+	PSP2_FreeGPUOverlay
+};
+
+/* SDL plane order matches the gxm formats, YV12 has V before U */
+static SceGxmTextureFormat TextureFormat(Uint32 format)
+{
+	switch (format) {
+	    case SDL_YV12_OVERLAY:
+		return SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC0;
+	    case SDL_IYUV_OVERLAY:
+		return SCE_GXM_TEXTURE_FORMAT_YUV420P3_CSC0;
+	    case SDL_YUY2_OVERLAY:
+		return SCE_GXM_TEXTURE_FORMAT_YUYV422_CSC0;
+	    case SDL_UYVY_OVERLAY:
+		return SCE_GXM_TEXTURE_FORMAT_UYVY422_CSC0;
+	    case SDL_YVYU_OVERLAY:
+		return SCE_GXM_TEXTURE_FORMAT_YVYU422_CSC0;
+	    default:
+		return 0;
+	}
+}
+
+/* Points the overlay at the planes of the current texture */
+static void SetPlanes(SDL_Overlay *overlay)
+{
+	struct private_yuvhwdata *hwdata = overlay->hwdata;
+	gxm_texture *texture = hwdata->textures[hwdata->current];
+	const unsigned int stride = gxm_texture_get_stride(texture);
+
+	hwdata->planes[0] = (Uint8 *)gxm_texture_get_datap(texture);
+	hwdata->pitches[0] = stride;
+	if ( overlay->planes == 3 ) {
+		hwdata->pitches[1] = stride / 2;
+		hwdata->pitches[2] = stride / 2;
+		hwdata->planes[1] = hwdata->planes[0] + stride * overlay->h;
+		hwdata->planes[2] = hwdata->planes[1] +
+		                    hwdata->pitches[1] * ((overlay->h + 1) / 2);
+	}
+}
+
+SDL_Overlay *PSP2_CreateGPUOverlay(_THIS, int width, int height,
+                                   Uint32 format, SDL_Surface *display)
+{
+	const SceGxmTextureFormat texture_format = TextureFormat(format);
+	SDL_Overlay *overlay;
+	struct private_yuvhwdata *hwdata;
+	int i;
+
+	/* The texture unit works on pairs of pixels */
+	if ( texture_format == 0 || (width & 1) ) {
+		return(NULL);
+	}
+	if ( display != this->screen || display->hwdata == NULL ||
+	     gxm_texture_enable_render_target(display->hwdata->texture) < 0 ) {
+		return(NULL);
+	}
+
+	overlay = (SDL_Overlay *)SDL_malloc(sizeof *overlay);
+	hwdata = (struct private_yuvhwdata *)SDL_malloc(sizeof *hwdata);
+	if ( overlay == NULL || hwdata == NULL ) {
+		SDL_free(overlay);
+		SDL_free(hwdata);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(overlay, 0, (sizeof *overlay));
+	SDL_memset(hwdata, 0, (sizeof *hwdata));
+
+	overlay->format = format;
+	overlay->w = width;
+	overlay->h = height;
+	overlay->hwfuncs = &gpu_yuvfuncs;
+	overlay->hwdata = hwdata;
+	overlay->hw_overlay = 1;
+	overlay->planes = (texture_format == SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC0 ||
+	                   texture_format == SCE_GXM_TEXTURE_FORMAT_YUV420P3_CSC0) ? 3 : 1;
+	overlay->pitches = hwdata->pitches;
+	overlay->pixels = hwdata->planes;
+
+	for ( i = 0; i < PSP2_YUV_TEXTURES; ++i ) {
+		hwdata->textures[i] = create_gxm_texture(width, height, texture_format);
+		if ( hwdata->textures[i] == NULL ) {
+			PSP2_FreeGPUOverlay(this, overlay);
+			SDL_free(overlay);
+			SDL_OutOfMemory();
+			return(NULL);
+		}
+		gxm_texture_set_filters(hwdata->textures[i],
+		                        SCE_GXM_TEXTURE_FILTER_LINEAR,
+		                        SCE_GXM_TEXTURE_FILTER_LINEAR);
+	}
+	SetPlanes(overlay);
+
+	return(overlay);
+}
+
+static int PSP2_LockGPUOverlay(_THIS, SDL_Overlay *overlay)
+{
+	struct private_yuvhwdata *hwdata = overlay->hwdata;
+	unsigned int fence;
+
+	/* Move on to the texture the GPU is most likely done with */
+	if ( hwdata->displayed ) {
+		hwdata->current = (hwdata->current + 1) % PSP2_YUV_TEXTURES;
+		hwdata->displayed = 0;
+		SetPlanes(overlay);
+	}
+	fence = hwdata->fences[hwdata->current];
+	if ( !gxm_fence_reached(fence) ) {
+		gxm_wait_fence(fence);
+	}
+	return(0);
+}
+
+static void PSP2_UnlockGPUOverlay(_THIS, SDL_Overlay *overlay)
+{
+}
+
+static void SetVertex(texture_vertex *vertex, int x, int y, float u, float v)
+{
+	vertex->x = (float)x;
+	vertex->y = (float)y;
+	vertex->z = +0.5f;
+	vertex->u = u;
+	vertex->v = v;
+}
+
+static int PSP2_DisplayGPUOverlay(_THIS, SDL_Overlay *overlay, SDL_Rect *src, SDL_Rect *dst)
+{
+	struct private_yuvhwdata *hwdata = overlay->hwdata;
+	private_hwdata *target = this->screen->hwdata;
+	const gxm_texture *texture = hwdata->textures[hwdata->current];
+	texture_vertex *quad;
+	unsigned int fence;
+
+	/* Blits queued into the screen go first, the GPU runs scenes in order */
+	PSP2_FlushGPUBlits();
+
+	/* A flipped screen may have switched to a ring texture not used yet */
+	if ( gxm_texture_enable_render_target(target->texture) < 0 ) {
+		return(-1);
+	}
+	gxm_start_drawing_to_texture(target->texture);
+	quad = gxm_reserve_quads(1);
+	if ( quad == NULL ) {
+		gxm_end_drawing();
+		return(-1);
+	}
+	SetVertex(&quad[0], dst->x, dst->y,
+	          (float)src->x / overlay->w, (float)src->y / overlay->h);
+	SetVertex(&quad[1], dst->x + dst->w, dst->y,
+	          (float)(src->x + src->w) / overlay->w, (float)src->y / overlay->h);
+	SetVertex(&quad[2], dst->x, dst->y + dst->h,
+	          (float)src->x / overlay->w, (float)(src->y + src->h) / overlay->h);
+	SetVertex(&quad[3], dst->x + dst->w, dst->y + dst->h,
+	          (float)(src->x + src->w) / overlay->w, (float)(src->y + src->h) / overlay->h);
+	gxm_draw_quads(texture, 0, quad, 1);
+	gxm_end_drawing();
+
+	fence = gxm_get_fence();
+	hwdata->fences[hwdata->current] = fence;
+	hwdata->displayed = 1;
+	target->fence = fence;
+	target->blend_dirty = 1;
+
+	/* Only hardware surfaces are locked before the CPU draws to them */
+	if ( !(this->screen->flags & SDL_HWSURFACE) && !gxm_fence_reached(fence) ) {
+		gxm_wait_fence(fence);
+	}
+
+	if ( this->UpdateRects ) {
+		this->UpdateRects(this, 1, dst);
+	}
+	return(0);
+}
+
+static void PSP2_FreeGPUOverlay(_THIS, SDL_Overlay *overlay)
+{
+	struct private_yuvhwdata *hwdata = overlay->hwdata;
+	int i;
+
+	if ( hwdata ) {
+		/* The GPU may still read them, they go once it's done */
+		for ( i = 0; i < PSP2_YUV_TEXTURES; ++i ) {
+			PSP2_RetireTexture(&this->hidden->retired, hwdata->textures[i]);
+		}
+		PSP2_ReclaimTextures(&this->hidden->retired);
+		SDL_free(hwdata);
+		overlay->hwdata = NULL;
+	}
+}
@@ -0,0 +1,40 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_psp2yuv_c_h
+#define _SDL_psp2yuv_c_h
+
+#include "SDL_psp2video.h"
+#include "../SDL_yuvfuncs.h"
+
+/* Number of textures a GPU overlay writes to in turn */
+#define PSP2_YUV_TEXTURES	2
+
+/* Creates an overlay whose planes the GPU converts while drawing it into
+   the screen texture. Returns NULL if the format, size or screen can't be
+   handled that way, SDL then falls back to a software overlay.
+ */
+extern SDL_Overlay *PSP2_CreateGPUOverlay(_THIS, int width, int height,
+                                          Uint32 format, SDL_Surface *display);
+
+#endif /* _SDL_psp2yuv_c_h */
@@ -0,0 +1,375 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "SDL_render_vita_gxm_heap.h"
+
+#define MAX_ORDERS 32
+
+// state of the minimum sized piece at the start of a block
+#define BLOCK_NONE 0    // inside a block
+#define BLOCK_FREE 1
+#define BLOCK_USED 2
+
+typedef struct gxm_heap_arena {
+    struct gxm_heap_arena *next;
+    Uint8 *base;
+    void *handle;
+    unsigned int size;
+    int large;
+    unsigned int used;
+    unsigned int large_requested;
+
+    // per minimum sized piece, only meaningful at block starts. All in one
+    // allocation starting at next_free.
+    Uint8 *order;
+    Uint8 *state;
+    Sint32 *next_free;
+    Sint32 *prev_free;
+    Uint32 *requested;
+    Sint32 free_head[MAX_ORDERS];
+} gxm_heap_arena;
+
+struct gxm_heap {
+    gxm_heap_backend backend;
+    unsigned int arena_size;
+    unsigned int min_block;
+    unsigned int min_shift;
+    unsigned int max_order;
+    gxm_heap_arena *arenas;
+
+    unsigned int reserved;
+    unsigned int used;
+    unsigned int requested;
+    unsigned int high_water;
+    unsigned int allocations;
+    unsigned int large_allocations;
+};
+
+static unsigned int log2_of(unsigned int value)
+{
+    unsigned int shift = 0;
+    while ((1u << shift) < value) {
+        shift++;
+    }
+    return shift;
+}
+
+static void push_free(gxm_heap_arena *arena, Sint32 index, unsigned int order)
+{
+    arena->order[index] = order;
+    arena->state[index] = BLOCK_FREE;
+    arena->prev_free[index] = -1;
+    arena->next_free[index] = arena->free_head[order];
+    if (arena->free_head[order] >= 0) {
+        arena->prev_free[arena->free_head[order]] = index;
+    }
+    arena->free_head[order] = index;
+}
+
+static void remove_free(gxm_heap_arena *arena, Sint32 index)
+{
+    const unsigned int order = arena->order[index];
+
+    if (arena->prev_free[index] >= 0) {
+        arena->next_free[arena->prev_free[index]] = arena->next_free[index];
+    } else {
+        arena->free_head[order] = arena->next_free[index];
+    }
+    if (arena->next_free[index] >= 0) {
+        arena->prev_free[arena->next_free[index]] = arena->prev_free[index];
+    }
+    arena->state[index] = BLOCK_NONE;
+}
+
+static void free_arena(gxm_heap *heap, gxm_heap_arena *arena)
+{
+    gxm_heap_arena **link = &heap->arenas;
+
+    while (*link != arena) {
+        link = &(*link)->next;
+    }
+    *link = arena->next;
+
+    heap->reserved -= arena->size;
+    heap->backend.release(heap->backend.userdata, arena->base, arena->handle);
+    SDL_free(arena->next_free);
+    SDL_free(arena);
+}
+
+static gxm_heap_arena *new_arena(gxm_heap *heap, unsigned int size, int large)
+{
+    const unsigned int pieces = large ? 0 : (size >> heap->min_shift);
+    gxm_heap_arena *arena;
+    Uint8 *bookkeeping = NULL;
+    unsigned int i;
+
+    arena = (gxm_heap_arena *)SDL_calloc(1, sizeof(gxm_heap_arena));
+    if (!arena) {
+        return NULL;
+    }
+    if (pieces) {
+        // one allocation for all the per piece arrays, 32 bit ones first
+        bookkeeping = (Uint8 *)SDL_malloc(pieces * (3 * sizeof(Sint32) + 2));
+        if (!bookkeeping) {
+            SDL_free(arena);
+            return NULL;
+        }
+        arena->next_free = (Sint32 *)bookkeeping;
+        arena->prev_free = arena->next_free + pieces;
+        arena->requested = (Uint32 *)(arena->prev_free + pieces);
+        arena->order = (Uint8 *)(arena->requested + pieces);
+        arena->state = arena->order + pieces;
+    }
+
+    arena->base = (Uint8 *)heap->backend.reserve(heap->backend.userdata, size, &arena->handle);
+    if (!arena->base) {
+        SDL_free(bookkeeping);
+        SDL_free(arena);
+        return NULL;
+    }
+    arena->size = size;
+    arena->large = large;
+
+    if (pieces) {
+        SDL_memset(arena->state, BLOCK_NONE, pieces);
+        for (i = 0; i < MAX_ORDERS; i++) {
+            arena->free_head[i] = -1;
+        }
+        push_free(arena, 0, heap->max_order);
+    }
+
+    arena->next = heap->arenas;
+    heap->arenas = arena;
+    heap->reserved += size;
+    return arena;
+}
+
+gxm_heap *gxm_heap_create(const gxm_heap_backend *backend, unsigned int arena_size, unsigned int min_block)
+{
+    gxm_heap *heap;
+
+    if ((arena_size & (arena_size - 1)) || (min_block & (min_block - 1)) ||
+        min_block > GXM_HEAP_MAX_ALIGNMENT || arena_size < 4 * min_block) {
+        SDL_SetError("invalid gxm heap block sizes");
+        return NULL;
+    }
+
+    heap = (gxm_heap *)SDL_calloc(1, sizeof(gxm_heap));
+    if (!heap) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    heap->backend = *backend;
+    heap->arena_size = arena_size;
+    heap->min_block = min_block;
+    heap->min_shift = log2_of(min_block);
+    heap->max_order = log2_of(arena_size) - heap->min_shift;
+    return heap;
+}
+
+void gxm_heap_destroy(gxm_heap *heap)
+{
+    if (heap) {
+        while (heap->arenas) {
+            free_arena(heap, heap->arenas);
+        }
+        SDL_free(heap);
+    }
+}
+
+// Takes a free block of the order, splitting a larger one if needed
+static Sint32 take_block(gxm_heap_arena *arena, unsigned int order, unsigned int max_order)
+{
+    unsigned int found = order;
+    Sint32 index;
+
+    while (found <= max_order && arena->free_head[found] < 0) {
+        found++;
+    }
+    if (found > max_order) {
+        return -1;
+    }
+
+    index = arena->free_head[found];
+    remove_free(arena, index);
+    while (found > order) {
+        found--;
+        push_free(arena, index + (1 << found), found);
+    }
+    arena->order[index] = order;
+    arena->state[index] = BLOCK_USED;
+    return index;
+}
+
+void *gxm_heap_alloc(gxm_heap *heap, unsigned int size, unsigned int alignment)
+{
+    unsigned int need = SDL_max(SDL_max(size, alignment), 1);
+    gxm_heap_arena *arena;
+    unsigned int order;
+    Sint32 index = -1;
+
+    if (alignment > GXM_HEAP_MAX_ALIGNMENT) {
+        SDL_SetError("gxm heap alignment too large");
+        return NULL;
+    }
+
+    // big ones would waste too much of an arena
+    if (need > heap->arena_size / 4) {
+        arena = new_arena(heap, need, 1);
+        if (!arena) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        arena->used = need;
+        arena->large_requested = size;
+        heap->used += need;
+        heap->requested += size;
+        heap->high_water = SDL_max(heap->high_water, heap->used);
+        heap->allocations++;
+        heap->large_allocations++;
+        return arena->base;
+    }
+
+    order = log2_of(need) > heap->min_shift ? log2_of(need) - heap->min_shift : 0;
+    for (arena = heap->arenas; arena; arena = arena->next) {
+        if (!arena->large) {
+            index = take_block(arena, order, heap->max_order);
+            if (index >= 0) {
+                break;
+            }
+        }
+    }
+    if (index < 0) {
+        arena = new_arena(heap, heap->arena_size, 0);
+        if (!arena) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        index = take_block(arena, order, heap->max_order);
+    }
+
+    arena->requested[index] = size;
+    arena->used += heap->min_block << order;
+    heap->used += heap->min_block << order;
+    heap->requested += size;
+    heap->high_water = SDL_max(heap->high_water, heap->used);
+    heap->allocations++;
+    return arena->base + ((unsigned int)index << heap->min_shift);
+}
+
+int gxm_heap_free(gxm_heap *heap, void *mem)
+{
+    Uint8 *ptr = (Uint8 *)mem;
+    gxm_heap_arena *arena, *other;
+    unsigned int order;
+    Sint32 index, buddy;
+
+    for (arena = heap->arenas; arena; arena = arena->next) {
+        if (ptr >= arena->base && ptr < arena->base + arena->size) {
+            break;
+        }
+    }
+    if (!arena) {
+        return -1;
+    }
+
+    if (arena->large) {
+        if (ptr != arena->base) {
+            return -1;
+        }
+        heap->used -= arena->used;
+        heap->requested -= arena->large_requested;
+        heap->allocations--;
+        heap->large_allocations--;
+        free_arena(heap, arena);
+        return 0;
+    }
+
+    index = (Sint32)((ptr - arena->base) >> heap->min_shift);
+    if ((ptr - arena->base) & (heap->min_block - 1) || arena->state[index] != BLOCK_USED) {
+        return -1;
+    }
+    order = arena->order[index];
+    arena->used -= heap->min_block << order;
+    heap->used -= heap->min_block << order;
+    heap->requested -= arena->requested[index];
+    heap->allocations--;
+    arena->state[index] = BLOCK_NONE;
+
+    // merge with the buddy as long as it's free as a whole
+    while (order < heap->max_order) {
+        buddy = index ^ (1 << order);
+        if (arena->state[buddy] != BLOCK_FREE || arena->order[buddy] != order) {
+            break;
+        }
+        remove_free(arena, buddy);
+        index = SDL_min(index, buddy);
+        order++;
+    }
+    push_free(arena, index, order);
+
+    // keep one empty arena around, so a single texture coming and going
+    // doesn't reserve and release memory each time
+    if (arena->used == 0) {
+        for (other = heap->arenas; other; other = other->next) {
+            if (other != arena && !other->large) {
+                free_arena(heap, arena);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+void gxm_heap_get_stats(const gxm_heap *heap, gxm_heap_stats *stats)
+{
+    const gxm_heap_arena *arena;
+    unsigned int order;
+
+    SDL_memset(stats, 0, sizeof(*stats));
+    for (arena = heap->arenas; arena; arena = arena->next) {
+        if (arena->large) {
+            continue;
+        }
+        stats->arenas++;
+        stats->free += arena->size - arena->used;
+        for (order = heap->max_order + 1; order-- > 0; ) {
+            if (arena->free_head[order] >= 0) {
+                stats->largest_free = SDL_max(stats->largest_free, heap->min_block << order);
+                break;
+            }
+        }
+    }
+    if (stats->free) {
+        stats->fragmentation = 100 - (unsigned int)((Uint64)stats->largest_free * 100 / stats->free);
+    }
+    stats->reserved = heap->reserved;
+    stats->used = heap->used;
+    stats->requested = heap->requested;
+    stats->high_water = heap->high_water;
+    stats->allocations = heap->allocations;
+    stats->large_allocations = heap->large_allocations;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
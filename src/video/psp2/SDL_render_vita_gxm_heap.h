@@ -0,0 +1,76 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Buddy heap for GPU memory. Large blocks of backing memory (arenas) are
+ * reserved once and split into power of two sized blocks, which are merged
+ * with their buddy again when both are free. Allocations too big for that
+ * get backing memory of their own.
+ *
+ * The heap doesn't know where the memory comes from, the Vita reserves
+ * mapped memblocks and the host uses malloc, so it can be tested anywhere.
+ * Its bookkeeping is kept in system memory, away from the GPU memory.
+ */
+
+#ifndef SDL_RENDER_VITA_GXM_HEAP_H
+#define SDL_RENDER_VITA_GXM_HEAP_H
+
+/* Largest alignment an allocation can ask for, backing memory has to be
+   aligned to it */
+#define GXM_HEAP_MAX_ALIGNMENT 4096
+
+typedef struct gxm_heap gxm_heap;
+
+typedef struct gxm_heap_backend {
+    // returns size bytes aligned to GXM_HEAP_MAX_ALIGNMENT, or NULL. handle
+    // receives whatever release needs besides the address.
+    void *(*reserve)(void *userdata, unsigned int size, void **handle);
+    void (*release)(void *userdata, void *base, void *handle);
+    void *userdata;
+} gxm_heap_backend;
+
+typedef struct gxm_heap_stats {
+    unsigned int reserved;      // backing memory taken from the backend
+    unsigned int used;          // size of the handed out blocks
+    unsigned int requested;     // size the handed out blocks were asked for
+    unsigned int high_water;    // most memory used at once
+    unsigned int free;          // free memory in arenas
+    unsigned int largest_free;  // largest free block
+    unsigned int fragmentation; // percent of the free memory outside the largest free block
+    unsigned int arenas;
+    unsigned int allocations;
+    unsigned int large_allocations; // allocations with their own backing memory
+} gxm_heap_stats;
+
+/* arena_size and min_block must be powers of two, min_block at most
+   GXM_HEAP_MAX_ALIGNMENT */
+gxm_heap *gxm_heap_create(const gxm_heap_backend *backend, unsigned int arena_size, unsigned int min_block);
+void gxm_heap_destroy(gxm_heap *heap);
+
+void *gxm_heap_alloc(gxm_heap *heap, unsigned int size, unsigned int alignment);
+
+/* Returns -1 if mem wasn't allocated from the heap */
+int gxm_heap_free(gxm_heap *heap, void *mem);
+
+void gxm_heap_get_stats(const gxm_heap *heap, gxm_heap_stats *stats);
+
+#endif /* SDL_RENDER_VITA_GXM_HEAP_H */
+
+/* vi: set ts=4 sw=4 expandtab: */
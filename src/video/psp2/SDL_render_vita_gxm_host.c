@@ -0,0 +1,552 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Host stand-in for SDL_render_vita_gxm_tools.c. Textures live in system
+ * memory and drawing calls are recorded instead of being rendered, so the
+ * driver logic built on top of them can be tested without a Vita.
+ *
+ * Quads drawn into textures are also executed in software, as reference for
+ * what the GPU does: point sampling, blending in floating point and rounding
+ * to the precision of the target. YUV textures are sampled with the full
+ * range BT.601 conversion SDL_yuv_sw.c uses. Like on the GPU the quads only
+ * show up in the target once their scene completes.
+ *
+ * Texture memory comes from the same heap as on the Vita, backed by malloc.
+ */
+
+#ifndef __vita__
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+
+#define GXM_HOST_MAX_CALLS 4096
+
+typedef struct host_quad {
+    unsigned int fence;
+    gxm_texture *target;
+    const gxm_texture *texture;
+    int blend;
+    int sx, sy, sw, sh, dx, dy, w, h;
+} host_quad;
+
+static gxm_host_call calls[GXM_HOST_MAX_CALLS];
+static int num_calls;
+static unsigned int back_buffer_index;
+
+/* The simulated GPU finishes a scene once this many newer scenes were
+   submitted, or when the CPU waits for it */
+static unsigned int gpu_latency;
+static unsigned int submitted_fence;
+static unsigned int completed_fence;
+
+/* Makes gxm_texture_enable_render_target() fail, as when out of memory */
+static int fail_render_targets;
+
+static gxm_texture *current_target;
+static host_quad *quads;
+static int num_quads;
+static int max_quads;
+
+/* Vertices reserved in the current scene, freed when the next one starts */
+typedef struct host_vertex_chunk {
+    struct host_vertex_chunk *next;
+    texture_vertex vertices[1];
+} host_vertex_chunk;
+
+static host_vertex_chunk *vertex_chunks;
+
+#define GXM_HOST_ARENA_SIZE (1024 * 1024)
+#define GXM_HOST_MIN_BLOCK  512
+
+static gxm_heap *texture_heap;
+
+static void *heap_reserve(void *userdata, unsigned int size, void **handle)
+{
+    Uint8 *mem = SDL_malloc(size + GXM_HEAP_MAX_ALIGNMENT);
+
+    *handle = mem;
+    if (!mem)
+        return NULL;
+    return (void *)(((uintptr_t)mem + GXM_HEAP_MAX_ALIGNMENT - 1) & ~(uintptr_t)(GXM_HEAP_MAX_ALIGNMENT - 1));
+}
+
+static void heap_release(void *userdata, void *base, void *handle)
+{
+    SDL_free(handle);
+}
+
+static void record_call(gxm_host_op op, const gxm_texture *texture, int x, int y, int w, int h)
+{
+    if (num_calls < GXM_HOST_MAX_CALLS) {
+        gxm_host_call *call = &calls[num_calls++];
+        call->op = op;
+        call->texture = texture;
+        call->buffer = back_buffer_index;
+        call->x = x;
+        call->y = y;
+        call->w = w;
+        call->h = h;
+    }
+}
+
+static int host_bytespp(SceGxmTextureFormat format)
+{
+    return format & 0xFF;
+}
+
+static float clamp_unit(float value)
+{
+    return value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+}
+
+// Returns 0 if the texture isn't YUV
+static int read_yuv_texel(const gxm_texture *texture, int x, int y, float *rgba)
+{
+    const unsigned int stride = gxm_texture_get_stride(texture);
+    const Uint8 *data = (const Uint8 *)texture->data;
+    const Uint8 *group = data + y * stride + (x & ~1) * 2;
+    const Uint8 *plane1 = data + stride * texture->height;
+    const Uint8 *plane2 = plane1 + (stride / 2) * ((texture->height + 1) / 2);
+    const unsigned int chroma = (y / 2) * (stride / 2) + x / 2;
+    float l, u, v;
+
+    switch (texture->format) {
+    case SCE_GXM_TEXTURE_FORMAT_YUV420P3_CSC0:
+        l = data[y * stride + x];
+        u = plane1[chroma];
+        v = plane2[chroma];
+        break;
+    case SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC0:
+        l = data[y * stride + x];
+        v = plane1[chroma];
+        u = plane2[chroma];
+        break;
+    case SCE_GXM_TEXTURE_FORMAT_YUYV422_CSC0:
+        l = group[(x & 1) * 2];
+        u = group[1];
+        v = group[3];
+        break;
+    case SCE_GXM_TEXTURE_FORMAT_UYVY422_CSC0:
+        l = group[(x & 1) * 2 + 1];
+        u = group[0];
+        v = group[2];
+        break;
+    case SCE_GXM_TEXTURE_FORMAT_YVYU422_CSC0:
+        l = group[(x & 1) * 2];
+        v = group[1];
+        u = group[3];
+        break;
+    default:
+        return 0;
+    }
+    u -= 128.0f;
+    v -= 128.0f;
+    rgba[0] = clamp_unit((l + 1.402f * v) / 255.0f);
+    rgba[1] = clamp_unit((l - 0.344f * u - 0.714f * v) / 255.0f);
+    rgba[2] = clamp_unit((l + 1.772f * u) / 255.0f);
+    rgba[3] = 1.0f;
+    return 1;
+}
+
+static void read_texel(const gxm_texture *texture, int x, int y, float *rgba)
+{
+    const Uint8 *row = (const Uint8 *)texture->data + y * gxm_texture_get_stride(texture);
+
+    if (read_yuv_texel(texture, x, y, rgba)) {
+        return;
+    }
+    if (texture->format == SCE_GXM_TEXTURE_FORMAT_R5G6B5) {
+        const Uint16 pixel = ((const Uint16 *)row)[x];
+        rgba[0] = (pixel >> 11) / 31.0f;
+        rgba[1] = ((pixel >> 5) & 0x3F) / 63.0f;
+        rgba[2] = (pixel & 0x1F) / 31.0f;
+        rgba[3] = 1.0f;
+    } else {
+        const Uint32 pixel = ((const Uint32 *)row)[x];
+        rgba[0] = (pixel & 0xFF) / 255.0f;
+        rgba[1] = ((pixel >> 8) & 0xFF) / 255.0f;
+        rgba[2] = ((pixel >> 16) & 0xFF) / 255.0f;
+        rgba[3] = (pixel >> 24) / 255.0f;
+    }
+}
+
+static Uint32 to_unorm(float value, unsigned int max)
+{
+    if (value <= 0.0f) {
+        return 0;
+    }
+    if (value >= 1.0f) {
+        return max;
+    }
+    return (Uint32)(value * max + 0.5f);
+}
+
+static void write_texel(gxm_texture *texture, int x, int y, const float *rgba)
+{
+    Uint8 *row = (Uint8 *)texture->data + y * gxm_texture_get_stride(texture);
+
+    if (texture->format == SCE_GXM_TEXTURE_FORMAT_R5G6B5) {
+        ((Uint16 *)row)[x] = (Uint16)((to_unorm(rgba[0], 31) << 11) |
+                                      (to_unorm(rgba[1], 63) << 5) |
+                                      to_unorm(rgba[2], 31));
+    } else {
+        ((Uint32 *)row)[x] = (to_unorm(rgba[3], 255) << 24) |
+                             (to_unorm(rgba[2], 255) << 16) |
+                             (to_unorm(rgba[1], 255) << 8) |
+                             to_unorm(rgba[0], 255);
+    }
+}
+
+static void execute_quad(const host_quad *quad)
+{
+    float src[4], dst[4];
+    int x, y, i;
+
+    for (y = 0; y < quad->h; y++) {
+        for (x = 0; x < quad->w; x++) {
+            read_texel(quad->texture, quad->sx + x * quad->sw / quad->w,
+                       quad->sy + y * quad->sh / quad->h, src);
+            if (quad->blend) {
+                read_texel(quad->target, quad->dx + x, quad->dy + y, dst);
+                for (i = 0; i < 3; i++) {
+                    src[i] = src[i] * src[3] + dst[i] * (1.0f - src[3]);
+                }
+                src[3] = dst[3];
+            }
+            write_texel(quad->target, quad->dx + x, quad->dy + y, src);
+        }
+    }
+}
+
+// Runs the quads of every scene the simulated GPU completed so far
+static void execute_quads()
+{
+    int i, done = 0;
+
+    while (done < num_quads && gxm_fence_reached(quads[done].fence)) {
+        execute_quad(&quads[done]);
+        done++;
+    }
+    for (i = done; i < num_quads; i++) {
+        quads[i - done] = quads[i];
+    }
+    num_quads -= done;
+}
+
+int gxm_host_get_calls(const gxm_host_call **recorded)
+{
+    *recorded = calls;
+    return num_calls;
+}
+
+void gxm_host_clear_calls()
+{
+    num_calls = 0;
+}
+
+void gxm_host_set_gpu_latency(unsigned int scenes)
+{
+    gpu_latency = scenes;
+}
+
+void gxm_host_fail_render_targets(int fail)
+{
+    fail_render_targets = fail;
+}
+
+int gxm_init()
+{
+    back_buffer_index = 0;
+    num_calls = 0;
+    gpu_latency = 0;
+    fail_render_targets = 0;
+    submitted_fence = 0;
+    completed_fence = 0;
+    current_target = NULL;
+    num_quads = 0;
+    return 0;
+}
+
+static void free_vertex_chunks()
+{
+    while (vertex_chunks) {
+        host_vertex_chunk *next = vertex_chunks->next;
+        SDL_free(vertex_chunks);
+        vertex_chunks = next;
+    }
+}
+
+void gxm_finish()
+{
+    free_vertex_chunks();
+    SDL_free(quads);
+    quads = NULL;
+    num_quads = 0;
+    max_quads = 0;
+}
+
+void gxm_wait_rendering_done()
+{
+    record_call(GXM_HOST_WAIT_RENDERING_DONE, NULL, 0, 0, 0, 0);
+    completed_fence = submitted_fence;
+    execute_quads();
+}
+
+void gxm_start_drawing()
+{
+    record_call(GXM_HOST_START_DRAWING, NULL, 0, 0, 0, 0);
+    current_target = NULL;
+    free_vertex_chunks();
+}
+
+void gxm_start_drawing_to_texture(gxm_texture *target)
+{
+    record_call(GXM_HOST_START_DRAWING_TO_TEXTURE, target, 0, 0, target->width, target->height);
+    current_target = target;
+    free_vertex_chunks();
+}
+
+gxm_texture *create_gxm_texture(unsigned int w, unsigned int h, SceGxmTextureFormat format)
+{
+    gxm_texture *texture = SDL_calloc(1, sizeof(gxm_texture));
+    unsigned int size;
+    if (!texture)
+        return NULL;
+
+    texture->format = format;
+    texture->width = w;
+    texture->height = h;
+    texture->min_filter = SCE_GXM_TEXTURE_FILTER_POINT;
+    texture->mag_filter = SCE_GXM_TEXTURE_FILTER_POINT;
+    if (!texture_heap) {
+        gxm_heap_backend backend;
+        backend.reserve = heap_reserve;
+        backend.release = heap_release;
+        backend.userdata = NULL;
+        texture_heap = gxm_heap_create(&backend, GXM_HOST_ARENA_SIZE, GXM_HOST_MIN_BLOCK);
+    }
+    size = gxm_texture_get_stride(texture) * h;
+    if (format == SCE_GXM_TEXTURE_FORMAT_YUV420P3_CSC0 ||
+        format == SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC0) {
+        size += (gxm_texture_get_stride(texture) / 2) * ((h + 1) / 2) * 2;
+    }
+    texture->data = texture_heap ? gxm_heap_alloc(texture_heap, size, SCE_GXM_TEXTURE_ALIGNMENT) : NULL;
+    if (!texture->data) {
+        SDL_free(texture);
+        return NULL;
+    }
+    SDL_memset(texture->data, 0, size);
+    return texture;
+}
+
+void free_gxm_texture(gxm_texture *texture)
+{
+    if (texture) {
+        gxm_heap_free(texture_heap, texture->data);
+        SDL_free(texture);
+    }
+}
+
+void gxm_texture_set_filters(gxm_texture *texture, SceGxmTextureFilter min_filter, SceGxmTextureFilter mag_filter)
+{
+    texture->min_filter = min_filter;
+    texture->mag_filter = mag_filter;
+}
+
+int gxm_texture_enable_render_target(gxm_texture *texture)
+{
+    if (fail_render_targets) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+    if (texture->format != SCE_GXM_TEXTURE_FORMAT_R5G6B5 &&
+        texture->format != SCE_GXM_TEXTURE_FORMAT_A8B8G8R8) {
+        SDL_SetError("texture format can't be rendered to");
+        return -1;
+    }
+    texture->render_target = 1;
+    return 0;
+}
+
+void gxm_texture_set_alloc_memblock_type(SceKernelMemBlockType type)
+{
+}
+
+void gxm_get_texture_memory_stats(gxm_heap_stats *stats)
+{
+    if (texture_heap) {
+        gxm_heap_get_stats(texture_heap, stats);
+    } else {
+        SDL_memset(stats, 0, sizeof(*stats));
+    }
+}
+
+SceGxmTextureFormat gxm_texture_get_format(const gxm_texture *texture)
+{
+    return texture->format;
+}
+
+unsigned int gxm_texture_get_width(const gxm_texture *texture)
+{
+    return texture->width;
+}
+
+unsigned int gxm_texture_get_height(const gxm_texture *texture)
+{
+    return texture->height;
+}
+
+unsigned int gxm_texture_get_stride(const gxm_texture *texture)
+{
+    return ((texture->width + 7) & ~7) * host_bytespp(texture->format);
+}
+
+void *gxm_texture_get_datap(const gxm_texture *texture)
+{
+    return texture->data;
+}
+
+void gxm_draw_texture(const gxm_texture *texture)
+{
+    record_call(GXM_HOST_DRAW_TEXTURE, texture, 0, 0, texture->width, texture->height);
+}
+
+void gxm_draw_texture_part(const gxm_texture *texture, int x, int y, int w, int h)
+{
+    record_call(GXM_HOST_DRAW_TEXTURE_PART, texture, x, y, w, h);
+}
+
+texture_vertex *gxm_reserve_quads(unsigned int count)
+{
+    host_vertex_chunk *chunk;
+
+    chunk = SDL_malloc(sizeof(host_vertex_chunk) + (4 * count) * sizeof(texture_vertex));
+    if (!chunk) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    chunk->next = vertex_chunks;
+    vertex_chunks = chunk;
+    return chunk->vertices;
+}
+
+static int texel_coord(float coord, unsigned int size)
+{
+    return (int)(coord * size + 0.5f);
+}
+
+// Turns the vertices back into rectangles for the software executor
+void gxm_draw_quads(const gxm_texture *texture, int blend, const texture_vertex *vertices, unsigned int count)
+{
+    unsigned int i;
+
+    record_call(GXM_HOST_DRAW_QUADS, texture, blend, 0, count, 0);
+    if (!current_target || !current_target->render_target) {
+        SDL_SetError("quads drawn outside of a texture scene");
+        return;
+    }
+    if (num_quads + (int)count > max_quads) {
+        int size = max_quads ? max_quads : 256;
+        host_quad *resized;
+
+        while (num_quads + (int)count > size) {
+            size *= 2;
+        }
+        resized = SDL_realloc(quads, size * sizeof(host_quad));
+        if (!resized) {
+            SDL_OutOfMemory();
+            return;
+        }
+        quads = resized;
+        max_quads = size;
+    }
+
+    for (i = 0; i < count; i++, vertices += 4) {
+        host_quad *quad = &quads[num_quads++];
+        quad->fence = submitted_fence + 1;
+        quad->target = current_target;
+        quad->texture = texture;
+        quad->blend = blend;
+        quad->sx = texel_coord(vertices[0].u, texture->width);
+        quad->sy = texel_coord(vertices[0].v, texture->height);
+        quad->sw = texel_coord(vertices[3].u, texture->width) - quad->sx;
+        quad->sh = texel_coord(vertices[3].v, texture->height) - quad->sy;
+        quad->dx = (int)vertices[0].x;
+        quad->dy = (int)vertices[0].y;
+        quad->w = (int)(vertices[3].x - vertices[0].x);
+        quad->h = (int)(vertices[3].y - vertices[0].y);
+    }
+}
+
+void gxm_init_texture_scale(const gxm_texture *texture, float x, float y, float x_scale, float y_scale)
+{
+}
+
+void gxm_end_drawing()
+{
+    record_call(GXM_HOST_END_DRAWING, NULL, 0, 0, 0, 0);
+    submitted_fence++;
+    if ((int)(submitted_fence - gpu_latency - completed_fence) > 0) {
+        completed_fence = submitted_fence - gpu_latency;
+    }
+    current_target = NULL;
+    execute_quads();
+}
+
+void gxm_swap_buffers()
+{
+    record_call(GXM_HOST_SWAP_BUFFERS, NULL, 0, 0, 0, 0);
+    back_buffer_index = (back_buffer_index + 1) % VITA_GXM_BUFFERS;
+}
+
+void gxm_set_vblank_wait(int enable)
+{
+}
+
+unsigned int gxm_get_back_buffer_index()
+{
+    return back_buffer_index;
+}
+
+unsigned int gxm_get_fence()
+{
+    return submitted_fence;
+}
+
+int gxm_fence_reached(unsigned int fence)
+{
+    return (int)(completed_fence - fence) >= 0;
+}
+
+void gxm_wait_fence(unsigned int fence)
+{
+    if (!gxm_fence_reached(fence)) {
+        record_call(GXM_HOST_WAIT_FENCE, NULL, fence, 0, 0, 0);
+        completed_fence = fence;
+        execute_quads();
+    }
+}
+
+#endif /* !__vita__ */
+
+/* vi: set ts=4 sw=4 expandtab: */
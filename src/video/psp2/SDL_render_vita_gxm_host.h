@@ -0,0 +1,64 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Minimal stand-ins for the libgxm and kernel types used by the gxm tools
+ * interface. They let the platform independent parts of the psp2 driver be
+ * built and tested on a desktop host against SDL_render_vita_gxm_host.c.
+ */
+
+#ifndef SDL_RENDER_VITA_GXM_HOST_H
+#define SDL_RENDER_VITA_GXM_HOST_H
+
+#ifdef __vita__
+#error This header is only meant for host builds
+#endif
+
+typedef int SceUID;
+typedef int SceKernelMemBlockType;
+typedef unsigned int SceGxmTextureFormat;
+typedef int SceGxmTextureFilter;
+
+#define SCE_KERNEL_MEMBLOCK_TYPE_USER_RW            0x0c20d060
+#define SCE_KERNEL_MEMBLOCK_TYPE_USER_RW_UNCACHE    0x0c208060
+#define SCE_KERNEL_MEMBLOCK_TYPE_USER_CDRAM_RW      0x09408060
+
+/* On the host the low byte of the texture format is the bytes per pixel,
+   of the luma plane for planar YUV */
+#define SCE_GXM_TEXTURE_FORMAT_P8                   1
+#define SCE_GXM_TEXTURE_FORMAT_R5G6B5               2
+#define SCE_GXM_TEXTURE_FORMAT_U8U8U8_RGB           3
+#define SCE_GXM_TEXTURE_FORMAT_A8B8G8R8             4
+#define SCE_GXM_TEXTURE_FORMAT_YUV420P3_CSC0        0x101
+#define SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC0        0x201
+#define SCE_GXM_TEXTURE_FORMAT_YUYV422_CSC0         0x302
+#define SCE_GXM_TEXTURE_FORMAT_UYVY422_CSC0         0x402
+#define SCE_GXM_TEXTURE_FORMAT_YVYU422_CSC0         0x502
+
+#define SCE_GXM_TEXTURE_FILTER_POINT                0
+#define SCE_GXM_TEXTURE_FILTER_LINEAR               1
+
+#define SCE_GXM_TEXTURE_ALIGNMENT                   16
+#define SCE_GXM_TILE_SIZEX                          32
+#define SCE_GXM_TILE_SIZEY                          32
+
+#endif /* SDL_RENDER_VITA_GXM_HOST_H */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -19,8 +19,24 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
+#include "SDL_stdinc.h"
+
 #include "SDL_render_vita_gxm_memory.h"
 
+// Textures are sub-allocated from memblocks of this size, one heap per
+// memblock type. See SDL_render_vita_gxm_heap.c.
+#define MEM_HEAP_ARENA_SIZE (8 * 1024 * 1024)
+#define MEM_HEAP_MIN_BLOCK  512
+#define MEM_HEAP_TYPES      4
+
+typedef struct mem_heap {
+    SceKernelMemBlockType type;
+    gxm_heap *heap;
+} mem_heap;
+
+static mem_heap heaps[MEM_HEAP_TYPES];
+static int num_heaps = 0;
+
 void *mem_gpu_alloc(SceKernelMemBlockType type, unsigned int size, unsigned int alignment, unsigned int attribs, SceUID *uid)
 {
     void *mem;
@@ -102,4 +118,110 @@ void mem_fragment_usse_free(SceUID uid)
     sceKernelFreeMemBlock(uid);
 }
 
+static void *heap_reserve(void *userdata, unsigned int size, void **handle)
+{
+    const mem_heap *owner = (const mem_heap *)userdata;
+    SceUID uid;
+    void *mem;
+
+    mem = mem_gpu_alloc(
+        owner->type,
+        size,
+        GXM_HEAP_MAX_ALIGNMENT,
+        SCE_GXM_MEMORY_ATTRIB_READ | SCE_GXM_MEMORY_ATTRIB_WRITE,
+        &uid
+    );
+    *handle = (void *)(intptr_t)uid;
+    return mem;
+}
+
+static void heap_release(void *userdata, void *base, void *handle)
+{
+    mem_gpu_free((SceUID)(intptr_t)handle);
+}
+
+static gxm_heap *get_heap(SceKernelMemBlockType type)
+{
+    gxm_heap_backend backend;
+    mem_heap *owner;
+    int i;
+
+    for (i = 0; i < num_heaps; i++) {
+        if (heaps[i].type == type) {
+            return heaps[i].heap;
+        }
+    }
+    if (num_heaps == MEM_HEAP_TYPES) {
+        return NULL;
+    }
+
+    owner = &heaps[num_heaps];
+    backend.reserve = heap_reserve;
+    backend.release = heap_release;
+    backend.userdata = owner;
+    owner->type = type;
+    owner->heap = gxm_heap_create(&backend, MEM_HEAP_ARENA_SIZE, MEM_HEAP_MIN_BLOCK);
+    if (!owner->heap) {
+        return NULL;
+    }
+    num_heaps++;
+    return owner->heap;
+}
+
+void *mem_gpu_heap_alloc(SceKernelMemBlockType type, unsigned int size, unsigned int alignment)
+{
+    gxm_heap *heap = get_heap(type);
+
+    if (!heap)
+        return NULL;
+
+    return gxm_heap_alloc(heap, size, alignment);
+}
+
+void mem_gpu_heap_free(void *mem)
+{
+    int i;
+
+    for (i = 0; i < num_heaps; i++) {
+        if (gxm_heap_free(heaps[i].heap, mem) == 0) {
+            return;
+        }
+    }
+}
+
+// Sums up the statistics of all heaps, the high water mark is the sum of
+// the peaks of each heap
+void mem_gpu_heap_get_stats(gxm_heap_stats *stats)
+{
+    gxm_heap_stats heap_stats;
+    int i;
+
+    SDL_memset(stats, 0, sizeof(*stats));
+    for (i = 0; i < num_heaps; i++) {
+        gxm_heap_get_stats(heaps[i].heap, &heap_stats);
+        stats->reserved += heap_stats.reserved;
+        stats->used += heap_stats.used;
+        stats->requested += heap_stats.requested;
+        stats->high_water += heap_stats.high_water;
+        stats->free += heap_stats.free;
+        stats->largest_free = SDL_max(stats->largest_free, heap_stats.largest_free);
+        stats->arenas += heap_stats.arenas;
+        stats->allocations += heap_stats.allocations;
+        stats->large_allocations += heap_stats.large_allocations;
+    }
+    if (stats->free) {
+        stats->fragmentation = 100 - (unsigned int)((Uint64)stats->largest_free * 100 / stats->free);
+    }
+}
+
+void mem_gpu_heap_finish()
+{
+    int i;
+
+    for (i = 0; i < num_heaps; i++) {
+        gxm_heap_destroy(heaps[i].heap);
+    }
+    num_heaps = 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -26,6 +26,8 @@
 #include <psp2/types.h>
 #include <psp2/kernel/sysmem.h>
 
+#include "SDL_render_vita_gxm_heap.h"
+
 #define ALIGN(x, a) (((x) + ((a) - 1)) & ~((a) - 1))
 
 void *mem_gpu_alloc(SceKernelMemBlockType type, unsigned int size, unsigned int alignment, unsigned int attribs, SceUID *uid);
@@ -35,6 +37,11 @@ void mem_vertex_usse_free(SceUID uid);
 void *mem_fragment_usse_alloc(unsigned int size, SceUID *uid, unsigned int *usse_offset);
 void mem_fragment_usse_free(SceUID uid);
 
+void *mem_gpu_heap_alloc(SceKernelMemBlockType type, unsigned int size, unsigned int alignment);
+void mem_gpu_heap_free(void *mem);
+void mem_gpu_heap_get_stats(gxm_heap_stats *stats);
+void mem_gpu_heap_finish();
+
 #endif /* SDL_RENDER_VITA_GXM_MEMORY_H */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -78,6 +78,8 @@ static int tex_format_to_bytespp(SceGxmTextureFormat format)
     case SCE_GXM_TEXTURE_BASE_FORMAT_U8:
     case SCE_GXM_TEXTURE_BASE_FORMAT_S8:
     case SCE_GXM_TEXTURE_BASE_FORMAT_P8:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
         return 1;
     case SCE_GXM_TEXTURE_BASE_FORMAT_U4U4U4U4:
     case SCE_GXM_TEXTURE_BASE_FORMAT_U8U3U3U2:
@@ -86,6 +88,7 @@ static int tex_format_to_bytespp(SceGxmTextureFormat format)
     case SCE_GXM_TEXTURE_BASE_FORMAT_S5S5U6:
     case SCE_GXM_TEXTURE_BASE_FORMAT_U8U8:
     case SCE_GXM_TEXTURE_BASE_FORMAT_S8S8:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV422:
         return 2;
     case SCE_GXM_TEXTURE_BASE_FORMAT_U8U8U8:
     case SCE_GXM_TEXTURE_BASE_FORMAT_S8S8S8:
@@ -100,6 +103,20 @@ static int tex_format_to_bytespp(SceGxmTextureFormat format)
     }
 }
 
+static int tex_format_to_color_format(SceGxmTextureFormat format, SceGxmColorFormat *color_format)
+{
+    switch (format) {
+    case SCE_GXM_TEXTURE_FORMAT_R5G6B5:
+        *color_format = SCE_GXM_COLOR_FORMAT_U5U6U5_RGB;
+        return 0;
+    case SCE_GXM_TEXTURE_FORMAT_A8B8G8R8:
+        *color_format = SCE_GXM_COLOR_FORMAT_A8B8G8R8;
+        return 0;
+    default:
+        return -1;
+    }
+}
+
 static void display_callback(const void *callback_data)
 {
     SceDisplayFrameBuf framebuf;
@@ -454,6 +471,33 @@ int gxm_init()
         return err;
     }
 
+    // Same program with source alpha blending for quads drawn into textures.
+    // The target keeps its own alpha.
+    static const SceGxmBlendInfo blend_info_alpha = {
+        .colorFunc = SCE_GXM_BLEND_FUNC_ADD,
+        .alphaFunc = SCE_GXM_BLEND_FUNC_ADD,
+        .colorSrc  = SCE_GXM_BLEND_FACTOR_SRC_ALPHA,
+        .colorDst  = SCE_GXM_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+        .alphaSrc  = SCE_GXM_BLEND_FACTOR_ZERO,
+        .alphaDst  = SCE_GXM_BLEND_FACTOR_ONE,
+        .colorMask = SCE_GXM_COLOR_MASK_ALL
+    };
+
+    err = sceGxmShaderPatcherCreateFragmentProgram(
+        data->shaderPatcher,
+        data->textureFragmentProgramId,
+        SCE_GXM_OUTPUT_REGISTER_FORMAT_UCHAR4,
+        0,
+        &blend_info_alpha,
+        textureVertexProgramGxp,
+        &data->textureBlendFragmentProgram
+    );
+
+    if (err != SCE_OK) {
+        SDL_SetError("Patcher create fragment (blend) failed: %d\n", err);
+        return err;
+    }
+
     // find vertex uniforms by name and cache parameter information
     data->textureWvpParam = (SceGxmProgramParameter *)sceGxmProgramFindParameterByName(textureVertexProgramGxp, "wvp");
 
@@ -465,13 +509,64 @@ int gxm_init()
         SCE_GXM_MEMORY_ATTRIB_READ,
         &data->verticesUid
     );
+
+    // Partial updates get their own quads, one set per display buffer so a
+    // frame never rewrites vertices the GPU may still be reading
+    data->regionVertices = mem_gpu_alloc(
+        SCE_KERNEL_MEMBLOCK_TYPE_USER_RW,
+        VITA_GXM_BUFFERS * VITA_GXM_MAX_REGIONS * 4 * sizeof(texture_vertex),
+        sizeof(texture_vertex),
+        SCE_GXM_MEMORY_ATTRIB_READ,
+        &data->regionVerticesUid
+    );
+
+    // Quads drawn into textures, see gxm_reserve_quads
+    data->quadVertices = mem_gpu_alloc(
+        SCE_KERNEL_MEMBLOCK_TYPE_USER_RW,
+        VITA_GXM_QUADS * 4 * sizeof(texture_vertex),
+        sizeof(texture_vertex),
+        SCE_GXM_MEMORY_ATTRIB_READ,
+        &data->quadVerticesUid
+    );
+    data->quadCapacity = VITA_GXM_QUADS;
+    data->quadCount = 0;
+    data->quadSceneCount = 0;
+    data->quadHalvesUsed = 0;
+    data->quadHalvesPending = 0;
+    data->retiredQuadCount = 0;
+
+    // Two triangles per quad, the same for every draw of up to VITA_GXM_QUADS_PER_DRAW quads
+    data->quadIndices = (uint16_t *)mem_gpu_alloc(
+        SCE_KERNEL_MEMBLOCK_TYPE_USER_RW_UNCACHE,
+        VITA_GXM_QUADS_PER_DRAW * 6 * sizeof(uint16_t),
+        sizeof(uint16_t),
+        SCE_GXM_MEMORY_ATTRIB_READ,
+        &data->quadIndicesUid
+    );
+    for (i = 0; i < VITA_GXM_QUADS_PER_DRAW; i++) {
+        data->quadIndices[6 * i + 0] = 4 * i + 0;
+        data->quadIndices[6 * i + 1] = 4 * i + 1;
+        data->quadIndices[6 * i + 2] = 4 * i + 2;
+        data->quadIndices[6 * i + 3] = 4 * i + 1;
+        data->quadIndices[6 * i + 4] = 4 * i + 3;
+        data->quadIndices[6 * i + 5] = 4 * i + 2;
+    }
+
     init_orthographic_matrix(data->ortho_matrix, 0.0f, VITA_GXM_SCREEN_WIDTH, VITA_GXM_SCREEN_HEIGHT, 0.0f, 0.0f, 1.0f);
 
     data->backBufferIndex = 0;
     data->frontBufferIndex = 0;
 
+    // every scene writes its fence value to one of these when the GPU is done with it
+    data->fenceWords = sceGxmGetNotificationRegion();
+    for (i = 0; i < VITA_GXM_FENCES; i++) {
+        data->fenceWords[i] = 0;
+    }
+    data->sceneFence = 0;
+
     sceGxmSetVertexProgram(data->gxm_context, data->textureVertexProgram);
 	sceGxmSetFragmentProgram(data->gxm_context, data->textureFragmentProgram);
+    data->currentFragmentProgram = data->textureFragmentProgram;
 
     return 0;
 }
@@ -484,6 +579,7 @@ void gxm_finish()
     // clean up allocations
     sceGxmShaderPatcherReleaseVertexProgram(data->shaderPatcher, data->textureVertexProgram);
     sceGxmShaderPatcherReleaseFragmentProgram(data->shaderPatcher, data->textureFragmentProgram);
+    sceGxmShaderPatcherReleaseFragmentProgram(data->shaderPatcher, data->textureBlendFragmentProgram);
 
     mem_gpu_free(data->linearIndicesUid);
 
@@ -524,6 +620,17 @@ void gxm_finish()
     mem_gpu_free(data->vdmRingBufferUid);
     SDL_free(data->contextParams.hostMem);
     mem_gpu_free(data->verticesUid);
+    mem_gpu_free(data->regionVerticesUid);
+    mem_gpu_free(data->quadVerticesUid);
+    for (size_t i = 0; i < data->retiredQuadCount; i++)
+    {
+        mem_gpu_free(data->retiredQuadUid[i]);
+    }
+    mem_gpu_free(data->quadIndicesUid);
+
+    // release the memory reserved for textures
+    mem_gpu_heap_finish();
+
     // terminate libgxm
     sceGxmTerminate();
 
@@ -536,13 +643,13 @@ void free_gxm_texture(gxm_texture *texture)
         if (texture->gxm_rendertarget) {
             sceGxmDestroyRenderTarget(texture->gxm_rendertarget);
         }
-        if (texture->depth_UID) {
-            mem_gpu_free(texture->depth_UID);
+        if (texture->depth) {
+            mem_gpu_heap_free(texture->depth);
         }
-        if (texture->palette_UID) {
-            mem_gpu_free(texture->palette_UID);
+        if (texture->palette) {
+            mem_gpu_heap_free(texture->palette);
         }
-        mem_gpu_free(texture->data_UID);
+        mem_gpu_heap_free(gxm_texture_get_datap(texture));
         SDL_free(texture);
     }
 }
@@ -573,6 +680,11 @@ void* gxm_texture_get_datap(const gxm_texture *texture)
     return sceGxmTextureGetData(&texture->gxm_tex);
 }
 
+void gxm_get_texture_memory_stats(gxm_heap_stats *stats)
+{
+    mem_gpu_heap_get_stats(stats);
+}
+
 void gxm_texture_set_alloc_memblock_type(SceKernelMemBlockType type)
 {
 	textureMemBlockType = (type == 0) ? SCE_KERNEL_MEMBLOCK_TYPE_USER_CDRAM_RW : type;
@@ -580,23 +692,32 @@ void gxm_texture_set_alloc_memblock_type(SceKernelMemBlockType type)
 
 gxm_texture* create_gxm_texture(unsigned int w, unsigned int h, SceGxmTextureFormat format)
 {
-    gxm_texture *texture = SDL_malloc(sizeof(gxm_texture));
+    gxm_texture *texture = SDL_calloc(1, sizeof(gxm_texture));
     if (!texture)
         return NULL;
 
-    const int tex_size =  ((w + 7) & ~ 7) * h * tex_format_to_bytespp(format);
+    int tex_size =  ((w + 7) & ~ 7) * h * tex_format_to_bytespp(format);
+
+    // Planar YUV: the chroma planes follow the luma plane, at half its
+    // stride and half its height
+    switch (format & 0x9f000000U) {
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
+        tex_size += (((w + 7) & ~7) / 2) * ((h + 1) / 2) * 2;
+        break;
+    default:
+        break;
+    }
 
     /* Allocate a GPU buffer for the texture */
-    void *texture_data = mem_gpu_alloc(
+    void *texture_data = mem_gpu_heap_alloc(
         textureMemBlockType,
         tex_size,
-        SCE_GXM_TEXTURE_ALIGNMENT,
-        SCE_GXM_MEMORY_ATTRIB_READ | SCE_GXM_MEMORY_ATTRIB_WRITE,
-        &texture->data_UID
+        SCE_GXM_TEXTURE_ALIGNMENT
     );
 
     if (!texture_data) {
-        free(texture);
+        SDL_free(texture);
         return NULL;
     }
 
@@ -609,34 +730,108 @@ gxm_texture* create_gxm_texture(unsigned int w, unsigned int h, SceGxmTextureFor
     if ((format & 0x9f000000U) == SCE_GXM_TEXTURE_BASE_FORMAT_P8) {
         const int pal_size = 256 * sizeof(uint32_t);
 
-        void *texture_palette = mem_gpu_alloc(
+        texture->palette = mem_gpu_heap_alloc(
             SCE_KERNEL_MEMBLOCK_TYPE_USER_CDRAM_RW,
             pal_size,
-            SCE_GXM_PALETTE_ALIGNMENT,
-            SCE_GXM_MEMORY_ATTRIB_READ,
-            &texture->palette_UID);
+            SCE_GXM_PALETTE_ALIGNMENT);
 
-        if (!texture_palette) {
-            texture->palette_UID = 0;
+        if (!texture->palette) {
             free_gxm_texture(texture);
             return NULL;
         }
 
-        SDL_memset(texture_palette, 0, pal_size);
+        SDL_memset(texture->palette, 0, pal_size);
 
-        sceGxmTextureSetPalette(&texture->gxm_tex, texture_palette);
-    } else {
-        texture->palette_UID = 0;
+        sceGxmTextureSetPalette(&texture->gxm_tex, texture->palette);
     }
 
     return texture;
 }
 
+// Sets up the color surface and render target needed to draw into the
+// texture. Only 16 bit R5G6B5 and 32 bit A8B8G8R8 textures are supported.
+int gxm_texture_enable_render_target(gxm_texture *texture)
+{
+    SceGxmColorFormat color_format;
+    const unsigned int w = gxm_texture_get_width(texture);
+    const unsigned int h = gxm_texture_get_height(texture);
+    SceGxmRenderTargetParams renderTargetParams;
+    int err;
+
+    if (texture->gxm_rendertarget) {
+        return 0;
+    }
+    if (tex_format_to_color_format(gxm_texture_get_format(texture), &color_format) < 0) {
+        SDL_SetError("texture format can't be rendered to");
+        return -1;
+    }
+
+    err = sceGxmColorSurfaceInit(
+        &texture->gxm_colorsurface,
+        color_format,
+        SCE_GXM_COLOR_SURFACE_LINEAR,
+        SCE_GXM_COLOR_SURFACE_SCALE_NONE,
+        SCE_GXM_OUTPUT_REGISTER_SIZE_32BIT,
+        w,
+        h,
+        (w + 7) & ~7,
+        gxm_texture_get_datap(texture)
+    );
+    if (err != SCE_OK) {
+        SDL_SetError("color surface init failed: %d\n", err);
+        return -1;
+    }
+
+    // the depth buffer is never tested, but a scene needs one
+    const unsigned int alignedWidth = ALIGN(w, SCE_GXM_TILE_SIZEX);
+    const unsigned int alignedHeight = ALIGN(h, SCE_GXM_TILE_SIZEY);
+    texture->depth = mem_gpu_heap_alloc(
+        SCE_KERNEL_MEMBLOCK_TYPE_USER_RW_UNCACHE,
+        4 * alignedWidth * alignedHeight,
+        SCE_GXM_DEPTHSTENCIL_SURFACE_ALIGNMENT);
+    if (!texture->depth) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+
+    sceGxmDepthStencilSurfaceInit(
+        &texture->gxm_depthstencil,
+        SCE_GXM_DEPTH_STENCIL_FORMAT_S8D24,
+        SCE_GXM_DEPTH_STENCIL_SURFACE_TILED,
+        alignedWidth,
+        texture->depth,
+        NULL);
+
+    SDL_memset(&renderTargetParams, 0, sizeof(SceGxmRenderTargetParams));
+    renderTargetParams.flags                = 0;
+    renderTargetParams.width                = w;
+    renderTargetParams.height               = h;
+    renderTargetParams.scenesPerFrame       = 1;
+    renderTargetParams.multisampleMode      = SCE_GXM_MULTISAMPLE_NONE;
+    renderTargetParams.multisampleLocations = 0;
+    renderTargetParams.driverMemBlock       = -1; // Invalid UID
+
+    err = sceGxmCreateRenderTarget(&renderTargetParams, &texture->gxm_rendertarget);
+    if (err != SCE_OK) {
+        texture->gxm_rendertarget = NULL;
+        mem_gpu_heap_free(texture->depth);
+        texture->depth = NULL;
+        SDL_SetError("render target creation failed: %d\n", err);
+        return -1;
+    }
+    return 0;
+}
+
 void gxm_init_texture_scale(const gxm_texture *texture, float x, float y, float x_scale, float y_scale)
 {
 	const float w = x_scale * gxm_texture_get_width(texture);
 	const float h = y_scale * gxm_texture_get_height(texture);
 
+	data->texture_x = x;
+	data->texture_y = y;
+	data->texture_x_scale = x_scale;
+	data->texture_y_scale = y_scale;
+
 	data->vertices[0].x = x;
 	data->vertices[0].y = y;
 	data->vertices[0].z = +0.5f;
@@ -666,8 +861,19 @@ void gxm_init_texture_scale(const gxm_texture *texture, float x, float y, float
 	sceGxmSetVertexStream(data->gxm_context, 0, data->vertices);
 }
 
+static void set_fragment_program(SceGxmFragmentProgram *program)
+{
+    if (data->currentFragmentProgram != program) {
+        sceGxmSetFragmentProgram(data->gxm_context, program);
+        data->currentFragmentProgram = program;
+    }
+}
+
 void gxm_start_drawing()
 {
+    data->regionCount = 0;
+    set_fragment_program(data->textureFragmentProgram);
+
     sceGxmBeginScene(
         data->gxm_context,
         0,
@@ -683,11 +889,215 @@ void gxm_start_drawing()
 void gxm_draw_texture(const gxm_texture *texture)
 {
     void *vertex_wvp_buffer;
+	sceGxmSetFragmentTexture(data->gxm_context, 0, &texture->gxm_tex);
+	sceGxmSetVertexStream(data->gxm_context, 0, data->vertices);
 	sceGxmReserveVertexDefaultUniformBuffer(data->gxm_context, &vertex_wvp_buffer);
 	sceGxmSetUniformDataF(vertex_wvp_buffer, data->textureWvpParam, 0, 16, data->ortho_matrix);
 	sceGxmDraw(data->gxm_context, SCE_GXM_PRIMITIVE_TRIANGLE_STRIP, SCE_GXM_INDEX_FORMAT_U16, data->linearIndices, 4);
 }
 
+// Draws the x,y,w,h part of the texture at the position and scale set by
+// gxm_init_texture_scale. The quad is widened to whole GPU tiles so that no
+// tile is left half written.
+void gxm_draw_texture_part(const gxm_texture *texture, int x, int y, int w, int h)
+{
+    void *vertex_wvp_buffer;
+    texture_vertex *vertices;
+    const float tex_w = (float)gxm_texture_get_width(texture);
+    const float tex_h = (float)gxm_texture_get_height(texture);
+    const float dst_x0 = data->texture_x;
+    const float dst_y0 = data->texture_y;
+    const float dst_x1 = dst_x0 + data->texture_x_scale * tex_w;
+    const float dst_y1 = dst_y0 + data->texture_y_scale * tex_h;
+    float x0, y0, x1, y1;
+
+    if (data->regionCount >= VITA_GXM_MAX_REGIONS) {
+        return;
+    }
+
+    x0 = (float)(((int)(dst_x0 + x * data->texture_x_scale) / SCE_GXM_TILE_SIZEX) * SCE_GXM_TILE_SIZEX);
+    y0 = (float)(((int)(dst_y0 + y * data->texture_y_scale) / SCE_GXM_TILE_SIZEY) * SCE_GXM_TILE_SIZEY);
+    x1 = (float)ALIGN((int)(dst_x0 + (x + w) * data->texture_x_scale + 0.999f), SCE_GXM_TILE_SIZEX);
+    y1 = (float)ALIGN((int)(dst_y0 + (y + h) * data->texture_y_scale + 0.999f), SCE_GXM_TILE_SIZEY);
+    if (x0 < dst_x0) x0 = dst_x0;
+    if (y0 < dst_y0) y0 = dst_y0;
+    if (x1 > dst_x1) x1 = dst_x1;
+    if (y1 > dst_y1) y1 = dst_y1;
+
+    vertices = &data->regionVertices[(data->backBufferIndex * VITA_GXM_MAX_REGIONS + data->regionCount) * 4];
+    data->regionCount++;
+
+    vertices[0].x = x0;
+    vertices[0].y = y0;
+    vertices[0].z = +0.5f;
+    vertices[0].u = (x0 - dst_x0) / (dst_x1 - dst_x0);
+    vertices[0].v = (y0 - dst_y0) / (dst_y1 - dst_y0);
+
+    vertices[1].x = x1;
+    vertices[1].y = y0;
+    vertices[1].z = +0.5f;
+    vertices[1].u = (x1 - dst_x0) / (dst_x1 - dst_x0);
+    vertices[1].v = vertices[0].v;
+
+    vertices[2].x = x0;
+    vertices[2].y = y1;
+    vertices[2].z = +0.5f;
+    vertices[2].u = vertices[0].u;
+    vertices[2].v = (y1 - dst_y0) / (dst_y1 - dst_y0);
+
+    vertices[3].x = x1;
+    vertices[3].y = y1;
+    vertices[3].z = +0.5f;
+    vertices[3].u = vertices[1].u;
+    vertices[3].v = vertices[2].v;
+
+    sceGxmSetFragmentTexture(data->gxm_context, 0, &texture->gxm_tex);
+    sceGxmSetVertexStream(data->gxm_context, 0, vertices);
+    sceGxmReserveVertexDefaultUniformBuffer(data->gxm_context, &vertex_wvp_buffer);
+    sceGxmSetUniformDataF(vertex_wvp_buffer, data->textureWvpParam, 0, 16, data->ortho_matrix);
+    sceGxmDraw(data->gxm_context, SCE_GXM_PRIMITIVE_TRIANGLE_STRIP, SCE_GXM_INDEX_FORMAT_U16, data->linearIndices, 4);
+}
+
+// Starts a scene drawing into a texture set up with
+// gxm_texture_enable_render_target
+void gxm_start_drawing_to_texture(gxm_texture *target)
+{
+    init_orthographic_matrix(data->target_matrix, 0.0f, gxm_texture_get_width(target), gxm_texture_get_height(target), 0.0f, 0.0f, 1.0f);
+
+    sceGxmBeginScene(
+        data->gxm_context,
+        0,
+        target->gxm_rendertarget,
+        NULL,
+        NULL,
+        NULL,
+        &target->gxm_colorsurface,
+        &target->gxm_depthstencil
+    );
+}
+
+// Frees the outgrown quad pools the GPU is done with. They retire in
+// fence order.
+static void free_retired_quad_pools()
+{
+    unsigned int i, done = 0;
+
+    while (done < data->retiredQuadCount && gxm_fence_reached(data->retiredQuadFence[done])) {
+        mem_gpu_free(data->retiredQuadUid[done]);
+        done++;
+    }
+    for (i = done; i < data->retiredQuadCount; i++) {
+        data->retiredQuadUid[i - done] = data->retiredQuadUid[i];
+        data->retiredQuadFence[i - done] = data->retiredQuadFence[i];
+    }
+    data->retiredQuadCount -= done;
+}
+
+static int grow_quad_pool(unsigned int capacity)
+{
+    texture_vertex *vertices;
+    SceUID uid;
+
+    free_retired_quad_pools();
+    if (data->retiredQuadCount == VITA_GXM_RETIRED_POOLS) {
+        gxm_wait_fence(data->retiredQuadFence[0]);
+        free_retired_quad_pools();
+    }
+
+    vertices = mem_gpu_alloc(
+        SCE_KERNEL_MEMBLOCK_TYPE_USER_RW,
+        capacity * 4 * sizeof(texture_vertex),
+        sizeof(texture_vertex),
+        SCE_GXM_MEMORY_ATTRIB_READ,
+        &uid
+    );
+    if (!vertices) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+
+    // the scene being drawn may still use the old pool
+    data->retiredQuadUid[data->retiredQuadCount] = data->quadVerticesUid;
+    data->retiredQuadFence[data->retiredQuadCount] = data->sceneFence + 1;
+    data->retiredQuadCount++;
+
+    data->quadVertices = vertices;
+    data->quadVerticesUid = uid;
+    data->quadCapacity = capacity;
+    data->quadCount = 0;
+    data->quadSceneCount = 0;
+    data->quadHalvesUsed = 0;
+    data->quadHalvesPending = 0;
+    return 0;
+}
+
+// Reserves vertices for count quads of the current scene, they have to stay
+// untouched until the GPU finished it. The pool is used in two halves and
+// moving into a half waits for the last scene that drew from it. A scene
+// never takes more than a half, the pool grows instead.
+texture_vertex *gxm_reserve_quads(unsigned int count)
+{
+    unsigned int half_size = data->quadCapacity / 2;
+    unsigned int half, skip;
+    texture_vertex *vertices;
+
+    if (data->quadSceneCount + count > half_size) {
+        unsigned int capacity = data->quadCapacity * 2;
+        while (count > capacity / 2) {
+            capacity *= 2;
+        }
+        if (grow_quad_pool(capacity) < 0) {
+            return NULL;
+        }
+        half_size = capacity / 2;
+    }
+
+    // a reservation doesn't cross halves
+    if (data->quadCount % half_size + count > half_size) {
+        skip = half_size - data->quadCount % half_size;
+        data->quadCount += skip;
+        data->quadSceneCount += skip;
+    }
+    if (data->quadCount == data->quadCapacity) {
+        data->quadCount = 0;
+    }
+
+    half = data->quadCount / half_size;
+    if (data->quadCount % half_size == 0 && (data->quadHalvesPending & (1 << half))) {
+        gxm_wait_fence(data->quadHalfFence[half]);
+    }
+    data->quadHalvesUsed |= 1 << half;
+
+    vertices = &data->quadVertices[4 * data->quadCount];
+    data->quadCount += count;
+    data->quadSceneCount += count;
+    return vertices;
+}
+
+// Draws count quads from vertices reserved with gxm_reserve_quads, four per
+// quad: top left, top right, bottom left, bottom right. Only for scenes
+// started with gxm_start_drawing_to_texture. Blended quads mix with the
+// target by the source alpha.
+void gxm_draw_quads(const gxm_texture *texture, int blend, const texture_vertex *vertices, unsigned int count)
+{
+    void *vertex_wvp_buffer;
+
+    set_fragment_program(blend ? data->textureBlendFragmentProgram : data->textureFragmentProgram);
+    sceGxmSetFragmentTexture(data->gxm_context, 0, &texture->gxm_tex);
+
+    while (count > 0) {
+        const unsigned int n = SDL_min(count, VITA_GXM_QUADS_PER_DRAW);
+
+        sceGxmSetVertexStream(data->gxm_context, 0, vertices);
+        sceGxmReserveVertexDefaultUniformBuffer(data->gxm_context, &vertex_wvp_buffer);
+        sceGxmSetUniformDataF(vertex_wvp_buffer, data->textureWvpParam, 0, 16, data->target_matrix);
+        sceGxmDraw(data->gxm_context, SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, data->quadIndices, 6 * n);
+
+        vertices += 4 * n;
+        count -= n;
+    }
+}
+
 void gxm_wait_rendering_done()
 {
 	sceGxmFinish(data->gxm_context);
@@ -695,7 +1105,20 @@ void gxm_wait_rendering_done()
 
 void gxm_end_drawing()
 {
-	sceGxmEndScene(data->gxm_context, NULL, NULL);
+    SceGxmNotification notification;
+
+    data->sceneFence++;
+    notification.address = &data->fenceWords[data->sceneFence % VITA_GXM_FENCES];
+    notification.value = data->sceneFence;
+
+	sceGxmEndScene(data->gxm_context, NULL, &notification);
+
+    // the quad pool halves this scene drew from are in use until it's done
+    if (data->quadHalvesUsed & 1) data->quadHalfFence[0] = data->sceneFence;
+    if (data->quadHalvesUsed & 2) data->quadHalfFence[1] = data->sceneFence;
+    data->quadHalvesPending |= data->quadHalvesUsed;
+    data->quadHalvesUsed = 0;
+    data->quadSceneCount = 0;
 }
 
 void gxm_swap_buffers()
@@ -723,3 +1146,32 @@ void gxm_set_vblank_wait(int enable)
 {
 	data->vblank_wait = enable;
 }
+
+unsigned int gxm_get_back_buffer_index()
+{
+    return data->backBufferIndex;
+}
+
+// Returns the fence of the last scene ended with gxm_end_drawing
+unsigned int gxm_get_fence()
+{
+    return data->sceneFence;
+}
+
+int gxm_fence_reached(unsigned int fence)
+{
+    // scenes complete in order, so a later fence in the same word counts too
+    return (int)(data->fenceWords[fence % VITA_GXM_FENCES] - fence) >= 0;
+}
+
+void gxm_wait_fence(unsigned int fence)
+{
+    SceGxmNotification notification;
+
+    if (gxm_fence_reached(fence)) {
+        return;
+    }
+    notification.address = &data->fenceWords[fence % VITA_GXM_FENCES];
+    notification.value = fence;
+    sceGxmNotificationWait(&notification);
+}
@@ -22,14 +22,17 @@
 #ifndef SDL_RENDER_VITA_GXM_TOOLS_H
 #define SDL_RENDER_VITA_GXM_TOOLS_H
 
+#ifdef __vita__
 #include <psp2/kernel/processmgr.h>
 #include <psp2/appmgr.h>
 #include <psp2/display.h>
 #include <psp2/gxm.h>
 #include <psp2/types.h>
 #include <psp2/kernel/sysmem.h>
+#endif
 
 #include "SDL_render_vita_gxm_types.h"
+#include "SDL_render_vita_gxm_heap.h"
 
 #ifndef SCE_OK
 #define SCE_OK 0
@@ -42,12 +45,15 @@ void gxm_finish();
 
 void gxm_wait_rendering_done();
 void gxm_start_drawing();
+void gxm_start_drawing_to_texture(gxm_texture *target);
 
 gxm_texture *create_gxm_texture(unsigned int w, unsigned int h, SceGxmTextureFormat format);
 void free_gxm_texture(gxm_texture *texture);
 
 void gxm_texture_set_filters(gxm_texture *texture, SceGxmTextureFilter min_filter, SceGxmTextureFilter mag_filter);
+int gxm_texture_enable_render_target(gxm_texture *texture);
 void gxm_texture_set_alloc_memblock_type(SceKernelMemBlockType type);
+void gxm_get_texture_memory_stats(gxm_heap_stats *stats);
 SceGxmTextureFormat gxm_texture_get_format(const gxm_texture *texture);
 
 unsigned int gxm_texture_get_width(const gxm_texture *texture);
@@ -56,10 +62,46 @@ unsigned int gxm_texture_get_stride(const gxm_texture *texture);
 void *gxm_texture_get_datap(const gxm_texture *texture);
 
 void gxm_draw_texture(const gxm_texture *texture);
+void gxm_draw_texture_part(const gxm_texture *texture, int x, int y, int w, int h);
+texture_vertex *gxm_reserve_quads(unsigned int count);
+void gxm_draw_quads(const gxm_texture *texture, int blend, const texture_vertex *vertices, unsigned int count);
 void gxm_init_texture_scale(const gxm_texture *texture, float x, float y, float x_scale, float y_scale);
 void gxm_end_drawing();
 void gxm_swap_buffers();
 void gxm_set_vblank_wait(int enable);
+unsigned int gxm_get_back_buffer_index();
+
+unsigned int gxm_get_fence();
+int gxm_fence_reached(unsigned int fence);
+void gxm_wait_fence(unsigned int fence);
+
+#ifndef __vita__
+/* The host stand-in records every drawing call instead of rendering it */
+typedef enum {
+    GXM_HOST_START_DRAWING,
+    GXM_HOST_START_DRAWING_TO_TEXTURE,
+    GXM_HOST_DRAW_TEXTURE,
+    GXM_HOST_DRAW_TEXTURE_PART,
+    GXM_HOST_DRAW_QUADS,
+    GXM_HOST_END_DRAWING,
+    GXM_HOST_WAIT_RENDERING_DONE,
+    GXM_HOST_WAIT_FENCE,
+    GXM_HOST_SWAP_BUFFERS
+} gxm_host_op;
+
+/* For GXM_HOST_DRAW_QUADS x is the blend flag and w the number of quads */
+typedef struct gxm_host_call {
+    gxm_host_op op;
+    const gxm_texture *texture;
+    unsigned int buffer;
+    int x, y, w, h;
+} gxm_host_call;
+
+int gxm_host_get_calls(const gxm_host_call **calls);
+void gxm_host_clear_calls();
+void gxm_host_set_gpu_latency(unsigned int scenes);
+void gxm_host_fail_render_targets(int fail);
+#endif
 
 #endif /* SDL_RENDER_VITA_GXM_TOOLS_H */
 
@@ -22,12 +22,16 @@
 #ifndef SDL_RENDER_VITA_GXM_TYPES_H
 #define SDL_RENDER_VITA_GXM_TYPES_H
 
+#ifdef __vita__
 #include <psp2/kernel/processmgr.h>
 #include <psp2/appmgr.h>
 #include <psp2/display.h>
 #include <psp2/gxm.h>
 #include <psp2/types.h>
 #include <psp2/kernel/sysmem.h>
+#else
+#include "SDL_render_vita_gxm_host.h"
+#endif
 
 
 #define VITA_GXM_SCREEN_WIDTH     960
@@ -40,11 +44,23 @@
 #define VITA_GXM_BUFFERS          3
 #define VITA_GXM_PENDING_SWAPS    2
 
+/* Maximum number of partial screen updates drawn in a single frame */
+#define VITA_GXM_MAX_REGIONS      16
+
+/* Notification words used to tell when the GPU finished a scene. Must be
+   larger than the number of scenes that can be in flight at once. */
+#define VITA_GXM_FENCES           64
+
+/* Initial size of the vertex pool for quads drawn into textures. It grows
+   when a scene needs more than half of it, see gxm_reserve_quads. */
+#define VITA_GXM_QUADS            2048
+
+/* Most quads one draw call can index with 16 bit indices */
+#define VITA_GXM_QUADS_PER_DRAW   16384
+
+/* Outgrown quad pools kept until the GPU is done with them */
+#define VITA_GXM_RETIRED_POOLS    4
 
-typedef struct
-{
-    void     *address;
-} VITA_GXM_DisplayData;
 
 typedef struct texture_vertex {
     float x;
@@ -54,14 +70,20 @@ typedef struct texture_vertex {
     float v;
 } texture_vertex;
 
+#ifdef __vita__
+
+typedef struct
+{
+    void     *address;
+} VITA_GXM_DisplayData;
+
 typedef struct gxm_texture {
     SceGxmTexture gxm_tex;
-    SceUID data_UID;
-    SceUID palette_UID;
+    void *palette;
     SceGxmRenderTarget *gxm_rendertarget;
     SceGxmColorSurface gxm_colorsurface;
     SceGxmDepthStencilSurface gxm_depthstencil;
-    SceUID depth_UID;
+    void *depth;
 } gxm_texture;
 
 typedef struct
@@ -89,13 +111,43 @@ typedef struct
     unsigned int backBufferIndex;
     unsigned int frontBufferIndex;
 
+    volatile unsigned int *fenceWords;
+    unsigned int sceneFence;
+
     texture_vertex *vertices;
     SceUID verticesUid;
 
+    texture_vertex *regionVertices;
+    SceUID regionVerticesUid;
+    unsigned int regionCount;
+
+    float texture_x;
+    float texture_y;
+    float texture_x_scale;
+    float texture_y_scale;
+
+    texture_vertex *quadVertices;
+    SceUID quadVerticesUid;
+    unsigned int quadCapacity;
+    unsigned int quadCount;
+    unsigned int quadSceneCount;
+    unsigned int quadHalvesUsed;
+    unsigned int quadHalvesPending;
+    unsigned int quadHalfFence[2];
+    SceUID retiredQuadUid[VITA_GXM_RETIRED_POOLS];
+    unsigned int retiredQuadFence[VITA_GXM_RETIRED_POOLS];
+    unsigned int retiredQuadCount;
+
+    uint16_t *quadIndices;
+    SceUID quadIndicesUid;
+
     float ortho_matrix[4*4];
+    float target_matrix[4*4];
 
     SceGxmVertexProgram *textureVertexProgram;
     SceGxmFragmentProgram *textureFragmentProgram;
+    SceGxmFragmentProgram *textureBlendFragmentProgram;
+    SceGxmFragmentProgram *currentFragmentProgram;
     SceGxmProgramParameter *textureWvpParam;
 
     SceGxmShaderPatcher *shaderPatcher;
@@ -113,6 +165,20 @@ typedef struct
     int vblank_wait;
 } VITA_GXM_RenderData;
 
+#else
+
+/* Host stand-in texture: plain system memory, no GPU state */
+typedef struct gxm_texture {
+    void *data;
+    SceGxmTextureFormat format;
+    unsigned int width;
+    unsigned int height;
+    SceGxmTextureFilter min_filter;
+    SceGxmTextureFilter mag_filter;
+    int render_target;
+} gxm_texture;
+
+#endif /* __vita__ */
 
 #endif /* SDL_RENDER_VITA_GXM_TYPES_H */
 
@@ -0,0 +1,452 @@
+/* Checks the atomic operations and spinlocks from several threads, both
+   with the compiler builtins and with the mutex they fall back on, then
+   times them against SDL_mutex as more threads fight over one counter:
+   testatomic [iterations]
+
+   Built with src/atomic/SDL_atomic.c for the mutex version, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_atomic.h"
+#include "testcheck.h"
+
+/* The mutex version, under other names */
+#define SDL_ATOMIC_MUTEX	1
+#define SDL_AtomicInit		Mutex_AtomicInit
+#define SDL_AtomicTryLock	Mutex_AtomicTryLock
+#define SDL_AtomicLock		Mutex_AtomicLock
+#define SDL_AtomicUnlock	Mutex_AtomicUnlock
+#define SDL_MemoryBarrierReleaseFunction	Mutex_MemoryBarrierRelease
+#define SDL_MemoryBarrierAcquireFunction	Mutex_MemoryBarrierAcquire
+#define SDL_AtomicCAS		Mutex_AtomicCAS
+#define SDL_AtomicSet		Mutex_AtomicSet
+#define SDL_AtomicGet		Mutex_AtomicGet
+#define SDL_AtomicAdd		Mutex_AtomicAdd
+#define SDL_AtomicOr		Mutex_AtomicOr
+#define SDL_AtomicAnd		Mutex_AtomicAnd
+#define SDL_AtomicCASPtr	Mutex_AtomicCASPtr
+#define SDL_AtomicSetPtr	Mutex_AtomicSetPtr
+#define SDL_AtomicGetPtr	Mutex_AtomicGetPtr
+void Mutex_AtomicInit(void);
+#include "SDL_atomic.c"
+#undef SDL_AtomicInit
+#undef SDL_AtomicTryLock
+#undef SDL_AtomicLock
+#undef SDL_AtomicUnlock
+#undef SDL_MemoryBarrierReleaseFunction
+#undef SDL_MemoryBarrierAcquireFunction
+#undef SDL_AtomicCAS
+#undef SDL_AtomicSet
+#undef SDL_AtomicGet
+#undef SDL_AtomicAdd
+#undef SDL_AtomicOr
+#undef SDL_AtomicAnd
+#undef SDL_AtomicCASPtr
+#undef SDL_AtomicSetPtr
+#undef SDL_AtomicGetPtr
+
+#define MAXTHREADS	4
+
+typedef struct {
+	const char *name;
+	SDL_bool (SDLCALL *TryLock)(SDL_SpinLock *lock);
+	void (SDLCALL *Lock)(SDL_SpinLock *lock);
+	void (SDLCALL *Unlock)(SDL_SpinLock *lock);
+	void (SDLCALL *Release)(void);
+	void (SDLCALL *Acquire)(void);
+	SDL_bool (SDLCALL *CAS)(SDL_atomic_t *a, int oldval, int newval);
+	int (SDLCALL *Set)(SDL_atomic_t *a, int v);
+	int (SDLCALL *Get)(SDL_atomic_t *a);
+	int (SDLCALL *Add)(SDL_atomic_t *a, int v);
+	int (SDLCALL *Or)(SDL_atomic_t *a, int v);
+	int (SDLCALL *And)(SDL_atomic_t *a, int v);
+	SDL_bool (SDLCALL *CASPtr)(void **a, void *oldval, void *newval);
+	void *(SDLCALL *SetPtr)(void **a, void *v);
+	void *(SDLCALL *GetPtr)(void **a);
+} Atomics;
+
+static const Atomics builtin = {
+	"builtins",
+	SDL_AtomicTryLock, SDL_AtomicLock, SDL_AtomicUnlock,
+	SDL_MemoryBarrierReleaseFunction, SDL_MemoryBarrierAcquireFunction,
+	SDL_AtomicCAS, SDL_AtomicSet, SDL_AtomicGet, SDL_AtomicAdd,
+	SDL_AtomicOr, SDL_AtomicAnd,
+	SDL_AtomicCASPtr, SDL_AtomicSetPtr, SDL_AtomicGetPtr
+};
+
+static const Atomics mutexed = {
+	"mutex",
+	Mutex_AtomicTryLock, Mutex_AtomicLock, Mutex_AtomicUnlock,
+	Mutex_MemoryBarrierRelease, Mutex_MemoryBarrierAcquire,
+	Mutex_AtomicCAS, Mutex_AtomicSet, Mutex_AtomicGet, Mutex_AtomicAdd,
+	Mutex_AtomicOr, Mutex_AtomicAnd,
+	Mutex_AtomicCASPtr, Mutex_AtomicSetPtr, Mutex_AtomicGetPtr
+};
+
+static void TestSingle(const Atomics *ops)
+{
+	SDL_atomic_t a;
+	SDL_SpinLock lock = 0;
+	int x, y;
+	void *p = NULL;
+
+	a.value = 0;
+	CHECK(ops->Set(&a, 5) == 0);
+	CHECK(ops->Get(&a) == 5);
+	CHECK(ops->Add(&a, 3) == 5);
+	CHECK(ops->Add(&a, -10) == 8);
+	CHECK(ops->Get(&a) == -2);
+	CHECK(ops->CAS(&a, 7, 1) == SDL_FALSE && ops->Get(&a) == -2);
+	CHECK(ops->CAS(&a, -2, 1) == SDL_TRUE && ops->Get(&a) == 1);
+	CHECK(ops->Or(&a, 6) == 1 && ops->Get(&a) == 7);
+	CHECK(ops->And(&a, ~2) == 7 && ops->Get(&a) == 5);
+	CHECK(ops->And(&a, 1) == 5 && ops->Get(&a) == 1);
+
+	/* The last reference is the one that drops it to 0 */
+	CHECK(ops->Add(&a, 1) == 1);
+	CHECK(ops->Add(&a, -1) != 1);
+	CHECK(ops->Add(&a, -1) == 1);
+
+	CHECK(ops->SetPtr(&p, &x) == NULL);
+	CHECK(ops->GetPtr(&p) == &x);
+	CHECK(ops->CASPtr(&p, &y, NULL) == SDL_FALSE && p == &x);
+	CHECK(ops->CASPtr(&p, &x, &y) == SDL_TRUE && p == &y);
+
+	CHECK(ops->TryLock(&lock) == SDL_TRUE);
+	CHECK(ops->TryLock(&lock) == SDL_FALSE);
+	ops->Unlock(&lock);
+	CHECK(lock == 0);
+	ops->Lock(&lock);
+	CHECK(ops->TryLock(&lock) == SDL_FALSE);
+	ops->Unlock(&lock);
+	CHECK(ops->TryLock(&lock) == SDL_TRUE);
+	ops->Unlock(&lock);
+
+	/* The macros from the header */
+	a.value = 1;
+	CHECK(SDL_AtomicIncRef(&a) == 1);
+	CHECK(!SDL_AtomicDecRef(&a));
+	CHECK(SDL_AtomicDecRef(&a));
+	SDL_CompilerBarrier();
+	SDL_MemoryBarrierRelease();
+	SDL_MemoryBarrierAcquire();
+}
+
+/* What the threads share */
+static const Atomics *ops;
+static int iterations;
+static SDL_atomic_t counter;
+static SDL_atomic_t casses;
+static SDL_atomic_t swapped;
+static SDL_SpinLock lock;
+static volatile int locked_counter;
+static volatile int inside;
+static int overlaps;
+static SDL_atomic_t sum_in, sum_out;
+
+/* Message passing with the barriers, a thousand messages at most since
+   each one may have to wait for the other thread to be scheduled
+ */
+#define MAXMESSAGES	1000
+
+static volatile int message[4];
+static volatile int posted;
+static int torn;
+
+static int SDLCALL Adder(void *data)
+{
+	int i;
+
+	for ( i = 0; i < iterations; ++i ) {
+		ops->Add(&counter, 1);
+	}
+	return(0);
+}
+
+static int SDLCALL Casser(void *data)
+{
+	int i, value;
+
+	for ( i = 0; i < iterations; ++i ) {
+		do {
+			value = ops->Get(&casses);
+		} while ( !ops->CAS(&casses, value, value + 1) );
+	}
+	return(0);
+}
+
+static int SDLCALL Locker(void *data)
+{
+	int i;
+
+	for ( i = 0; i < iterations; ++i ) {
+		/* Now and then see if it's free first */
+		if ( (i & 7) != 0 || !ops->TryLock(&lock) ) {
+			ops->Lock(&lock);
+		}
+		if ( inside++ ) {
+			++overlaps;
+		}
+		locked_counter = locked_counter + 1;
+		--inside;
+		ops->Unlock(&lock);
+	}
+	return(0);
+}
+
+/* Everything put in with a swap comes out of one, once */
+static int SwapValue(int id, int i)
+{
+	return (id * iterations + i) % 1000 + 1;
+}
+
+static int SDLCALL Swapper(void *data)
+{
+	int id = (int)(size_t)data;
+	int i, in = 0, out = 0, value;
+
+	for ( i = 0; i < iterations; ++i ) {
+		value = SwapValue(id, i);
+		in += value;
+		out += ops->Set(&swapped, value);
+	}
+	ops->Add(&sum_in, in);
+	ops->Add(&sum_out, out);
+	return(0);
+}
+
+/* A stack of nodes pushed and popped with SDL_AtomicCASPtr(); nodes
+   aren't pushed again once popped, so there's no ABA problem
+ */
+typedef struct Node {
+	struct Node *next;
+	int popped;
+} Node;
+
+static Node *nodes;
+static void *top;
+
+static int SDLCALL Pusher(void *data)
+{
+	int id = (int)(size_t)data;
+	Node *node;
+	int i;
+
+	for ( i = 0; i < iterations; ++i ) {
+		node = &nodes[id * iterations + i];
+		do {
+			node->next = (Node *)ops->GetPtr(&top);
+		} while ( !ops->CASPtr(&top, node->next, node) );
+	}
+	return(0);
+}
+
+static int SDLCALL Popper(void *data)
+{
+	Node *node;
+
+	for ( ; ; ) {
+		do {
+			node = (Node *)ops->GetPtr(&top);
+			if ( node == NULL ) {
+				return(0);
+			}
+		} while ( !ops->CASPtr(&top, node, node->next) );
+		++node->popped;
+	}
+}
+
+static int SDLCALL Writer(void *data)
+{
+	int i, j;
+
+	for ( i = 1; i <= MAXMESSAGES && i <= iterations; ++i ) {
+		while ( posted ) {
+			SDL_Delay(0);
+		}
+		ops->Acquire();
+		for ( j = 0; j < SDL_arraysize(message); ++j ) {
+			message[j] = i;
+		}
+		ops->Release();
+		posted = i;
+	}
+	return(0);
+}
+
+static int SDLCALL Reader(void *data)
+{
+	int i, j, seen;
+
+	for ( i = 1; i <= MAXMESSAGES && i <= iterations; ++i ) {
+		while ( (seen = posted) == 0 ) {
+			SDL_Delay(0);
+		}
+		ops->Acquire();
+		for ( j = 0; j < SDL_arraysize(message); ++j ) {
+			if ( message[j] != seen ) {
+				++torn;
+			}
+		}
+		ops->Release();
+		posted = 0;
+	}
+	return(0);
+}
+
+static void RunThreads(int (SDLCALL *fn)(void *), int threads)
+{
+	SDL_Thread *thread[MAXTHREADS];
+	int i;
+
+	for ( i = 0; i < threads; ++i ) {
+		thread[i] = SDL_CreateThread(fn, (void *)(size_t)i);
+		CHECK(thread[i] != NULL);
+	}
+	for ( i = 0; i < threads; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+	}
+}
+
+static void TestThreads(const Atomics *atomics, int threads)
+{
+	SDL_Thread *writer, *reader;
+	int i, expected, popped;
+
+	ops = atomics;
+
+	counter.value = 0;
+	RunThreads(Adder, threads);
+	CHECK(ops->Get(&counter) == threads * iterations);
+
+	casses.value = 0;
+	RunThreads(Casser, threads);
+	CHECK(ops->Get(&casses) == threads * iterations);
+
+	lock = 0;
+	locked_counter = inside = overlaps = 0;
+	RunThreads(Locker, threads);
+	CHECK(locked_counter == threads * iterations);
+	CHECK(overlaps == 0);
+	CHECK(lock == 0);
+
+	swapped.value = 0;
+	sum_in.value = sum_out.value = 0;
+	RunThreads(Swapper, threads);
+	expected = 0;
+	for ( i = 0; i < threads * iterations; ++i ) {
+		expected += SwapValue(i / iterations, i % iterations);
+	}
+	CHECK(ops->Get(&sum_in) == expected);
+	CHECK(ops->Get(&sum_out) + ops->Get(&swapped) == expected);
+
+	/* Every node comes off the stack once */
+	nodes = (Node *)SDL_calloc(threads * iterations, sizeof(*nodes));
+	top = NULL;
+	RunThreads(Pusher, threads);
+	RunThreads(Popper, threads);
+	popped = 0;
+	for ( i = 0; i < threads * iterations; ++i ) {
+		popped += (nodes[i].popped == 1);
+	}
+	CHECK(popped == threads * iterations);
+	CHECK(ops->SetPtr(&top, nodes) == NULL);
+	CHECK(ops->GetPtr(&top) == nodes);
+	SDL_free(nodes);
+
+	posted = torn = 0;
+	writer = SDL_CreateThread(Writer, NULL);
+	reader = SDL_CreateThread(Reader, NULL);
+	SDL_WaitThread(writer, NULL);
+	SDL_WaitThread(reader, NULL);
+	CHECK(torn == 0);
+
+	printf("%s, %d threads: counters %d %d %d, torn messages %d\n",
+	       ops->name, threads, counter.value, casses.value,
+	       locked_counter, torn);
+}
+
+/* The same counter behind an SDL_mutex */
+static SDL_mutex *mutex;
+
+static int SDLCALL MutexAdder(void *data)
+{
+	int i;
+
+	for ( i = 0; i < iterations; ++i ) {
+		SDL_mutexP(mutex);
+		locked_counter = locked_counter + 1;
+		SDL_mutexV(mutex);
+	}
+	return(0);
+}
+
+/* Returns the nanoseconds each increment took */
+static double Time(int (SDLCALL *fn)(void *), int threads)
+{
+	Uint64 start = SDL_GetTicksUS();
+
+	RunThreads(fn, threads);
+	return (double)(SDL_GetTicksUS() - start) * 1000.0 / (threads * iterations);
+}
+
+static void Benchmark(void)
+{
+	int threads;
+
+	ops = &builtin;
+	mutex = SDL_CreateMutex();
+	printf("Nanoseconds per increment of one shared counter:\n");
+	printf("threads  SDL_AtomicAdd  CAS loop  spinlock  SDL_mutex  mutex atomics\n");
+	for ( threads = 1; threads <= MAXTHREADS; ++threads ) {
+		double add, cas, spin, locked, fallback;
+
+		ops = &builtin;
+		counter.value = casses.value = 0;
+		lock = locked_counter = 0;
+		add = Time(Adder, threads);
+		cas = Time(Casser, threads);
+		spin = Time(Locker, threads);
+		locked_counter = 0;
+		locked = Time(MutexAdder, threads);
+		ops = &mutexed;
+		counter.value = 0;
+		fallback = Time(Adder, threads);
+		printf("%7d  %13.1f  %8.1f  %8.1f  %9.1f  %13.1f\n",
+		       threads, add, cas, spin, locked, fallback);
+	}
+	SDL_DestroyMutex(mutex);
+}
+
+int main(int argc, char *argv[])
+{
+	int threads;
+
+	iterations = 100000;
+	if ( argc > 1 ) {
+		iterations = atoi(argv[1]);
+		if ( iterations <= 0 ) {
+			fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	Mutex_AtomicInit();
+
+	TestSingle(&builtin);
+	TestSingle(&mutexed);
+	for ( threads = 2; threads <= MAXTHREADS; threads *= 2 ) {
+		TestThreads(&builtin, threads);
+		TestThreads(&mutexed, threads);
+	}
+	Benchmark();
+	SDL_Quit();
+
+	return(CheckResult());
+}
@@ -0,0 +1,231 @@
+/* Checks that the fused audio conversions give the same bytes as the
+   filter chain for every pair of sample formats, then times both:
+   testaudiocvt [loops]
+
+   SDL_AUDIO_FUSED=0 turns the fused conversions off, so both are built
+   with SDL_BuildAudioCVT() and run with SDL_ConvertAudio().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#define FRAMES		4096
+
+static const struct {
+	Uint16 format;
+	const char *name;
+} formats[] = {
+	{ AUDIO_U8, "U8" },
+	{ AUDIO_S8, "S8" },
+	{ AUDIO_U16LSB, "U16LSB" },
+	{ AUDIO_S16LSB, "S16LSB" },
+	{ AUDIO_U16MSB, "U16MSB" },
+	{ AUDIO_S16MSB, "S16MSB" },
+};
+#define NUM_FORMATS	SDL_arraysize(formats)
+
+static const struct {
+	Uint8 src, dst;
+} channels[] = {
+	{ 1, 1 }, { 2, 2 }, { 1, 2 }, { 2, 1 }, { 4, 4 }, { 6, 6 }, { 6, 2 }
+};
+
+static const struct {
+	int src, dst;
+} rates[] = {
+	{ 22050, 22050 }, { 22050, 44100 }, { 11025, 44100 },
+	{ 44100, 22050 }, { 44100, 11025 }
+};
+
+typedef struct {
+	Uint16 src_format, dst_format;
+	Uint8 src_channels, dst_channels;
+	int src_rate, dst_rate;
+} Conversion;
+
+static int Build(SDL_AudioCVT *cvt, const Conversion *conv, int fused, int len)
+{
+	/* Literals, putenv() keeps the string */
+	SDL_putenv(fused ? "SDL_AUDIO_FUSED=1" : "SDL_AUDIO_FUSED=0");
+	if ( SDL_BuildAudioCVT(cvt, conv->src_format, conv->src_channels,
+	                       conv->src_rate, conv->dst_format,
+	                       conv->dst_channels, conv->dst_rate) < 0 ) {
+		return(-1);
+	}
+	cvt->len = len;
+	cvt->buf = (Uint8 *)malloc(len * cvt->len_mult);
+	if ( !cvt->buf ) {
+		return(-1);
+	}
+	return(0);
+}
+
+static int CountFilters(SDL_AudioCVT *cvt)
+{
+	int count = 0;
+
+	while ( cvt->needed && cvt->filters[count] ) {
+		++count;
+	}
+	return(count);
+}
+
+/* Returns 1 if the conversion was fused */
+static int TestSame(const Conversion *conv, const Uint8 *data, int len)
+{
+	SDL_AudioCVT chain, fused;
+	int was_fused = 0;
+
+	if ( Build(&chain, conv, 0, len) < 0 || Build(&fused, conv, 1, len) < 0 ) {
+		printf("Couldn't build conversion: %s\n", SDL_GetError());
+		++failures;
+		return(0);
+	}
+	memcpy(chain.buf, data, len);
+	memcpy(fused.buf, data, len);
+	CHECK(SDL_ConvertAudio(&chain) == 0);
+	CHECK(SDL_ConvertAudio(&fused) == 0);
+	if ( fused.len_cvt != chain.len_cvt ||
+	     memcmp(fused.buf, chain.buf, chain.len_cvt) != 0 ) {
+		printf("%04x %d Hz %u channels -> %04x %d Hz %u channels, "
+		       "%d bytes: %d fused bytes differ from %d\n",
+		       conv->src_format, conv->src_rate, conv->src_channels,
+		       conv->dst_format, conv->dst_rate, conv->dst_channels,
+		       len, fused.len_cvt, chain.len_cvt);
+		CHECK(!"same");
+	}
+	was_fused = (CountFilters(&fused) == CountFilters(&chain) + 1);
+	free(chain.buf);
+	free(fused.buf);
+	return(was_fused);
+}
+
+/* Every combination, for a whole number of frames and for lengths that
+   the fused filters leave to the chain
+ */
+static void TestAll(void)
+{
+	Uint8 data[FRAMES * 6 * 2 + 1];
+	Conversion conv;
+	int i, s, d, c, r, len, tests = 0, fused = 0;
+	static const int frames[] = { FRAMES, 333 };
+
+	srand(1);
+	for ( i = 0; i < (int)sizeof(data); ++i ) {
+		data[i] = (Uint8)rand();
+	}
+	for ( s = 0; s < NUM_FORMATS; ++s )
+	for ( d = 0; d < NUM_FORMATS; ++d )
+	for ( c = 0; c < SDL_arraysize(channels); ++c )
+	for ( r = 0; r < SDL_arraysize(rates); ++r ) {
+		conv.src_format = formats[s].format;
+		conv.dst_format = formats[d].format;
+		conv.src_channels = channels[c].src;
+		conv.dst_channels = channels[c].dst;
+		conv.src_rate = rates[r].src;
+		conv.dst_rate = rates[r].dst;
+		for ( i = 0; i < SDL_arraysize(frames); ++i ) {
+			len = frames[i] * conv.src_channels *
+			      (conv.src_format & 0xFF) / 8;
+			fused += TestSame(&conv, data, len);
+			TestSame(&conv, data, len + 1);
+			tests += 2;
+		}
+	}
+	printf("%d conversions checked, %d of them fused\n", tests, fused);
+	CHECK(fused > 0);
+}
+
+/* Returns the microseconds a conversion of FRAMES frames took on average,
+   or 0 if there's nothing to convert.
+   The buffer is converted again in place each time, the contents don't
+   change the time it takes.
+ */
+static double Time(const Conversion *conv, int fused, int loops)
+{
+	SDL_AudioCVT cvt;
+	Uint64 start;
+	int i;
+
+	if ( Build(&cvt, conv, fused,
+	           FRAMES * conv->src_channels * (conv->src_format & 0xFF) / 8) < 0 ) {
+		++failures;
+		return(0.0);
+	}
+	if ( !cvt.needed ) {
+		free(cvt.buf);
+		return(0.0);
+	}
+	memset(cvt.buf, 0, cvt.len * cvt.len_mult);
+	SDL_ConvertAudio(&cvt);
+	start = SDL_GetTicksUS();
+	for ( i = 0; i < loops; ++i ) {
+		SDL_ConvertAudio(&cvt);
+	}
+	start = SDL_GetTicksUS() - start;
+	free(cvt.buf);
+	return((double)start / loops);
+}
+
+static void TimeAll(int loops)
+{
+	static const Conversion shapes[] = {
+		{ 0, 0, 2, 2, 44100, 44100 },
+		{ 0, 0, 1, 2, 44100, 44100 },
+		{ 0, 0, 1, 2, 22050, 44100 },
+		{ 0, 0, 2, 1, 44100, 22050 },
+	};
+	Conversion conv;
+	double chain, fused;
+	int s, d, i;
+
+	printf("%d frames, %d loops, microseconds per conversion "
+	       "(chain/fused, speedup):\n", FRAMES, loops);
+	printf("%-18s %22s %22s %22s %22s\n", "", "stereo",
+	       "mono -> stereo", "mono 22k -> stereo 44k",
+	       "stereo 44k -> mono 22k");
+	for ( s = 0; s < NUM_FORMATS; ++s )
+	for ( d = 0; d < NUM_FORMATS; ++d ) {
+		printf("%6s -> %-8s", formats[s].name, formats[d].name);
+		for ( i = 0; i < SDL_arraysize(shapes); ++i ) {
+			conv = shapes[i];
+			conv.src_format = formats[s].format;
+			conv.dst_format = formats[d].format;
+			chain = Time(&conv, 0, loops);
+			fused = Time(&conv, 1, loops);
+			if ( chain > 0.0 ) {
+				printf(" %6.1f/%6.1f (%.2fx)", chain, fused, chain / fused);
+			} else {
+				printf(" %22s", "-");
+			}
+		}
+		printf("\n");
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int loops = 1000;
+
+	if ( argc > 1 ) {
+		loops = atoi(argv[1]);
+		if ( loops <= 0 ) {
+			fprintf(stderr, "Usage: %s [loops]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestAll();
+	TimeAll(loops);
+	SDL_Quit();
+
+	return(CheckResult());
+}
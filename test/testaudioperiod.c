@@ -0,0 +1,232 @@
+/* Checks the audio thread's output with and without conversion through
+   the disk audio driver, then times each buffer through the dummy driver:
+   testaudioperiod [periods]
+
+   The timing covers the callback, the silence fill and the conversion,
+   as counted by SDL_GetAudioPeriodStats().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#define RATE		48000
+#define SAMPLES		1024
+#define OUTFILE		"testaudioperiod.raw"
+#define FILLS		1	/* the callback writes the whole buffer */
+
+static Uint32 position;
+static volatile Uint32 calls;
+
+/* Never silence, so a missing sample shows */
+static Sint16 Pattern(Uint32 i)
+{
+	return((Sint16)(i % 30000 + 1));
+}
+
+/* Writes the pattern to the left channel and 2 more to the right one, so
+   mixing them to mono gives the pattern plus 1
+ */
+static void SDLCALL FillStereo(void *userdata, Uint8 *stream, int len)
+{
+	Sint16 *out = (Sint16 *)stream;
+	int i;
+
+	for ( i = 0; i < len / 4; ++i ) {
+		out[0] = Pattern(position);
+		out[1] = Pattern(position) + 2;
+		out += 2;
+		++position;
+	}
+	++calls;
+}
+
+static void SDLCALL FillMono(void *userdata, Uint8 *stream, int len)
+{
+	Sint16 *out = (Sint16 *)stream;
+	int i;
+
+	for ( i = 0; i < len / 2; ++i ) {
+		out[i] = Pattern(position++);
+	}
+	++calls;
+}
+
+/* Only writes the first half, the rest must be silence */
+static void SDLCALL FillHalf(void *userdata, Uint8 *stream, int len)
+{
+	FillMono(userdata, stream, len / 2);
+}
+
+static int Open(const char *driver, int channels, int device_channels,
+                int fills, void (SDLCALL *callback)(void *, Uint8 *, int))
+{
+	/* putenv() keeps the strings */
+	static char driver_env[64], dummy_env[64], disk_env[64];
+	SDL_AudioSpec spec;
+
+	SDL_snprintf(driver_env, sizeof(driver_env), "SDL_AUDIODRIVER=%s", driver);
+	SDL_putenv(driver_env);
+	SDL_snprintf(dummy_env, sizeof(dummy_env),
+	             "SDL_DUMMYAUDIOCHANNELS=%d", device_channels);
+	SDL_putenv(dummy_env);
+	SDL_snprintf(disk_env, sizeof(disk_env),
+	             "SDL_DISKAUDIOCHANNELS=%d", device_channels);
+	SDL_putenv(disk_env);
+
+	SDL_memset(&spec, 0, sizeof(spec));
+	spec.freq = RATE;
+	spec.format = AUDIO_S16SYS;
+	spec.channels = channels;
+	spec.samples = SAMPLES;
+	/* Old programs leave garbage here, SDL must not care */
+	spec.padding = 0xFFFF;
+	SDL_SetAudioCallbackFillsBuffer(fills);
+	spec.callback = callback;
+	position = 0;
+	calls = 0;
+	if ( SDL_OpenAudio(&spec, NULL) < 0 ) {
+		printf("Couldn't open %s audio: %s\n", driver, SDL_GetError());
+		++failures;
+		return(-1);
+	}
+	return(0);
+}
+
+/* Plays until the callback has been called the given number of times */
+static void Play(Uint32 periods)
+{
+	SDL_PauseAudio(0);
+	while ( calls < periods ) {
+		SDL_Delay(1);
+	}
+}
+
+/* Checks the file from the last test holds the pattern plus 'offset' in
+   the first 'played' frames of each buffer and silence in the rest.  The
+   buffers made while paused are all silence and skipped.
+ */
+static void CheckOutput(const char *name, int channels, int offset,
+                        int played)
+{
+	Sint16 buffer[SAMPLES * 2];
+	Uint32 i = 0, buffers = 0, wrong = 0;
+	Sint16 expected;
+	int frame, silent;
+	FILE *fp;
+
+	fp = fopen(OUTFILE, "rb");
+	CHECK(fp != NULL);
+	if ( !fp ) {
+		return;
+	}
+	while ( fread(buffer, sizeof(Sint16) * channels, SAMPLES, fp) == SAMPLES ) {
+		silent = 1;
+		for ( frame = 0; frame < SAMPLES * channels; ++frame ) {
+			silent &= (buffer[frame] == 0);
+		}
+		if ( silent ) {
+			continue;
+		}
+		for ( frame = 0; frame < SAMPLES; ++frame ) {
+			expected = 0;
+			if ( frame < played ) {
+				expected = Pattern(i++) + offset;
+			}
+			if ( buffer[frame * channels] != expected ||
+			     buffer[frame * channels + channels - 1] != expected ) {
+				++wrong;
+			}
+		}
+		++buffers;
+	}
+	fclose(fp);
+	remove(OUTFILE);
+	if ( wrong || buffers < 4 ) {
+		printf("%s: %u frames wrong in %u buffers\n", name, wrong, buffers);
+		CHECK(!"output");
+	}
+}
+
+static void TestOutput(const char *name, int channels, int device_channels,
+                       int fills, void (SDLCALL *callback)(void *, Uint8 *, int),
+                       int offset, int played)
+{
+	if ( Open("disk", channels, device_channels, fills, callback) < 0 ) {
+		return;
+	}
+	Play(4);
+	SDL_CloseAudio();
+	CheckOutput(name, device_channels, offset, played);
+}
+
+static void TestOutputs(void)
+{
+	SDL_putenv("SDL_DISKAUDIOFILE=" OUTFILE);
+	SDL_putenv("SDL_DISKAUDIODELAY=0");
+
+	/* Mono to stereo fits in the device buffer, stereo to mono doesn't */
+	TestOutput("mono", 1, 1, FILLS, FillMono, 0, SAMPLES);
+	TestOutput("mono to stereo", 1, 2, 0, FillMono, 0, SAMPLES);
+	TestOutput("mono to stereo, fills", 1, 2, FILLS,
+	           FillMono, 0, SAMPLES);
+	TestOutput("stereo to mono", 2, 1, FILLS,
+	           FillStereo, 1, SAMPLES);
+	TestOutput("half", 1, 1, 0, FillHalf, 0, SAMPLES / 2);
+	TestOutput("half to stereo", 1, 2, 0, FillHalf, 0, SAMPLES / 2);
+}
+
+static void Time(const char *name, int channels, int device_channels,
+                 int fills, void (SDLCALL *callback)(void *, Uint8 *, int),
+                 Uint32 periods)
+{
+	Uint64 total, worst;
+	double us = 1000000.0 / SDL_GetPerformanceFrequency();
+
+	if ( Open("dummy", channels, device_channels, fills, callback) < 0 ) {
+		return;
+	}
+	Play(8);
+	SDL_ResetAudioPeriodStats();
+	Play(8 + periods);
+	SDL_GetAudioPeriodStats(&periods, &total, &worst);
+	SDL_CloseAudio();
+	printf("%-24s %8.2f %8.2f\n", name,
+	       (double)total / periods * us, (double)worst * us);
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 periods = 1000;
+
+	if ( argc > 1 ) {
+		periods = (Uint32)atoi(argv[1]);
+		if ( atoi(argv[1]) <= 0 ) {
+			fprintf(stderr, "Usage: %s [periods]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestOutputs();
+
+	SDL_putenv("SDL_DUMMYAUDIODELAY=0");
+	printf("%d frames at %d Hz, %u buffers, microseconds per buffer:\n",
+	       SAMPLES, RATE, periods);
+	printf("%-24s %8s %8s\n", "", "average", "worst");
+	Time("stereo", 2, 2, 0, FillStereo, periods);
+	Time("stereo, fills", 2, 2, FILLS, FillStereo, periods);
+	Time("mono to stereo", 1, 2, 0, FillMono, periods);
+	Time("mono to stereo, fills", 1, 2, FILLS,
+	     FillMono, periods);
+	Time("stereo to mono, fills", 2, 1, FILLS,
+	     FillStereo, periods);
+	SDL_Quit();
+
+	return(CheckResult());
+}
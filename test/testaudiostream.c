@@ -0,0 +1,248 @@
+/* Checks audio streams against converting all of the audio at once:
+   testaudiostream [frames]
+
+   The source goes into the stream in pieces of random size, which split
+   frames, and comes out in pieces of random size in between.  After
+   SDL_AudioStreamFlush() the output must be the bytes SDL_ConvertAudio()
+   makes of the whole source, also when the rate goes through the
+   resampler or the SDL_RateDIV2 filters.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+typedef struct {
+	const char *name;
+	Uint16 src_format;
+	Uint8 src_channels;
+	int src_rate;
+	Uint16 dst_format;
+	Uint8 dst_channels;
+	int dst_rate;
+} Conversion;
+
+static const Conversion conversions[] = {
+	{ "same", AUDIO_S16LSB, 2, 44100, AUDIO_S16LSB, 2, 44100 },
+	{ "format", AUDIO_U16LSB, 2, 22050, AUDIO_S8, 2, 22050 },
+	{ "mono to 5.1", AUDIO_U8, 1, 44100, AUDIO_S16MSB, 6, 44100 },
+	{ "4 to stereo", AUDIO_U8, 4, 22050, AUDIO_S16LSB, 2, 22050 },
+	{ "rate * 2", AUDIO_U8, 1, 22050, AUDIO_S16MSB, 2, 44100 },
+	{ "rate / 4", AUDIO_S16MSB, 2, 44100, AUDIO_U8, 1, 11025 },
+	{ "44100 to 48000", AUDIO_S16LSB, 2, 44100, AUDIO_S16LSB, 2, 48000 },
+	{ "8000 to 48000", AUDIO_S8, 1, 8000, AUDIO_U16MSB, 1, 48000 },
+	{ "48000 to 8000", AUDIO_S16SYS, 2, 48000, AUDIO_S16SYS, 1, 8000 },
+	{ "5.1 to 44100", AUDIO_S16LSB, 6, 48000, AUDIO_U8, 2, 44100 },
+};
+
+/* Converts all of the source at once into a new buffer */
+static Uint8 *ConvertAll(const Conversion *conv, const Uint8 *src, int len,
+                         int *out_len)
+{
+	SDL_AudioCVT cvt;
+	Uint8 *out;
+
+	if ( SDL_BuildAudioCVT(&cvt, conv->src_format, conv->src_channels,
+	                       conv->src_rate, conv->dst_format,
+	                       conv->dst_channels, conv->dst_rate) < 0 ) {
+		printf("%s: Couldn't build conversion: %s\n", conv->name,
+		       SDL_GetError());
+		++failures;
+		return(NULL);
+	}
+	out = (Uint8 *)malloc(len * cvt.len_mult);
+	if ( !out ) {
+		printf("Out of memory\n");
+		++failures;
+		return(NULL);
+	}
+	memcpy(out, src, len);
+	cvt.buf = out;
+	cvt.len = len;
+	CHECK(SDL_ConvertAudio(&cvt) == 0);
+	*out_len = cvt.len_cvt;
+	return(out);
+}
+
+/* Takes up to 'len' bytes out, checking the stream gives what it has */
+static int Take(SDL_AudioStream *stream, Uint8 *out, int len)
+{
+	int available = SDL_AudioStreamAvailable(stream);
+	int taken = SDL_AudioStreamGet(stream, out, len);
+
+	CHECK(taken == (len < available ? len : available));
+	CHECK(SDL_AudioStreamAvailable(stream) == available - taken);
+	return(taken);
+}
+
+/* Streams the source in pieces of up to 'piece' bytes and flushes, the
+   output has to match 'expected'
+ */
+static void Stream(SDL_AudioStream *stream, const char *name,
+                   const Uint8 *src, int len, int piece,
+                   const Uint8 *expected, int expected_len)
+{
+	Uint8 *out;
+	int in_pos = 0, out_pos = 0, amount;
+
+	out = (Uint8 *)malloc(expected_len + 1);
+	if ( !out ) {
+		printf("Out of memory\n");
+		++failures;
+		return;
+	}
+	while ( in_pos < len ) {
+		amount = rand() % (piece + 1);
+		if ( amount > len - in_pos ) {
+			amount = len - in_pos;
+		}
+		CHECK(SDL_AudioStreamPut(stream, src + in_pos, amount) == 0);
+		in_pos += amount;
+		if ( rand() % 2 ) {
+			amount = rand() % (piece + 1);
+			if ( amount > expected_len - out_pos ) {
+				amount = expected_len - out_pos;
+			}
+			out_pos += Take(stream, out + out_pos, amount);
+		}
+	}
+	CHECK(SDL_AudioStreamFlush(stream) == 0);
+	out_pos += Take(stream, out + out_pos, expected_len - out_pos);
+	CHECK(SDL_AudioStreamAvailable(stream) == 0);
+	CHECK(SDL_AudioStreamGet(stream, out + out_pos, 1) == 0);
+	if ( out_pos != expected_len || memcmp(out, expected, out_pos) != 0 ) {
+		printf("%s, pieces of up to %d bytes: %d bytes, expected %d\n",
+		       name, piece, out_pos, expected_len);
+		CHECK(!"same");
+	}
+	free(out);
+}
+
+static void TestConversion(const Conversion *conv, int frames)
+{
+	static const int pieces[] = { 1, 7, 100, 3000, 100000 };
+	const int frame_size = conv->src_channels * (conv->src_format & 0xFF) / 8;
+	const int len = frames * frame_size;
+	SDL_AudioStream *stream;
+	Uint8 *src, *expected;
+	int expected_len, i;
+
+	src = (Uint8 *)malloc(len);
+	if ( !src ) {
+		printf("Out of memory\n");
+		++failures;
+		return;
+	}
+	for ( i = 0; i < len; ++i ) {
+		src[i] = (Uint8)rand();
+	}
+	expected = ConvertAll(conv, src, len, &expected_len);
+	if ( !expected ) {
+		free(src);
+		return;
+	}
+
+	stream = SDL_NewAudioStream(conv->src_format, conv->src_channels,
+	                            conv->src_rate, conv->dst_format,
+	                            conv->dst_channels, conv->dst_rate);
+	CHECK(stream != NULL);
+	if ( stream ) {
+		/* The flush starts the stream over for the next round */
+		for ( i = 0; i < SDL_arraysize(pieces); ++i ) {
+			Stream(stream, conv->name, src, len, pieces[i],
+			       expected, expected_len);
+		}
+
+		/* Nothing from before clearing may come out */
+		CHECK(SDL_AudioStreamPut(stream, src + 1, len / 2) == 0);
+		SDL_AudioStreamClear(stream);
+		CHECK(SDL_AudioStreamAvailable(stream) == 0);
+		Stream(stream, conv->name, src, len, 500, expected, expected_len);
+		SDL_FreeAudioStream(stream);
+	}
+	free(expected);
+	free(src);
+}
+
+static void TestErrors(void)
+{
+	CHECK(SDL_NewAudioStream(AUDIO_S16SYS, 3, 44100, AUDIO_S16SYS, 2, 44100) == NULL);
+	CHECK(SDL_NewAudioStream(AUDIO_S16SYS, 2, 0, AUDIO_S16SYS, 2, 44100) == NULL);
+	CHECK(SDL_NewAudioStream(AUDIO_S16SYS, 2, 44100, 0x1234, 2, 44100) == NULL);
+	SDL_FreeAudioStream(NULL);
+}
+
+/* Times streaming music in 4 KB pieces against one conversion */
+static void TimeStream(int frames)
+{
+	const int len = frames * 4;
+	Conversion conv = conversions[6];
+	SDL_AudioStream *stream;
+	Uint8 *src, *out;
+	Uint64 start, streamed, all;
+	int i, out_len;
+
+	src = (Uint8 *)malloc(len);
+	out = (Uint8 *)malloc(4096);
+	stream = SDL_NewAudioStream(conv.src_format, conv.src_channels,
+	                            conv.src_rate, conv.dst_format,
+	                            conv.dst_channels, conv.dst_rate);
+	if ( !src || !out || !stream ) {
+		printf("Couldn't set up timing\n");
+		++failures;
+		return;
+	}
+	memset(src, 0, len);
+	start = SDL_GetTicksUS();
+	for ( i = 0; i < len; i += 4096 ) {
+		SDL_AudioStreamPut(stream, src + i, (len - i < 4096) ? len - i : 4096);
+		while ( SDL_AudioStreamGet(stream, out, 4096) > 0 ) {
+		}
+	}
+	SDL_AudioStreamFlush(stream);
+	while ( SDL_AudioStreamGet(stream, out, 4096) > 0 ) {
+	}
+	streamed = SDL_GetTicksUS() - start;
+
+	start = SDL_GetTicksUS();
+	free(ConvertAll(&conv, src, len, &out_len));
+	all = SDL_GetTicksUS() - start;
+	printf("%s, %d frames: streamed in %.1f ms, converted at once in %.1f ms\n",
+	       conv.name, frames, streamed / 1000.0, all / 1000.0);
+
+	SDL_FreeAudioStream(stream);
+	free(out);
+	free(src);
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = 10007;
+	int i;
+
+	if ( argc > 1 ) {
+		frames = atoi(argv[1]);
+		if ( frames <= 0 ) {
+			fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	srand(1);
+	TestErrors();
+	for ( i = 0; i < SDL_arraysize(conversions); ++i ) {
+		TestConversion(&conversions[i], frames);
+	}
+	printf("%d conversions streamed\n", (int)SDL_arraysize(conversions));
+	TimeStream(frames * 100);
+	SDL_Quit();
+
+	return(CheckResult());
+}
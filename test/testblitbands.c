@@ -0,0 +1,304 @@
+/* Checks that blits, fills and stretches split into bands on the blit
+   threads come out the same as on one thread, then times them on a
+   960x544 screen for 1 to 4 threads: testblitbands [loops]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#define WIDTH		960
+#define HEIGHT		544
+#define MAXTHREADS	4
+
+static SDL_Surface *CreateSurface(int w, int h, int bpp, int alpha)
+{
+	SDL_Surface *surface;
+
+	switch (bpp) {
+	    case 16:
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 16,
+		                               0xF800, 0x07E0, 0x001F, 0);
+		break;
+	    case 24:
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 24,
+		                               0xFF0000, 0x00FF00, 0x0000FF, 0);
+		break;
+	    default:
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32,
+		                               0x00FF0000, 0x0000FF00, 0x000000FF,
+		                               alpha ? 0xFF000000 : 0);
+		break;
+	}
+	return(surface);
+}
+
+static void Randomize(SDL_Surface *surface)
+{
+	Uint8 *row = (Uint8 *)surface->pixels;
+	int x, y;
+
+	for ( y = 0; y < surface->h; ++y ) {
+		for ( x = 0; x < surface->pitch; ++x ) {
+			row[x] = (Uint8)rand();
+		}
+		row += surface->pitch;
+	}
+}
+
+static int Same(SDL_Surface *a, SDL_Surface *b)
+{
+	int y;
+
+	for ( y = 0; y < a->h; ++y ) {
+		if ( memcmp((Uint8 *)a->pixels + y*a->pitch,
+		            (Uint8 *)b->pixels + y*b->pitch,
+		            a->w * a->format->BytesPerPixel) != 0 ) {
+			return(0);
+		}
+	}
+	return(1);
+}
+
+typedef enum {
+	CONVERT,	/* 32 bpp to 16 bpp, as SDL_ConvertSurface() does */
+	ALPHA,		/* 32 bpp with per pixel alpha onto 32 bpp */
+	COLORKEY,	/* 16 bpp with a color key onto 16 bpp */
+	FILL,		/* SDL_FillRect() on 32 bpp */
+	STRETCH,	/* SDL_SoftStretch() of a quarter screen to full */
+	NUM_OPS
+} Operation;
+
+static const char *names[NUM_OPS] = {
+	"32->16 blit", "alpha blit", "colorkey blit", "fill", "2x stretch"
+};
+
+typedef struct {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+} Test;
+
+static void SetupTest(Test *test, Operation op)
+{
+	switch (op) {
+	    case CONVERT:
+		test->src = CreateSurface(WIDTH, HEIGHT, 32, 0);
+		test->dst = CreateSurface(WIDTH, HEIGHT, 16, 0);
+		break;
+	    case ALPHA:
+		test->src = CreateSurface(WIDTH, HEIGHT, 32, 1);
+		test->dst = CreateSurface(WIDTH, HEIGHT, 32, 0);
+		break;
+	    case COLORKEY:
+		test->src = CreateSurface(WIDTH, HEIGHT, 16, 0);
+		test->dst = CreateSurface(WIDTH, HEIGHT, 16, 0);
+		break;
+	    case STRETCH:
+		test->src = CreateSurface(WIDTH/2, HEIGHT/2, 32, 0);
+		test->dst = CreateSurface(WIDTH, HEIGHT, 32, 0);
+		break;
+	    default:
+		test->src = NULL;
+		test->dst = CreateSurface(WIDTH, HEIGHT, 32, 0);
+		break;
+	}
+	if ( test->src ) {
+		Randomize(test->src);
+	}
+	Randomize(test->dst);
+	if ( op == COLORKEY ) {
+		SDL_SetColorKey(test->src, SDL_SRCCOLORKEY, *(Uint16 *)test->src->pixels);
+	}
+}
+
+static void FreeTest(Test *test)
+{
+	SDL_FreeSurface(test->src);
+	SDL_FreeSurface(test->dst);
+}
+
+static void RunTest(Test *test, Operation op, int i)
+{
+	SDL_Rect rect;
+
+	switch (op) {
+	    case FILL:
+		/* Odd sizes, so the bands don't all start aligned */
+		rect.x = i % 7;
+		rect.y = i % 5;
+		rect.w = WIDTH - rect.x - i % 3;
+		rect.h = HEIGHT - rect.y - i % 11;
+		SDL_FillRect(test->dst, &rect, 0x10101 * (i & 0xFF));
+		break;
+	    case STRETCH:
+		SDL_SoftStretch(test->src, NULL, test->dst, NULL);
+		break;
+	    default:
+		rect.x = i % 3;
+		rect.y = i % 5;
+		SDL_BlitSurface(test->src, NULL, test->dst, &rect);
+		break;
+	}
+}
+
+static void TestSame(Operation op)
+{
+	Test one, many;
+	int i;
+
+	srand(op);
+	SetupTest(&one, op);
+	srand(op);
+	SetupTest(&many, op);
+
+	for ( i = 0; i < 4; ++i ) {
+		CHECK(SDL_SetBlitThreads(1) == 0);
+		RunTest(&one, op, i);
+		CHECK(SDL_SetBlitThreads(3) == 0);
+		RunTest(&many, op, i);
+		if ( !Same(one.dst, many.dst) ) {
+			printf("%s differs on 3 threads\n", names[op]);
+			CHECK(!"same");
+			break;
+		}
+	}
+	FreeTest(&one);
+	FreeTest(&many);
+}
+
+static int SDLCALL FillThread(void *data)
+{
+	SDL_Surface *surface = (SDL_Surface *)data;
+	Uint32 color;
+
+	for ( color = 1; color <= 20; ++color ) {
+		SDL_FillRect(surface, NULL, color);
+	}
+	return(0);
+}
+
+/* The first fills of the program on several threads at once, which all
+   find the blit threads not set up yet
+ */
+static void TestFirstBlits(void)
+{
+	SDL_Surface *screens[MAXTHREADS];
+	SDL_Thread *threads[MAXTHREADS];
+	int i, x, y, filled = 1;
+
+	SDL_putenv("SDL_BLIT_THREADS=3");
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		screens[i] = CreateSurface(WIDTH, HEIGHT, 32, 0);
+	}
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		threads[i] = SDL_CreateThread(FillThread, screens[i]);
+	}
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		SDL_WaitThread(threads[i], NULL);
+		for ( y = 0; y < HEIGHT; ++y ) {
+			const Uint32 *row = (const Uint32 *)
+				((Uint8 *)screens[i]->pixels + y*screens[i]->pitch);
+
+			for ( x = 0; x < WIDTH; ++x ) {
+				filled &= (row[x] == 20);
+			}
+		}
+		SDL_FreeSurface(screens[i]);
+	}
+	CHECK(filled);
+}
+
+/* Scrolling a surface onto itself has to stay on one thread */
+static void TestOverlap(void)
+{
+	SDL_Surface *screen = CreateSurface(WIDTH, HEIGHT, 32, 0);
+	SDL_Surface *copy = CreateSurface(WIDTH, HEIGHT, 32, 0);
+	SDL_Rect from, to;
+	int y, scrolled = 1;
+
+	Randomize(screen);
+	SDL_BlitSurface(screen, NULL, copy, NULL);
+	from.x = 0;
+	from.y = 0;
+	from.w = WIDTH;
+	from.h = HEIGHT - 1;
+	to.x = 0;
+	to.y = 1;
+	CHECK(SDL_SetBlitThreads(4) == 0);
+	SDL_BlitSurface(screen, &from, screen, &to);
+	for ( y = 1; y < HEIGHT; ++y ) {
+		scrolled &= (memcmp((Uint8 *)screen->pixels + y*screen->pitch,
+		                    (Uint8 *)copy->pixels + (y-1)*copy->pitch,
+		                    WIDTH*4) == 0);
+	}
+	CHECK(scrolled);
+	SDL_FreeSurface(screen);
+	SDL_FreeSurface(copy);
+}
+
+/* Returns the microseconds each operation took on average */
+static double Time(Operation op, int threads, int loops)
+{
+	Test test;
+	Uint64 start;
+	int i;
+
+	SetupTest(&test, op);
+	SDL_SetBlitThreads(threads);
+	RunTest(&test, op, 0);
+	start = SDL_GetTicksUS();
+	for ( i = 0; i < loops; ++i ) {
+		RunTest(&test, op, i);
+	}
+	start = SDL_GetTicksUS() - start;
+	FreeTest(&test);
+	return((double)start / loops);
+}
+
+int main(int argc, char *argv[])
+{
+	double us[MAXTHREADS+1];
+	int loops = 100;
+	int op, threads;
+
+	if ( argc > 1 ) {
+		loops = atoi(argv[1]);
+		if ( loops <= 0 ) {
+			fprintf(stderr, "Usage: %s [loops]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestFirstBlits();
+	CHECK(SDL_SetBlitThreads(-1) == -1);
+	for ( op = 0; op < NUM_OPS; ++op ) {
+		TestSame((Operation)op);
+	}
+	TestOverlap();
+
+	printf("%dx%d, %d loops, microseconds per operation (speedup):\n",
+	       WIDTH, HEIGHT, loops);
+	printf("%-14s", "");
+	for ( threads = 1; threads <= MAXTHREADS; ++threads ) {
+		printf("    %d thread%s ", threads, threads > 1 ? "s" : " ");
+	}
+	printf("\n");
+	for ( op = 0; op < NUM_OPS; ++op ) {
+		printf("%-14s", names[op]);
+		for ( threads = 1; threads <= MAXTHREADS; ++threads ) {
+			us[threads] = Time((Operation)op, threads, loops);
+			printf(" %6.0f (%.2fx)", us[threads], us[1] / us[threads]);
+		}
+		printf("\n");
+	}
+	SDL_Quit();
+
+	return(CheckResult());
+}
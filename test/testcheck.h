@@ -0,0 +1,31 @@
+/* The checks shared by the test programs: CHECK() prints and counts the
+   ones that fail, and main() ends with return(CheckResult()), which
+   reports them and gives the exit status. Each program includes this once.
+ */
+
+#ifndef _testcheck_h
+#define _testcheck_h
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(expr) \
+	do { \
+		if ( !(expr) ) { \
+			printf("FAILED line %d: %s\n", __LINE__, #expr); \
+			++failures; \
+		} \
+	} while ( 0 )
+
+static int CheckResult(void)
+{
+	if ( failures ) {
+		printf("%d checks failed\n", failures);
+		return(1);
+	}
+	printf("All tests passed\n");
+	return(0);
+}
+
+#endif /* _testcheck_h */
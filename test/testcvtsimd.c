@@ -0,0 +1,350 @@
+/* Compares the SIMD versions of the audio conversion filters with the C
+   filters and times both: testcvtsimd [loops]
+
+   Built from src/audio/SDL_audiocvt_NEON.c and SDL_audiocvt_SSE2.c, see
+   Makefile.in. The NEON functions use the portable stand-ins of
+   SDL_neon_emu.h on a host without NEON, which checks the arithmetic but
+   not the speed. The SSE2 functions are only tested on x86.
+
+   The C output comes from SDL_ConvertAudio() with SDL_AUDIO_SIMD=0, and
+   SDL_AUDIO_FUSED=0 keeps the filters apart, so each conversion below is
+   one filter.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_audiocvt_NEON.h"
+#include "SDL_audiocvt_SSE2.h"
+
+#define MAX_LEN		1200
+#define FRAMES		4096
+
+typedef Uint32 (*CvtFunc)(Uint8 *buf, Uint32 len, Uint16 format);
+
+static const struct {
+	Uint16 format;
+	const char *name;
+} formats[] = {
+	{ AUDIO_U8, "U8" },
+	{ AUDIO_S8, "S8" },
+	{ AUDIO_U16LSB, "U16LSB" },
+	{ AUDIO_S16LSB, "S16LSB" },
+	{ AUDIO_U16MSB, "U16MSB" },
+	{ AUDIO_S16MSB, "S16MSB" },
+};
+#define NUM_FORMATS	SDL_arraysize(formats)
+
+enum {
+	SIGN, TO_16LSB, TO_16MSB, STEREO, MONO, SURROUND, STRIP, NUM_FILTERS
+};
+
+/* How each filter changes the length and a conversion that is only it */
+static const struct {
+	const char *name;
+	int mul, div;
+	Uint8 src_channels, dst_channels;
+} filters[NUM_FILTERS] = {
+	{ "sign", 1, 1, 1, 1 },
+	{ "to 16LSB", 2, 1, 1, 1 },
+	{ "to 16MSB", 2, 1, 1, 1 },
+	{ "stereo", 2, 1, 1, 2 },
+	{ "mono", 1, 2, 2, 1 },
+	{ "surround", 3, 1, 2, 6 },
+	{ "strip", 1, 3, 6, 2 },
+};
+
+#define ONLY_16BIT	1	/* 8 bit samples are left to the C filter */
+
+typedef struct Kernel {
+	const char *name;
+	int filter;
+	CvtFunc convert;
+	int flags;
+} Kernel;
+
+static const Kernel kernels[] = {
+	{ "NEON", SIGN, SDL_ConvertSign_NEON, 0 },
+	{ "NEON", TO_16LSB, SDL_Convert16LSB_NEON, 0 },
+	{ "NEON", TO_16MSB, SDL_Convert16MSB_NEON, 0 },
+	{ "NEON", STEREO, SDL_ConvertStereo_NEON, 0 },
+	{ "NEON", MONO, SDL_ConvertMono_NEON, 0 },
+	{ "NEON", SURROUND, SDL_ConvertSurround_NEON, 0 },
+	{ "NEON", STRIP, SDL_ConvertStrip_NEON, 0 },
+#if SDL_AUDIOCVT_SSE2
+	{ "SSE2", SIGN, SDL_ConvertSign_SSE2, 0 },
+	{ "SSE2", TO_16LSB, SDL_Convert16LSB_SSE2, 0 },
+	{ "SSE2", TO_16MSB, SDL_Convert16MSB_SSE2, 0 },
+	{ "SSE2", STEREO, SDL_ConvertStereo_SSE2, 0 },
+	{ "SSE2", MONO, SDL_ConvertMono_SSE2, 0 },
+	{ "SSE2", SURROUND, SDL_ConvertSurround_SSE2, ONLY_16BIT },
+	{ "SSE2", STRIP, SDL_ConvertStrip_SSE2, ONLY_16BIT },
+#endif
+};
+
+/* The 8 to 16 bit filters only take 8 bit samples, the others any */
+static int Takes(int filter, Uint16 format)
+{
+	if ( filter == TO_16LSB || filter == TO_16MSB ) {
+		return((format & 0xFF) == 8);
+	}
+	return(1);
+}
+
+static Uint16 DstFormat(int filter, Uint16 format)
+{
+	switch (filter) {
+		case SIGN:
+			return(format ^ 0x8000);
+		case TO_16LSB:
+			return((format & 0x8000) | AUDIO_U16LSB);
+		case TO_16MSB:
+			return((format & 0x8000) | AUDIO_U16MSB);
+	}
+	return(format);
+}
+
+static int Build(SDL_AudioCVT *cvt, int filter, Uint16 format, int simd,
+                 int len)
+{
+	/* Literals, putenv() keeps the string */
+	SDL_putenv("SDL_AUDIO_FUSED=0");
+	SDL_putenv(simd ? "SDL_AUDIO_SIMD=1" : "SDL_AUDIO_SIMD=0");
+	if ( SDL_BuildAudioCVT(cvt, format, filters[filter].src_channels, 44100,
+	                       DstFormat(filter, format),
+	                       filters[filter].dst_channels, 44100) < 0 ) {
+		printf("Couldn't build conversion: %s\n", SDL_GetError());
+		++failures;
+		return(-1);
+	}
+	cvt->len = len;
+	cvt->buf = (Uint8 *)malloc(len * cvt->len_mult + 1);
+	if ( !cvt->buf ) {
+		printf("Out of memory\n");
+		++failures;
+		return(-1);
+	}
+	return(0);
+}
+
+/* Converts 'len' bytes with the C filter into 'out' */
+static int Reference(int filter, Uint16 format, const Uint8 *data, int len,
+                     Uint8 *out)
+{
+	SDL_AudioCVT cvt;
+	int len_cvt;
+
+	if ( Build(&cvt, filter, format, 0, len) < 0 ) {
+		return(-1);
+	}
+	memcpy(cvt.buf, data, len);
+	CHECK(SDL_ConvertAudio(&cvt) == 0);
+	len_cvt = cvt.len_cvt;
+	memcpy(out, cvt.buf, len_cvt);
+	free(cvt.buf);
+	return(len_cvt);
+}
+
+/* Every whole number of frames up to MAX_LEN bytes, checking the part the
+   kernel converted is where the C filter puts it, with the same bytes
+ */
+static void TestKernel(const Kernel *kernel, Uint16 format, const char *name,
+                       const Uint8 *data)
+{
+	static Uint8 buf[MAX_LEN * 3], ref[MAX_LEN * 3];
+	const int filter = kernel->filter;
+	const int mul = filters[filter].mul;
+	const int div = filters[filter].div;
+	int frame, len, wrong = 0, skipped = 0;
+	Uint32 done, start, end;
+
+	frame = filters[filter].src_channels * (format & 0xFF) / 8;
+	for ( len = 0; len <= MAX_LEN; len += frame ) {
+		if ( Reference(filter, format, data, len, ref) != len * mul / div ) {
+			CHECK(!"reference length");
+			return;
+		}
+		memcpy(buf, data, len);
+		done = kernel->convert(buf, len, format);
+		if ( done > (Uint32)len || (done % 16) != 0 ) {
+			printf("%s %s %s, %d bytes: %u done\n",
+			       kernel->name, filters[filter].name, name, len, done);
+			CHECK(!"done");
+			return;
+		}
+		if ( done == 0 && len >= 96 ) {
+			++skipped;
+		}
+		if ( mul > div ) {
+			start = (len - done) * mul / div;
+			end = len * mul / div;
+		} else {
+			start = 0;
+			end = done * mul / div;
+		}
+		if ( memcmp(buf + start, ref + start, end - start) != 0 ) {
+			++wrong;
+		}
+	}
+	if ( wrong ) {
+		printf("%s %s %s: %d lengths differ\n",
+		       kernel->name, filters[filter].name, name, wrong);
+		CHECK(!"same");
+	}
+	if ( (kernel->flags & ONLY_16BIT) && (format & 0xFF) == 8 ) {
+		CHECK(skipped == (MAX_LEN - 96) / frame + 1);
+	} else {
+		CHECK(skipped == 0);
+	}
+}
+
+static void TestKernels(const Uint8 *data)
+{
+	int k, f, tests = 0;
+
+	for ( k = 0; k < SDL_arraysize(kernels); ++k )
+	for ( f = 0; f < NUM_FORMATS; ++f ) {
+		if ( Takes(kernels[k].filter, formats[f].format) ) {
+			TestKernel(&kernels[k], formats[f].format, formats[f].name, data);
+			++tests;
+		}
+	}
+	printf("%d kernels and formats checked\n", tests);
+}
+
+/* Through SDL_ConvertAudio(), where the C filter does what's left */
+static void TestLibrary(const Uint8 *data)
+{
+	static Uint8 ref[MAX_LEN * 3];
+	SDL_AudioCVT cvt;
+	int filter, f, frame, len, ref_len, tests = 0, replaced = 0, pairs = 0;
+	void (SDLCALL *first)(struct SDL_AudioCVT *cvt, Uint16 format);
+
+	for ( filter = 0; filter < NUM_FILTERS; ++filter )
+	for ( f = 0; f < NUM_FORMATS; ++f ) {
+		if ( !Takes(filter, formats[f].format) ) {
+			continue;
+		}
+		frame = filters[filter].src_channels * (formats[f].format & 0xFF) / 8;
+		for ( len = 0; len <= MAX_LEN; len += frame ) {
+			ref_len = Reference(filter, formats[f].format, data, len, ref);
+			if ( ref_len < 0 ) {
+				return;
+			}
+			if ( Build(&cvt, filter, formats[f].format, 1, len) < 0 ) {
+				return;
+			}
+			memcpy(cvt.buf, data, len);
+			CHECK(SDL_ConvertAudio(&cvt) == 0);
+			if ( cvt.len_cvt != ref_len ||
+			     memcmp(cvt.buf, ref, ref_len) != 0 ) {
+				printf("%s %s, %d bytes: differs from the C filter\n",
+				       filters[filter].name, formats[f].name, len);
+				CHECK(!"same");
+			}
+			free(cvt.buf);
+			++tests;
+		}
+		/* Whether the SIMD filter took the place of the C one */
+		Build(&cvt, filter, formats[f].format, 0, 1);
+		free(cvt.buf);
+		first = cvt.filters[0];
+		Build(&cvt, filter, formats[f].format, 1, 1);
+		free(cvt.buf);
+		replaced += (cvt.filters[0] != first);
+		++pairs;
+	}
+	printf("%d conversions checked, SIMD filters for %d of %d formats\n",
+	       tests, replaced, pairs);
+#if SDL_AUDIOCVT_SSE2
+	if ( SDL_HasSSE2() ) {
+		CHECK(replaced > 0);
+	}
+#endif
+}
+
+/* Returns the megabytes of input converted per second */
+static double Time(int filter, Uint16 format, int simd, int loops)
+{
+	SDL_AudioCVT cvt;
+	Uint64 start;
+	int i, len;
+
+	len = FRAMES * filters[filter].src_channels * (format & 0xFF) / 8;
+	if ( Build(&cvt, filter, format, simd, len) < 0 ) {
+		return(0.0);
+	}
+	memset(cvt.buf, 0, len * cvt.len_mult);
+	SDL_ConvertAudio(&cvt);
+	start = SDL_GetTicksUS();
+	for ( i = 0; i < loops; ++i ) {
+		SDL_ConvertAudio(&cvt);
+	}
+	start = SDL_GetTicksUS() - start;
+	free(cvt.buf);
+	if ( start == 0 ) {
+		start = 1;
+	}
+	return((double)len * loops / start);
+}
+
+static void TimeAll(int loops)
+{
+	double c, simd;
+	int filter, f;
+
+	printf("%d frames, %d loops, megabytes of input per second "
+	       "(C/SIMD, speedup):\n", FRAMES, loops);
+	printf("%-10s", "");
+	for ( f = 0; f < NUM_FORMATS; ++f ) {
+		printf(" %22s", formats[f].name);
+	}
+	printf("\n");
+	for ( filter = 0; filter < NUM_FILTERS; ++filter ) {
+		printf("%-10s", filters[filter].name);
+		for ( f = 0; f < NUM_FORMATS; ++f ) {
+			if ( !Takes(filter, formats[f].format) ) {
+				printf(" %22s", "-");
+				continue;
+			}
+			c = Time(filter, formats[f].format, 0, loops);
+			simd = Time(filter, formats[f].format, 1, loops);
+			printf(" %6.0f/%6.0f (%.2fx)", c, simd, simd / c);
+		}
+		printf("\n");
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static Uint8 data[MAX_LEN];
+	int loops = 1000;
+	int i;
+
+	if ( argc > 1 ) {
+		loops = atoi(argv[1]);
+		if ( loops <= 0 ) {
+			fprintf(stderr, "Usage: %s [loops]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	srand(1);
+	for ( i = 0; i < sizeof(data); ++i ) {
+		data[i] = (Uint8)rand();
+	}
+	TestKernels(data);
+	TestLibrary(data);
+	TimeAll(loops);
+	SDL_Quit();
+
+	return(CheckResult());
+}
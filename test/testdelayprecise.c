@@ -0,0 +1,107 @@
+/* Checks the high resolution counter and how close SDL_DelayPrecise()
+   gets to the time asked for, next to SDL_Delay(): testdelayprecise [loops]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+static Uint64 frequency;
+
+static Uint64 Elapsed(Uint64 start)
+{
+	return ((SDL_GetPerformanceCounter() - start) * 1000000) / frequency;
+}
+
+static void TestClocks(void)
+{
+	Uint64 counter, us, last;
+	Uint32 ticks;
+	int i, backwards = 0;
+
+	frequency = SDL_GetPerformanceFrequency();
+	printf("Performance counter frequency: %.0f Hz\n", (double)frequency);
+	CHECK(frequency >= 1000000);
+
+	/* The clocks agree, and only go forward */
+	ticks = SDL_GetTicks();
+	us = SDL_GetTicksUS();
+	CHECK(us / 1000 >= ticks && us / 1000 <= ticks + 1);
+	last = SDL_GetTicksUS();
+	for ( i = 0; i < 100000; ++i ) {
+		us = SDL_GetTicksUS();
+		backwards += (us < last);
+		last = us;
+	}
+	CHECK(backwards == 0);
+
+	counter = SDL_GetPerformanceCounter();
+	us = SDL_GetTicksUS();
+	SDL_Delay(100);
+	us = SDL_GetTicksUS() - us;
+	counter = Elapsed(counter);
+	printf("SDL_Delay(100): %.0f us by the counter, %.0f us by SDL_GetTicksUS\n",
+	       (double)counter, (double)us);
+	CHECK(us >= 100000 && counter >= 100000);
+	CHECK(counter - us < 1000 || us - counter < 1000);
+}
+
+static void TestDelay(Uint32 us, int loops)
+{
+	Uint64 start, took, error, total = 0, worst = 0;
+	Uint64 delay_total = 0;
+	int i;
+
+	for ( i = 0; i < loops; ++i ) {
+		start = SDL_GetPerformanceCounter();
+		SDL_DelayPrecise(us);
+		took = Elapsed(start);
+		CHECK(took >= us);
+		error = took - us;
+		total += error;
+		if ( error > worst ) {
+			worst = error;
+		}
+		if ( us >= 1000 ) {
+			start = SDL_GetPerformanceCounter();
+			SDL_Delay(us / 1000);
+			delay_total += Elapsed(start) - us / 1000 * 1000;
+		}
+	}
+	printf("%6u us: SDL_DelayPrecise %4.0f us late on average, worst %4.0f us",
+	       us, (double)total / loops, (double)worst);
+	if ( us >= 1000 ) {
+		printf(", SDL_Delay %4.0f us", (double)delay_total / loops);
+	}
+	printf("\n");
+	CHECK(total / loops < 100);
+}
+
+int main(int argc, char *argv[])
+{
+	static const Uint32 delays[] = { 20, 100, 500, 1000, 2500, 8333, 16667 };
+	int loops = 50;
+	int i;
+
+	if ( argc > 1 ) {
+		loops = atoi(argv[1]);
+		if ( loops <= 0 ) {
+			fprintf(stderr, "Usage: %s [loops]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestClocks();
+	for ( i = 0; i < SDL_arraysize(delays); ++i ) {
+		TestDelay(delays[i], loops);
+	}
+	SDL_Quit();
+
+	return(CheckResult());
+}
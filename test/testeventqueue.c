@@ -0,0 +1,304 @@
+/* Stress test and benchmark of the event queue: testeventqueue [events]
+
+   Several threads push events while the main thread takes them out, some
+   of the time all at once with SDL_PollEvents() and some of the time only
+   one type with SDL_PeepEvents().  Every event has to come out once, in
+   the order its thread pushed it.  The benchmark compares the queue with
+   a ring behind an SDL_mutex, like the one it replaced.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#define MAXPRODUCERS	4
+#define QUEUESIZE	4096
+#define BATCH		64
+
+typedef struct Producer {
+	int id;
+	int count;
+	int retries;
+	int (*push)(SDL_Event *event);
+} Producer;
+
+static int SDLCALL ProduceEvents(void *data)
+{
+	Producer *producer = (Producer *)data;
+	SDL_Event event;
+	int i;
+
+	SDL_memset(&event, 0, sizeof(event));
+	event.type = SDL_USEREVENT + producer->id;
+	event.user.code = producer->id;
+	for ( i = 0; i < producer->count; ++i ) {
+		event.user.data1 = (void *)(size_t)i;
+		while ( producer->push(&event) < 0 ) {
+			/* Full, give the consumer some time */
+			++producer->retries;
+			SDL_Delay(1);
+		}
+	}
+	return(0);
+}
+
+static int DrainAll(void)
+{
+	SDL_Event events[BATCH];
+	int total = 0, n;
+
+	while ( (n = SDL_PollEvents(events, BATCH)) > 0 ) {
+		total += n;
+	}
+	return(total);
+}
+
+static void TestOrder(void)
+{
+	SDL_Event event, events[16];
+	int i, n;
+
+	SDL_memset(&event, 0, sizeof(event));
+	for ( i = 0; i < 12; ++i ) {
+		event.type = SDL_USEREVENT + (i % 3);
+		event.user.code = i;
+		CHECK(SDL_PushEvent(&event) == 0);
+	}
+
+	/* Peeking at one type leaves the queue alone */
+	n = SDL_PeepEvents(events, 16, SDL_PEEKEVENT, SDL_EVENTMASK(SDL_USEREVENT+1));
+	CHECK(n == 4);
+	for ( i = 0; i < n; ++i ) {
+		CHECK(events[i].type == SDL_USEREVENT+1 && events[i].user.code == 1 + 3*i);
+	}
+	CHECK(SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_ALLEVENTS) == 1);
+	CHECK(SDL_PeepEvents(NULL, 0, SDL_GETEVENT, SDL_EVENTMASK(SDL_USEREVENT+3)) == 0);
+
+	/* Taking two types out leaves the third in order */
+	n = SDL_PeepEvents(events, 16, SDL_GETEVENT,
+	                   SDL_EVENTMASK(SDL_USEREVENT) | SDL_EVENTMASK(SDL_USEREVENT+2));
+	CHECK(n == 8);
+	for ( i = 0; i < n; ++i ) {
+		CHECK(events[i].user.code == (i/2)*3 + (i&1)*2);
+	}
+	n = SDL_PollEvents(events, 16);
+	CHECK(n == 4);
+	for ( i = 0; i < n; ++i ) {
+		CHECK(events[i].type == SDL_USEREVENT+1 && events[i].user.code == 1 + 3*i);
+	}
+	CHECK(SDL_PollEvent(NULL) == 0);
+}
+
+static void TestFull(void)
+{
+	SDL_Event event;
+	int i, added = 0;
+
+	SDL_memset(&event, 0, sizeof(event));
+	event.type = SDL_USEREVENT;
+	for ( i = 0; i < QUEUESIZE; ++i ) {
+		added += (SDL_PushEvent(&event) == 0);
+	}
+	CHECK(added == QUEUESIZE);
+	CHECK(SDL_PushEvent(&event) < 0);
+
+	/* The other types have queues of their own */
+	event.type = SDL_USEREVENT+1;
+	CHECK(SDL_PushEvent(&event) == 0);
+	CHECK(DrainAll() == QUEUESIZE + 1);
+	event.type = SDL_USEREVENT;
+	CHECK(SDL_PushEvent(&event) == 0);
+	CHECK(DrainAll() == 1);
+}
+
+static void TestProducers(int producers, int count)
+{
+	Producer producer[MAXPRODUCERS];
+	SDL_Thread *thread[MAXPRODUCERS];
+	SDL_Event events[BATCH];
+	int next[MAXPRODUCERS];
+	int i, j, n, total = 0, bad = 0, retries = 0, polls = 0;
+
+	for ( i = 0; i < producers; ++i ) {
+		producer[i].id = i;
+		producer[i].count = count;
+		producer[i].retries = 0;
+		producer[i].push = SDL_PushEvent;
+		next[i] = 0;
+		thread[i] = SDL_CreateThread(ProduceEvents, &producer[i]);
+		CHECK(thread[i] != NULL);
+	}
+	while ( total < producers * count ) {
+		if ( polls++ & 1 ) {
+			n = SDL_PollEvents(events, BATCH);
+		} else {
+			Uint32 mask = SDL_EVENTMASK(SDL_USEREVENT + (polls/2) % producers);
+			n = SDL_PeepEvents(events, BATCH, SDL_GETEVENT, mask);
+		}
+		for ( j = 0; j < n; ++j ) {
+			int id = events[j].user.code;
+
+			if ( id < 0 || id >= producers ||
+			     events[j].type != SDL_USEREVENT + id ||
+			     (int)(size_t)events[j].user.data1 != next[id]++ ) {
+				++bad;
+			}
+		}
+		total += n;
+	}
+	for ( i = 0; i < producers; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+		retries += producer[i].retries;
+	}
+	printf("%d producers: %d events, %d out of order, %d pushes retried\n",
+	       producers, total, bad, retries);
+	CHECK(bad == 0);
+	CHECK(total == producers * count);
+	CHECK(SDL_PollEvent(NULL) == 0);
+}
+
+/* A ring behind a mutex, like the event queue before it was lock-free */
+static int SDLCALL PeekEvents(void *data)
+{
+	int i;
+
+	for ( i = 0; i < *(int *)data; ++i ) {
+		SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_ALLEVENTS);
+	}
+	return(0);
+}
+
+/* The main loop polls while another thread keeps peeking, which only
+   holds the reading lock for a moment */
+static void TestReaders(int count)
+{
+	SDL_Thread *thread;
+	SDL_Event event;
+	Uint64 start, took, worst = 0;
+	int i, total = 0;
+
+	SDL_memset(&event, 0, sizeof(event));
+	event.type = SDL_USEREVENT;
+	thread = SDL_CreateThread(PeekEvents, &count);
+	CHECK(thread != NULL);
+	for ( i = 0; i < count / 10; ++i ) {
+		CHECK(SDL_PushEvent(&event) == 0);
+		start = SDL_GetTicksUS();
+		total += SDL_PollEvent(&event);
+		took = SDL_GetTicksUS() - start;
+		if ( took > worst ) {
+			worst = took;
+		}
+	}
+	SDL_WaitThread(thread, NULL);
+	printf("Polled %d events while peeking, slowest poll %u us\n",
+	       total, (unsigned int)worst);
+	CHECK(total == count / 10);
+	CHECK(SDL_PollEvent(NULL) == 0);
+}
+
+static struct {
+	SDL_mutex *lock;
+	int head, tail;
+	SDL_Event event[QUEUESIZE];
+} ring;
+
+static int RingPush(SDL_Event *event)
+{
+	int tail, added = 0;
+
+	SDL_mutexP(ring.lock);
+	tail = (ring.tail + 1) % QUEUESIZE;
+	if ( tail != ring.head ) {
+		ring.event[ring.tail] = *event;
+		ring.tail = tail;
+		added = 1;
+	}
+	SDL_mutexV(ring.lock);
+	return(added ? 0 : -1);
+}
+
+static int RingGet(SDL_Event *event)
+{
+	int got = 0;
+
+	SDL_mutexP(ring.lock);
+	if ( ring.head != ring.tail ) {
+		*event = ring.event[ring.head];
+		ring.head = (ring.head + 1) % QUEUESIZE;
+		got = 1;
+	}
+	SDL_mutexV(ring.lock);
+	return(got);
+}
+
+static Uint32 Benchmark(int producers, int count, int locked)
+{
+	Producer producer[MAXPRODUCERS];
+	SDL_Thread *thread[MAXPRODUCERS];
+	SDL_Event events[BATCH];
+	Uint32 start = SDL_GetTicks();
+	int i, total = 0;
+
+	for ( i = 0; i < producers; ++i ) {
+		producer[i].id = i;
+		producer[i].count = count;
+		producer[i].retries = 0;
+		producer[i].push = locked ? RingPush : SDL_PushEvent;
+		thread[i] = SDL_CreateThread(ProduceEvents, &producer[i]);
+	}
+	while ( total < producers * count ) {
+		if ( locked ) {
+			total += RingGet(events);
+		} else {
+			total += SDL_PollEvents(events, BATCH);
+		}
+	}
+	for ( i = 0; i < producers; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+	}
+	return(SDL_GetTicks() - start);
+}
+
+int main(int argc, char *argv[])
+{
+	int count = 200000;
+	int producers;
+
+	if ( argc > 1 ) {
+		count = atoi(argv[1]);
+		if ( count <= 0 ) {
+			fprintf(stderr, "Usage: %s [events]\n", argv[0]);
+			return(1);
+		}
+	}
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	SDL_putenv("SDL_EVENT_QUEUE_SIZE=4096");
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	DrainAll();
+
+	TestOrder();
+	TestFull();
+	for ( producers = 1; producers <= MAXPRODUCERS; producers *= 2 ) {
+		TestProducers(producers, count);
+	}
+	TestReaders(count);
+
+	ring.lock = SDL_CreateMutex();
+	for ( producers = 1; producers <= MAXPRODUCERS; producers *= 2 ) {
+		Uint32 queue_ticks = Benchmark(producers, count, 0);
+		Uint32 ring_ticks = Benchmark(producers, count, 1);
+
+		printf("%d producers, %d events each: queue %u ms, mutex ring %u ms\n",
+		       producers, count, queue_ticks, ring_ticks);
+	}
+	SDL_DestroyMutex(ring.lock);
+	SDL_Quit();
+
+	return(CheckResult());
+}
@@ -0,0 +1,480 @@
+/* Tests the psp2 condition variable algorithm on Linux, with a futex for
+   its semaphore, and times signals against the semaphore emulation it
+   replaced and SDL_cond: testfastcond [iterations]
+
+   Built with src/thread/SDL_fastcond_c.h and SDL_fastmutex_c.h, the way
+   psp2 pairs them, and with src/thread/generic/SDL_syscond.c for the old
+   emulation, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "SDL.h"
+#include "SDL_thread.h"
+#include "testcheck.h"
+
+/* A counting semaphore on a futex */
+typedef struct FutexSem {
+	volatile int value;
+} FutexSem;
+
+static int FutexWait(FutexSem *sem, Uint32 ms)
+{
+	struct timespec now, deadline, timeout;
+	int value;
+
+	if ( ms != SDL_MUTEX_MAXWAIT ) {
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += ms / 1000;
+		deadline.tv_nsec += (ms % 1000) * 1000000;
+		if ( deadline.tv_nsec >= 1000000000 ) {
+			deadline.tv_nsec -= 1000000000;
+			++deadline.tv_sec;
+		}
+	}
+	for ( ; ; ) {
+		value = __atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+		if ( value > 0 ) {
+			if ( __atomic_compare_exchange_n(&sem->value, &value, value - 1, 0,
+			                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+				return 0;
+			}
+			continue;
+		}
+		if ( ms == SDL_MUTEX_MAXWAIT ) {
+			syscall(SYS_futex, &sem->value, FUTEX_WAIT_PRIVATE, 0, NULL, NULL, 0);
+			continue;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		timeout.tv_sec = deadline.tv_sec - now.tv_sec;
+		timeout.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+		if ( timeout.tv_nsec < 0 ) {
+			timeout.tv_nsec += 1000000000;
+			--timeout.tv_sec;
+		}
+		if ( timeout.tv_sec < 0 ) {
+			return SDL_MUTEX_TIMEDOUT;
+		}
+		syscall(SYS_futex, &sem->value, FUTEX_WAIT_PRIVATE, 0, &timeout, NULL, 0);
+	}
+}
+
+static int FutexPost(FutexSem *sem, int n)
+{
+	__atomic_fetch_add(&sem->value, n, __ATOMIC_RELEASE);
+	syscall(SYS_futex, &sem->value, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+	return 0;
+}
+
+static __thread Uint32 thread_id;
+
+static Uint32 Self(void)
+{
+	if ( !thread_id ) {
+		thread_id = (Uint32)syscall(SYS_gettid);
+	}
+	return thread_id;
+}
+
+#define SDL_FastMutexSem	FutexSem
+#define SDL_FastMutexWait(sem)	FutexWait(&(sem), SDL_MUTEX_MAXWAIT)
+#define SDL_FastMutexPost(sem)	FutexPost(&(sem), 1)
+#define SDL_FastMutexSelf()	Self()
+
+#include "SDL_fastmutex_c.h"
+
+#define SDL_FastCondSem			FutexSem
+#define SDL_FastCondWait(sem, ms)	FutexWait(&(sem), ms)
+#define SDL_FastCondPost(sem, n)	FutexPost(&(sem), n)
+
+#include "SDL_fastcond_c.h"
+
+/* The semaphore emulation psp2 used before, under other names */
+#define SDL_CreateCond		Emulated_CreateCond
+#define SDL_DestroyCond		Emulated_DestroyCond
+#define SDL_CondSignal		Emulated_CondSignal
+#define SDL_CondBroadcast	Emulated_CondBroadcast
+#define SDL_CondWaitTimeout	Emulated_CondWaitTimeout
+#define SDL_CondWait		Emulated_CondWait
+void Emulated_DestroyCond(SDL_cond *cond);
+#include "generic/SDL_syscond.c"
+#undef SDL_CreateCond
+#undef SDL_DestroyCond
+#undef SDL_CondSignal
+#undef SDL_CondBroadcast
+#undef SDL_CondWaitTimeout
+#undef SDL_CondWait
+
+#define MAXTHREADS	4
+#define QUEUESIZE	16
+
+enum { FAST, EMULATED, NATIVE, NUM_KINDS };
+
+static const char *kind_name[NUM_KINDS] = {
+	"fast cond", "emulated cond", "SDL_cond"
+};
+
+/* The kind being tested, with two condition variables and their mutex */
+static int kind;
+static SDL_FastMutex fast_mutex;
+static SDL_FastCond fast_cond[2];
+static SDL_mutex *mutex;
+static SDL_cond *emulated_cond[2];
+static SDL_cond *native_cond[2];
+
+static void Lock(void)
+{
+	if ( kind == FAST ) {
+		SDL_FastMutexLock(&fast_mutex);
+	} else {
+		SDL_mutexP(mutex);
+	}
+}
+
+static void Unlock(void)
+{
+	if ( kind == FAST ) {
+		SDL_FastMutexUnlock(&fast_mutex);
+	} else {
+		SDL_mutexV(mutex);
+	}
+}
+
+static int Wait(int which, Uint32 ms)
+{
+	int retval;
+
+	switch (kind) {
+	    case FAST:
+		SDL_FastCondPrepare(&fast_cond[which]);
+		SDL_FastMutexUnlock(&fast_mutex);
+		retval = SDL_FastCondSleep(&fast_cond[which], ms);
+		SDL_FastMutexLock(&fast_mutex);
+		return retval;
+	    case EMULATED:
+		return Emulated_CondWaitTimeout(emulated_cond[which], mutex, ms);
+	    default:
+		return SDL_CondWaitTimeout(native_cond[which], mutex, ms);
+	}
+}
+
+static void Signal(int which, int all)
+{
+	switch (kind) {
+	    case FAST:
+		SDL_FastCondSignal(&fast_cond[which], all);
+		break;
+	    case EMULATED:
+		if ( all ) {
+			Emulated_CondBroadcast(emulated_cond[which]);
+		} else {
+			Emulated_CondSignal(emulated_cond[which]);
+		}
+		break;
+	    default:
+		if ( all ) {
+			SDL_CondBroadcast(native_cond[which]);
+		} else {
+			SDL_CondSignal(native_cond[which]);
+		}
+		break;
+	}
+}
+
+/* Every fast cond wakeup went to a waiter that took it */
+static void CheckIdle(void)
+{
+	int i;
+
+	if ( kind == FAST ) {
+		for ( i = 0; i < 2; ++i ) {
+			CHECK(fast_cond[i].state.value == 0 && fast_cond[i].sem.value == 0);
+		}
+		CHECK(fast_mutex.count.value == 0);
+	}
+}
+
+static int waiting, woken, tokens;
+
+static int SDLCALL TakeToken(void *unused)
+{
+	Lock();
+	++waiting;
+	while ( tokens == 0 ) {
+		Wait(0, SDL_MUTEX_MAXWAIT);
+	}
+	--tokens;
+	++woken;
+	Unlock();
+	return(0);
+}
+
+static void WaitForWaiters(int count)
+{
+	int ready;
+
+	do {
+		SDL_Delay(1);
+		Lock();
+		ready = (waiting == count);
+		Unlock();
+	} while ( ! ready );
+}
+
+static void TestSemantics(void)
+{
+	SDL_Thread *thread[MAXTHREADS];
+	Uint32 start;
+	int i, retval;
+
+	/* Signals with nobody waiting are lost, and timeouts time out */
+	Signal(0, 0);
+	Signal(0, 1);
+	Lock();
+	start = SDL_GetTicks();
+	retval = Wait(0, 20);
+	CHECK(retval == SDL_MUTEX_TIMEDOUT);
+	CHECK(SDL_GetTicks() - start >= 20);
+	CHECK(Wait(0, 0) == SDL_MUTEX_TIMEDOUT);
+	Unlock();
+	CheckIdle();
+
+	/* A signal wakes one waiter, a broadcast the rest */
+	waiting = woken = tokens = 0;
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		thread[i] = SDL_CreateThread(TakeToken, NULL);
+	}
+	WaitForWaiters(MAXTHREADS);
+	Lock();
+	tokens = 1;
+	Signal(0, 0);
+	Unlock();
+	SDL_Delay(50);
+	Lock();
+	CHECK(woken == 1);
+	tokens = MAXTHREADS - 1;
+	Signal(0, 1);
+	Unlock();
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+	}
+	CHECK(woken == MAXTHREADS && tokens == 0);
+	CheckIdle();
+}
+
+/* Waits with short timeouts racing signals and broadcasts */
+static int racing;
+
+static int SDLCALL RaceWait(void *data)
+{
+	int *signaled = (int *)data;
+	int i, retval;
+
+	for ( i = 0; __atomic_load_n(&racing, __ATOMIC_RELAXED); ++i ) {
+		Lock();
+		retval = Wait(0, 1 + i % 3);
+		Unlock();
+		if ( retval == 0 ) {
+			++*signaled;
+		} else {
+			CHECK(retval == SDL_MUTEX_TIMEDOUT);
+		}
+	}
+	return(0);
+}
+
+static void TestTimeoutRace(void)
+{
+	SDL_Thread *thread[MAXTHREADS];
+	int signaled[MAXTHREADS];
+	Uint32 start;
+	int i, total = 0, signals = 0;
+
+	__atomic_store_n(&racing, 1, __ATOMIC_RELAXED);
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		signaled[i] = 0;
+		thread[i] = SDL_CreateThread(RaceWait, &signaled[i]);
+	}
+	start = SDL_GetTicks();
+	while ( SDL_GetTicks() - start < 200 ) {
+		Signal(0, (signals++ % 8) == 0);
+		if ( signals % 16 == 0 ) {
+			SDL_Delay(1);
+		}
+	}
+	__atomic_store_n(&racing, 0, __ATOMIC_RELAXED);
+	for ( i = 0; i < MAXTHREADS; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+		total += signaled[i];
+	}
+	CHECK(total > 0);
+	CheckIdle();
+}
+
+/* Two threads taking turns, every signal has a sleeping thread to wake */
+static int iterations;
+static int turn;
+
+static int SDLCALL PingPong(void *data)
+{
+	int me = *(int *)data;
+	int i;
+
+	Lock();
+	for ( i = 0; i < iterations; ++i ) {
+		while ( turn != me ) {
+			Wait(me, SDL_MUTEX_MAXWAIT);
+		}
+		turn = !me;
+		Signal(!me, 0);
+	}
+	Unlock();
+	return(0);
+}
+
+static Uint32 BenchPingPong(void)
+{
+	static int ids[2] = { 0, 1 };
+	SDL_Thread *thread[2];
+	Uint32 start = SDL_GetTicks();
+
+	turn = 0;
+	thread[0] = SDL_CreateThread(PingPong, &ids[0]);
+	thread[1] = SDL_CreateThread(PingPong, &ids[1]);
+	SDL_WaitThread(thread[0], NULL);
+	SDL_WaitThread(thread[1], NULL);
+	return SDL_GetTicks() - start;
+}
+
+/* A bounded queue, signalled on every put and take */
+static int queue[QUEUESIZE];
+static int head, count;
+static Uint64 consumed_sum;
+
+static int SDLCALL Produce(void *unused)
+{
+	int i;
+
+	for ( i = 0; i < iterations; ++i ) {
+		Lock();
+		while ( count == QUEUESIZE ) {
+			Wait(1, SDL_MUTEX_MAXWAIT);
+		}
+		queue[(head + count++) % QUEUESIZE] = i;
+		Unlock();
+		Signal(0, 0);
+	}
+	return(0);
+}
+
+static int SDLCALL Consume(void *unused)
+{
+	int i, value;
+
+	for ( i = 0; i < iterations; ++i ) {
+		Lock();
+		while ( count == 0 ) {
+			Wait(0, SDL_MUTEX_MAXWAIT);
+		}
+		value = queue[head];
+		head = (head + 1) % QUEUESIZE;
+		--count;
+		consumed_sum += value;
+		Unlock();
+		Signal(1, 0);
+	}
+	return(0);
+}
+
+static Uint32 BenchQueue(int pairs)
+{
+	SDL_Thread *thread[2*MAXTHREADS];
+	Uint32 start = SDL_GetTicks();
+	int i;
+
+	head = count = consumed_sum = 0;
+	for ( i = 0; i < pairs; ++i ) {
+		thread[2*i] = SDL_CreateThread(Produce, NULL);
+		thread[2*i+1] = SDL_CreateThread(Consume, NULL);
+	}
+	for ( i = 0; i < 2*pairs; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+	}
+	CHECK(count == 0);
+	CHECK(consumed_sum == (Uint64)pairs * iterations * (iterations - 1) / 2);
+	return SDL_GetTicks() - start;
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 ticks[NUM_KINDS];
+	int pairs;
+
+	iterations = 100000;
+	if ( argc > 1 ) {
+		iterations = atoi(argv[1]);
+		if ( iterations <= 0 ) {
+			fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	mutex = SDL_CreateMutex();
+	emulated_cond[0] = Emulated_CreateCond();
+	emulated_cond[1] = Emulated_CreateCond();
+	native_cond[0] = SDL_CreateCond();
+	native_cond[1] = SDL_CreateCond();
+
+	for ( kind = 0; kind < NUM_KINDS; ++kind ) {
+		TestSemantics();
+		/* The emulation deadlocks here: a thread that times out just as
+		   another is signalled waits for a wakeup with its lock held,
+		   and the signalled thread may have taken that wakeup already.
+		 */
+		if ( kind != EMULATED ) {
+			TestTimeoutRace();
+		}
+	}
+
+	for ( kind = 0; kind < NUM_KINDS; ++kind ) {
+		ticks[kind] = BenchPingPong();
+		CheckIdle();
+	}
+	printf("Ping-pong, %d round trips: ", iterations);
+	for ( kind = 0; kind < NUM_KINDS; ++kind ) {
+		printf("%s%s %.2f us/signal", kind ? ", " : "", kind_name[kind],
+		       ticks[kind] * 1000.0 / (2.0 * iterations));
+	}
+	printf("\n");
+
+	for ( pairs = 1; pairs <= MAXTHREADS; pairs *= 2 ) {
+		for ( kind = 0; kind < NUM_KINDS; ++kind ) {
+			ticks[kind] = BenchQueue(pairs);
+			CheckIdle();
+		}
+		printf("%d producer/consumer pairs, %d items each: ", pairs, iterations);
+		for ( kind = 0; kind < NUM_KINDS; ++kind ) {
+			printf("%s%s %.2f us/signal", kind ? ", " : "", kind_name[kind],
+			       ticks[kind] * 1000.0 / (2.0 * pairs * iterations));
+		}
+		printf("\n");
+	}
+
+	Emulated_DestroyCond(emulated_cond[0]);
+	Emulated_DestroyCond(emulated_cond[1]);
+	SDL_DestroyCond(native_cond[0]);
+	SDL_DestroyCond(native_cond[1]);
+	SDL_DestroyMutex(mutex);
+	SDL_Quit();
+
+	return(CheckResult());
+}
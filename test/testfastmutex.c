@@ -0,0 +1,188 @@
+/* Tests the psp2 fast mutex algorithm on Linux, with a futex for its
+   semaphore, and times it against SDL_mutex: testfastmutex [iterations]
+
+   Built with src/thread/SDL_fastmutex_c.h, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "SDL.h"
+#include "SDL_thread.h"
+#include "testcheck.h"
+
+/* A counting semaphore on a futex */
+typedef struct FutexSem {
+	volatile int value;
+} FutexSem;
+
+static int FutexWait(FutexSem *sem)
+{
+	int value;
+
+	for ( ; ; ) {
+		value = __atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+		if ( value > 0 ) {
+			if ( __atomic_compare_exchange_n(&sem->value, &value, value - 1, 0,
+			                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+				return 0;
+			}
+			continue;
+		}
+		syscall(SYS_futex, &sem->value, FUTEX_WAIT_PRIVATE, 0, NULL, NULL, 0);
+	}
+}
+
+static void FutexPost(FutexSem *sem)
+{
+	__atomic_fetch_add(&sem->value, 1, __ATOMIC_RELEASE);
+	syscall(SYS_futex, &sem->value, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static __thread Uint32 thread_id;
+
+static Uint32 Self(void)
+{
+	if ( !thread_id ) {
+		thread_id = (Uint32)syscall(SYS_gettid);
+	}
+	return thread_id;
+}
+
+#define SDL_FastMutexSem	FutexSem
+#define SDL_FastMutexWait(sem)	FutexWait(&(sem))
+#define SDL_FastMutexPost(sem)	FutexPost(&(sem))
+#define SDL_FastMutexSelf()	Self()
+
+#include "SDL_fastmutex_c.h"
+
+#define MAXTHREADS	4
+
+static SDL_FastMutex fast;
+static SDL_mutex *mutex;
+static int use_fast;
+static int iterations;
+static volatile int counter;
+
+static void Lock(void)
+{
+	if ( use_fast ) {
+		SDL_FastMutexLock(&fast);
+	} else {
+		SDL_mutexP(mutex);
+	}
+}
+
+static void Unlock(void)
+{
+	if ( use_fast ) {
+		SDL_FastMutexUnlock(&fast);
+	} else {
+		SDL_mutexV(mutex);
+	}
+}
+
+static int SDLCALL TryUnlock(void *unused)
+{
+	return SDL_FastMutexUnlock(&fast);
+}
+
+static void TestRecursion(void)
+{
+	SDL_Thread *thread;
+	int status = 0;
+
+	CHECK(SDL_FastMutexLock(&fast) == 0);
+	CHECK(SDL_FastMutexLock(&fast) == 0);
+	CHECK(SDL_FastMutexLock(&fast) == 0);
+	CHECK(fast.recursion == 3 && fast.count.value == 1);
+
+	/* Only the owner can unlock it */
+	thread = SDL_CreateThread(TryUnlock, NULL);
+	SDL_WaitThread(thread, &status);
+	CHECK(status == -1);
+
+	CHECK(SDL_FastMutexUnlock(&fast) == 0);
+	CHECK(SDL_FastMutexUnlock(&fast) == 0);
+	CHECK(SDL_FastMutexUnlock(&fast) == 0);
+	CHECK(fast.count.value == 0 && fast.owner.value == 0);
+	CHECK(SDL_FastMutexUnlock(&fast) == -1);
+}
+
+static int SDLCALL Increment(void *unused)
+{
+	int i, value;
+
+	for ( i = 0; i < iterations; ++i ) {
+		Lock();
+		value = counter;
+		if ( i & 1 ) {
+			/* Nest the lock now and then */
+			Lock();
+			counter = value + 1;
+			Unlock();
+		} else {
+			counter = value + 1;
+		}
+		Unlock();
+	}
+	return(0);
+}
+
+/* Returns the milliseconds 'threads' threads took to count together */
+static Uint32 Count(int threads)
+{
+	SDL_Thread *thread[MAXTHREADS];
+	Uint32 start;
+	int i;
+
+	counter = 0;
+	start = SDL_GetTicks();
+	for ( i = 0; i < threads; ++i ) {
+		thread[i] = SDL_CreateThread(Increment, NULL);
+	}
+	for ( i = 0; i < threads; ++i ) {
+		SDL_WaitThread(thread[i], NULL);
+	}
+	CHECK(counter == threads * iterations);
+	CHECK(fast.count.value == 0 && fast.owner.value == 0);
+	return SDL_GetTicks() - start;
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 fast_ticks, mutex_ticks;
+	int threads;
+
+	iterations = 1000000;
+	if ( argc > 1 ) {
+		iterations = atoi(argv[1]);
+		if ( iterations <= 0 ) {
+			fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	mutex = SDL_CreateMutex();
+
+	TestRecursion();
+	for ( threads = 1; threads <= MAXTHREADS; threads *= 2 ) {
+		use_fast = 1;
+		fast_ticks = Count(threads);
+		use_fast = 0;
+		mutex_ticks = Count(threads);
+		printf("%d threads, %d locks each: fast mutex %u ms, SDL_mutex %u ms\n",
+		       threads, iterations, fast_ticks, mutex_ticks);
+	}
+
+	SDL_DestroyMutex(mutex);
+	SDL_Quit();
+
+	return(CheckResult());
+}
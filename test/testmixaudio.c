@@ -0,0 +1,258 @@
+/* Compares the SIMD versions of SDL_MixAudio with its C code and times
+   them: testmixaudio [megabytes]
+
+   Built from src/audio/SDL_mixer_NEON.c and SDL_mixer_SSE2.c, see
+   Makefile.in. The NEON functions use the portable stand-ins of
+   SDL_neon_emu.h on a host without NEON, which checks the arithmetic but
+   not the speed. The SSE2 functions are only tested on x86.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_mixer_NEON.h"
+#include "SDL_mixer_SSE2.h"
+
+#define BUFFER_SIZE	4096
+
+typedef Uint32 (*MixFunc)(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+
+typedef struct Kernel {
+	const char *name;
+	Uint16 format;
+	MixFunc mix;
+} Kernel;
+
+static const Kernel kernels[] = {
+	{ "NEON U8", AUDIO_U8, SDL_MixAudio_NEON_U8 },
+	{ "NEON S8", AUDIO_S8, SDL_MixAudio_NEON_S8 },
+	{ "NEON S16LSB", AUDIO_S16LSB, SDL_MixAudio_NEON_S16LSB },
+#if SDL_MIXER_SSE2
+	{ "SSE2 U8", AUDIO_U8, SDL_MixAudio_SSE2_U8 },
+	{ "SSE2 S8", AUDIO_S8, SDL_MixAudio_SSE2_S8 },
+	{ "SSE2 S16LSB", AUDIO_S16LSB, SDL_MixAudio_SSE2_S16LSB },
+#endif
+};
+
+/* The C code of SDL_MixAudio, the values the SIMD functions have to match */
+static void ReferenceMix(Uint16 format, Uint8 *dst, const Uint8 *src,
+                         Uint32 len, int volume)
+{
+	Uint32 i;
+	int sample;
+
+	switch (format) {
+		case AUDIO_U8:
+			for ( i = 0; i < len; ++i ) {
+				Uint8 s = (Uint8)(((src[i] - 128) * volume) / SDL_MIX_MAXVOLUME + 128);
+
+				sample = dst[i] + s - 128;
+				dst[i] = (Uint8)(sample < 0 ? 0 : sample > 0xFE ? 0xFE : sample);
+			}
+			break;
+		case AUDIO_S8:
+			for ( i = 0; i < len; ++i ) {
+				Sint8 s = (Sint8)(((Sint8)src[i] * volume) / SDL_MIX_MAXVOLUME);
+
+				sample = (Sint8)dst[i] + s;
+				dst[i] = (Uint8)(sample < -128 ? -128 : sample > 127 ? 127 : sample);
+			}
+			break;
+		case AUDIO_S16LSB:
+			for ( i = 0; i + 1 < len; i += 2 ) {
+				Sint16 s = (Sint16)(src[i + 1] << 8 | src[i]);
+				Sint16 d = (Sint16)(dst[i + 1] << 8 | dst[i]);
+
+				s = (Sint16)((s * volume) / SDL_MIX_MAXVOLUME);
+				sample = d + s;
+				sample = sample < -32768 ? -32768 : sample > 32767 ? 32767 : sample;
+				dst[i] = (Uint8)(sample & 0xFF);
+				dst[i + 1] = (Uint8)((sample >> 8) & 0xFF);
+			}
+			break;
+	}
+}
+
+/* Every pair of 8 bit samples, or random 16 bit ones with the extremes */
+static void FillBuffers(Uint16 format, Uint8 *dst, Uint8 *src, Uint32 len)
+{
+	static const Sint16 edges[] = { -32768, -32767, -129, -128, -127, -1, 0, 1, 127, 128, 32767 };
+	Uint32 i;
+
+	for ( i = 0; i < len; ++i ) {
+		if ( format == AUDIO_S16LSB ) {
+			Sint16 d, s;
+
+			if ( (i / 2) < SDL_arraysize(edges) * SDL_arraysize(edges) ) {
+				d = edges[(i / 2) % SDL_arraysize(edges)];
+				s = edges[(i / 2) / SDL_arraysize(edges)];
+			} else {
+				d = (Sint16)rand();
+				s = (Sint16)rand();
+			}
+			dst[i] = (Uint8)(((i & 1) ? d >> 8 : d) & 0xFF);
+			src[i] = (Uint8)(((i & 1) ? s >> 8 : s) & 0xFF);
+		} else {
+			dst[i] = (Uint8)(i >> 8);
+			src[i] = (Uint8)i;
+		}
+	}
+}
+
+static void TestKernel(const Kernel *kernel)
+{
+	const Uint32 len = 65536;
+	Uint8 *src = (Uint8 *)malloc(len);
+	Uint8 *dst = (Uint8 *)malloc(len);
+	Uint8 *ref = (Uint8 *)malloc(len);
+	Uint8 *start = (Uint8 *)malloc(len);
+	int volume, diff = 0;
+
+	if ( !src || !dst || !ref || !start ) {
+		CHECK(!"out of memory");
+		return;
+	}
+	srand(1);
+	FillBuffers(kernel->format, start, src, len);
+	for ( volume = 0; volume <= SDL_MIX_MAXVOLUME; ++volume ) {
+		SDL_memcpy(ref, start, len);
+		SDL_memcpy(dst, start, len);
+		ReferenceMix(kernel->format, ref, src, len, volume);
+		CHECK(kernel->mix(dst, src, len, volume) == len);
+		if ( SDL_memcmp(dst, ref, len) != 0 ) {
+			++diff;
+		}
+	}
+	printf("%s: %d of %d volumes differ\n", kernel->name, diff, SDL_MIX_MAXVOLUME + 1);
+	CHECK(diff == 0);
+
+	/* Only whole 16 byte blocks are mixed */
+	SDL_memcpy(dst, start, len);
+	CHECK(kernel->mix(dst + 1, src + 1, 37, SDL_MIX_MAXVOLUME) == 32);
+	CHECK(SDL_memcmp(dst + 33, start + 33, len - 33) == 0);
+
+	free(start);
+	free(ref);
+	free(dst);
+	free(src);
+}
+
+static void Callback(void *userdata, Uint8 *stream, int len)
+{
+}
+
+static int OpenAudio(Uint16 format)
+{
+	SDL_AudioSpec spec;
+
+	spec.freq = 22050;
+	spec.format = format;
+	spec.channels = 1;
+	spec.samples = 512;
+	spec.callback = Callback;
+	spec.userdata = NULL;
+	if ( SDL_OpenAudio(&spec, NULL) < 0 ) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		return(-1);
+	}
+	return(0);
+}
+
+/* SDL_MixAudio itself, with lengths and offsets the SIMD functions can't
+   do all of, and volumes they don't take
+ */
+static void TestMixAudio(Uint16 format, const char *name)
+{
+	static const int volumes[] = { 1, 64, 100, SDL_MIX_MAXVOLUME, 200 };
+	const Uint32 len = 2 * 1021;
+	Uint8 src[2 * 1021 + 1], dst[2 * 1021 + 1], ref[2 * 1021 + 1];
+	int i, diff = 0;
+
+	if ( OpenAudio(format) < 0 ) {
+		CHECK(!"SDL_OpenAudio");
+		return;
+	}
+	for ( i = 0; i < SDL_arraysize(volumes); ++i ) {
+		FillBuffers(format, dst, src, sizeof(dst));
+		SDL_memcpy(ref, dst, sizeof(dst));
+		ReferenceMix(format, ref + 1, src + 1, len, volumes[i]);
+		SDL_MixAudio(dst + 1, src + 1, len, volumes[i]);
+		if ( SDL_memcmp(dst, ref, sizeof(dst)) != 0 ) {
+			++diff;
+		}
+	}
+	printf("SDL_MixAudio %s: %d of %d volumes differ\n", name, diff,
+	       (int)SDL_arraysize(volumes));
+	CHECK(diff == 0);
+	SDL_CloseAudio();
+}
+
+static void Benchmark(Uint16 format, const char *name, int megabytes)
+{
+	const int count = megabytes * (1024 * 1024 / BUFFER_SIZE);
+	Uint8 *src = (Uint8 *)malloc(BUFFER_SIZE);
+	Uint8 *dst = (Uint8 *)malloc(BUFFER_SIZE);
+	Uint32 ref_ticks, mix_ticks, start;
+	int i;
+
+	if ( !src || !dst || OpenAudio(format) < 0 ) {
+		CHECK(!"benchmark setup");
+		return;
+	}
+	FillBuffers(format, dst, src, BUFFER_SIZE);
+
+	start = SDL_GetTicks();
+	for ( i = 0; i < count; ++i ) {
+		ReferenceMix(format, dst, src, BUFFER_SIZE, 100);
+	}
+	ref_ticks = SDL_GetTicks() - start;
+
+	start = SDL_GetTicks();
+	for ( i = 0; i < count; ++i ) {
+		SDL_MixAudio(dst, src, BUFFER_SIZE, 100);
+	}
+	mix_ticks = SDL_GetTicks() - start;
+
+	printf("%-7s %d MB mixed: C %u ms, SDL_MixAudio %u ms\n", name,
+	       megabytes, ref_ticks, mix_ticks);
+	SDL_CloseAudio();
+	free(dst);
+	free(src);
+}
+
+int main(int argc, char *argv[])
+{
+	int megabytes = 64;
+	int i;
+
+	if ( argc > 1 ) {
+		megabytes = atoi(argv[1]);
+		if ( megabytes <= 0 ) {
+			fprintf(stderr, "Usage: %s [megabytes]\n", argv[0]);
+			return(1);
+		}
+	}
+	SDL_putenv("SDL_AUDIODRIVER=dummy");
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	for ( i = 0; i < SDL_arraysize(kernels); ++i ) {
+		TestKernel(&kernels[i]);
+	}
+	TestMixAudio(AUDIO_U8, "U8");
+	TestMixAudio(AUDIO_S8, "S8");
+	TestMixAudio(AUDIO_S16LSB, "S16LSB");
+
+	printf("SIMD: NEON %d, SSE2 %d\n", SDL_HasARMNEON(), SDL_HasSSE2());
+	Benchmark(AUDIO_U8, "U8", megabytes);
+	Benchmark(AUDIO_S8, "S8", megabytes);
+	Benchmark(AUDIO_S16LSB, "S16LSB", megabytes);
+	SDL_Quit();
+
+	return(CheckResult());
+}
@@ -0,0 +1,295 @@
+/* Tests the psp2 sprite batching against the host gxm stand-in, and times
+   it with thousands of sprites: testpsp2batch [sprites] [frames]
+
+   Built from src/video/psp2/SDL_psp2batch.c and
+   src/video/psp2/SDL_render_vita_gxm_host.c, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2batch_c.h"
+
+#define NUM_TEXTURES	4
+
+static SDL_Rect MakeRect(int x, int y, int w, int h)
+{
+	SDL_Rect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.w = w;
+	rect.h = h;
+	return rect;
+}
+
+static int CountOps(gxm_host_op op)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == op ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+static Uint32 *Pixel(gxm_texture *texture, int x, int y)
+{
+	Uint8 *row = (Uint8 *)gxm_texture_get_datap(texture) +
+	             y * gxm_texture_get_stride(texture);
+	return (Uint32 *)row + x;
+}
+
+/* Opaque texture where every texel is unique */
+static gxm_texture *CreateSheet(int index, int w, int h)
+{
+	gxm_texture *texture = create_gxm_texture(w, h,
+	                           SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	int x, y;
+
+	for ( y = 0; y < h; ++y ) {
+		for ( x = 0; x < w; ++x ) {
+			*Pixel(texture, x, y) = 0xFF000000 | (index << 16) |
+			                        (y << 8) | x;
+		}
+	}
+	return texture;
+}
+
+static int DrawBatch(PSP2_SpriteBatch *batch, gxm_texture *target)
+{
+	int result;
+
+	gxm_start_drawing_to_texture(target);
+	result = PSP2_DrawSpriteBatch(batch);
+	gxm_end_drawing();
+	PSP2_ClearSpriteBatch(batch);
+	return result;
+}
+
+static void TestSorting(void)
+{
+	PSP2_SpriteBatch batch;
+	gxm_texture *sheets[PSP2_BATCH_LOOKBACK + 1];
+	gxm_texture *a, *b, *target;
+	SDL_Rect cell = MakeRect(0, 0, 8, 8);
+	int i, s;
+
+	printf("Testing sorting by state\n");
+
+	gxm_init();
+	SDL_memset(&batch, 0, sizeof(batch));
+	a = CreateSheet(0, 8, 8);
+	b = CreateSheet(1, 8, 8);
+	target = create_gxm_texture(256, 64, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	gxm_texture_enable_render_target(target);
+
+	/* Alternating textures that don't overlap make one run each */
+	for ( i = 0; i < 20; ++i ) {
+		PSP2_AddSprite(&batch, (i & 1) ? b : a, 0, &cell, i * 8, 0, NULL);
+	}
+	CHECK(batch.num_runs == 2);
+	CHECK(batch.runs[0].count == 10 && batch.runs[1].count == 10);
+
+	/* and keep their queued order within the run */
+	for ( i = 0, s = batch.runs[0].head; s >= 0; s = batch.sprites[s].next ) {
+		CHECK(batch.sprites[s].dx == i * 16);
+		++i;
+	}
+	CHECK(i == 10);
+
+	gxm_host_clear_calls();
+	CHECK(DrawBatch(&batch, target) == 0);
+	CHECK(CountOps(GXM_HOST_DRAW_QUADS) == 2);
+	CHECK(batch.stats.batches == 2);
+	CHECK(batch.stats.draw_calls == 2);
+	CHECK(batch.stats.quads == 20);
+
+	/* A sprite can't move before one it overlaps */
+	PSP2_AddSprite(&batch, a, 0, &cell, 0, 0, NULL);
+	PSP2_AddSprite(&batch, b, 0, &cell, 4, 4, NULL);
+	PSP2_AddSprite(&batch, a, 0, &cell, 8, 8, NULL);
+	CHECK(batch.num_runs == 3);
+	PSP2_ClearSpriteBatch(&batch);
+
+	/* The blend state separates runs too */
+	PSP2_AddSprite(&batch, a, 0, &cell, 0, 0, NULL);
+	PSP2_AddSprite(&batch, a, 1, &cell, 16, 0, NULL);
+	PSP2_AddSprite(&batch, a, 0, &cell, 32, 0, NULL);
+	CHECK(batch.num_runs == 2);
+	PSP2_ClearSpriteBatch(&batch);
+
+	/* Runs further back than the lookback aren't joined */
+	for ( i = 0; i <= PSP2_BATCH_LOOKBACK; ++i ) {
+		PSP2_AddSprite(&batch, (i & 1) ? b : a, i & 2 ? 1 : 0,
+		               &cell, (i % 16) * 16, (i / 16) * 16, NULL);
+	}
+	CHECK(batch.num_runs == 4);
+	PSP2_ClearSpriteBatch(&batch);
+	for ( i = 0; i <= PSP2_BATCH_LOOKBACK; ++i ) {
+		sheets[i] = CreateSheet(i, 8, 8);
+		PSP2_AddSprite(&batch, sheets[i], 0, &cell, i * 8, 0, NULL);
+	}
+	PSP2_AddSprite(&batch, sheets[0], 0, &cell, 0, 32, NULL);
+	CHECK(batch.num_runs == PSP2_BATCH_LOOKBACK + 2);
+	PSP2_ClearSpriteBatch(&batch);
+	for ( i = 0; i <= PSP2_BATCH_LOOKBACK; ++i ) {
+		free_gxm_texture(sheets[i]);
+	}
+
+	PSP2_FreeSpriteBatch(&batch);
+	free_gxm_texture(a);
+	free_gxm_texture(b);
+	free_gxm_texture(target);
+	gxm_finish();
+}
+
+/* Random overlapping sprites have to end up as if drawn in queued order */
+static void TestOrdering(void)
+{
+	PSP2_SpriteBatch batch;
+	gxm_texture *sheets[NUM_TEXTURES];
+	gxm_texture *target, *expected;
+	int i, x, y, diff = 0;
+
+	printf("Testing drawing order\n");
+
+	gxm_init();
+	SDL_memset(&batch, 0, sizeof(batch));
+	for ( i = 0; i < NUM_TEXTURES; ++i ) {
+		sheets[i] = CreateSheet(i, 16, 16);
+	}
+	target = create_gxm_texture(128, 128, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	expected = create_gxm_texture(128, 128, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	gxm_texture_enable_render_target(target);
+
+	srand(1);
+	for ( i = 0; i < 2000; ++i ) {
+		gxm_texture *sheet = sheets[rand() % NUM_TEXTURES];
+		SDL_Rect src = MakeRect(rand() % 8, rand() % 8, 1 + rand() % 8, 1 + rand() % 8);
+		int dx = rand() % (128 - src.w);
+		int dy = rand() % (128 - src.h);
+
+		PSP2_AddSprite(&batch, sheet, 0, &src, dx, dy, NULL);
+		for ( y = 0; y < src.h; ++y ) {
+			for ( x = 0; x < src.w; ++x ) {
+				*Pixel(expected, dx + x, dy + y) =
+					*Pixel(sheet, src.x + x, src.y + y);
+			}
+		}
+	}
+	CHECK(batch.num_runs < 2000);
+	CHECK(DrawBatch(&batch, target) == 0);
+	gxm_wait_rendering_done();
+
+	for ( y = 0; y < 128; ++y ) {
+		for ( x = 0; x < 128; ++x ) {
+			if ( *Pixel(target, x, y) != *Pixel(expected, x, y) ) {
+				++diff;
+			}
+		}
+	}
+	CHECK(diff == 0);
+
+	PSP2_FreeSpriteBatch(&batch);
+	for ( i = 0; i < NUM_TEXTURES; ++i ) {
+		free_gxm_texture(sheets[i]);
+	}
+	free_gxm_texture(target);
+	free_gxm_texture(expected);
+	gxm_finish();
+}
+
+/* Queues and draws frames of sprites from a few sheets, either laid out
+   like a tile map or scattered at random */
+static void Benchmark(const char *name, int sprites, int frames, int tiled)
+{
+	PSP2_SpriteBatch batch;
+	gxm_texture *sheets[NUM_TEXTURES];
+	gxm_texture *target;
+	SDL_Rect cell = MakeRect(0, 0, 8, 8);
+	Uint32 start, ticks = 0;
+	int i, frame;
+
+	gxm_init();
+	SDL_memset(&batch, 0, sizeof(batch));
+	for ( i = 0; i < NUM_TEXTURES; ++i ) {
+		sheets[i] = CreateSheet(i, 64, 64);
+	}
+	target = create_gxm_texture(960, 544, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	gxm_texture_enable_render_target(target);
+
+	srand(2);
+	for ( frame = 0; frame < frames; ++frame ) {
+		start = SDL_GetTicks();
+		for ( i = 0; i < sprites; ++i ) {
+			int dx, dy;
+
+			if ( tiled ) {
+				dx = (i % 120) * 8;
+				dy = ((i / 120) % 68) * 8;
+			} else {
+				dx = rand() % (960 - 8);
+				dy = rand() % (544 - 8);
+			}
+			cell.x = (rand() % 8) * 8;
+			cell.y = (rand() % 8) * 8;
+			PSP2_AddSprite(&batch, sheets[rand() % NUM_TEXTURES], 0,
+			               &cell, dx, dy, NULL);
+		}
+		gxm_start_drawing_to_texture(target);
+		CHECK(PSP2_DrawSpriteBatch(&batch) == 0);
+		ticks += SDL_GetTicks() - start;
+		gxm_end_drawing();
+		PSP2_ClearSpriteBatch(&batch);
+		gxm_host_clear_calls();
+	}
+
+	printf("%s: %d sprites x %d frames in %u ms, "
+	       "%u batches and %u draw calls per frame\n",
+	       name, sprites, frames, ticks,
+	       batch.stats.batches / frames, batch.stats.draw_calls / frames);
+
+	PSP2_FreeSpriteBatch(&batch);
+	for ( i = 0; i < NUM_TEXTURES; ++i ) {
+		free_gxm_texture(sheets[i]);
+	}
+	free_gxm_texture(target);
+	gxm_finish();
+}
+
+int main(int argc, char *argv[])
+{
+	int sprites = 5000;
+	int frames = 20;
+
+	if ( argc > 1 ) {
+		sprites = atoi(argv[1]);
+	}
+	if ( argc > 2 ) {
+		frames = atoi(argv[2]);
+	}
+	if ( sprites <= 0 || frames <= 0 ) {
+		fprintf(stderr, "Usage: %s [sprites] [frames]\n", argv[0]);
+		return(1);
+	}
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestSorting();
+	TestOrdering();
+	Benchmark("Tiles", sprites, frames, 1);
+	Benchmark("Sprites", sprites, frames, 0);
+	SDL_Quit();
+
+	return(CheckResult());
+}
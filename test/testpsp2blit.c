@@ -0,0 +1,392 @@
+/* Tests the psp2 GPU blits against the software blitters, using the host
+   gxm stand-in to execute the quads.
+
+   Built from src/video/psp2/SDL_psp2blit.c, src/video/psp2/SDL_psp2batch.c,
+   src/video/psp2/SDL_psp2retire.c and the host gxm stand-in, see
+   Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2blit_c.h"
+
+/* A surface in a host texture, as the driver would create it, and a
+   software copy for the reference blits */
+typedef struct TestSurface {
+	SDL_Surface *gpu;
+	SDL_Surface *cpu;
+} TestSurface;
+
+static void GetMasks(int bpp, Uint32 *r, Uint32 *g, Uint32 *b, Uint32 *a)
+{
+	if ( bpp == 16 ) {
+		*r = 0xF800; *g = 0x07E0; *b = 0x001F; *a = 0;
+	} else {
+		*r = 0x000000FF; *g = 0x0000FF00; *b = 0x00FF0000; *a = 0xFF000000;
+	}
+}
+
+static TestSurface CreateTestSurface(int w, int h, int bpp, int alpha_channel)
+{
+	TestSurface surface;
+	gxm_texture *texture;
+	Uint32 r, g, b, a;
+
+	GetMasks(bpp, &r, &g, &b, &a);
+	if ( !alpha_channel ) {
+		a = 0;
+	}
+	texture = create_gxm_texture(w, h, (bpp == 16) ?
+		SCE_GXM_TEXTURE_FORMAT_R5G6B5 : SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	surface.gpu = SDL_CreateRGBSurfaceFrom(gxm_texture_get_datap(texture),
+		w, h, bpp, gxm_texture_get_stride(texture), r, g, b, a);
+	surface.gpu->hwdata = (private_hwdata *)calloc(1, sizeof(private_hwdata));
+	surface.gpu->hwdata->texture = texture;
+	surface.cpu = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, bpp, r, g, b, a);
+	return surface;
+}
+
+static void FreeTestSurface(TestSurface *surface)
+{
+	PSP2_RetireQueue retired = { NULL, 0, 0 };
+
+	PSP2_ReleaseGPUBlits(surface->gpu, &retired);
+	PSP2_RetireTexture(&retired, surface->gpu->hwdata->texture);
+	PSP2_DrainRetireQueue(&retired);
+	free(surface->gpu->hwdata);
+	surface->gpu->hwdata = NULL;
+	SDL_FreeSurface(surface->gpu);
+	SDL_FreeSurface(surface->cpu);
+}
+
+static Uint32 GetPixel(SDL_Surface *surface, int x, int y)
+{
+	Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+	if ( surface->format->BytesPerPixel == 2 ) {
+		return ((Uint16 *)row)[x];
+	}
+	return ((Uint32 *)row)[x];
+}
+
+static void PutPixel(SDL_Surface *surface, int x, int y, Uint32 pixel)
+{
+	Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+	if ( surface->format->BytesPerPixel == 2 ) {
+		((Uint16 *)row)[x] = (Uint16)pixel;
+	} else {
+		((Uint32 *)row)[x] = pixel;
+	}
+}
+
+/* Random pixels, every fourth one the given key */
+static void FillTestSurface(TestSurface *surface, Uint32 key)
+{
+	int x, y;
+
+	for ( y = 0; y < surface->gpu->h; ++y ) {
+		for ( x = 0; x < surface->gpu->w; ++x ) {
+			Uint32 pixel = ((Uint32)rand() << 16) ^ (Uint32)rand();
+			if ( (rand() % 4) == 0 ) {
+				pixel = key;
+			}
+			PutPixel(surface->gpu, x, y, pixel);
+			PutPixel(surface->cpu, x, y, pixel);
+		}
+	}
+}
+
+/* Largest difference of any channel, in 8 bit steps */
+static int CompareTestSurface(TestSurface *surface, int with_alpha)
+{
+	int x, y, diff = 0;
+
+	for ( y = 0; y < surface->gpu->h; ++y ) {
+		for ( x = 0; x < surface->gpu->w; ++x ) {
+			Uint8 c1[4], c2[4];
+			int i;
+
+			SDL_GetRGBA(GetPixel(surface->gpu, x, y), surface->gpu->format,
+			            &c1[0], &c1[1], &c1[2], &c1[3]);
+			SDL_GetRGBA(GetPixel(surface->cpu, x, y), surface->cpu->format,
+			            &c2[0], &c2[1], &c2[2], &c2[3]);
+			for ( i = 0; i < (with_alpha ? 4 : 3); ++i ) {
+				diff = SDL_max(diff, abs(c1[i] - c2[i]));
+			}
+		}
+	}
+	return diff;
+}
+
+/* Continues from the GPU results */
+static void CopyTestSurface(TestSurface *surface)
+{
+	int y;
+
+	for ( y = 0; y < surface->gpu->h; ++y ) {
+		SDL_memcpy((Uint8 *)surface->cpu->pixels + y * surface->cpu->pitch,
+		           (Uint8 *)surface->gpu->pixels + y * surface->gpu->pitch,
+		           surface->gpu->w * surface->gpu->format->BytesPerPixel);
+	}
+}
+
+static void SetupSource(TestSurface *src, int key, int alpha)
+{
+	Uint32 ckey = src->gpu->format->Rmask | src->gpu->format->Bmask;
+
+	FillTestSurface(src, ckey);
+	SDL_SetAlpha(src->gpu, alpha ? SDL_SRCALPHA : 0, (Uint8)alpha);
+	SDL_SetAlpha(src->cpu, alpha ? SDL_SRCALPHA : 0, (Uint8)alpha);
+	SDL_SetColorKey(src->gpu, key ? SDL_SRCCOLORKEY : 0, ckey);
+	SDL_SetColorKey(src->cpu, key ? SDL_SRCCOLORKEY : 0, ckey);
+	PSP2_InvalidateGPUBlits(src->gpu);
+}
+
+/* Does a few random blits both ways and returns the largest difference.
+   The results are compared after every blit, so rounding differences
+   don't add up where blits overlap. */
+static int BlitBoth(TestSurface *src, TestSurface *dst, int with_alpha)
+{
+	int i, diff = 0;
+
+	for ( i = 0; i < 20; ++i ) {
+		SDL_Rect srcrect, dstrect;
+
+		srcrect.w = 1 + rand() % src->gpu->w;
+		srcrect.h = 1 + rand() % src->gpu->h;
+		srcrect.x = rand() % (src->gpu->w - srcrect.w + 1);
+		srcrect.y = rand() % (src->gpu->h - srcrect.h + 1);
+		dstrect.x = rand() % (dst->gpu->w - srcrect.w + 1);
+		dstrect.y = rand() % (dst->gpu->h - srcrect.h + 1);
+		dstrect.w = srcrect.w;
+		dstrect.h = srcrect.h;
+
+		CHECK(PSP2_GPUBlit(src->gpu, &srcrect, dst->gpu, &dstrect) == 0);
+		CHECK(SDL_LowerBlit(src->cpu, &srcrect, dst->cpu, &dstrect) == 0);
+		PSP2_WaitGPUBlits(dst->gpu);
+		diff = SDL_max(diff, CompareTestSurface(dst, with_alpha));
+		CopyTestSurface(dst);
+	}
+	return diff;
+}
+
+static void TestBlit(const char *name, int srcbpp, int dstbpp,
+                     int key, int alpha, int pixel_alpha, int tolerance)
+{
+	/* Surface alpha is ignored for surfaces with an alpha channel */
+	TestSurface src = CreateTestSurface(40, 30, srcbpp, !alpha);
+	TestSurface dst = CreateTestSurface(64, 48, dstbpp, 1);
+	int diff;
+
+	FillTestSurface(&dst, 0);
+	SetupSource(&src, key, alpha);
+	if ( pixel_alpha ) {
+		SDL_SetAlpha(src.gpu, SDL_SRCALPHA, 255);
+		SDL_SetAlpha(src.cpu, SDL_SRCALPHA, 255);
+	}
+
+	CHECK(PSP2_CanGPUBlit(src.gpu, dst.gpu));
+	diff = BlitBoth(&src, &dst, !key && !alpha && !pixel_alpha);
+	printf("%-38s largest difference %d\n", name, diff);
+	CHECK(diff <= tolerance);
+
+	FreeTestSurface(&src);
+	FreeTestSurface(&dst);
+}
+
+static int CountOps(gxm_host_op op)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == op ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+static int CountQuads(void)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == GXM_HOST_DRAW_QUADS ) {
+			count += calls[i].w;
+		}
+	}
+	return count;
+}
+
+static void TestBatching(void)
+{
+	TestSurface src = CreateTestSurface(16, 16, 16, 0);
+	TestSurface dst1 = CreateTestSurface(64, 64, 16, 0);
+	TestSurface dst2 = CreateTestSurface(64, 64, 16, 0);
+	SDL_Rect srcrect = { 0, 0, 16, 16 };
+	SDL_Rect dstrect = { 0, 0, 16, 16 };
+	Uint32 before;
+	int i;
+
+	printf("Testing batching and synchronisation\n");
+
+	SetupSource(&src, 0, 0);
+	FillTestSurface(&dst1, 0);
+	gxm_host_clear_calls();
+
+	/* Blits into the same surface share one scene and draw call */
+	for ( i = 0; i < 10; ++i ) {
+		dstrect.x = i * 4;
+		PSP2_GPUBlit(src.gpu, &srcrect, dst1.gpu, &dstrect);
+	}
+	CHECK(CountOps(GXM_HOST_START_DRAWING_TO_TEXTURE) == 0);
+	PSP2_FlushGPUBlits();
+	CHECK(CountOps(GXM_HOST_START_DRAWING_TO_TEXTURE) == 1);
+	CHECK(CountOps(GXM_HOST_DRAW_QUADS) == 1);
+	CHECK(CountQuads() == 10);
+	CHECK(CountOps(GXM_HOST_END_DRAWING) == 1);
+
+	/* Switching the destination starts a new one */
+	gxm_host_clear_calls();
+	PSP2_GPUBlit(src.gpu, &srcrect, dst1.gpu, &dstrect);
+	PSP2_GPUBlit(src.gpu, &srcrect, dst2.gpu, &dstrect);
+	PSP2_GPUBlit(src.gpu, &srcrect, dst1.gpu, &dstrect);
+	PSP2_FlushGPUBlits();
+	CHECK(CountOps(GXM_HOST_START_DRAWING_TO_TEXTURE) == 3);
+
+	/* With the GPU behind, results only show up after waiting */
+	gxm_host_set_gpu_latency(2);
+	PSP2_WaitGPUBlits(dst1.gpu);
+	dstrect.x = 32;
+	dstrect.y = 32;
+	PutPixel(src.gpu, 0, 0, 0x1234);
+	PutPixel(dst1.gpu, 32, 32, 0);
+	PSP2_GPUBlit(src.gpu, &srcrect, dst1.gpu, &dstrect);
+	PSP2_FlushGPUBlits();
+	CHECK(GetPixel(dst1.gpu, 32, 32) == 0);
+
+	/* Touching the source first waits for the blit that reads it */
+	gxm_host_clear_calls();
+	PSP2_WaitGPUBlits(src.gpu);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 1);
+	before = GetPixel(dst1.gpu, 32, 32);
+	CHECK(before == 0x1234);
+	PutPixel(src.gpu, 0, 0, 0x4321);
+	PSP2_InvalidateGPUBlits(src.gpu);
+	PSP2_WaitGPUBlits(dst1.gpu);
+	CHECK(GetPixel(dst1.gpu, 32, 32) == before);
+
+	/* Queued blits are submitted before the CPU touches the destination */
+	gxm_host_clear_calls();
+	PSP2_GPUBlit(src.gpu, &srcrect, dst1.gpu, &dstrect);
+	PSP2_WaitGPUBlits(dst1.gpu);
+	CHECK(CountOps(GXM_HOST_END_DRAWING) == 1);
+	CHECK(GetPixel(dst1.gpu, 32, 32) == 0x4321);
+	gxm_host_set_gpu_latency(0);
+
+	FreeTestSurface(&src);
+	FreeTestSurface(&dst1);
+	FreeTestSurface(&dst2);
+}
+
+/* Queued blits still land if the destination can't be rendered to when
+   they are submitted */
+static void TestNoRenderTarget(const char *name, int bpp, int key, int alpha,
+                               int tolerance)
+{
+	TestSurface src = CreateTestSurface(40, 30, bpp, 0);
+	TestSurface dst = CreateTestSurface(64, 48, bpp, 1);
+	SDL_Rect srcrect = { 4, 2, 30, 20 };
+	SDL_Rect dstrect = { 10, 12, 30, 20 };
+	int diff;
+
+	FillTestSurface(&dst, 0);
+	SetupSource(&src, key, alpha);
+	CHECK(PSP2_CanGPUBlit(src.gpu, dst.gpu));
+
+	gxm_host_clear_calls();
+	gxm_host_fail_render_targets(1);
+	CHECK(PSP2_GPUBlit(src.gpu, &srcrect, dst.gpu, &dstrect) == 0);
+	CHECK(SDL_LowerBlit(src.cpu, &srcrect, dst.cpu, &dstrect) == 0);
+	dstrect.x = 30;
+	dstrect.y = 20;
+	CHECK(PSP2_GPUBlit(src.gpu, &srcrect, dst.gpu, &dstrect) == 0);
+	CHECK(SDL_LowerBlit(src.cpu, &srcrect, dst.cpu, &dstrect) == 0);
+	PSP2_WaitGPUBlits(dst.gpu);
+	gxm_host_fail_render_targets(0);
+	CHECK(CountOps(GXM_HOST_START_DRAWING_TO_TEXTURE) == 0);
+
+	diff = CompareTestSurface(&dst, 0);
+	printf("%-38s largest difference %d\n", name, diff);
+	CHECK(diff <= tolerance);
+
+	FreeTestSurface(&src);
+	FreeTestSurface(&dst);
+}
+
+static void TestUnsupported(void)
+{
+	TestSurface surface16 = CreateTestSurface(8, 8, 16, 0);
+	TestSurface surface32 = CreateTestSurface(8, 8, 32, 1);
+	SDL_Surface *argb;
+
+	printf("Testing unsupported blits\n");
+
+	/* Overlapping blits within one surface stay on the CPU */
+	CHECK(!PSP2_CanGPUBlit(surface16.gpu, surface16.gpu));
+
+	/* Only layouts that match the textures */
+	argb = SDL_CreateRGBSurfaceFrom(surface32.gpu->pixels, 8, 8, 32,
+		surface32.gpu->pitch, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+	argb->hwdata = surface32.gpu->hwdata;
+	CHECK(!PSP2_CanGPUBlit(argb, surface16.gpu));
+	CHECK(!PSP2_CanGPUBlit(surface16.gpu, argb));
+	argb->hwdata = NULL;
+	SDL_FreeSurface(argb);
+
+	/* And no software surfaces */
+	CHECK(!PSP2_CanGPUBlit(surface16.cpu, surface16.gpu));
+
+	FreeTestSurface(&surface16);
+	FreeTestSurface(&surface32);
+}
+
+int main(int argc, char *argv[])
+{
+	gxm_init();
+	srand(1);
+
+	printf("Testing blits against SDL_LowerBlit\n");
+	/* Copies and colour keys are exact. The software blitters blend with
+	   truncating integer maths, so alpha may be off by one step: 2 for
+	   8 bit channels, 9 for the 5 bit channels of a 16 bit surface. */
+	TestBlit("copy 16 -> 16", 16, 16, 0, 0, 0, 0);
+	TestBlit("copy 32 -> 32", 32, 32, 0, 0, 0, 0);
+	TestBlit("colour key 16 -> 16", 16, 16, 1, 0, 0, 0);
+	TestBlit("colour key 32 -> 32", 32, 32, 1, 0, 0, 0);
+	TestBlit("surface alpha 16 -> 16", 16, 16, 0, 100, 0, 9);
+	TestBlit("surface alpha 32 -> 32", 32, 32, 0, 100, 0, 2);
+	TestBlit("colour key and surface alpha 16 -> 16", 16, 16, 1, 200, 0, 9);
+	TestBlit("colour key and surface alpha 32 -> 32", 32, 32, 1, 200, 0, 2);
+	TestBlit("pixel alpha 32 -> 32", 32, 32, 0, 0, 1, 2);
+	TestBlit("pixel alpha 32 -> 16", 32, 16, 0, 0, 1, 9);
+
+	printf("Testing blits without a render target\n");
+	TestNoRenderTarget("copy 16 -> 16", 16, 0, 0, 0);
+	TestNoRenderTarget("colour key and surface alpha 32 -> 32", 32, 1, 200, 2);
+
+	TestBatching();
+	TestUnsupported();
+
+	gxm_finish();
+
+	return(CheckResult());
+}
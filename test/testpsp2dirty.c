@@ -0,0 +1,182 @@
+/* Tests the psp2 dirty rectangle presentation against the host gxm stand-in.
+
+   Built from src/video/psp2/SDL_psp2dirty.c and
+   src/video/psp2/SDL_render_vita_gxm_host.c, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2dirty_c.h"
+
+static SDL_Rect MakeRect(int x, int y, int w, int h)
+{
+	SDL_Rect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.w = w;
+	rect.h = h;
+	return rect;
+}
+
+static int CountOps(gxm_host_op op)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == op ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+/* Area drawn by all the partial draws, counting overlaps twice */
+static int DrawnArea(void)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, area = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == GXM_HOST_DRAW_TEXTURE_PART ) {
+			area += calls[i].w * calls[i].h;
+		}
+	}
+	return area;
+}
+
+static int Present(PSP2_DirtyState *state, const gxm_texture *texture)
+{
+	gxm_host_clear_calls();
+	if ( PSP2_PresentDirtyRects(state, texture) ) {
+		gxm_swap_buffers();
+		return 1;
+	}
+	return 0;
+}
+
+static void TestMerge(void)
+{
+	PSP2_DirtyRects set;
+	SDL_Rect rect;
+	int i;
+
+	printf("Testing rectangle merging\n");
+
+	/* Overlapping sprites collapse into one rectangle */
+	set.count = 0;
+	rect = MakeRect(10, 10, 32, 32);
+	PSP2_AddDirtyRect(&set, &rect);
+	rect = MakeRect(20, 20, 32, 32);
+	PSP2_AddDirtyRect(&set, &rect);
+	CHECK(set.count == 1);
+	CHECK(set.rects[0].x == 10 && set.rects[0].y == 10);
+	CHECK(set.rects[0].w == 42 && set.rects[0].h == 42);
+
+	/* A contained rectangle doesn't add anything */
+	rect = MakeRect(12, 12, 4, 4);
+	PSP2_AddDirtyRect(&set, &rect);
+	CHECK(set.count == 1);
+
+	/* Distant rectangles stay separate */
+	rect = MakeRect(500, 400, 16, 16);
+	PSP2_AddDirtyRect(&set, &rect);
+	CHECK(set.count == 2);
+
+	/* Empty rectangles are ignored */
+	rect = MakeRect(100, 100, 0, 10);
+	PSP2_AddDirtyRect(&set, &rect);
+	CHECK(set.count == 2);
+
+	/* A rectangle bridging both merges everything in one go */
+	rect = MakeRect(0, 0, 600, 500);
+	PSP2_AddDirtyRect(&set, &rect);
+	CHECK(set.count == 1);
+	CHECK(set.rects[0].w == 600 && set.rects[0].h == 500);
+
+	/* The set never overflows */
+	set.count = 0;
+	for ( i = 0; i < 100; ++i ) {
+		rect = MakeRect((i % 10) * 90, (i / 10) * 50, 8, 8);
+		PSP2_AddDirtyRect(&set, &rect);
+		CHECK(set.count <= VITA_GXM_MAX_REGIONS);
+	}
+}
+
+static void TestPresent(void)
+{
+	PSP2_DirtyState state;
+	gxm_texture *texture;
+	SDL_Rect rects[2];
+	int frame;
+
+	printf("Testing partial presents\n");
+
+	gxm_init();
+	texture = create_gxm_texture(640, 480, SCE_GXM_TEXTURE_FORMAT_R5G6B5);
+	PSP2_ResetDirtyState(&state, 640, 480);
+
+	/* Nothing reported, nothing drawn */
+	CHECK(Present(&state, texture) == 0);
+	CHECK(CountOps(GXM_HOST_START_DRAWING) == 0);
+
+	/* Every display buffer starts out black, so the first updates after a
+	   reset redraw the whole screen once per buffer */
+	for ( frame = 0; frame < VITA_GXM_BUFFERS; ++frame ) {
+		rects[0] = MakeRect(0, 0, 8, 8);
+		PSP2_AddDirtyRects(&state, 1, rects);
+		CHECK(Present(&state, texture) == 1);
+		CHECK(DrawnArea() == 640 * 480);
+	}
+
+	/* Now only the changed rectangles are drawn */
+	rects[0] = MakeRect(0, 0, 640, 16);
+	rects[1] = MakeRect(100, 200, 32, 32);
+	PSP2_AddDirtyRects(&state, 2, rects);
+	CHECK(Present(&state, texture) == 1);
+	CHECK(CountOps(GXM_HOST_START_DRAWING) == 1);
+	CHECK(CountOps(GXM_HOST_DRAW_TEXTURE_PART) == 2);
+	CHECK(CountOps(GXM_HOST_DRAW_TEXTURE) == 0);
+	CHECK(CountOps(GXM_HOST_END_DRAWING) == 1);
+	CHECK(DrawnArea() == 640 * 16 + 32 * 32);
+
+	/* The next buffer missed that frame, so it gets those too */
+	rects[0] = MakeRect(300, 300, 10, 10);
+	PSP2_AddDirtyRects(&state, 1, rects);
+	CHECK(Present(&state, texture) == 1);
+	CHECK(DrawnArea() == 640 * 16 + 32 * 32 + 10 * 10);
+
+	/* Nothing changed: skip, and no damage is lost for later frames */
+	CHECK(Present(&state, texture) == 0);
+	CHECK(CountOps(GXM_HOST_SWAP_BUFFERS) == 0);
+
+	/* Rectangles outside the surface are clipped or dropped */
+	rects[0] = MakeRect(-10, -10, 20, 20);
+	rects[1] = MakeRect(700, 10, 20, 20);
+	PSP2_AddDirtyRects(&state, 2, rects);
+	CHECK(state.pending.count == 1);
+	CHECK(state.pending.rects[0].x == 0 && state.pending.rects[0].w == 10);
+
+	/* After a full draw only the other buffers are stale */
+	PSP2_MarkDirtyPresented(&state);
+	CHECK(state.stale[gxm_get_back_buffer_index()].count == 0);
+	CHECK(state.stale[(gxm_get_back_buffer_index() + 1) % VITA_GXM_BUFFERS].count == 1);
+
+	free_gxm_texture(texture);
+	gxm_finish();
+}
+
+int main(int argc, char *argv[])
+{
+	TestMerge();
+	TestPresent();
+
+	return(CheckResult());
+}
@@ -0,0 +1,105 @@
+/* Tests the psp2 screen texture ring against the host gxm stand-in,
+   whose simulated GPU finishes scenes a fixed number of frames late.
+
+   Built from src/video/psp2/SDL_psp2flip.c, src/video/psp2/SDL_psp2retire.c
+   and the host gxm stand-in, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2flip_c.h"
+
+#define FRAMES 100
+
+static int CountOps(gxm_host_op op)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == op ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+/* Runs a frame loop like PSP2_FlipHWSurface, returns the number of waits */
+static int RunFrames(int count, unsigned int latency)
+{
+	PSP2_FlipRing ring;
+	PSP2_RetireQueue retired = { NULL, 0, 0 };
+	gxm_texture *texture;
+	int frame, i, waits;
+	int seen[VITA_GXM_BUFFERS];
+
+	gxm_init();
+	gxm_host_set_gpu_latency(latency);
+
+	texture = create_gxm_texture(320, 240, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	CHECK(PSP2_CreateFlipRing(&ring, texture, count) == 0);
+	CHECK(ring.count == SDL_min(count, VITA_GXM_BUFFERS));
+	for ( i = 0; i < VITA_GXM_BUFFERS; ++i ) {
+		seen[i] = 0;
+	}
+
+	for ( frame = 0; frame < FRAMES; ++frame ) {
+		Uint32 *pixels = (Uint32 *)gxm_texture_get_datap(texture);
+
+		/* The CPU must never touch a texture the GPU still reads */
+		CHECK(texture == ring.textures[ring.current]);
+		CHECK(gxm_fence_reached(ring.fences[ring.current]));
+		pixels[0] = frame;
+		seen[ring.current]++;
+
+		gxm_start_drawing();
+		gxm_draw_texture(texture);
+		gxm_end_drawing();
+		texture = PSP2_RotateFlipRing(&ring);
+		gxm_swap_buffers();
+	}
+
+	/* Every texture of the ring got its turn */
+	for ( i = 0; i < ring.count; ++i ) {
+		CHECK(seen[i] >= FRAMES / ring.count);
+	}
+
+	waits = CountOps(GXM_HOST_WAIT_FENCE);
+	PSP2_DestroyFlipRing(&ring, &retired);
+	PSP2_DrainRetireQueue(&retired);
+	gxm_finish();
+
+	return waits;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int latency;
+	int count;
+
+	/* A ring of N textures absorbs a GPU up to N-1 frames behind */
+	for ( count = 1; count <= VITA_GXM_BUFFERS; ++count ) {
+		for ( latency = 0; latency <= VITA_GXM_BUFFERS + 1; ++latency ) {
+			int waits = RunFrames(count, latency);
+
+			printf("%d textures, GPU %u frames behind: %d waits in %d frames\n",
+			       count, latency, waits, FRAMES);
+			if ( latency < (unsigned int)count ) {
+				CHECK(waits == 0);
+			} else {
+				CHECK(waits > 0);
+			}
+		}
+	}
+
+	/* Asking for more textures than display buffers is clamped */
+	CHECK(RunFrames(VITA_GXM_BUFFERS + 2, 0) == 0);
+
+	return(CheckResult());
+}
@@ -0,0 +1,258 @@
+/* Fuzzes and times the psp2 GPU memory heap with a malloc backend:
+   testpsp2heap [operations] [seed]
+
+   Built from src/video/psp2/SDL_render_vita_gxm_heap.c, see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_heap.h"
+
+#define ARENA_SIZE	(256 * 1024)
+#define MIN_BLOCK	256
+#define MAX_LIVE	512
+
+static int reserved_blocks = 0;
+
+static void *Reserve(void *userdata, unsigned int size, void **handle)
+{
+	Uint8 *mem = (Uint8 *)malloc(size + GXM_HEAP_MAX_ALIGNMENT);
+
+	*handle = mem;
+	if ( mem == NULL ) {
+		return NULL;
+	}
+	++reserved_blocks;
+	return (void *)(((uintptr_t)mem + GXM_HEAP_MAX_ALIGNMENT - 1) &
+	                ~(uintptr_t)(GXM_HEAP_MAX_ALIGNMENT - 1));
+}
+
+static void Release(void *userdata, void *base, void *handle)
+{
+	--reserved_blocks;
+	free(handle);
+}
+
+static gxm_heap *CreateHeap(void)
+{
+	gxm_heap_backend backend;
+
+	backend.reserve = Reserve;
+	backend.release = Release;
+	backend.userdata = NULL;
+	return gxm_heap_create(&backend, ARENA_SIZE, MIN_BLOCK);
+}
+
+typedef struct Allocation {
+	Uint8 *mem;
+	unsigned int size;
+	Uint8 fill;
+} Allocation;
+
+/* Every allocation is filled with its own byte, an overlap shows up as a
+   wrong byte in one of them */
+static int Intact(const Allocation *allocation)
+{
+	unsigned int i;
+
+	for ( i = 0; i < allocation->size; ++i ) {
+		if ( allocation->mem[i] != allocation->fill ) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static unsigned int RandomSize(void)
+{
+	switch ( rand() % 8 ) {
+	    case 0:
+		return 1 + rand() % 16;
+	    case 1:
+		return ARENA_SIZE / 4 + rand() % ARENA_SIZE;	/* own backing */
+	    default:
+		return 1 + rand() % 8192;
+	}
+}
+
+static void TestFuzz(int operations)
+{
+	gxm_heap *heap = CreateHeap();
+	Allocation live[MAX_LIVE];
+	gxm_heap_stats stats;
+	unsigned int requested = 0, peak = 0;
+	int i, num_live = 0, broken = 0;
+
+	printf("Fuzzing %d operations\n", operations);
+
+	for ( i = 0; i < operations; ++i ) {
+		if ( num_live < MAX_LIVE && (num_live == 0 || rand() % 3 != 0) ) {
+			Allocation *allocation = &live[num_live];
+			unsigned int alignment = 1 << (rand() % 13);
+
+			allocation->size = RandomSize();
+			allocation->mem = (Uint8 *)gxm_heap_alloc(heap, allocation->size, alignment);
+			if ( allocation->mem == NULL ) {
+				CHECK(allocation->mem != NULL);
+				break;
+			}
+			CHECK(((uintptr_t)allocation->mem & (alignment - 1)) == 0);
+			allocation->fill = (Uint8)(i + 1);
+			SDL_memset(allocation->mem, allocation->fill, allocation->size);
+			requested += allocation->size;
+			++num_live;
+		} else {
+			int victim = rand() % num_live;
+
+			if ( !Intact(&live[victim]) ) {
+				++broken;
+			}
+			CHECK(gxm_heap_free(heap, live[victim].mem) == 0);
+			requested -= live[victim].size;
+			live[victim] = live[--num_live];
+		}
+
+		gxm_heap_get_stats(heap, &stats);
+		CHECK(stats.requested == requested);
+		CHECK(stats.used >= stats.requested);
+		CHECK(stats.allocations == (unsigned int)num_live);
+		CHECK(stats.reserved >= stats.used);
+		peak = SDL_max(peak, stats.used);
+		CHECK(stats.high_water == peak);
+	}
+	CHECK(broken == 0);
+
+	/* Freeing what it doesn't own is refused */
+	CHECK(gxm_heap_free(heap, &stats) == -1);
+	if ( num_live > 0 && live[0].size > 1 ) {
+		CHECK(gxm_heap_free(heap, live[0].mem + 1) == -1);
+	}
+
+	while ( num_live > 0 ) {
+		--num_live;
+		CHECK(Intact(&live[num_live]));
+		CHECK(gxm_heap_free(heap, live[num_live].mem) == 0);
+	}
+
+	/* Everything merged back into one arena */
+	gxm_heap_get_stats(heap, &stats);
+	CHECK(stats.used == 0 && stats.requested == 0);
+	CHECK(stats.arenas == 1 && stats.large_allocations == 0);
+	CHECK(stats.largest_free == ARENA_SIZE);
+	CHECK(stats.fragmentation == 0);
+
+	gxm_heap_destroy(heap);
+	CHECK(reserved_blocks == 0);
+}
+
+static void TestCoalescing(void)
+{
+	gxm_heap *heap = CreateHeap();
+	void *blocks[ARENA_SIZE / MIN_BLOCK];
+	gxm_heap_stats stats;
+	int i, count = ARENA_SIZE / MIN_BLOCK;
+
+	printf("Testing coalescing\n");
+
+	/* Fill an arena with the smallest blocks */
+	for ( i = 0; i < count; ++i ) {
+		blocks[i] = gxm_heap_alloc(heap, 1, 1);
+	}
+	gxm_heap_get_stats(heap, &stats);
+	CHECK(stats.arenas == 1 && stats.free == 0);
+
+	/* Every other one free is all fragments */
+	for ( i = 0; i < count; i += 2 ) {
+		gxm_heap_free(heap, blocks[i]);
+	}
+	gxm_heap_get_stats(heap, &stats);
+	CHECK(stats.largest_free == MIN_BLOCK);
+	CHECK(stats.free == ARENA_SIZE / 2);
+	CHECK(stats.fragmentation > 90);
+
+	/* Freeing the rest in random order merges them again */
+	for ( i = 1; i < count; i += 2 ) {
+		int j = 1 + 2 * (rand() % (count / 2));
+		void *swap = blocks[i];
+		blocks[i] = blocks[j];
+		blocks[j] = swap;
+	}
+	for ( i = 1; i < count; i += 2 ) {
+		gxm_heap_free(heap, blocks[i]);
+	}
+	gxm_heap_get_stats(heap, &stats);
+	CHECK(stats.largest_free == ARENA_SIZE);
+	CHECK(stats.fragmentation == 0);
+
+	/* so the biggest block fits without reserving more */
+	CHECK(gxm_heap_alloc(heap, ARENA_SIZE / 4, 16) != NULL);
+	gxm_heap_get_stats(heap, &stats);
+	CHECK(stats.arenas == 1 && stats.reserved == ARENA_SIZE);
+
+	/* A 32x32 sprite costs a few blocks, not a whole memblock */
+	CHECK(gxm_heap_alloc(heap, 32 * 32 * 2, 16) != NULL);
+	gxm_heap_get_stats(heap, &stats);
+	CHECK(stats.used == ARENA_SIZE / 4 + 32 * 32 * 2);
+
+	gxm_heap_destroy(heap);
+	CHECK(reserved_blocks == 0);
+}
+
+/* Many sprite sized textures coming and going */
+static void Benchmark(int operations)
+{
+	gxm_heap *heap = CreateHeap();
+	void *live[MAX_LIVE];
+	gxm_heap_stats stats;
+	Uint32 start;
+	int i;
+
+	for ( i = 0; i < MAX_LIVE; ++i ) {
+		live[i] = gxm_heap_alloc(heap, 512 + rand() % 4096, 16);
+	}
+	start = SDL_GetTicks();
+	for ( i = 0; i < operations; ++i ) {
+		int victim = rand() % MAX_LIVE;
+		gxm_heap_free(heap, live[victim]);
+		live[victim] = gxm_heap_alloc(heap, 512 + rand() % 4096, 16);
+	}
+	gxm_heap_get_stats(heap, &stats);
+	printf("%d frees and allocations in %u ms, %u KiB used in %u arenas, "
+	       "%u%% fragmentation\n", operations, SDL_GetTicks() - start,
+	       stats.used / 1024, stats.arenas, stats.fragmentation);
+
+	gxm_heap_destroy(heap);
+}
+
+int main(int argc, char *argv[])
+{
+	int operations = 20000;
+	unsigned int seed = 1;
+
+	if ( argc > 1 ) {
+		operations = atoi(argv[1]);
+	}
+	if ( argc > 2 ) {
+		seed = (unsigned int)atoi(argv[2]);
+	}
+	if ( operations <= 0 ) {
+		fprintf(stderr, "Usage: %s [operations] [seed]\n", argv[0]);
+		return(1);
+	}
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	srand(seed);
+
+	TestFuzz(operations);
+	TestCoalescing();
+	Benchmark(operations * 10);
+	SDL_Quit();
+
+	return(CheckResult());
+}
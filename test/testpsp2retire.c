@@ -0,0 +1,171 @@
+/* Tests the psp2 deferred texture destruction against the host gxm
+   stand-in, whose simulated GPU finishes scenes a fixed number of frames
+   late.
+
+   Built from src/video/psp2/SDL_psp2retire.c and the host gxm stand-in,
+   see Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2retire_c.h"
+
+#define NUM_TEXTURES	200
+
+static int CountOps(gxm_host_op op)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == op ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+static int CountTextures(void)
+{
+	gxm_heap_stats stats;
+
+	gxm_get_texture_memory_stats(&stats);
+	return stats.allocations;
+}
+
+/* One frame drawing the textures, like a flip after blitting them */
+static void DrawFrame(gxm_texture **textures, int count)
+{
+	int i;
+
+	gxm_start_drawing();
+	for ( i = 0; i < count; ++i ) {
+		gxm_draw_texture(textures[i]);
+	}
+	gxm_end_drawing();
+	gxm_swap_buffers();
+}
+
+static void TestUnload(void)
+{
+	PSP2_RetireQueue retired = { NULL, 0, 0 };
+	gxm_texture *textures[NUM_TEXTURES];
+	int i;
+
+	printf("Testing a level unload with the GPU 2 frames behind\n");
+
+	gxm_init();
+	gxm_host_set_gpu_latency(2);
+	for ( i = 0; i < NUM_TEXTURES; ++i ) {
+		textures[i] = create_gxm_texture(32, 32, SCE_GXM_TEXTURE_FORMAT_R5G6B5);
+	}
+	DrawFrame(textures, NUM_TEXTURES);
+	CHECK(CountTextures() == NUM_TEXTURES);
+
+	/* Freeing them all never waits for the GPU */
+	gxm_host_clear_calls();
+	for ( i = 0; i < NUM_TEXTURES; ++i ) {
+		PSP2_RetireTexture(&retired, textures[i]);
+	}
+	CHECK(PSP2_ReclaimTextures(&retired) == 0);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 0);
+	CHECK(CountOps(GXM_HOST_WAIT_RENDERING_DONE) == 0);
+	CHECK(retired.count == NUM_TEXTURES);
+	CHECK(CountTextures() == NUM_TEXTURES);
+
+	/* They go once the frame that drew them completed */
+	DrawFrame(NULL, 0);
+	CHECK(PSP2_ReclaimTextures(&retired) == 0);
+	DrawFrame(NULL, 0);
+	CHECK(PSP2_ReclaimTextures(&retired) == NUM_TEXTURES);
+	CHECK(retired.count == 0);
+	CHECK(CountTextures() == 0);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 0);
+
+	PSP2_DrainRetireQueue(&retired);
+	gxm_host_set_gpu_latency(0);
+	gxm_finish();
+}
+
+static void TestOrder(void)
+{
+	PSP2_RetireQueue retired = { NULL, 0, 0 };
+	gxm_texture *textures[4];
+	int i;
+
+	printf("Testing reclaiming in frame order\n");
+
+	gxm_init();
+	gxm_host_set_gpu_latency(3);
+	for ( i = 0; i < 4; ++i ) {
+		textures[i] = create_gxm_texture(16, 16, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	}
+
+	/* One texture retired after each of four frames */
+	for ( i = 0; i < 4; ++i ) {
+		DrawFrame(&textures[i], 1);
+		PSP2_RetireTexture(&retired, textures[i]);
+	}
+	CHECK(retired.count == 4);
+	CHECK(CountTextures() == 4);
+
+	/* The first frame completed when the fourth was submitted */
+	CHECK(PSP2_ReclaimTextures(&retired) == 1);
+	CHECK(CountTextures() == 3);
+	for ( i = 0; i < 3; ++i ) {
+		DrawFrame(NULL, 0);
+		CHECK(PSP2_ReclaimTextures(&retired) == 1);
+		CHECK(CountTextures() == 2 - i);
+	}
+
+	/* With the GPU idle a texture is freed right away */
+	textures[0] = create_gxm_texture(16, 16, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	gxm_wait_rendering_done();
+	PSP2_RetireTexture(&retired, textures[0]);
+	CHECK(retired.count == 0);
+	CHECK(CountTextures() == 0);
+
+	PSP2_DrainRetireQueue(&retired);
+	gxm_host_set_gpu_latency(0);
+	gxm_finish();
+}
+
+static void TestDrain(void)
+{
+	PSP2_RetireQueue retired = { NULL, 0, 0 };
+	gxm_texture *texture;
+
+	printf("Testing shutdown\n");
+
+	gxm_init();
+	gxm_host_set_gpu_latency(2);
+	texture = create_gxm_texture(16, 16, SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	DrawFrame(&texture, 1);
+	PSP2_RetireTexture(&retired, texture);
+	CHECK(CountTextures() == 1);
+
+	/* Waits for the GPU once, then everything is gone */
+	gxm_host_clear_calls();
+	PSP2_DrainRetireQueue(&retired);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 1);
+	CHECK(CountTextures() == 0);
+	CHECK(retired.entries == NULL && retired.count == 0);
+
+	gxm_host_set_gpu_latency(0);
+	gxm_finish();
+}
+
+int main(int argc, char *argv[])
+{
+	TestUnload();
+	TestOrder();
+	TestDrain();
+
+	return(CheckResult());
+}
@@ -0,0 +1,423 @@
+/* Tests the psp2 GPU YUV overlays against the host gxm stand-in, which
+   converts YUV textures the way SDL_yuv_sw.c does.
+
+   Built from src/video/psp2/SDL_psp2yuv.c and the host gxm stand-in, see
+   Makefile.in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_render_vita_gxm_tools.h"
+#include "SDL_psp2yuv_c.h"
+
+#define SCREEN_WIDTH	64
+#define SCREEN_HEIGHT	48
+
+/* Just enough of a psp2 video device for the overlays */
+static SDL_VideoDevice device;
+static struct SDL_PrivateVideoData hidden;
+static private_hwdata screen_hwdata;
+static SDL_Rect updated;
+static int num_updates;
+
+static void UpdateRects(SDL_VideoDevice *this, int numrects, SDL_Rect *rects)
+{
+	updated = rects[numrects - 1];
+	++num_updates;
+}
+
+static SDL_Surface *CreateScreen(SceGxmTextureFormat format)
+{
+	SDL_Surface *screen;
+
+	gxm_init();
+	SDL_memset(&device, 0, sizeof(device));
+	SDL_memset(&hidden, 0, sizeof(hidden));
+	SDL_memset(&screen_hwdata, 0, sizeof(screen_hwdata));
+	screen = SDL_CreateRGBSurface(SDL_SWSURFACE, SCREEN_WIDTH, SCREEN_HEIGHT,
+	                              32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0);
+	screen_hwdata.texture = create_gxm_texture(SCREEN_WIDTH, SCREEN_HEIGHT, format);
+	screen->hwdata = &screen_hwdata;
+	device.screen = screen;
+	device.hidden = &hidden;
+	device.UpdateRects = UpdateRects;
+	num_updates = 0;
+	return screen;
+}
+
+static void FreeScreen(SDL_Surface *screen)
+{
+	PSP2_QuitGPUBlits();
+	PSP2_DrainRetireQueue(&hidden.retired);
+	free_gxm_texture(screen_hwdata.texture);
+	screen->hwdata = NULL;
+	SDL_FreeSurface(screen);
+	gxm_host_set_gpu_latency(0);
+	gxm_finish();
+}
+
+static int CountOps(gxm_host_op op)
+{
+	const gxm_host_call *calls;
+	int num = gxm_host_get_calls(&calls);
+	int i, count = 0;
+
+	for ( i = 0; i < num; ++i ) {
+		if ( calls[i].op == op ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+static int CountTextures(void)
+{
+	gxm_heap_stats stats;
+
+	gxm_get_texture_memory_stats(&stats);
+	return stats.allocations;
+}
+
+static Uint32 ScreenPixel(int x, int y)
+{
+	const Uint8 *row = (const Uint8 *)gxm_texture_get_datap(screen_hwdata.texture) +
+	                   y * gxm_texture_get_stride(screen_hwdata.texture);
+	return ((const Uint32 *)row)[x];
+}
+
+/* The test pattern, every pixel different enough to catch mixed up planes */
+static Uint8 PatternY(int x, int y)
+{
+	return (Uint8)(16 + x * 5 + y * 3);
+}
+
+static Uint8 PatternU(int x, int y)
+{
+	return (Uint8)(40 + x * 11);
+}
+
+static Uint8 PatternV(int x, int y)
+{
+	return (Uint8)(220 - y * 9);
+}
+
+/* Full range BT.601, with a bit of slack for rounding */
+static int MatchesPattern(Uint32 pixel, int x, int y)
+{
+	const float l = PatternY(x, y);
+	const float u = PatternU(x / 2, y / 2) - 128.0f;
+	const float v = PatternV(x / 2, y / 2) - 128.0f;
+	const float rgb[3] = {
+		l + 1.402f * v,
+		l - 0.344f * u - 0.714f * v,
+		l + 1.772f * u
+	};
+	int i;
+
+	for ( i = 0; i < 3; ++i ) {
+		int expected = (int)(SDL_max(0.0f, SDL_min(rgb[i], 255.0f)) + 0.5f);
+		int actual = (pixel >> (8 * i)) & 0xFF;
+
+		if ( SDL_abs(expected - actual) > 1 ) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Writes the pattern through the planes the overlay hands out. Packed
+   formats share the chroma of the pattern's 2x2 blocks too. */
+static void FillOverlay(SDL_Overlay *overlay)
+{
+	int x, y;
+
+	CHECK(overlay->hwfuncs->Lock(&device, overlay) == 0);
+	for ( y = 0; y < overlay->h; ++y ) {
+		for ( x = 0; x < overlay->w; ++x ) {
+			const Uint8 l = PatternY(x, y);
+			const Uint8 u = PatternU(x / 2, y / 2);
+			const Uint8 v = PatternV(x / 2, y / 2);
+			Uint8 *group = overlay->pixels[0] + y * overlay->pitches[0] +
+			               (x & ~1) * 2;
+
+			switch (overlay->format) {
+			    case SDL_YV12_OVERLAY:
+			    case SDL_IYUV_OVERLAY: {
+				int uplane = (overlay->format == SDL_IYUV_OVERLAY) ? 1 : 2;
+				overlay->pixels[0][y * overlay->pitches[0] + x] = l;
+				overlay->pixels[uplane][(y / 2) * overlay->pitches[uplane] + x / 2] = u;
+				overlay->pixels[3 - uplane][(y / 2) * overlay->pitches[3 - uplane] + x / 2] = v;
+				break;
+			    }
+			    case SDL_YUY2_OVERLAY:
+				group[(x & 1) * 2] = l;
+				group[1] = u;
+				group[3] = v;
+				break;
+			    case SDL_UYVY_OVERLAY:
+				group[(x & 1) * 2 + 1] = l;
+				group[0] = u;
+				group[2] = v;
+				break;
+			    case SDL_YVYU_OVERLAY:
+				group[(x & 1) * 2] = l;
+				group[1] = v;
+				group[3] = u;
+				break;
+			}
+		}
+	}
+	overlay->hwfuncs->Unlock(&device, overlay);
+}
+
+static SDL_Rect MakeRect(int x, int y, int w, int h)
+{
+	SDL_Rect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.w = w;
+	rect.h = h;
+	return rect;
+}
+
+static void TestFormats(void)
+{
+	static const Uint32 formats[] = {
+		SDL_YV12_OVERLAY, SDL_IYUV_OVERLAY,
+		SDL_YUY2_OVERLAY, SDL_UYVY_OVERLAY, SDL_YVYU_OVERLAY
+	};
+	int i, x, y;
+
+	printf("Testing the overlay formats\n");
+
+	for ( i = 0; i < SDL_arraysize(formats); ++i ) {
+		SDL_Surface *screen = CreateScreen(SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+		SDL_Overlay *overlay;
+		SDL_Rect src, dst;
+		int diff = 0, outside = 0;
+
+		/* Not a multiple of 8 wide, so the pitches are padded */
+		overlay = PSP2_CreateGPUOverlay(&device, 34, 20, formats[i], screen);
+		CHECK(overlay != NULL);
+		if ( overlay == NULL ) {
+			FreeScreen(screen);
+			continue;
+		}
+		CHECK(overlay->hw_overlay);
+		if ( formats[i] == SDL_YV12_OVERLAY || formats[i] == SDL_IYUV_OVERLAY ) {
+			CHECK(overlay->planes == 3);
+			CHECK(overlay->pitches[0] == 40);
+			CHECK(overlay->pitches[1] == 20 && overlay->pitches[2] == 20);
+		} else {
+			CHECK(overlay->planes == 1);
+			CHECK(overlay->pitches[0] == 80);
+		}
+		FillOverlay(overlay);
+
+		src = MakeRect(0, 0, 34, 20);
+		dst = MakeRect(3, 5, 34, 20);
+		gxm_host_clear_calls();
+		CHECK(overlay->hwfuncs->Display(&device, overlay, &src, &dst) == 0);
+		CHECK(CountOps(GXM_HOST_DRAW_QUADS) == 1);
+		CHECK(num_updates == 1 && updated.x == 3 && updated.w == 34);
+		gxm_wait_rendering_done();
+
+		for ( y = 0; y < SCREEN_HEIGHT; ++y ) {
+			for ( x = 0; x < SCREEN_WIDTH; ++x ) {
+				Uint32 pixel = ScreenPixel(x, y);
+
+				if ( x < 3 || x >= 37 || y < 5 || y >= 25 ) {
+					outside += (pixel != 0);
+				} else if ( !MatchesPattern(pixel, x - 3, y - 5) ) {
+					++diff;
+				}
+			}
+		}
+		CHECK(diff == 0);
+		CHECK(outside == 0);
+
+		overlay->hwfuncs->FreeHW(&device, overlay);
+		SDL_free(overlay);
+		FreeScreen(screen);
+	}
+}
+
+static void TestScaling(void)
+{
+	SDL_Surface *screen = CreateScreen(SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	SDL_Overlay *overlay;
+	SDL_Rect src, dst;
+	int x, y, diff = 0;
+
+	printf("Testing scaling and clipping\n");
+
+	overlay = PSP2_CreateGPUOverlay(&device, 16, 8, SDL_YV12_OVERLAY, screen);
+	FillOverlay(overlay);
+
+	/* Twice the size */
+	src = MakeRect(0, 0, 16, 8);
+	dst = MakeRect(0, 0, 32, 16);
+	CHECK(overlay->hwfuncs->Display(&device, overlay, &src, &dst) == 0);
+	gxm_wait_rendering_done();
+	for ( y = 0; y < 16; ++y ) {
+		for ( x = 0; x < 32; ++x ) {
+			diff += !MatchesPattern(ScreenPixel(x, y), x / 2, y / 2);
+		}
+	}
+	CHECK(diff == 0);
+
+	/* Part of the overlay, like SDL_DisplayYUVOverlay clips it */
+	src = MakeRect(4, 2, 8, 4);
+	dst = MakeRect(40, 20, 8, 4);
+	diff = 0;
+	CHECK(overlay->hwfuncs->Display(&device, overlay, &src, &dst) == 0);
+	gxm_wait_rendering_done();
+	for ( y = 0; y < 4; ++y ) {
+		for ( x = 0; x < 8; ++x ) {
+			diff += !MatchesPattern(ScreenPixel(40 + x, 20 + y), 4 + x, 2 + y);
+		}
+	}
+	CHECK(diff == 0);
+
+	overlay->hwfuncs->FreeHW(&device, overlay);
+	SDL_free(overlay);
+	FreeScreen(screen);
+}
+
+/* One frame of a movie: decode into the overlay, display, flip. Returns
+   where the frame went. */
+static Uint8 *PlayFrame(SDL_Overlay *overlay)
+{
+	SDL_Rect src = MakeRect(0, 0, overlay->w, overlay->h);
+	Uint8 *pixels;
+
+	overlay->hwfuncs->Lock(&device, overlay);
+	pixels = overlay->pixels[0];
+	SDL_memset(pixels, 0x80, overlay->pitches[0] * overlay->h);
+	overlay->hwfuncs->Unlock(&device, overlay);
+	overlay->hwfuncs->Display(&device, overlay, &src, &src);
+	gxm_start_drawing();
+	gxm_draw_texture(screen_hwdata.texture);
+	gxm_end_drawing();
+	gxm_swap_buffers();
+	return pixels;
+}
+
+static void TestRotation(void)
+{
+	SDL_Surface *screen = CreateScreen(SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	SDL_Overlay *overlay;
+	Uint8 *planes[3];
+	int i;
+
+	printf("Testing texture rotation\n");
+
+	/* Locked before the CPU draws to it, as with GPU blits */
+	screen->flags |= SDL_HWSURFACE;
+	overlay = PSP2_CreateGPUOverlay(&device, 32, 16, SDL_YUY2_OVERLAY, screen);
+	CHECK(CountTextures() == 1 + PSP2_YUV_TEXTURES);
+
+	/* With the GPU a frame behind the app never waits */
+	gxm_host_set_gpu_latency(1);
+	gxm_host_clear_calls();
+	for ( i = 0; i < 3; ++i ) {
+		planes[i] = PlayFrame(overlay);
+	}
+	overlay->hwfuncs->Lock(&device, overlay);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 0);
+	CHECK(CountOps(GXM_HOST_WAIT_RENDERING_DONE) == 0);
+	CHECK(planes[0] != planes[1] && planes[0] == planes[2]);
+	CHECK(overlay->pixels[0] == planes[1]);
+
+	/* Locking again without displaying keeps the planes */
+	overlay->hwfuncs->Lock(&device, overlay);
+	CHECK(overlay->pixels[0] == planes[1]);
+
+	/* Further behind, it waits for the texture it moves to */
+	gxm_host_set_gpu_latency(4);
+	PlayFrame(overlay);
+	PlayFrame(overlay);
+	gxm_host_clear_calls();
+	overlay->hwfuncs->Lock(&device, overlay);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 1);
+
+	/* Freeing it doesn't wait either */
+	PlayFrame(overlay);
+	gxm_host_clear_calls();
+	overlay->hwfuncs->FreeHW(&device, overlay);
+	SDL_free(overlay);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 0);
+	CHECK(CountTextures() == 1 + PSP2_YUV_TEXTURES);
+	for ( i = 0; i < 4; ++i ) {
+		gxm_start_drawing();
+		gxm_end_drawing();
+	}
+	PSP2_ReclaimTextures(&hidden.retired);
+	CHECK(CountTextures() == 1);
+
+	FreeScreen(screen);
+}
+
+/* The CPU may draw to a software screen right after the overlay */
+static void TestSoftwareScreen(void)
+{
+	SDL_Surface *screen = CreateScreen(SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	SDL_Overlay *overlay;
+	SDL_Rect rect = MakeRect(0, 0, 16, 8);
+	int x, y, diff = 0;
+
+	printf("Testing a software screen\n");
+
+	overlay = PSP2_CreateGPUOverlay(&device, 16, 8, SDL_YV12_OVERLAY, screen);
+	FillOverlay(overlay);
+	gxm_host_set_gpu_latency(4);
+	gxm_host_clear_calls();
+	CHECK(overlay->hwfuncs->Display(&device, overlay, &rect, &rect) == 0);
+	CHECK(CountOps(GXM_HOST_WAIT_FENCE) == 1);
+	for ( y = 0; y < 8; ++y ) {
+		for ( x = 0; x < 16; ++x ) {
+			diff += !MatchesPattern(ScreenPixel(x, y), x, y);
+		}
+	}
+	CHECK(diff == 0);
+
+	overlay->hwfuncs->FreeHW(&device, overlay);
+	SDL_free(overlay);
+	FreeScreen(screen);
+}
+
+static void TestFallback(void)
+{
+	SDL_Surface *screen = CreateScreen(SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+	SDL_Surface *other;
+
+	printf("Testing what is left to software overlays\n");
+
+	CHECK(PSP2_CreateGPUOverlay(&device, 33, 16, SDL_YV12_OVERLAY, screen) == NULL);
+	CHECK(PSP2_CreateGPUOverlay(&device, 32, 16, SDL_YVYU_OVERLAY + 1, screen) == NULL);
+	other = SDL_CreateRGBSurface(SDL_SWSURFACE, 32, 16, 32, 0, 0, 0, 0);
+	CHECK(PSP2_CreateGPUOverlay(&device, 32, 16, SDL_YV12_OVERLAY, other) == NULL);
+	SDL_FreeSurface(other);
+	CHECK(CountTextures() == 1);
+	FreeScreen(screen);
+
+	/* The GPU can't draw into 24 bit textures */
+	screen = CreateScreen(SCE_GXM_TEXTURE_FORMAT_U8U8U8_RGB);
+	CHECK(PSP2_CreateGPUOverlay(&device, 32, 16, SDL_YV12_OVERLAY, screen) == NULL);
+	FreeScreen(screen);
+}
+
+int main(int argc, char *argv[])
+{
+	TestFormats();
+	TestScaling();
+	TestRotation();
+	TestSoftwareScreen();
+	TestFallback();
+
+	return(CheckResult());
+}
@@ -0,0 +1,215 @@
+/* Checks the audio queue: testqueueaudio [samples]
+
+   The samples are queued in pieces of random size while the disk audio
+   driver takes them as fast as it can, then the file it wrote is checked
+   for every sample in order, with only silence from underruns between.
+   The latency from queueing a buffer until the audio thread has taken
+   it is measured on the dummy audio driver, which plays in real time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#define RATE		22050
+#define SAMPLES		512
+#define OUTFILE		"testqueueaudio.raw"
+#define LATENCY_RUNS	20
+
+static void SDLCALL Callback(void *userdata, Uint8 *stream, int len)
+{
+}
+
+static int Open(const char *driver, void (SDLCALL *callback)(void *, Uint8 *, int))
+{
+	static char env[64];	/* putenv() keeps the string */
+	SDL_AudioSpec spec;
+
+	SDL_snprintf(env, sizeof(env), "SDL_AUDIODRIVER=%s", driver);
+	SDL_putenv(env);
+	spec.freq = RATE;
+	spec.format = AUDIO_S16SYS;
+	spec.channels = 1;
+	spec.samples = SAMPLES;
+	spec.callback = callback;
+	spec.userdata = NULL;
+	if ( SDL_OpenAudio(&spec, NULL) < 0 ) {
+		printf("Couldn't open %s audio: %s\n", driver, SDL_GetError());
+		++failures;
+		return(-1);
+	}
+	return(0);
+}
+
+/* The queue is only there without a callback */
+static void TestErrors(void)
+{
+	Sint16 data[16];
+
+	SDL_memset(data, 0, sizeof(data));
+	CHECK(SDL_QueueAudio(data, sizeof(data)) == -1);
+	CHECK(SDL_GetQueuedAudioSize() == 0);
+	CHECK(SDL_GetAudioUnderruns() == 0);
+	if ( Open("dummy", Callback) == 0 ) {
+		CHECK(SDL_QueueAudio(data, sizeof(data)) == -1);
+		CHECK(SDL_GetQueuedAudioSize() == 0);
+		SDL_CloseAudio();
+	}
+}
+
+/* Never silence, so the gaps from underruns can be told apart */
+static Sint16 Pattern(Uint32 i)
+{
+	return((Sint16)(i % 32767 + 1));
+}
+
+static void TestNoDrops(Uint32 total)
+{
+	Sint16 *data;
+	Uint32 i, piece, underruns, transitions;
+	Sint16 sample;
+	int playing;
+	FILE *fp;
+
+	data = (Sint16 *)malloc(total * sizeof(Sint16));
+	if ( !data ) {
+		printf("Out of memory\n");
+		++failures;
+		return;
+	}
+	for ( i = 0; i < total; ++i ) {
+		data[i] = Pattern(i);
+	}
+
+	SDL_putenv("SDL_DISKAUDIOFILE=" OUTFILE);
+	SDL_putenv("SDL_DISKAUDIODELAY=1");
+	if ( Open("disk", NULL) < 0 ) {
+		free(data);
+		return;
+	}
+
+	/* Cleared data must never be played, -1 isn't in the pattern */
+	for ( i = 0; i < 3000; ++i ) {
+		CHECK(SDL_QueueAudio("\377\377", 2) == 0);
+	}
+	CHECK(SDL_GetQueuedAudioSize() == 6000);
+	SDL_ClearQueuedAudio();
+	CHECK(SDL_GetQueuedAudioSize() == 0);
+
+	/* Keep a few buffers queued, so some run dry and some don't */
+	srand(1);
+	SDL_PauseAudio(0);
+	for ( i = 0; i < total; i += piece ) {
+		piece = 1 + rand() % 2000;
+		if ( piece > total - i ) {
+			piece = total - i;
+		}
+		CHECK(SDL_QueueAudio(data + i, piece * sizeof(Sint16)) == 0);
+		if ( rand() % 8 == 0 ) {
+			SDL_Delay(5);
+		}
+		while ( SDL_GetQueuedAudioSize() > 4 * SAMPLES * sizeof(Sint16) ) {
+			SDL_Delay(1);
+		}
+	}
+	while ( SDL_GetQueuedAudioSize() > 0 ) {
+		SDL_Delay(1);
+	}
+	SDL_Delay(50);
+	underruns = SDL_GetAudioUnderruns();
+	SDL_CloseAudio();
+	free(data);
+
+	/* Every sample in order, counting where the data stops */
+	fp = fopen(OUTFILE, "rb");
+	CHECK(fp != NULL);
+	if ( !fp ) {
+		return;
+	}
+	i = 0;
+	transitions = 0;
+	playing = 0;
+	while ( fread(&sample, sizeof(sample), 1, fp) == 1 ) {
+		if ( sample == 0 ) {
+			transitions += playing;
+			playing = 0;
+			continue;
+		}
+		if ( i == total || sample != Pattern(i) ) {
+			printf("Sample %u is %d\n", i, sample);
+			CHECK(!"in order");
+			break;
+		}
+		playing = 1;
+		++i;
+	}
+	fclose(fp);
+	remove(OUTFILE);
+	printf("%u samples played, %u underruns\n", i, underruns);
+	CHECK(i == total);
+	CHECK(transitions == underruns);
+}
+
+static void TestLatency(void)
+{
+	Sint16 data[SAMPLES];
+	Uint64 start, us, total = 0, worst = 0;
+	Uint64 period = (Uint64)SAMPLES * 1000000 / RATE;
+	Uint32 underruns;
+	int i;
+
+	if ( Open("dummy", NULL) < 0 ) {
+		return;
+	}
+	for ( i = 0; i < SAMPLES; ++i ) {
+		data[i] = Pattern(i);
+	}
+	SDL_PauseAudio(0);
+	for ( i = 0; i < LATENCY_RUNS; ++i ) {
+		SDL_Delay(i % 7);
+		start = SDL_GetTicksUS();
+		CHECK(SDL_QueueAudio(data, sizeof(data)) == 0);
+		while ( SDL_GetQueuedAudioSize() > 0 ) {
+			SDL_Delay(1);
+		}
+		us = SDL_GetTicksUS() - start;
+		total += us;
+		if ( us > worst ) {
+			worst = us;
+		}
+	}
+	underruns = SDL_GetAudioUnderruns();
+	SDL_CloseAudio();
+
+	/* Taken at the next buffer, which is at most one period away */
+	printf("Queue to audio thread: %.1f ms average, %.1f ms worst, "
+	       "%.1f ms buffers, %u underruns\n", total / 1000.0 / LATENCY_RUNS,
+	       worst / 1000.0, period / 1000.0, underruns);
+	CHECK(worst < 4 * period + 50000);
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 total = 4 * RATE;
+
+	if ( argc > 1 ) {
+		total = (Uint32)atoi(argv[1]);
+		if ( atoi(argv[1]) <= 0 ) {
+			fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestErrors();
+	TestNoDrops(total);
+	TestLatency();
+	SDL_Quit();
+
+	return(CheckResult());
+}
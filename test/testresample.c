@@ -0,0 +1,335 @@
+/* Measures the signal to noise ratio of the sinc resampler and times it:
+   testresample [seconds]
+
+   Built from src/audio/SDL_resample.c, see Makefile.in. Sine tones are
+   converted between the common rates the SDL_RateMUL2/SDL_RateDIV2 chain
+   can't do, and compared with the same tones computed at the new rate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_resample_c.h"
+
+#define TONE_FRAMES	8192
+#define AMPLITUDE	16384.0
+
+static const char *quality_names[SDL_RESAMPLE_QUALITIES] = {
+	"fast", "medium", "best"
+};
+
+/* Lowest SNR in dB, for tones up to the given part of the lower rate.
+   Higher tones are attenuated by the lowpass, that counts as noise here.
+ */
+static const double min_snr[SDL_RESAMPLE_QUALITIES] = { 45.0, 68.0, 85.0 };
+static const double max_tone[SDL_RESAMPLE_QUALITIES] = { 0.2, 0.3, 0.35 };
+
+static const struct {
+	int src_rate, dst_rate;
+} rates[] = {
+	{ 44100, 48000 },
+	{ 48000, 44100 },
+	{ 22050, 48000 },
+	{ 32000, 44100 },
+	{ 8000, 48000 },
+	{ 48000, 11025 },
+};
+
+static void MakeTone(Sint16 *buf, int frames, int channels,
+                     double freq, int rate)
+{
+	int i, c;
+
+	for ( i = 0; i < frames; ++i ) {
+		for ( c = 0; c < channels; ++c ) {
+			/* A different phase per channel, to catch them mixing up */
+			double v = AMPLITUDE * sin(2.0 * M_PI * freq * i / rate + c);
+			buf[i * channels + c] = (Sint16)floor(v + 0.5);
+		}
+	}
+}
+
+/* Compares with the ideal tone, away from the ends where the buffer
+   conversion fades in and out
+ */
+static double ToneSNR(const Sint16 *buf, int frames, int channels,
+                      double freq, int rate, int margin)
+{
+	double signal = 0.0, noise = 0.0;
+	int i, c;
+
+	for ( i = margin; i < frames - margin; ++i ) {
+		for ( c = 0; c < channels; ++c ) {
+			double ref = AMPLITUDE * sin(2.0 * M_PI * freq * i / rate + c);
+			double err = buf[i * channels + c] - ref;
+
+			signal += ref * ref;
+			noise += err * err;
+		}
+	}
+	if ( noise == 0.0 ) {
+		return 200.0;
+	}
+	return 10.0 * log10(signal / noise);
+}
+
+static double Level(const Sint16 *buf, int frames, int channels, int margin)
+{
+	double sum = 0.0;
+	int i;
+
+	for ( i = margin * channels; i < (frames - margin) * channels; ++i ) {
+		sum += (double)buf[i] * buf[i];
+	}
+	sum /= (frames - 2 * margin) * channels;
+	return 10.0 * log10(sum / (AMPLITUDE * AMPLITUDE / 2.0) + 1e-20);
+}
+
+static void TestSNR(int quality)
+{
+	const int channels = 2;
+	Sint16 *in = (Sint16 *)malloc(TONE_FRAMES * channels * sizeof(Sint16));
+	Sint16 *out = (Sint16 *)malloc(TONE_FRAMES * 8 * channels * sizeof(Sint16));
+	int r;
+
+	for ( r = 0; r < SDL_arraysize(rates); ++r ) {
+		const int src_rate = rates[r].src_rate;
+		const int dst_rate = rates[r].dst_rate;
+		const int lo_rate = (src_rate < dst_rate) ? src_rate : dst_rate;
+		const double rate_incr = (double)src_rate / dst_rate;
+		const double tones[] = { 0.01, 0.05, 0.1, 0.2, 0.3, 0.35 };
+		double worst = 200.0;
+		int t, frames;
+
+		CHECK(SDL_NeedsResampler(src_rate, dst_rate));
+		for ( t = 0; t < SDL_arraysize(tones); ++t ) {
+			const double freq = tones[t] * lo_rate;
+			double snr;
+
+			if ( tones[t] > max_tone[quality] ) {
+				break;
+			}
+
+			MakeTone(in, TONE_FRAMES, channels, freq, src_rate);
+			frames = SDL_ResampleBuffer(quality, channels, rate_incr,
+			                            in, TONE_FRAMES, out);
+			CHECK(frames == SDL_ResampleLength(rate_incr, TONE_FRAMES));
+			snr = ToneSNR(out, frames, channels, freq, dst_rate,
+			              frames / 8);
+			if ( snr < worst ) {
+				worst = snr;
+			}
+		}
+		printf("%-6s %5d -> %5d: SNR %5.1f dB up to %.0f Hz",
+		       quality_names[quality], src_rate, dst_rate, worst,
+		       max_tone[quality] * lo_rate);
+		CHECK(worst >= min_snr[quality]);
+
+		/* A tone well past the new Nyquist rate must not alias back,
+		   closer to it the filter is still rolling off */
+		if ( src_rate >= 2 * dst_rate ) {
+			const double freq = 0.65 * dst_rate;
+			double level;
+
+			MakeTone(in, TONE_FRAMES, channels, freq, src_rate);
+			frames = SDL_ResampleBuffer(quality, channels, rate_incr,
+			                            in, TONE_FRAMES, out);
+			level = Level(out, frames, channels, frames / 8);
+			printf(", %.0f Hz at %5.1f dB", freq, level);
+			CHECK(level < -min_snr[quality]);
+		}
+		printf("\n");
+	}
+	free(out);
+	free(in);
+}
+
+/* Taking the output in device sized blocks must give exactly what a whole
+   buffer conversion gives, the blocks only hold back the lookahead
+ */
+static void TestStreaming(int quality)
+{
+	const int channels = 2;
+	const int period = 1024;	/* SDL_RunAudio block */
+	const int chunk = 941;		/* callback block */
+	const int src_rate = 44100, dst_rate = 48000;
+	const double rate_incr = (double)src_rate / dst_rate;
+	const int in_frames = 40 * chunk;
+	Sint16 *in = (Sint16 *)malloc(in_frames * channels * sizeof(Sint16));
+	Sint16 *whole = (Sint16 *)malloc(2 * in_frames * channels * sizeof(Sint16));
+	Sint16 *streamed = (Sint16 *)malloc(2 * in_frames * channels * sizeof(Sint16));
+	SDL_Resampler *resampler;
+	int i, put = 0, got = 0, calls = 0;
+
+	for ( i = 0; i < in_frames * channels; ++i ) {
+		in[i] = (Sint16)((rand() % 65536) - 32768);
+	}
+	SDL_ResampleBuffer(quality, channels, rate_incr, in, in_frames, whole);
+
+	resampler = SDL_NewResampler(quality, channels, rate_incr, period, chunk);
+	CHECK(resampler != NULL);
+	if ( resampler == NULL ) {
+		return;
+	}
+	while ( put + chunk <= in_frames ) {
+		while ( SDL_ResamplerNeeded(resampler, period) > 0 &&
+		        put + chunk <= in_frames ) {
+			CHECK(SDL_ResamplerPut(resampler, in + put * channels, chunk) == 0);
+			put += chunk;
+			++calls;
+		}
+		if ( SDL_ResamplerNeeded(resampler, period) > 0 ) {
+			break;
+		}
+		CHECK(SDL_ResamplerGet(resampler, streamed + got * channels, period) == period);
+		got += period;
+	}
+	CHECK(got > in_frames);
+	CHECK(SDL_memcmp(whole, streamed, got * channels * sizeof(Sint16)) == 0);
+	printf("%-6s streamed %d frames from %d callbacks, same as one buffer\n",
+	       quality_names[quality], got, calls);
+
+	/* Asking for more than was put in fails */
+	CHECK(SDL_ResamplerGet(resampler, streamed, 2 * period) == -1);
+
+	SDL_FreeResampler(resampler);
+	free(streamed);
+	free(whole);
+	free(in);
+}
+
+/* Converts through the public API, from 16 bit mono to each format in
+   stereo, and checks the length and that nothing is written past
+   len*len_mult
+ */
+static void TestAudioCVT(void)
+{
+	const Uint16 formats[] = {
+		AUDIO_U8, AUDIO_S8, AUDIO_S16LSB, AUDIO_S16MSB, AUDIO_U16LSB
+	};
+	const int frames = 4410;
+	int f;
+
+	for ( f = 0; f < SDL_arraysize(formats); ++f ) {
+		SDL_AudioCVT cvt;
+		Sint16 *tone;
+		int size, i, bytes;
+
+		CHECK(SDL_BuildAudioCVT(&cvt, AUDIO_S16SYS, 1, 44100,
+		                        formats[f], 2, 48000) == 1);
+		cvt.len = frames * 2;
+		size = cvt.len * cvt.len_mult;
+		cvt.buf = (Uint8 *)malloc(size + 64);
+		SDL_memset(cvt.buf + size, 0xA5, 64);
+		tone = (Sint16 *)cvt.buf;
+		for ( i = 0; i < frames; ++i ) {
+			tone[i] = (Sint16)floor(AMPLITUDE * sin(2.0 * M_PI * 1000.0 * i / 44100) + 0.5);
+		}
+		CHECK(SDL_ConvertAudio(&cvt) == 0);
+
+		bytes = (formats[f] & 0xFF) / 8;
+		CHECK(cvt.len_cvt == SDL_ResampleLength(44100.0 / 48000, frames) * 2 * bytes);
+		CHECK(cvt.len_cvt == (int)(cvt.len * cvt.len_ratio + 0.5));
+		for ( i = 0; i < 64; ++i ) {
+			CHECK(cvt.buf[size + i] == 0xA5);
+		}
+
+		/* Back to 16 bit native, to measure it */
+		if ( formats[f] != AUDIO_S16SYS ) {
+			SDL_AudioCVT back;
+			Uint8 *buf = (Uint8 *)malloc(cvt.len_cvt * 2);
+
+			SDL_BuildAudioCVT(&back, formats[f], 2, 48000,
+			                  AUDIO_S16SYS, 2, 48000);
+			SDL_memcpy(buf, cvt.buf, cvt.len_cvt);
+			back.buf = buf;
+			back.len = cvt.len_cvt;
+			SDL_ConvertAudio(&back);
+			SDL_memcpy(cvt.buf, buf, back.len_cvt);
+			free(buf);
+		}
+		{
+			const int out = cvt.len_cvt / (2 * bytes);
+			Sint16 *left = (Sint16 *)malloc(out * sizeof(Sint16));
+			double snr;
+
+			for ( i = 0; i < out; ++i ) {
+				left[i] = ((Sint16 *)cvt.buf)[i * 2];
+				CHECK(((Sint16 *)cvt.buf)[i * 2 + 1] == left[i]);
+			}
+			snr = ToneSNR(left, out, 1, 1000.0, 48000, out / 8);
+			printf("SDL_ConvertAudio S16 mono 44100 -> %04X stereo 48000: SNR %.1f dB\n",
+			       formats[f], snr);
+			CHECK(snr >= ((bytes == 1) ? 35.0 : 65.0));
+			free(left);
+		}
+		free(cvt.buf);
+	}
+
+	/* Power of two ratios still take the old filters */
+	CHECK(!SDL_NeedsResampler(22050, 44100));
+	CHECK(!SDL_NeedsResampler(48000, 12000));
+	CHECK(!SDL_NeedsResampler(44100, 44100));
+}
+
+static void Benchmark(int quality, int seconds)
+{
+	const int channels = 2;
+	const int in_frames = 44100;
+	Sint16 *in = (Sint16 *)malloc(in_frames * channels * sizeof(Sint16));
+	Sint16 *out = (Sint16 *)malloc(2 * in_frames * channels * sizeof(Sint16));
+	Uint32 start, ticks;
+	int i;
+
+	MakeTone(in, in_frames, channels, 1000.0, 44100);
+	start = SDL_GetTicks();
+	for ( i = 0; i < seconds; ++i ) {
+		SDL_ResampleBuffer(quality, channels, 44100.0 / 48000,
+		                   in, in_frames, out);
+	}
+	ticks = SDL_GetTicks() - start;
+	printf("%-6s %d s of stereo 44100 -> 48000 in %u ms, %.0fx realtime\n",
+	       quality_names[quality], seconds, ticks,
+	       ticks ? (seconds * 1000.0) / ticks : 0.0);
+	free(out);
+	free(in);
+}
+
+int main(int argc, char *argv[])
+{
+	int seconds = 20;
+	int quality;
+
+	if ( argc > 1 ) {
+		seconds = atoi(argv[1]);
+		if ( seconds <= 0 ) {
+			fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	printf("Testing signal to noise ratios\n");
+	for ( quality = 0; quality < SDL_RESAMPLE_QUALITIES; ++quality ) {
+		TestSNR(quality);
+	}
+	printf("Testing streaming\n");
+	for ( quality = 0; quality < SDL_RESAMPLE_QUALITIES; ++quality ) {
+		TestStreaming(quality);
+	}
+	printf("Testing SDL_ConvertAudio\n");
+	TestAudioCVT();
+	for ( quality = 0; quality < SDL_RESAMPLE_QUALITIES; ++quality ) {
+		Benchmark(quality, seconds);
+	}
+	SDL_Quit();
+
+	return(CheckResult());
+}
@@ -0,0 +1,184 @@
+/* Creates threads with SDL_CreateThreadWithAttributes() and checks from
+   inside them that Linux gave them the stack, nice value, CPUs and name
+   asked for, then does the same for the timer thread through its
+   SDL_TIMER_THREAD_* environment variables: testthreadattr
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "SDL.h"
+#include "SDL_thread.h"
+#include "testcheck.h"
+
+/* What a thread finds out about itself */
+typedef struct Seen {
+	size_t stacksize;
+	int nice;
+	Uint32 cpumask;
+	char name[16];
+} Seen;
+
+static Uint32 CPUMask(pid_t tid)
+{
+	cpu_set_t cpus;
+	Uint32 mask = 0;
+	int i;
+
+	if ( sched_getaffinity(tid, sizeof(cpus), &cpus) < 0 ) {
+		return 0;
+	}
+	for ( i = 0; i < 32; ++i ) {
+		if ( CPU_ISSET(i, &cpus) ) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+}
+
+static int SDLCALL Look(void *data)
+{
+	Seen *seen = (Seen *)data;
+	pthread_attr_t attr;
+
+	pthread_getattr_np(pthread_self(), &attr);
+	pthread_attr_getstacksize(&attr, &seen->stacksize);
+	pthread_attr_destroy(&attr);
+	seen->nice = getpriority(PRIO_PROCESS, syscall(SYS_gettid));
+	seen->cpumask = CPUMask(0);
+	pthread_getname_np(pthread_self(), seen->name, sizeof(seen->name));
+	return(0);
+}
+
+static void Create(const SDL_ThreadAttributes *attr, Seen *seen)
+{
+	SDL_Thread *thread;
+
+	SDL_memset(seen, 0, sizeof(*seen));
+	thread = SDL_CreateThreadWithAttributes(Look, seen, attr);
+	CHECK(thread != NULL);
+	SDL_WaitThread(thread, NULL);
+}
+
+static void TestAttributes(Uint32 cpu)
+{
+	SDL_ThreadAttributes attr;
+	Seen plain, seen;
+
+	/* No attributes, the same as SDL_CreateThread() */
+	Create(NULL, &plain);
+	CHECK(plain.nice == getpriority(PRIO_PROCESS, 0));
+	CHECK(plain.cpumask == CPUMask(0));
+
+	SDL_memset(&attr, 0, sizeof(attr));
+	attr.name = "worker with a long name";
+	attr.stacksize = 1024 * 1024;
+	attr.priority = SDL_THREAD_PRIORITY_LOW;
+	attr.cpumask = cpu;
+	Create(&attr, &seen);
+	printf("Stack %u bytes, nice %d, CPU mask 0x%x, name \"%s\"\n",
+	       (unsigned)seen.stacksize, seen.nice, seen.cpumask, seen.name);
+	CHECK(seen.stacksize >= attr.stacksize && seen.stacksize != plain.stacksize);
+	CHECK(seen.nice == 10);
+	CHECK(seen.cpumask == cpu);
+	CHECK(strcmp(seen.name, "worker with a l") == 0);
+
+	/* Raising the priority is allowed to fail without privileges */
+	attr.priority = SDL_THREAD_PRIORITY_TIME_CRITICAL;
+	Create(&attr, &seen);
+	CHECK(seen.nice == -10 || seen.nice == plain.nice);
+
+	/* CPUs that aren't there */
+	attr.cpumask = 0x80000000;
+	CHECK(SDL_CreateThreadWithAttributes(Look, &seen, &attr) == NULL);
+	printf("Bad CPU mask: %s\n", SDL_GetError());
+
+	/* Priorities that aren't there */
+	attr.cpumask = 0;
+	attr.priority = (SDL_ThreadPriority)(SDL_THREAD_PRIORITY_TIME_CRITICAL + 1);
+	CHECK(SDL_CreateThreadWithAttributes(Look, &seen, &attr) == NULL);
+	printf("Bad priority: %s\n", SDL_GetError());
+	attr.priority = (SDL_ThreadPriority)-1;
+	CHECK(SDL_CreateThreadWithAttributes(Look, &seen, &attr) == NULL);
+}
+
+/* Finds the thread called 'name' in /proc */
+static pid_t FindThread(const char *name)
+{
+	DIR *dir = opendir("/proc/self/task");
+	struct dirent *entry;
+	char path[300], comm[32];
+	pid_t tid = 0;
+	FILE *fp;
+
+	while ( dir && !tid && (entry = readdir(dir)) != NULL ) {
+		SDL_snprintf(path, sizeof(path), "/proc/self/task/%s/comm", entry->d_name);
+		fp = fopen(path, "r");
+		if ( fp ) {
+			if ( fgets(comm, sizeof(comm), fp) &&
+			     strncmp(comm, name, strlen(name)) == 0 ) {
+				tid = atoi(entry->d_name);
+			}
+			fclose(fp);
+		}
+	}
+	if ( dir ) {
+		closedir(dir);
+	}
+	return tid;
+}
+
+static void TestTimerThread(Uint32 cpu)
+{
+	static char value[64];	/* putenv() keeps it */
+	pid_t tid;
+
+	SDL_snprintf(value, sizeof(value), "SDL_TIMER_THREAD_CPUMASK=0x%x", cpu);
+	SDL_putenv(value);
+	SDL_putenv("SDL_TIMER_THREAD_PRIORITY=low");
+	SDL_putenv("SDL_TIMER_THREAD_STACKSIZE=262144");
+	CHECK(SDL_InitSubSystem(SDL_INIT_TIMER) == 0);
+
+	tid = FindThread("SDL timer");
+	CHECK(tid != 0);
+	if ( tid ) {
+		printf("Timer thread %d: nice %d, CPU mask 0x%x\n",
+		       (int)tid, getpriority(PRIO_PROCESS, tid), CPUMask(tid));
+		CHECK(getpriority(PRIO_PROCESS, tid) == 10);
+		CHECK(CPUMask(tid) == cpu);
+	}
+	SDL_QuitSubSystem(SDL_INIT_TIMER);
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 cpus, cpu;
+
+	if ( argc > 1 ) {
+		fprintf(stderr, "Usage: %s\n", argv[0]);
+		return(1);
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	/* The last CPU we may run on, alone */
+	cpus = CPUMask(0);
+	for ( cpu = 0x80000000; cpu && !(cpus & cpu); cpu >>= 1 )
+		;
+	CHECK(cpu != 0);
+
+	TestAttributes(cpu);
+	TestTimerThread(cpu);
+	SDL_Quit();
+
+	return(CheckResult());
+}
@@ -0,0 +1,185 @@
+/* Tests SDL_ThreadPool, then measures what it costs to run a task and
+   how a parallel loop scales from 1 to N workers: testthreadpool [N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SDL.h"
+#include "SDL_thread.h"
+#include "testcheck.h"
+
+#define NUM_TASKS	100000
+#define NUM_ITEMS	(1<<20)
+
+static SDL_ThreadPool *pool;
+static int done;
+
+static void SDLCALL Count(void *data)
+{
+	__atomic_fetch_add((int *)data, 1, __ATOMIC_RELAXED);
+}
+
+static void SDLCALL Nothing(void *data)
+{
+}
+
+/* A task that submits children and waits for them, several levels deep */
+static void SDLCALL Spawn(void *data)
+{
+	int depth = (int)(size_t)data;
+	SDL_TaskCounter *children;
+	int i;
+
+	Count(&done);
+	if ( depth > 0 ) {
+		children = SDL_CreateTaskCounter();
+		for ( i = 0; i < 4; ++i ) {
+			SDL_SubmitTask(pool, Spawn, (void *)(size_t)(depth - 1), children);
+		}
+		SDL_WaitTasks(pool, children);
+		SDL_DestroyTaskCounter(children);
+	}
+}
+
+static Uint8 visited[NUM_ITEMS];
+
+static void SDLCALL Visit(void *data, int first, int last)
+{
+	int i;
+
+	for ( i = first; i < last; ++i ) {
+		++visited[i];
+	}
+	Count(data);
+}
+
+static void TestTasks(int workers)
+{
+	SDL_TaskCounter *counter = SDL_CreateTaskCounter();
+	int i, parts = 0;
+
+	/* Every task runs once */
+	done = 0;
+	for ( i = 0; i < NUM_TASKS; ++i ) {
+		CHECK(SDL_SubmitTask(pool, Count, &done, counter) == 0);
+	}
+	CHECK(SDL_WaitTasks(pool, counter) == 0);
+	CHECK(done == NUM_TASKS);
+
+	/* 1 + 4 + 16 + 64 + 256 tasks, each waiting for its children */
+	done = 0;
+	CHECK(SDL_SubmitTask(pool, Spawn, (void *)4, counter) == 0);
+	SDL_WaitTasks(pool, counter);
+	CHECK(done == 341);
+
+	/* Every item once, in parts no bigger than the grain */
+	SDL_memset(visited, 0, sizeof(visited));
+	CHECK(SDL_ParallelFor(pool, 0, NUM_ITEMS, 1000, Visit, &parts, NULL) == 0);
+	for ( i = 0; i < NUM_ITEMS && visited[i] == 1; ++i )
+		;
+	CHECK(i == NUM_ITEMS);
+	CHECK(parts >= NUM_ITEMS / 1000 && parts <= 2 * NUM_ITEMS / 1000);
+
+	/* With a counter it returns at once, an empty range does nothing */
+	parts = 0;
+	CHECK(SDL_ParallelFor(pool, 10, NUM_ITEMS, 0, Visit, &parts, counter) == 0);
+	CHECK(SDL_ParallelFor(pool, 5, 5, 0, Visit, &parts, counter) == 0);
+	SDL_WaitTasks(pool, counter);
+	for ( i = 10; i < NUM_ITEMS && visited[i] == 2; ++i )
+		;
+	CHECK(i == NUM_ITEMS && visited[9] == 1);
+	CHECK(parts >= 4 * workers);
+
+	SDL_DestroyTaskCounter(counter);
+}
+
+/* Nanoseconds to submit an empty task and wait for it, in bulk */
+static double Dispatch(void)
+{
+	SDL_TaskCounter *counter = SDL_CreateTaskCounter();
+	Uint64 start;
+	int i;
+
+	start = SDL_GetTicksUS();
+	for ( i = 0; i < NUM_TASKS; ++i ) {
+		SDL_SubmitTask(pool, Nothing, NULL, counter);
+	}
+	SDL_WaitTasks(pool, counter);
+	SDL_DestroyTaskCounter(counter);
+	return (double)(SDL_GetTicksUS() - start) * 1000.0 / NUM_TASKS;
+}
+
+static float input[NUM_ITEMS], output[NUM_ITEMS];
+
+static void SDLCALL Work(void *data, int first, int last)
+{
+	float x;
+	int i, j;
+
+	for ( i = first; i < last; ++i ) {
+		x = input[i];
+		for ( j = 0; j < 16; ++j ) {
+			x = sinf(x) * 0.5f + sqrtf(x * x + 1.0f);
+		}
+		output[i] = x;
+	}
+}
+
+static Uint64 Loop(void)
+{
+	Uint64 start = SDL_GetTicksUS();
+
+	SDL_ParallelFor(pool, 0, NUM_ITEMS, 0, Work, NULL, NULL);
+	return SDL_GetTicksUS() - start;
+}
+
+int main(int argc, char *argv[])
+{
+	Uint64 serial, parallel;
+	int i, workers, maxworkers = 4;
+
+	if ( argc > 1 ) {
+		maxworkers = atoi(argv[1]);
+		if ( maxworkers <= 0 ) {
+			fprintf(stderr, "Usage: %s [workers]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	CHECK(SDL_CreateThreadPool(0, NULL) == NULL);
+	for ( i = 0; i < NUM_ITEMS; ++i ) {
+		input[i] = (float)i;
+	}
+	serial = SDL_GetTicksUS();
+	Work(NULL, 0, NUM_ITEMS);
+	serial = SDL_GetTicksUS() - serial;
+
+	for ( workers = 1; workers <= maxworkers; ++workers ) {
+		pool = SDL_CreateThreadPool(workers, NULL);
+		CHECK(pool != NULL);
+		if ( pool == NULL ) {
+			break;
+		}
+		TestTasks(workers);
+		Loop();
+		parallel = Loop();
+		printf("%d workers: %.0f ns per task, loop %.2f ms, %.2fx the serial loop\n",
+		       workers, Dispatch(), parallel / 1000.0, (double)serial / parallel);
+
+		/* Tasks still queued are run before the pool goes */
+		done = 0;
+		for ( i = 0; i < 1000; ++i ) {
+			SDL_SubmitTask(pool, Count, &done, NULL);
+		}
+		SDL_DestroyThreadPool(pool);
+		CHECK(done == 1000);
+	}
+	SDL_Quit();
+
+	return(CheckResult());
+}
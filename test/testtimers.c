@@ -0,0 +1,171 @@
+/* Runs 1000 timers and measures how late they fire, then how often the
+   timer thread wakes up with a single timer: testtimers [seconds]
+
+   Counts wake-ups with getrusage(), which on Linux adds up the voluntary
+   context switches of all the threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#define NUM_TIMERS	1000
+
+typedef struct Timer {
+	SDL_TimerID id;
+	Uint32 interval;
+	Uint32 expected;
+	int calls;
+	int late;
+	int worst;
+} Timer;
+
+static Timer timers[NUM_TIMERS];
+
+static Uint32 SDLCALL Measure(Uint32 interval, void *param)
+{
+	Timer *timer = (Timer *)param;
+	int late = (int)(SDL_GetTicks() - timer->expected);
+
+	timer->late += late;
+	if ( late > timer->worst ) {
+		timer->worst = late;
+	}
+	++timer->calls;
+	timer->expected += timer->interval;
+	return(interval);
+}
+
+static void TestJitter(Uint32 seconds)
+{
+	int i, calls = 0, worst = 0;
+	double late = 0.0;
+
+	srand(1);
+	for ( i = 0; i < NUM_TIMERS; ++i ) {
+		/* Multiples of TIMER_RESOLUTION, anything else is rounded up */
+		timers[i].interval = TIMER_RESOLUTION * (1 + rand() % 50);
+		timers[i].expected = SDL_GetTicks() + timers[i].interval;
+		timers[i].calls = timers[i].late = timers[i].worst = 0;
+		timers[i].id = SDL_AddTimer(timers[i].interval, Measure, &timers[i]);
+		CHECK(timers[i].id != NULL);
+	}
+	SDL_Delay(seconds * 1000);
+	for ( i = 0; i < NUM_TIMERS; ++i ) {
+		CHECK(SDL_RemoveTimer(timers[i].id));
+		calls += timers[i].calls;
+		late += timers[i].late;
+		if ( timers[i].worst > worst ) {
+			worst = timers[i].worst;
+		}
+	}
+	printf("%d timers, %d callbacks in %u s: %.2f ms late on average, worst %d ms\n",
+	       NUM_TIMERS, calls, seconds, late / calls, worst);
+	CHECK(calls > NUM_TIMERS * (int)seconds);
+	CHECK(late / calls < 5.0);
+}
+
+static Uint32 SDLCALL Count(Uint32 interval, void *param)
+{
+	++*(int *)param;
+	return(interval);
+}
+
+static void TestIdle(Uint32 seconds)
+{
+	struct rusage before, after;
+	SDL_TimerID id;
+	int calls = 0;
+	long wakeups;
+
+	id = SDL_AddTimer(1000, Count, &calls);
+	getrusage(RUSAGE_SELF, &before);
+	SDL_Delay(seconds * 1000);
+	getrusage(RUSAGE_SELF, &after);
+	SDL_RemoveTimer(id);
+
+	wakeups = after.ru_nvcsw - before.ru_nvcsw;
+	printf("One 1000 ms timer, %u s idle: %d callbacks, %ld wake-ups\n",
+	       seconds, calls, wakeups);
+	CHECK(calls >= (int)seconds - 1);
+	/* Polling every millisecond would be about 1000 a second */
+	CHECK(wakeups < 10 * (long)seconds + 10);
+}
+
+static SDL_TimerID victim, added, self;
+static int victim_calls, added_calls, self_calls;
+static SDL_bool victim_removed, self_removed;
+
+static Uint32 SDLCALL Victim(Uint32 interval, void *param)
+{
+	++victim_calls;
+	return(interval);
+}
+
+static Uint32 SDLCALL Added(Uint32 interval, void *param)
+{
+	++added_calls;
+	return(0);
+}
+
+static Uint32 SDLCALL Changer(Uint32 interval, void *param)
+{
+	victim_removed = SDL_RemoveTimer(victim);
+	added = SDL_AddTimer(10, Added, NULL);
+	return(0);
+}
+
+static Uint32 SDLCALL RemoveSelf(Uint32 interval, void *param)
+{
+	++self_calls;
+	self_removed = SDL_RemoveTimer(self);
+	return(interval);
+}
+
+/* Callbacks that add and remove timers */
+static void TestChanges(void)
+{
+	SDL_TimerID changer;
+
+	victim = SDL_AddTimer(300, Victim, NULL);
+	changer = SDL_AddTimer(20, Changer, NULL);
+	self = SDL_AddTimer(10, RemoveSelf, NULL);
+	CHECK(victim && changer && self);
+	SDL_Delay(400);
+
+	CHECK(victim_removed && victim_calls == 0);
+	CHECK(added != NULL && added_calls == 1);
+	CHECK(self_removed && self_calls == 1);
+	/* They are all gone */
+	CHECK(!SDL_RemoveTimer(victim));
+	CHECK(!SDL_RemoveTimer(changer));
+	CHECK(!SDL_RemoveTimer(added));
+	CHECK(!SDL_RemoveTimer(self));
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 seconds = 2;
+
+	if ( argc > 1 ) {
+		seconds = atoi(argv[1]);
+		if ( seconds == 0 ) {
+			fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_Init(SDL_INIT_TIMER) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestChanges();
+	TestJitter(seconds);
+	TestIdle(seconds);
+	SDL_Quit();
+
+	return(CheckResult());
+}
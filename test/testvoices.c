@@ -0,0 +1,523 @@
+/* Checks the voice mixer and times it against SDL_MixAudio:
+   testvoices [seconds]
+
+   The mixer is called directly for the checks and the benchmark, then
+   plays through the audio driver named by SDL_AUDIODRIVER, the dummy
+   driver by default. Use SDL_AUDIODRIVER=disk to write the mix to a file.
+
+   The SIMD loops from src/audio/SDL_voices_NEON.c and SDL_voices_SSE2.c
+   are built in, see Makefile.in, and checked against the C loops. NEON
+   uses the portable stand-ins of SDL_neon_emu.h on a host without it.
+   SDL_AUDIO_SIMD=0 times the mixer with the C loops.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_voices_NEON.h"
+#include "SDL_voices_SSE2.h"
+
+#define RATE		44100
+#define VOICES		32
+
+static void MakeSpec(SDL_AudioSpec *spec, Uint16 format, int channels, int freq)
+{
+	SDL_memset(spec, 0, sizeof(*spec));
+	spec->format = format;
+	spec->channels = channels;
+	spec->freq = freq;
+	spec->samples = 1024;
+}
+
+/* A sample where every frame has the same value */
+static SDL_VoiceSample *ConstantSample(Sint16 value, int frames, int channels)
+{
+	SDL_AudioSpec spec;
+	SDL_VoiceSample *sample;
+	Sint16 *buf = (Sint16 *)malloc(frames * channels * sizeof(Sint16));
+	int i;
+
+	for ( i = 0; i < frames * channels; ++i ) {
+		buf[i] = value;
+	}
+	MakeSpec(&spec, AUDIO_S16SYS, channels, RATE);
+	sample = SDL_CreateVoiceSample((Uint8 *)buf, frames * channels * sizeof(Sint16), &spec);
+	free(buf);
+	return sample;
+}
+
+static void TestVolumeAndPan(void)
+{
+	SDL_AudioSpec spec;
+	SDL_VoiceMixer *mixer;
+	SDL_VoiceSample *sample;
+	Sint16 out[2 * 64];
+
+	MakeSpec(&spec, AUDIO_S16SYS, 2, RATE);
+	mixer = SDL_CreateVoiceMixer(&spec, 4);
+	sample = ConstantSample(10000, 1000, 1);
+	CHECK(mixer && sample);
+	if ( !mixer || !sample ) {
+		return;
+	}
+
+	CHECK(SDL_PlayVoice(mixer, -1, sample, 0) == 0);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	CHECK(out[0] == 10000 && out[1] == 10000);
+	CHECK(out[126] == 10000 && out[127] == 10000);
+
+	SDL_SetVoiceVolume(mixer, 0, SDL_MIX_MAXVOLUME / 2);
+	SDL_SetVoicePan(mixer, 0, SDL_MIX_MAXVOLUME / 2);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	CHECK(out[0] == 2500 && out[1] == 5000);
+
+	SDL_SetVoicePan(mixer, 0, -SDL_MIX_MAXVOLUME);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	CHECK(out[0] == 5000 && out[1] == 0);
+
+	/* The settings stay with the voice, and -1 changes all of them */
+	CHECK(SDL_PlayVoice(mixer, 0, sample, 0) == 0);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	CHECK(out[0] == 5000 && out[1] == 0);
+	CHECK(SDL_SetVoicePan(mixer, -1, 0) == 0);
+	CHECK(SDL_SetVoiceVolume(mixer, -1, SDL_MIX_MAXVOLUME) == 0);
+
+	/* Four loud voices are clipped once, after summing */
+	CHECK(SDL_PlayVoice(mixer, -1, sample, 0) == 1);
+	CHECK(SDL_PlayVoice(mixer, -1, sample, 0) == 2);
+	CHECK(SDL_PlayVoice(mixer, -1, sample, 0) == 3);
+	CHECK(SDL_PlayVoice(mixer, -1, sample, 0) == -1);
+	CHECK(SDL_VoicePlaying(mixer, -1) == 4);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	CHECK(out[0] == 32767 && out[1] == 32767);
+	CHECK(SDL_SetVoiceVolume(mixer, 3, 0) == 0);
+	CHECK(SDL_SetVoicePan(mixer, 4, 0) == -1);
+
+	SDL_StopVoice(mixer, -1);
+	CHECK(SDL_VoicePlaying(mixer, -1) == 0);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	CHECK(out[0] == 0 && out[127] == 0);
+
+	SDL_FreeVoiceSample(sample);
+	SDL_FreeVoiceMixer(mixer);
+}
+
+/* Counts the frames a voice plays before it stops */
+static int PlayedFrames(SDL_VoiceMixer *mixer, int voice)
+{
+	Sint16 out[2 * 100];
+	int frames = 0, i;
+
+	while ( SDL_VoicePlaying(mixer, voice) && frames < 1000000 ) {
+		SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+		for ( i = 0; i < 100; ++i ) {
+			if ( out[2 * i] != 0 ) {
+				++frames;
+			}
+		}
+	}
+	return frames;
+}
+
+static void TestLoopsAndPitch(void)
+{
+	SDL_AudioSpec spec;
+	SDL_VoiceMixer *mixer;
+	SDL_VoiceSample *sample;
+
+	MakeSpec(&spec, AUDIO_S16SYS, 2, RATE);
+	mixer = SDL_CreateVoiceMixer(&spec, 2);
+	sample = ConstantSample(1000, 1000, 2);
+	CHECK(mixer && sample);
+	if ( !mixer || !sample ) {
+		return;
+	}
+
+	SDL_PlayVoice(mixer, 0, sample, 0);
+	CHECK(PlayedFrames(mixer, 0) == 1000);
+	SDL_PlayVoice(mixer, 0, sample, 2);
+	CHECK(PlayedFrames(mixer, 0) == 3000);
+
+	SDL_SetVoicePitch(mixer, 0, 2.0);
+	SDL_PlayVoice(mixer, 0, sample, 0);
+	CHECK(PlayedFrames(mixer, 0) == 500);
+	SDL_SetVoicePitch(mixer, 0, 0.5);
+	SDL_PlayVoice(mixer, 0, sample, 0);
+	CHECK(PlayedFrames(mixer, 0) == 2000);
+
+	/* Endless loops play until stopped */
+	SDL_SetVoicePitch(mixer, 0, 1.0);
+	SDL_PlayVoice(mixer, 0, sample, -1);
+	CHECK(PlayedFrames(mixer, 0) >= 1000000);
+	SDL_StopVoice(mixer, 0);
+
+	SDL_FreeVoiceSample(sample);
+	SDL_FreeVoiceMixer(mixer);
+}
+
+/* A ramp played at half speed gets the midpoints in between */
+static void TestInterpolation(void)
+{
+	SDL_AudioSpec spec;
+	SDL_VoiceMixer *mixer;
+	SDL_VoiceSample *sample;
+	Sint16 ramp[16], out[32];
+	int i, errors = 0;
+
+	for ( i = 0; i < 16; ++i ) {
+		ramp[i] = (Sint16)(i * 1000 - 8000);
+	}
+	MakeSpec(&spec, AUDIO_S16SYS, 1, RATE);
+	mixer = SDL_CreateVoiceMixer(&spec, 1);
+	sample = SDL_CreateVoiceSample((Uint8 *)ramp, sizeof(ramp), &spec);
+	CHECK(mixer && sample);
+	if ( !mixer || !sample ) {
+		return;
+	}
+	SDL_SetVoicePitch(mixer, 0, 0.5);
+	SDL_PlayVoice(mixer, 0, sample, 0);
+	SDL_MixVoices(mixer, (Uint8 *)out, sizeof(out));
+	for ( i = 0; i < 30; ++i ) {
+		if ( out[i] != (i * 500 - 8000) ) {
+			++errors;
+		}
+	}
+	CHECK(errors == 0);
+	/* The last frame is held, not interpolated toward silence */
+	CHECK(out[31] == 7000);
+
+	SDL_FreeVoiceSample(sample);
+	SDL_FreeVoiceMixer(mixer);
+}
+
+/* 8 bit stereo samples mixed to mono and converted to unsigned 8 bit, at
+   the output rate and resampled */
+static void TestFormats(void)
+{
+	static const int rates[] = { RATE, 22050 };
+	SDL_AudioSpec spec;
+	SDL_VoiceMixer *mixer;
+	SDL_VoiceSample *sample;
+	Sint8 sound[2 * 100];
+	Uint8 out[64];
+	int i;
+
+	for ( i = 0; i < 100; ++i ) {
+		sound[2 * i] = 64;
+		sound[2 * i + 1] = 32;
+	}
+	MakeSpec(&spec, AUDIO_U8, 1, RATE);
+	mixer = SDL_CreateVoiceMixer(&spec, 1);
+	CHECK(mixer != NULL);
+	if ( !mixer ) {
+		return;
+	}
+	for ( i = 0; i < SDL_arraysize(rates); ++i ) {
+		MakeSpec(&spec, AUDIO_S8, 2, rates[i]);
+		sample = SDL_CreateVoiceSample((Uint8 *)sound, sizeof(sound), &spec);
+		CHECK(sample != NULL);
+		if ( !sample ) {
+			break;
+		}
+		SDL_PlayVoice(mixer, 0, sample, 0);
+		SDL_MixVoices(mixer, out, sizeof(out));
+		CHECK(out[0] == 128 + 48 && out[63] == 128 + 48);
+		SDL_StopVoice(mixer, 0);
+		SDL_FreeVoiceSample(sample);
+	}
+
+	MakeSpec(&spec, AUDIO_S16SYS, 6, RATE);
+	CHECK(SDL_CreateVoiceMixer(&spec, 1) == NULL);
+	MakeSpec(&spec, AUDIO_S16SYS, 2, RATE);
+	CHECK(SDL_CreateVoiceMixer(&spec, SDL_MIX_MAXVOICES + 1) == NULL);
+
+	SDL_FreeVoiceMixer(mixer);
+}
+
+typedef struct Loops {
+	const char *name;
+	int (*copy)(Sint32 *accum, const Sint16 *s, int channels,
+	            int mix_channels, int count, int left, int right);
+	int (*run)(Sint32 *accum, const Sint16 *data, int channels,
+	           int mix_channels, Uint64 *pos, Uint32 step, int count,
+	           int left, int right);
+	int (*clip)(const Sint32 *accum, Sint16 *out, int count);
+} Loops;
+
+static const Loops loops[] = {
+	{ "NEON", SDL_MixVoiceCopy_NEON, SDL_MixVoiceRun_NEON, SDL_ClipVoices_NEON },
+#if SDL_VOICES_SSE2
+	{ "SSE2", SDL_MixVoiceCopy_SSE2, SDL_MixVoiceRun_SSE2, SDL_ClipVoices_SSE2 },
+#endif
+};
+
+/* The C loops of SDL_voices.c, a copy is a run at the output rate */
+static void ReferenceRun(Sint32 *accum, const Sint16 *data, int channels,
+                         int mix_channels, Uint64 *pos, Uint32 step,
+                         int count, int left, int right)
+{
+	int i, c, v[2];
+
+	for ( i = 0; i < count; ++i ) {
+		const Sint16 *s = data + channels * (Uint32)(*pos >> 16);
+		const int frac = (int)(*pos & 0xFFFF) >> 1;
+
+		for ( c = 0; c < channels; ++c ) {
+			v[c] = s[c] + (((s[c + channels] - s[c]) * frac) >> 15);
+		}
+		if ( mix_channels == 2 ) {
+			*accum++ += v[0] * left;
+			*accum++ += v[channels - 1] * right;
+		} else if ( channels == 1 ) {
+			*accum++ += v[0] * left;
+		} else {
+			*accum++ += ((v[0] + v[1]) * left) >> 1;
+		}
+		*pos += step;
+	}
+}
+
+static void TestLoops(const Loops *simd)
+{
+	enum { FRAMES = 64, MAX_STEP = 4 << 16 };
+	Sint16 data[2 * (FRAMES * 4 + 1)];
+	Sint32 accum[2 * FRAMES], expected[2 * FRAMES];
+	Sint16 out[2 * FRAMES], clipped[2 * FRAMES];
+	int i, test, channels, mix_channels, count, left, right, done;
+	Uint64 pos, expected_pos;
+	Uint32 step;
+
+	for ( test = 0; test < 2000; ++test ) {
+		channels = 1 + rand() % 2;
+		mix_channels = 1 + rand() % 2;
+		count = rand() % FRAMES;
+		left = rand() % (SDL_MIX_MAXVOLUME + 1);
+		right = rand() % (SDL_MIX_MAXVOLUME + 1);
+		for ( i = 0; i < SDL_arraysize(data); ++i ) {
+			data[i] = (Sint16)rand();
+		}
+		for ( i = 0; i < SDL_arraysize(accum); ++i ) {
+			accum[i] = expected[i] = rand() - RAND_MAX / 2;
+		}
+
+		if ( test % 2 ) {
+			expected_pos = 0;
+			step = 1 << 16;
+			done = simd->copy(accum, data, channels, mix_channels, count,
+			                  left, right);
+			pos = (Uint64)done << 16;
+		} else {
+			pos = expected_pos = rand() % (1 << 16);
+			step = 1 + rand() % MAX_STEP;
+			done = simd->run(accum, data, channels, mix_channels, &pos,
+			                 step, count, left, right);
+		}
+		CHECK(done == (count & ~3));
+		ReferenceRun(expected, data, channels, mix_channels, &expected_pos,
+		             step, done, left, right);
+		CHECK(pos == expected_pos);
+		if ( SDL_memcmp(accum, expected, sizeof(accum)) != 0 ) {
+			printf("%s %s, %d to %d channels, %d frames, step %u: wrong mix\n",
+			       simd->name, (test % 2) ? "copy" : "run", channels,
+			       mix_channels, count, step);
+			CHECK(!"same mix");
+		}
+
+		/* Clip sums from well beyond 16 bits */
+		for ( i = 0; i < SDL_arraysize(accum); ++i ) {
+			accum[i] = (rand() % (1 << 26)) - (1 << 25);
+			clipped[i] = (Sint16)(accum[i] >> 7);
+			if ( (accum[i] >> 7) > 32767 ) {
+				clipped[i] = 32767;
+			} else if ( (accum[i] >> 7) < -32768 ) {
+				clipped[i] = -32768;
+			}
+		}
+		count = rand() % SDL_arraysize(accum);
+		done = simd->clip(accum, out, count);
+		CHECK(done == (count & ~7));
+		CHECK(SDL_memcmp(out, clipped, done * sizeof(Sint16)) == 0);
+	}
+	printf("%s voice loops checked\n", simd->name);
+}
+
+/* A tone with a different pitch per voice */
+static SDL_VoiceSample *ToneSample(void)
+{
+	SDL_AudioSpec spec;
+	SDL_VoiceSample *sample;
+	Sint16 *buf = (Sint16 *)malloc(RATE * sizeof(Sint16));
+	int i;
+
+	for ( i = 0; i < RATE; ++i ) {
+		buf[i] = (Sint16)(((i * 440 * 2 / RATE) & 1) ? 3000 : -3000);
+	}
+	MakeSpec(&spec, AUDIO_S16SYS, 1, RATE);
+	sample = SDL_CreateVoiceSample((Uint8 *)buf, RATE * sizeof(Sint16), &spec);
+	free(buf);
+	return sample;
+}
+
+static void StartVoices(SDL_VoiceMixer *mixer, SDL_VoiceSample *sample)
+{
+	int i;
+
+	for ( i = 0; i < VOICES; ++i ) {
+		SDL_SetVoicePitch(mixer, i, 0.5 + i / (double)VOICES);
+		SDL_SetVoicePan(mixer, i, (i * 16) % 256 - SDL_MIX_MAXVOLUME);
+		SDL_SetVoiceVolume(mixer, i, SDL_MIX_MAXVOLUME / 4);
+		SDL_PlayVoice(mixer, i, sample, -1);
+	}
+}
+
+/* Times calls of the mixer for 'periods' buffers of 1024 frames */
+static Uint32 TimeVoices(SDL_VoiceMixer *mixer, Sint16 *stream, int periods)
+{
+	Uint32 start = SDL_GetTicks();
+	int i;
+
+	for ( i = 0; i < periods; ++i ) {
+		SDL_MixVoices(mixer, (Uint8 *)stream, 2 * 1024 * sizeof(Sint16));
+	}
+	CHECK(SDL_VoicePlaying(mixer, -1) == VOICES);
+	return SDL_GetTicks() - start;
+}
+
+/* The voice mixer against SDL_MixAudio on buffers at the output rate.
+   The mixer does the same job with the sound on every voice, then plays
+   a tone at a different pitch and pan on each voice, which SDL_MixAudio
+   can't do. The device is opened, paused, for SDL_MixAudio to know the
+   format.
+ */
+static void Benchmark(int seconds)
+{
+	const int periods = seconds * RATE / 1024;
+	SDL_AudioSpec spec;
+	SDL_VoiceMixer *mixer;
+	SDL_VoiceSample *sample, *tone;
+	Sint16 *stream = (Sint16 *)malloc(2 * 1024 * sizeof(Sint16));
+	Sint16 *sound = (Sint16 *)malloc(2 * RATE * sizeof(Sint16));
+	Uint32 start, mix_ticks, same_ticks, pitch_ticks;
+	int i, j;
+
+	if ( !stream || !sound ) {
+		CHECK(!"benchmark setup");
+		return;
+	}
+	for ( i = 0; i < 2 * RATE; ++i ) {
+		sound[i] = (Sint16)(((i * 440 / RATE) & 1) ? 3000 : -3000);
+	}
+	MakeSpec(&spec, AUDIO_S16SYS, 2, RATE);
+	sample = SDL_CreateVoiceSample((Uint8 *)sound, 2 * RATE * sizeof(Sint16), &spec);
+	mixer = SDL_CreateVoiceMixer(&spec, VOICES);
+	tone = ToneSample();
+	spec.callback = SDL_MixVoices;
+	spec.userdata = mixer;
+	if ( !mixer || !sample || !tone || SDL_OpenAudio(&spec, NULL) < 0 ) {
+		CHECK(!"benchmark setup");
+		return;
+	}
+
+	start = SDL_GetTicks();
+	for ( i = 0; i < periods; ++i ) {
+		const int offset = (i * 2 * 1024) % (2 * RATE - 2 * 1024);
+
+		SDL_memset(stream, 0, 2 * 1024 * sizeof(Sint16));
+		for ( j = 0; j < VOICES; ++j ) {
+			SDL_MixAudio((Uint8 *)stream, (Uint8 *)(sound + offset),
+			             2 * 1024 * sizeof(Sint16), SDL_MIX_MAXVOLUME / 4);
+		}
+	}
+	mix_ticks = SDL_GetTicks() - start;
+
+	SDL_SetVoiceVolume(mixer, -1, SDL_MIX_MAXVOLUME / 4);
+	for ( i = 0; i < VOICES; ++i ) {
+		SDL_PlayVoice(mixer, i, sample, -1);
+	}
+	same_ticks = TimeVoices(mixer, stream, periods);
+	SDL_StopVoice(mixer, -1);
+
+	StartVoices(mixer, tone);
+	pitch_ticks = TimeVoices(mixer, stream, periods);
+	SDL_CloseAudio();
+
+	printf("%d voices, %d s of stereo %d Hz: SDL_MixAudio %u ms, "
+	       "SDL_MixVoices %u ms, %u ms at %d pitches\n", VOICES, seconds,
+	       RATE, mix_ticks, same_ticks, pitch_ticks, VOICES);
+
+	SDL_FreeVoiceSample(tone);
+	SDL_FreeVoiceSample(sample);
+	SDL_FreeVoiceMixer(mixer);
+	free(sound);
+	free(stream);
+}
+
+/* The mixer as the callback of the audio driver */
+static void TestDevice(void)
+{
+	SDL_AudioSpec spec;
+	SDL_VoiceMixer *mixer;
+	SDL_VoiceSample *sample;
+	char name[32];
+
+	MakeSpec(&spec, AUDIO_S16SYS, 2, RATE);
+	mixer = SDL_CreateVoiceMixer(&spec, VOICES);
+	sample = ToneSample();
+	spec.callback = SDL_MixVoices;
+	spec.userdata = mixer;
+	if ( !mixer || !sample || SDL_OpenAudio(&spec, NULL) < 0 ) {
+		printf("Couldn't open audio: %s\n", SDL_GetError());
+		CHECK(!"device setup");
+		return;
+	}
+	StartVoices(mixer, sample);
+	SDL_PauseAudio(0);
+	SDL_Delay(200);
+	SDL_StopVoice(mixer, 3);
+	SDL_SetVoicePitch(mixer, -1, 1.5);
+	CHECK(SDL_VoicePlaying(mixer, -1) == VOICES - 1);
+	SDL_Delay(200);
+	printf("Played %d voices through the %s driver\n", VOICES,
+	       SDL_AudioDriverName(name, sizeof(name)));
+	SDL_CloseAudio();
+
+	SDL_FreeVoiceSample(sample);
+	SDL_FreeVoiceMixer(mixer);
+}
+
+int main(int argc, char *argv[])
+{
+	int seconds = 60;
+	int i;
+
+	if ( argc > 1 ) {
+		seconds = atoi(argv[1]);
+		if ( seconds <= 0 ) {
+			fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+			return(1);
+		}
+	}
+	if ( SDL_getenv("SDL_AUDIODRIVER") == NULL ) {
+		SDL_putenv("SDL_AUDIODRIVER=dummy");
+	}
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	TestVolumeAndPan();
+	TestLoopsAndPitch();
+	TestInterpolation();
+	TestFormats();
+	for ( i = 0; i < SDL_arraysize(loops); ++i ) {
+		TestLoops(&loops[i]);
+	}
+	Benchmark(seconds);
+	TestDevice();
+	SDL_Quit();
+
+	return(CheckResult());
+}
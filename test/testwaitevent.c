@@ -0,0 +1,118 @@
+/* Measures how long SDL_WaitEvent() takes to wake up for an event pushed
+   by another thread: testwaitevent [events]
+
+   Uses gettimeofday() for the timestamps, SDL_GetTicks() is too coarse.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+static Uint32 Microseconds(void)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (Uint32)(now.tv_sec * 1000000 + now.tv_usec);
+}
+
+static int SDLCALL PushEvents(void *data)
+{
+	int count = *(int *)data;
+	SDL_Event event;
+	int i;
+
+	SDL_memset(&event, 0, sizeof(event));
+	event.type = SDL_USEREVENT;
+	for ( i = 0; i < count; ++i ) {
+		/* Gaps the old 10 ms polling would have shown up in */
+		SDL_Delay(1 + rand() % 7);
+		event.user.code = i;
+		event.user.data1 = (void *)(size_t)Microseconds();
+		SDL_PushEvent(&event);
+	}
+	return(0);
+}
+
+static void TestLatency(int count)
+{
+	SDL_Thread *thread;
+	SDL_Event event;
+	Uint32 latency, total = 0, worst = 0;
+	int i, got = 0;
+
+	thread = SDL_CreateThread(PushEvents, &count);
+	CHECK(thread != NULL);
+	for ( i = 0; i < count; ++i ) {
+		if ( !SDL_WaitEvent(&event) ) {
+			CHECK(!"SDL_WaitEvent");
+			break;
+		}
+		latency = Microseconds() - (Uint32)(size_t)event.user.data1;
+		total += latency;
+		if ( latency > worst ) {
+			worst = latency;
+		}
+		got += (event.type == SDL_USEREVENT && event.user.code == i);
+	}
+	SDL_WaitThread(thread, NULL);
+
+	printf("%d events: average wake-up %u us, worst %u us\n",
+	       count, total / count, worst);
+	CHECK(got == count);
+	/* Polling every 10 ms would average about 5 ms */
+	CHECK(total / count < 2000);
+}
+
+static void TestTimeout(void)
+{
+	SDL_Event event;
+	Uint32 start;
+
+	/* Nothing comes, the timeout passes */
+	start = SDL_GetTicks();
+	CHECK(SDL_WaitEventTimeout(&event, 50) == 0);
+	CHECK(SDL_GetTicks() - start >= 50);
+	CHECK(SDL_WaitEventTimeout(NULL, 0) == 0);
+
+	/* An event already in the queue is returned right away */
+	SDL_memset(&event, 0, sizeof(event));
+	event.type = SDL_USEREVENT;
+	event.user.code = 42;
+	CHECK(SDL_PushEvent(&event) == 0);
+	SDL_memset(&event, 0, sizeof(event));
+	start = SDL_GetTicks();
+	CHECK(SDL_WaitEventTimeout(&event, 1000) == 1);
+	CHECK(SDL_GetTicks() - start < 100);
+	CHECK(event.type == SDL_USEREVENT && event.user.code == 42);
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Event event;
+	int count = 200;
+
+	if ( argc > 1 ) {
+		count = atoi(argv[1]);
+		if ( count <= 0 ) {
+			fprintf(stderr, "Usage: %s [events]\n", argv[0]);
+			return(1);
+		}
+	}
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	while ( SDL_PollEvent(&event) )
+		;
+
+	TestTimeout();
+	TestLatency(count);
+	SDL_Quit();
+
+	return(CheckResult());
+}
@@ -0,0 +1,249 @@
+/* Compares the NEON colorspace conversion with the C functions of the
+   software YUV overlays, for every combination of Y, U and V:
+   testyuvneon [frames]
+
+   Built from src/video/SDL_yuv_neon.c, see Makefile.in. On a host without
+   NEON the portable stand-ins of SDL_neon_emu.h are used, which checks the
+   arithmetic but not the speed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "testcheck.h"
+
+#include "SDL_yuv_neon_c.h"
+
+/* The overlays are made 8 pixels wider than the converted area, so the
+   library sticks to the C functions even on NEON builds */
+#define WIDTH		512
+#define REF_WIDTH	(WIDTH + 8)
+#define MOD		24	/* extra pixels at the end of each output row */
+
+typedef void (*ConvertFunc)(int *colortab, Uint32 *rgb_2_pix,
+                            unsigned char *lum, unsigned char *cr,
+                            unsigned char *cb, unsigned char *out,
+                            int rows, int cols, int mod);
+
+typedef struct Layout {
+	const char *name;
+	int bpp;
+	Uint32 Rmask, Gmask, Bmask;
+	ConvertFunc planar, packed;
+} Layout;
+
+static const Layout layouts[] = {
+	{ "565", 16, 0xF800, 0x07E0, 0x001F,
+	  Color565DitherYV12NEON1X, Color565DitherYUY2NEON1X },
+	{ "RGB", 32, 0x00FF0000, 0x0000FF00, 0x000000FF,
+	  ColorRGBDitherYV12NEON1X, ColorRGBDitherYUY2NEON1X },
+	{ "BGR", 32, 0x000000FF, 0x0000FF00, 0x00FF0000,
+	  ColorBGRDitherYV12NEON1X, ColorBGRDitherYUY2NEON1X },
+};
+
+typedef struct Format {
+	const char *name;
+	Uint32 format;
+	int packed;
+	int ly, lu, lv;	/* byte positions in a packed group */
+} Format;
+
+static const Format formats[] = {
+	{ "YV12", SDL_YV12_OVERLAY, 0, 0, 0, 0 },
+	{ "IYUV", SDL_IYUV_OVERLAY, 0, 0, 0, 0 },
+	{ "YUY2", SDL_YUY2_OVERLAY, 1, 0, 1, 3 },
+	{ "UYVY", SDL_UYVY_OVERLAY, 1, 1, 0, 2 },
+	{ "YVYU", SDL_YVYU_OVERLAY, 1, 0, 3, 1 },
+};
+
+/* Planar frames have a chroma sample per 2x2 block and 256x256 of them,
+   packed frames one per 2x1 pair and 256 rows. Every block gets its own
+   U and V, and the frame number picks the lumas, so all frames together
+   go through every combination.
+ */
+static int FrameHeight(const Format *format)
+{
+	return format->packed ? 256 : 512;
+}
+
+static int FrameCount(const Format *format)
+{
+	return format->packed ? 128 : 64;
+}
+
+static Uint8 Luma(const Format *format, int frame, int x, int y)
+{
+	if ( format->packed ) {
+		return (Uint8)(2 * frame + (x & 1));
+	}
+	return (Uint8)(4 * frame + 2 * (y & 1) + (x & 1));
+}
+
+/* Fills the overlay and a tight copy for the NEON functions, returns the
+   plane pointers into the copy in the order SDL_DisplayYUV_SW passes them */
+static void FillFrame(const Format *format, SDL_Overlay *overlay, int frame,
+                      Uint8 *tight, Uint8 **lum, Uint8 **cr, Uint8 **cb)
+{
+	const int h = FrameHeight(format);
+	int x, y;
+
+	if ( format->packed ) {
+		for ( y = 0; y < h; ++y ) {
+			Uint8 *row = overlay->pixels[0] + y * overlay->pitches[0];
+			Uint8 *trow = tight + y * WIDTH * 2;
+
+			for ( x = 0; x < REF_WIDTH; x += 2 ) {
+				Uint8 group[4];
+
+				group[format->ly] = Luma(format, frame, x, y);
+				group[format->ly + 2] = Luma(format, frame, x + 1, y);
+				group[format->lu] = (Uint8)((x / 2) + frame);
+				group[format->lv] = (Uint8)y;
+				SDL_memcpy(row + x * 2, group, 4);
+				if ( x < WIDTH ) {
+					SDL_memcpy(trow + x * 2, group, 4);
+				}
+			}
+		}
+		*lum = tight + format->ly;
+		*cb = tight + format->lu;
+		*cr = tight + format->lv;
+	} else {
+		Uint8 *u = tight + WIDTH * h;
+		Uint8 *v = u + (WIDTH / 2) * (h / 2);
+		int uplane = (format->format == SDL_IYUV_OVERLAY) ? 1 : 2;
+
+		for ( y = 0; y < h; ++y ) {
+			for ( x = 0; x < REF_WIDTH; ++x ) {
+				Uint8 l = Luma(format, frame, x, y);
+
+				overlay->pixels[0][y * overlay->pitches[0] + x] = l;
+				if ( x < WIDTH ) {
+					tight[y * WIDTH + x] = l;
+				}
+			}
+		}
+		for ( y = 0; y < h / 2; ++y ) {
+			for ( x = 0; x < REF_WIDTH / 2; ++x ) {
+				Uint8 cu = (Uint8)(x + frame);
+				Uint8 cv = (Uint8)y;
+
+				overlay->pixels[uplane][y * overlay->pitches[uplane] + x] = cu;
+				overlay->pixels[3 - uplane][y * overlay->pitches[3 - uplane] + x] = cv;
+				if ( x < WIDTH / 2 ) {
+					u[y * (WIDTH / 2) + x] = cu;
+					v[y * (WIDTH / 2) + x] = cv;
+				}
+			}
+		}
+		*lum = tight;
+		*cb = u;
+		*cr = v;
+	}
+}
+
+static void TestConversion(const Format *format, const Layout *layout, int frames)
+{
+	const int h = FrameHeight(format);
+	const int bytes = layout->bpp / 8;
+	SDL_Surface *display;
+	SDL_Overlay *overlay;
+	SDL_Rect rect;
+	Uint8 *tight, *out;
+	Uint8 *lum, *cr, *cb;
+	Uint32 ref_ticks = 0, neon_ticks = 0, start;
+	int frame, y, diff = 0;
+
+	display = SDL_CreateRGBSurface(SDL_SWSURFACE, REF_WIDTH, h, layout->bpp,
+	                               layout->Rmask, layout->Gmask, layout->Bmask, 0);
+	overlay = SDL_CreateYUVOverlay(REF_WIDTH, h, format->format, display);
+	tight = (Uint8 *)malloc(WIDTH * h * 2);
+	out = (Uint8 *)malloc((WIDTH + MOD) * h * bytes);
+	if ( !display || !overlay || !tight || !out ) {
+		CHECK(!"out of memory");
+		return;
+	}
+	CHECK(!overlay->hw_overlay);
+
+	rect.x = 0;
+	rect.y = 0;
+	rect.w = REF_WIDTH;
+	rect.h = h;
+	for ( frame = 0; frame < frames; ++frame ) {
+		SDL_LockYUVOverlay(overlay);
+		FillFrame(format, overlay, frame * FrameCount(format) / frames,
+		          tight, &lum, &cr, &cb);
+		SDL_UnlockYUVOverlay(overlay);
+
+		start = SDL_GetTicks();
+		SDL_DisplayYUVOverlay(overlay, &rect);
+		ref_ticks += SDL_GetTicks() - start;
+
+		start = SDL_GetTicks();
+		if ( format->packed ) {
+			layout->packed(NULL, NULL, lum, cr, cb, out, h, WIDTH, MOD);
+		} else {
+			layout->planar(NULL, NULL, lum, cr, cb, out, h, WIDTH, MOD);
+		}
+		neon_ticks += SDL_GetTicks() - start;
+
+		for ( y = 0; y < h; ++y ) {
+			if ( SDL_memcmp((Uint8 *)display->pixels + y * display->pitch,
+			                out + y * (WIDTH + MOD) * bytes,
+			                WIDTH * bytes) != 0 ) {
+				++diff;
+			}
+		}
+	}
+	printf("%s to %s: %d frames, C %u ms, NEON %u ms\n", format->name,
+	       layout->name, frames, ref_ticks, neon_ticks);
+	CHECK(diff == 0);
+
+	free(out);
+	free(tight);
+	SDL_FreeYUVOverlay(overlay);
+	SDL_FreeSurface(display);
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = 0;
+	int i, j;
+
+	if ( argc > 1 ) {
+		frames = atoi(argv[1]);
+		if ( frames <= 0 ) {
+			fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+			return(1);
+		}
+	}
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	/* The display rectangle is clipped to the screen */
+	if ( SDL_SetVideoMode(REF_WIDTH, 512, 16, SDL_SWSURFACE) == NULL ) {
+		fprintf(stderr, "Couldn't set video mode: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+
+	/* Every combination for YV12 and YUY2, a few frames for the others */
+	for ( i = 0; i < SDL_arraysize(formats); ++i ) {
+		for ( j = 0; j < SDL_arraysize(layouts); ++j ) {
+			int count = frames;
+
+			if ( count == 0 ) {
+				count = (formats[i].format == SDL_YV12_OVERLAY ||
+				         formats[i].format == SDL_YUY2_OVERLAY) ?
+				        FrameCount(&formats[i]) : 4;
+			}
+			TestConversion(&formats[i], &layouts[j], count);
+		}
+	}
+	SDL_Quit();
+
+	return(CheckResult());
+}